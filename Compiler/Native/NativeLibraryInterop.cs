@@ -264,6 +264,7 @@ internal class NativeLibraryInterop(NativeLibraryInteropContext context)
       UpsampleFactor = nativeModuleContext.UpsampleFactor,
       MaxSampleCount = nativeModuleContext.MaxSampleCount,
       SampleCount = nativeModuleContext.SampleCount,
+      VoiceStartSampleOffset = 0,
       IsCompileTime = NativeTypes.NativeBool.True,
       ReportingContext = (void*)GCHandle.ToIntPtr(memoryHandle),
       Report = &ReportWrapper,
@@ -280,6 +280,7 @@ internal unsafe struct NativeModuleContext
   public int UpsampleFactor;
   public SizeT MaxSampleCount;
   public SizeT SampleCount;
+  public SizeT VoiceStartSampleOffset;
   public NativeBool IsCompileTime;
 
   public void* ReportingContext;
@@ -293,11 +294,13 @@ internal unsafe struct NativeModule
   public NativeModuleSignature Signature;
   public NativeBool HasSideEffects;
   public NativeBool AlwaysRuntime;
+  public NativeBool IsTileable;
 
   public delegate* unmanaged[Cdecl]<NativeModuleContext*, NativeModuleArguments*, int*, NativeBool> Prepare;
   public delegate* unmanaged[Cdecl]<NativeModuleContext*, NativeModuleArguments*, MemoryRequirement*, void*> InitializeVoice;
   public delegate* unmanaged[Cdecl]<NativeModuleContext*, void> DeinitializeVoice;
   public delegate* unmanaged[Cdecl]<NativeModuleContext*, NativeBool, void> SetVoiceActive;
+  public delegate* unmanaged[Cdecl]<NativeModuleContext*, nuint> GetVoiceMemoryUsage;
   public delegate* unmanaged[Cdecl]<NativeModuleContext*, NativeModuleArguments*, void> InvokeCompileTime;
   public delegate* unmanaged[Cdecl]<NativeModuleContext*, NativeModuleArguments*, void*, nuint, void> Invoke;
 }
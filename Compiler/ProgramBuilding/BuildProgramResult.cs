@@ -26,10 +26,27 @@ file enum SerializedNodeType : byte
 
 file static class ProgramSerialization
 {
-  public const uint Version = 0;
+  public const uint Version = 1;
   public static readonly byte[] Header = Encoding.ASCII.GetBytes("CHORDHEADER");
   public static readonly byte[] HashSalt = [0x8b, 0xe1, 0x53, 0x2f, 0x41, 0x16, 0xc9, 0x8d, 0x1a, 0x2a, 0xb4, 0x3c, 0x0b, 0x34, 0xae, 0xdf];
 
+  public static SerializedNodeType GetSerializedNodeType(object node)
+    => node switch
+    {
+      InputProgramGraphNode => SerializedNodeType.Input,
+      OutputProgramGraphNode => SerializedNodeType.Output,
+      ConstantProgramGraphNode constantNode when constantNode.Value is float => SerializedNodeType.FloatConstant,
+      ConstantProgramGraphNode constantNode when constantNode.Value is double => SerializedNodeType.DoubleConstant,
+      ConstantProgramGraphNode constantNode when constantNode.Value is int => SerializedNodeType.IntConstant,
+      ConstantProgramGraphNode constantNode when constantNode.Value is bool => SerializedNodeType.BoolConstant,
+      ConstantProgramGraphNode constantNode when constantNode.Value is string => SerializedNodeType.StringConstant,
+      ArrayProgramGraphNode => SerializedNodeType.Array,
+      NativeModuleCallProgramGraphNode => SerializedNodeType.NativeModuleCall,
+      GraphInputProgramGraphNode => SerializedNodeType.GraphInput,
+      GraphOutputProgramGraphNode => SerializedNodeType.GraphOutput,
+      _ => throw new ArgumentException("Object is not a program graph node type"),
+    };
+
   public static IEnumerable<object> IterateGraph(IReadOnlyList<IProcessorProgramGraphNode> graph)
   {
     var visitedNodes = new HashSet<IProcessorProgramGraphNode>();
@@ -96,9 +113,11 @@ internal class BuildProgramResult : IBuildProgramResult
 
     contentWriter.Write((uint)nativeLibraries.Count);
 
-    // Order native libraries by name to be deterministic
+    // Order native libraries by name to be deterministic. Native module call nodes reference their native library by its index in this list.
+    var nativeLibraryDependencyIndices = new Dictionary<Guid, int>();
     foreach (var nativeLibrary in nativeLibraries.OrderBy((v) => v.Name))
     {
+      nativeLibraryDependencyIndices.Add(nativeLibrary.Id, nativeLibraryDependencyIndices.Count);
       contentWriter.Write(nativeLibrary.Id.ToByteArray());
       contentWriter.Write(nativeLibrary.Version.Major);
       contentWriter.Write(nativeLibrary.Version.Minor);
@@ -115,124 +134,133 @@ internal class BuildProgramResult : IBuildProgramResult
     contentWriter.Write((uint)InstrumentProperties.EffectActivationMode);
     contentWriter.Write(InstrumentProperties.EffectActivationThreshold);
 
-    // Assign a unique index for each node
-    var nodeIndices = new Dictionary<object, uint>();
+    // Assign a unique index for each node. Nodes are grouped by type so that the engine can locate any node's fixed-size record from its index alone.
+    var nodesByType = Enum.GetValues<SerializedNodeType>().ToDictionary((nodeType) => nodeType, (_) => new List<object>());
     foreach (var node in ProgramSerialization.IterateGraph(fullGraph))
     {
-      nodeIndices.Add(node, (uint)nodeIndices.Count);
+      nodesByType[ProgramSerialization.GetSerializedNodeType(node)].Add(node);
     }
 
-    contentWriter.Write(nodeIndices.Count);
-
-    // Write node types up-front
-    foreach (var node in ProgramSerialization.IterateGraph(fullGraph))
+    var nodeIndices = new Dictionary<object, uint>();
+    foreach (var nodeType in Enum.GetValues<SerializedNodeType>())
     {
-      var nodeType = node switch
+      foreach (var node in nodesByType[nodeType])
       {
-        InputProgramGraphNode => SerializedNodeType.Input,
-        OutputProgramGraphNode => SerializedNodeType.Output,
-        ConstantProgramGraphNode constantNode when constantNode.Value is float => SerializedNodeType.FloatConstant,
-        ConstantProgramGraphNode constantNode when constantNode.Value is double => SerializedNodeType.DoubleConstant,
-        ConstantProgramGraphNode constantNode when constantNode.Value is int => SerializedNodeType.IntConstant,
-        ConstantProgramGraphNode constantNode when constantNode.Value is bool => SerializedNodeType.BoolConstant,
-        ConstantProgramGraphNode constantNode when constantNode.Value is string => SerializedNodeType.StringConstant,
-        ArrayProgramGraphNode arrayNode => SerializedNodeType.Array,
-        NativeModuleCallProgramGraphNode => SerializedNodeType.NativeModuleCall,
-        GraphInputProgramGraphNode => SerializedNodeType.GraphInput,
-        GraphOutputProgramGraphNode => SerializedNodeType.GraphOutput,
-        _ => throw new ArgumentException("Object is not a program graph node type"),
-      };
-
-      contentWriter.Write((byte)nodeType);
+        nodeIndices.Add(node, (uint)nodeIndices.Count);
+      }
     }
 
-    // Write node data
-    foreach (var node in ProgramSerialization.IterateGraph(fullGraph))
+    // Variable-length lists of node indices are written to a shared reference table and string constants are written to a deduplicated UTF-32 pool so that
+    // every node record has a fixed size
+    var references = new List<uint>();
+    var stringPoolStream = new MemoryStream();
+    var stringPoolIndices = new Dictionary<string, uint>();
+    var recordStream = new MemoryStream();
+    var recordWriter = new BinaryWriter(recordStream);
+
+    uint AddReferences(IEnumerable<object> nodes)
     {
-      switch (node)
+      var firstReferenceIndex = (uint)references.Count;
+      references.AddRange(nodes.Select((node) => nodeIndices[node]));
+      return firstReferenceIndex;
+    }
+
+    foreach (var nodeType in Enum.GetValues<SerializedNodeType>())
+    {
+      foreach (var node in nodesByType[nodeType])
       {
-        case InputProgramGraphNode inputNode:
-          // Don't bother writing the input connection because it is redundant with output node connections
-          Debug.Assert(inputNode.Connection != null);
-          break;
-
-        case OutputProgramGraphNode outputNode:
-          contentWriter.Write((uint)outputNode.Connections.Count);
-          foreach (var connection in outputNode.Connections)
-          {
-            contentWriter.Write(nodeIndices[connection]);
-          }
-
-          break;
-
-        case ConstantProgramGraphNode constantNode when constantNode.Value is float:
-          contentWriter.Write(nodeIndices[constantNode.Output]);
-          contentWriter.Write(constantNode.FloatValue);
-          break;
-
-        case ConstantProgramGraphNode constantNode when constantNode.Value is double:
-          contentWriter.Write(nodeIndices[constantNode.Output]);
-          contentWriter.Write(constantNode.DoubleValue);
-          break;
-
-        case ConstantProgramGraphNode constantNode when constantNode.Value is int:
-          contentWriter.Write(nodeIndices[constantNode.Output]);
-          contentWriter.Write(constantNode.IntValue);
-          break;
-
-        case ConstantProgramGraphNode constantNode when constantNode.Value is bool:
-          contentWriter.Write(nodeIndices[constantNode.Output]);
-          contentWriter.Write(constantNode.BoolValue);
-          break;
-
-        case ConstantProgramGraphNode constantNode when constantNode.Value is string:
-          contentWriter.Write(nodeIndices[constantNode.Output]);
-          contentWriter.Write((uint)constantNode.StringValue.Length);
-          contentWriter.Write(Encoding.UTF32.GetBytes(constantNode.StringValue));
-          break;
-
-        case ArrayProgramGraphNode arrayNode:
-          contentWriter.Write((uint)arrayNode.Elements.Count);
-          foreach (var element in arrayNode.Elements)
-          {
-            contentWriter.Write(nodeIndices[element]);
-          }
-
-          contentWriter.Write(nodeIndices[arrayNode.Output]);
-          break;
-
-        case NativeModuleCallProgramGraphNode nativeModuleCallNode:
-          contentWriter.Write(nativeModuleCallNode.NativeModule.NativeLibraryId.ToByteArray());
-          contentWriter.Write(nativeModuleCallNode.NativeModule.Id.ToByteArray());
-          contentWriter.Write((uint)nativeModuleCallNode.Inputs.Count);
-          contentWriter.Write((uint)nativeModuleCallNode.Outputs.Count);
-          contentWriter.Write(nativeModuleCallNode.UpsampleFactor);
-
-          foreach (var input in nativeModuleCallNode.Inputs)
-          {
-            contentWriter.Write(nodeIndices[input]);
-          }
-
-          foreach (var input in nativeModuleCallNode.Outputs)
-          {
-            contentWriter.Write(nodeIndices[input]);
-          }
-
-          break;
-
-        case GraphInputProgramGraphNode graphInputNode:
-          contentWriter.Write(nodeIndices[graphInputNode.Output]);
-          break;
-
-        case GraphOutputProgramGraphNode graphOutputNode:
-          contentWriter.Write(nodeIndices[graphOutputNode.Input]);
-          break;
-
-        default:
-          throw new ArgumentException("Object is not a program graph node type");
+        switch (node)
+        {
+          case InputProgramGraphNode inputNode:
+            // Input nodes have no record because their connection is redundant with output node connections
+            Debug.Assert(inputNode.Connection != null);
+            break;
+
+          case OutputProgramGraphNode outputNode:
+            recordWriter.Write((uint)outputNode.Connections.Count);
+            recordWriter.Write(AddReferences(outputNode.Connections));
+            break;
+
+          case ConstantProgramGraphNode constantNode when constantNode.Value is float:
+            recordWriter.Write(nodeIndices[constantNode.Output]);
+            recordWriter.Write(constantNode.FloatValue);
+            break;
+
+          case ConstantProgramGraphNode constantNode when constantNode.Value is double:
+            recordWriter.Write(nodeIndices[constantNode.Output]);
+            recordWriter.Write(constantNode.DoubleValue);
+            break;
+
+          case ConstantProgramGraphNode constantNode when constantNode.Value is int:
+            recordWriter.Write(nodeIndices[constantNode.Output]);
+            recordWriter.Write(constantNode.IntValue);
+            break;
+
+          case ConstantProgramGraphNode constantNode when constantNode.Value is bool:
+            recordWriter.Write(nodeIndices[constantNode.Output]);
+            recordWriter.Write(constantNode.BoolValue ? 1u : 0u);
+            break;
+
+          case ConstantProgramGraphNode constantNode when constantNode.Value is string:
+            {
+              var stringBytes = Encoding.UTF32.GetBytes(constantNode.StringValue);
+              if (!stringPoolIndices.TryGetValue(constantNode.StringValue, out var stringPoolIndex))
+              {
+                stringPoolIndex = (uint)(stringPoolStream.Length / sizeof(uint));
+                stringPoolIndices.Add(constantNode.StringValue, stringPoolIndex);
+                stringPoolStream.Write(stringBytes);
+              }
+
+              recordWriter.Write(nodeIndices[constantNode.Output]);
+              recordWriter.Write(stringPoolIndex);
+              recordWriter.Write((uint)(stringBytes.Length / sizeof(uint)));
+              break;
+            }
+
+          case ArrayProgramGraphNode arrayNode:
+            recordWriter.Write((uint)arrayNode.Elements.Count);
+            recordWriter.Write(AddReferences(arrayNode.Elements));
+            recordWriter.Write(nodeIndices[arrayNode.Output]);
+            break;
+
+          case NativeModuleCallProgramGraphNode nativeModuleCallNode:
+            recordWriter.Write((uint)nativeLibraryDependencyIndices[nativeModuleCallNode.NativeModule.NativeLibraryId]);
+            recordWriter.Write(nativeModuleCallNode.NativeModule.Id.ToByteArray());
+            recordWriter.Write((uint)nativeModuleCallNode.Inputs.Count);
+            recordWriter.Write((uint)nativeModuleCallNode.Outputs.Count);
+            recordWriter.Write(nativeModuleCallNode.UpsampleFactor);
+            recordWriter.Write(AddReferences(nativeModuleCallNode.Inputs.Cast<object>().Concat(nativeModuleCallNode.Outputs)));
+            break;
+
+          case GraphInputProgramGraphNode graphInputNode:
+            recordWriter.Write(nodeIndices[graphInputNode.Output]);
+            break;
+
+          case GraphOutputProgramGraphNode graphOutputNode:
+            recordWriter.Write(nodeIndices[graphOutputNode.Input]);
+            break;
+
+          default:
+            throw new ArgumentException("Object is not a program graph node type");
+        }
       }
     }
 
+    foreach (var nodeType in Enum.GetValues<SerializedNodeType>())
+    {
+      contentWriter.Write((uint)nodesByType[nodeType].Count);
+    }
+
+    contentWriter.Write((uint)references.Count);
+    contentWriter.Write((uint)(stringPoolStream.Length / sizeof(uint)));
+    contentWriter.Write(recordStream.ToArray());
+    foreach (var reference in references)
+    {
+      contentWriter.Write(reference);
+    }
+
+    contentWriter.Write(stringPoolStream.ToArray());
+
     // Write the graph data
 
     contentWriter.Write(ProgramGraph.InputChannelsFloat != null);
@@ -28,6 +28,13 @@ namespace Chord
   NativeLibraryRegistry::~NativeLibraryRegistry() noexcept
     { UnloadNativeLibraries(); }
 
+  void NativeLibraryRegistry::RegisterNativeLibrary(const NativeLibrary* nativeLibrary)
+  {
+    usz firstEntryIndex = m_nativeLibraryEntries.Count();
+    ListNativeLibrariesCallback(nativeLibrary);
+    InitializeNativeLibraries(firstEntryIndex);
+  }
+
   std::optional<std::tuple<const NativeLibrary*, void*>> NativeLibraryRegistry::TryGetNativeLibraryAndContext(Guid id) const
   {
     for (const NativeLibraryEntry& entry : m_nativeLibraryEntries)
@@ -106,11 +113,7 @@ namespace Chord
       listNativeLibraries(this, &NativeLibraryRegistry::ListNativeLibrariesCallbackWrapper);
     }
 
-    for (NativeLibraryEntry& nativeLibraryEntry : m_nativeLibraryEntries)
-    {
-      if (nativeLibraryEntry.m_nativeLibrary.m_initialize != nullptr)
-        { nativeLibraryEntry.m_nativeLibraryContext = nativeLibraryEntry.m_nativeLibrary.m_initialize(); }
-    }
+    InitializeNativeLibraries(0);
   }
 
   void NativeLibraryRegistry::UnloadNativeLibraries()
@@ -134,6 +137,16 @@ namespace Chord
     m_dllHandles.Clear();
   }
 
+  void NativeLibraryRegistry::InitializeNativeLibraries(usz firstEntryIndex)
+  {
+    for (usz i = firstEntryIndex; i < m_nativeLibraryEntries.Count(); i++)
+    {
+      NativeLibraryEntry& nativeLibraryEntry = m_nativeLibraryEntries[i];
+      if (nativeLibraryEntry.m_nativeLibrary.m_initialize != nullptr)
+        { nativeLibraryEntry.m_nativeLibraryContext = nativeLibraryEntry.m_nativeLibrary.m_initialize(); }
+    }
+  }
+
   void NativeLibraryRegistry::ListNativeLibrariesCallbackWrapper(void* contextUntyped, const NativeLibrary* nativeLibrary)
     { static_cast<NativeLibraryRegistry*>(contextUntyped)->ListNativeLibrariesCallback(nativeLibrary); }
 
@@ -26,6 +26,12 @@ namespace Chord
 
       std::optional<std::tuple<const NativeLibrary*, void*>> TryGetNativeLibraryAndContext(Guid id) const;
 
+    protected:
+      // Registers a native library which is linked into the host rather than loaded from the native library path. The native library is copied so it does
+      // not need to outlive this call. This must not be called while programs are being loaded or processed. This is only exposed to tests (through a derived
+      // class) so that they can register test-only native modules.
+      void RegisterNativeLibrary(const NativeLibrary* nativeLibrary);
+
     private:
       struct NativeLibraryEntry
       {
@@ -35,6 +41,7 @@ namespace Chord
 
       void LoadNativeLibraries(const std::filesystem::path& nativeLibraryPath);
       void UnloadNativeLibraries();
+      void InitializeNativeLibraries(usz firstEntryIndex);
 
       static void ListNativeLibrariesCallbackWrapper(void* contextUntyped, const NativeLibrary* nativeLibraryNative);
       void ListNativeLibrariesCallback(const NativeLibrary* nativeLibraryNative);
@@ -22,18 +22,333 @@ namespace Chord
   };
 
   static constexpr char Header[] = { 'C', 'H', 'O', 'R', 'D', 'P', 'R', 'O', 'G', 'R', 'A', 'M' };
-  static constexpr u32 Version = 0;
+  static constexpr u32 NodeStreamVersion = 0;
+  static constexpr u32 NodeTableVersion = 1;
   static constexpr u8 HashSalt[] = { 0x8b, 0xe1, 0x53, 0x2f, 0x41, 0x16, 0xc9, 0x8d, 0x1a, 0x2a, 0xb4, 0x3c, 0x0b, 0x34, 0xae, 0xdf };
 
+  // Version 1 programs store nodes grouped by type (in SerializedNodeType order) as fixed-size little-endian records so that the location of every record is
+  // known from the node counts alone. Variable-length lists of node indices live in a shared u32 reference table and string constants live in a UTF-32 pool:
+  // - Output: connection count, first connection reference index
+  // - FloatConstant, IntConstant, BoolConstant (u32): output node index, value
+  // - DoubleConstant: output node index, value
+  // - StringConstant: output node index, string pool index, length
+  // - Array: element count, first element reference index, output node index
+  // - NativeModuleCall: native library dependency index, native module ID, input count, output count, upsample factor, first input reference index (outputs
+  //   immediately follow inputs)
+  // - GraphInput: output node index
+  // - GraphOutput: input node index
+  static constexpr usz NodeRecordByteCounts[] = { 0, 8, 8, 12, 8, 8, 12, 12, 36, 4, 4 };
+  static_assert(std::size(NodeRecordByteCounts) == EnumCount<SerializedNodeType>());
+
   template<typename TNode>
-  usz GetNodeIndex(const BoundedArray<TNode> &nodes, IProgramGraphNode* node)
+  usz GetNodeIndex(const BoundedArray<TNode> &nodes, const IProgramGraphNode* node)
   {
-    TNode* typedNode = static_cast<TNode*>(node);
+    const TNode* typedNode = static_cast<const TNode*>(node);
     ASSERT(typedNode >= nodes.Elements() && typedNode < nodes.Elements() + nodes.Count());
     return usz(typedNode - nodes.Elements());
   }
 
+  static constexpr usz HeaderByteCount = sizeof(Header) + sizeof(u32) + Sha256ByteCount;
+
+  using NodeRecordOffsets = FixedArray<usz, EnumCount<SerializedNodeType>() + 1>;
+
+  // The content bytes are hashed in place followed by the hash salt
+  static FixedArray<u8, Sha256ByteCount> CalculateContentHashInternal(Span<const u8> bytes)
+  {
+    Sha256 sha256;
+    sha256.Update(Span(bytes, HeaderByteCount, ToEnd));
+    sha256.Update(HashSalt);
+    return sha256.Finalize();
+  }
+
+  // Returns the offset of the first record of each node type (followed by the end of the last record) in a version 1 program. Returns nullopt for version 0
+  // programs or if the records don't fit in the bytes. Nothing past the node counts is validated.
+  static std::optional<NodeRecordOffsets> TryGetNodeRecordOffsets(Span<const u8> bytes)
+  {
+    BinaryReader reader(bytes, std::endian::little);
+    u32 version;
+    u32 nativeLibraryDependencyCount;
+    if (!reader.Seek(sizeof(Header))
+      || !reader.Read(&version)
+      || version != NodeTableVersion
+      || !reader.Seek(HeaderByteCount)
+      || !reader.Read(&nativeLibraryDependencyCount))
+      { return std::nullopt; }
+
+    // Skip the native library dependencies, the program variant properties, and the instrument properties to reach the node counts. The reference count
+    // and string pool length which follow the node counts aren't needed.
+    static constexpr usz NativeLibraryDependencyByteCount = Guid::ByteCount + 3 * sizeof(u32);
+    static constexpr usz PropertiesByteCount = 3 * sizeof(s32) + 2 * sizeof(u32) + sizeof(f64);
+    FixedArray<u32, EnumCount<SerializedNodeType>()> nodeTypeCounts;
+    if (!reader.Seek(reader.GetOffset() + usz(nativeLibraryDependencyCount) * NativeLibraryDependencyByteCount + PropertiesByteCount)
+      || !reader.Read(Span<u32>(nodeTypeCounts))
+      || !reader.Seek(reader.GetOffset() + 2 * sizeof(u32)))
+      { return std::nullopt; }
+
+    NodeRecordOffsets recordOffsets;
+    recordOffsets[0] = reader.GetOffset();
+    for (usz i = 0; i < nodeTypeCounts.Count(); i++)
+      { recordOffsets[i + 1] = recordOffsets[i] + usz(nodeTypeCounts[i]) * NodeRecordByteCounts[i]; }
+
+    if (recordOffsets[nodeTypeCounts.Count()] > bytes.Count())
+      { return std::nullopt; }
+
+    return recordOffsets;
+  }
+
+  static Span<const u8> GetNodeRecordBytes(Span<const u8> bytes, const NodeRecordOffsets& recordOffsets, SerializedNodeType nodeType)
+  {
+    usz nodeTypeIndex = EnumValue(nodeType);
+    return Span(bytes, recordOffsets[nodeTypeIndex], recordOffsets[nodeTypeIndex + 1] - recordOffsets[nodeTypeIndex]);
+  }
+
+  // Like the content hash except that numeric constant records only contribute their output node indices
+  static FixedArray<u8, Sha256ByteCount> CalculateStructureHashInternal(Span<const u8> bytes, const NodeRecordOffsets& recordOffsets)
+  {
+    usz constantsStartOffset = recordOffsets[EnumValue(SerializedNodeType::FloatConstant)];
+    usz constantsEndOffset = recordOffsets[EnumValue(SerializedNodeType::BoolConstant) + 1];
+
+    Sha256 sha256;
+    sha256.Update(Span(bytes, HeaderByteCount, constantsStartOffset - HeaderByteCount));
+    for (SerializedNodeType nodeType :
+      { SerializedNodeType::FloatConstant, SerializedNodeType::DoubleConstant, SerializedNodeType::IntConstant, SerializedNodeType::BoolConstant })
+    {
+      Span<const u8> recordBytes = GetNodeRecordBytes(bytes, recordOffsets, nodeType);
+      usz recordByteCount = NodeRecordByteCounts[EnumValue(nodeType)];
+      for (usz recordOffset = 0; recordOffset < recordBytes.Count(); recordOffset += recordByteCount)
+        { sha256.Update(Span(recordBytes, recordOffset, sizeof(u32))); }
+    }
+
+    sha256.Update(Span(bytes, constantsEndOffset, ToEnd));
+    sha256.Update(HashSalt);
+    return sha256.Finalize();
+  }
+
+  // Reads the values of a single numeric constant node type, skipping the output node index which precedes each value
+  template<typename TValue, typename TSerializedValue>
+  static bool TryReadConstantValues(Span<const u8> recordBytes, FixedArray<TValue>& values)
+  {
+    static constexpr usz RecordByteCount = sizeof(u32) + sizeof(TSerializedValue);
+    ASSERT(recordBytes.Count() % RecordByteCount == 0);
+
+    values = InitializeCapacity(recordBytes.Count() / RecordByteCount);
+    BinaryReader reader(recordBytes, std::endian::little);
+    for (TValue& value : values)
+    {
+      u32 outputNodeIndex;
+      TSerializedValue serializedValue;
+      if (!reader.Read(&outputNodeIndex) || !reader.Read(&serializedValue))
+        { return false; }
+
+      if constexpr (std::same_as<TValue, bool>)
+      {
+        if (serializedValue > 1)
+          { return false; }
+        value = serializedValue != 0;
+      }
+      else
+        { value = serializedValue; }
+    }
+
+    return true;
+  }
+
+  // Version 0 programs store each node's type so node pointers are pre-resolved into a lookup table
+  class Program::NodeStreamLookup
+  {
+  public:
+    NodeStreamLookup(FixedArray<SerializedNodeType> nodeTypes, FixedArray<IProgramGraphNode*> nodesFromIndices)
+      : m_nodeTypes(std::move(nodeTypes))
+      , m_nodesFromIndices(std::move(nodesFromIndices))
+      { }
+
+    u32 NodeCount() const
+      { return u32(m_nodeTypes.Count()); }
+
+    SerializedNodeType GetNodeType(u32 nodeIndex) const
+    {
+      ASSERT(nodeIndex < NodeCount());
+      return m_nodeTypes[nodeIndex];
+    }
+
+    IProgramGraphNode* GetNode(u32 nodeIndex) const
+    {
+      ASSERT(nodeIndex < NodeCount());
+      return m_nodesFromIndices[nodeIndex];
+    }
+
+  private:
+    FixedArray<SerializedNodeType> m_nodeTypes;
+    FixedArray<IProgramGraphNode*> m_nodesFromIndices;
+  };
+
+  // Version 1 programs group nodes by type so a node's type and location are determined by which of these index ranges it falls into
+  class Program::NodeTableLookup
+  {
+  public:
+    // The total node count must fit in a u32
+    NodeTableLookup(Program* program, const FixedArray<u32, EnumCount<SerializedNodeType>()>& nodeTypeCounts)
+      : m_program(program)
+    {
+      m_nodeTypeStartIndices[0] = 0;
+      for (usz i = 0; i < nodeTypeCounts.Count(); i++)
+        { m_nodeTypeStartIndices[i + 1] = m_nodeTypeStartIndices[i] + nodeTypeCounts[i]; }
+    }
+
+    u32 NodeCount() const
+      { return m_nodeTypeStartIndices[EnumCount<SerializedNodeType>()]; }
+
+    SerializedNodeType GetNodeType(u32 nodeIndex) const
+    {
+      ASSERT(nodeIndex < NodeCount());
+      usz nodeTypeIndex = 0;
+      while (nodeIndex >= m_nodeTypeStartIndices[nodeTypeIndex + 1])
+        { nodeTypeIndex++; }
+      return SerializedNodeType(nodeTypeIndex);
+    }
+
+    // Nodes are resolved from their index on demand. The node may not have been constructed yet but we know where it will live.
+    IProgramGraphNode* GetNode(u32 nodeIndex) const
+    {
+      SerializedNodeType nodeType = GetNodeType(nodeIndex);
+      usz index = nodeIndex - m_nodeTypeStartIndices[EnumValue(nodeType)];
+      switch (nodeType)
+      {
+      case SerializedNodeType::Input:
+        return m_program->m_inputNodes.Elements() + index;
+
+      case SerializedNodeType::Output:
+        return m_program->m_outputNodes.Elements() + index;
+
+      case SerializedNodeType::FloatConstant:
+        return m_program->m_floatConstantNodes.Elements() + index;
+
+      case SerializedNodeType::DoubleConstant:
+        return m_program->m_doubleConstantNodes.Elements() + index;
+
+      case SerializedNodeType::IntConstant:
+        return m_program->m_intConstantNodes.Elements() + index;
+
+      case SerializedNodeType::BoolConstant:
+        return m_program->m_boolConstantNodes.Elements() + index;
+
+      case SerializedNodeType::StringConstant:
+        return m_program->m_stringConstantNodes.Elements() + index;
+
+      case SerializedNodeType::Array:
+        return m_program->m_arrayNodes.Elements() + index;
+
+      case SerializedNodeType::NativeModuleCall:
+        return m_program->m_nativeModuleCallNodes.Elements() + index;
+
+      case SerializedNodeType::GraphInput:
+        return m_program->m_graphInputNodes.Elements() + index;
+
+      case SerializedNodeType::GraphOutput:
+        return m_program->m_graphOutputNodes.Elements() + index;
+
+      default:
+        ASSERT(false);
+        return nullptr;
+      }
+    }
+
+  private:
+    Program* m_program = nullptr;
+    FixedArray<u32, EnumCount<SerializedNodeType>() + 1> m_nodeTypeStartIndices;
+  };
+
+  // These resolve node indices through either format's node lookup
+  template<typename TNodeLookup>
+  static IProgramGraphNode* TryGetNode(const TNodeLookup& nodeLookup, u32 nodeIndex, SerializedNodeType nodeType)
+    { return nodeIndex < nodeLookup.NodeCount() && nodeLookup.GetNodeType(nodeIndex) == nodeType ? nodeLookup.GetNode(nodeIndex) : nullptr; }
+
+  template<typename TNodeLookup>
+  static bool TryGetProcessorNode(const TNodeLookup& nodeLookup, u32 nodeIndex, const IProcessorProgramGraphNode** processorNodePointer)
+  {
+    if (nodeIndex >= nodeLookup.NodeCount())
+      { return false; }
+    switch (nodeLookup.GetNodeType(nodeIndex))
+    {
+    case SerializedNodeType::Input:
+      return false;
+
+    case SerializedNodeType::Output:
+      return false;
+
+    case SerializedNodeType::FloatConstant:
+      *processorNodePointer = static_cast<FloatConstantProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    case SerializedNodeType::DoubleConstant:
+      *processorNodePointer = static_cast<DoubleConstantProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    case SerializedNodeType::IntConstant:
+      *processorNodePointer = static_cast<IntConstantProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    case SerializedNodeType::BoolConstant:
+      *processorNodePointer = static_cast<BoolConstantProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    case SerializedNodeType::StringConstant:
+      *processorNodePointer = static_cast<StringConstantProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    case SerializedNodeType::Array:
+      *processorNodePointer = static_cast<ArrayProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    case SerializedNodeType::NativeModuleCall:
+      *processorNodePointer = static_cast<NativeModuleCallProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    case SerializedNodeType::GraphInput:
+      *processorNodePointer = static_cast<GraphInputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    case SerializedNodeType::GraphOutput:
+      *processorNodePointer = static_cast<GraphOutputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
+      return true;
+
+    default:
+      ASSERT(false);
+      return false;
+    }
+  }
+
+  template<typename TNodeLookup, typename TSetInput>
+  static bool AttachProcessorInputNode(const TNodeLookup& nodeLookup, u32 inputNodeIndex, IProcessorProgramGraphNode* processorNode, TSetInput&& setInput)
+  {
+    InputProgramGraphNode* inputNode = static_cast<InputProgramGraphNode*>(TryGetNode(nodeLookup, inputNodeIndex, SerializedNodeType::Input));
+    if (inputNode == nullptr || inputNode->Processor() != nullptr)
+      { return false; }
+
+    ProgramGraphNodeModifier::SetInputNodeProcessor(inputNode, processorNode);
+    setInput(inputNode);
+    return true;
+  }
+
+  template<typename TNodeLookup, typename TSetOutput>
+  static bool AttachProcessorOutputNode(const TNodeLookup& nodeLookup, u32 outputNodeIndex, IProcessorProgramGraphNode* processorNode, TSetOutput&& setOutput)
+  {
+    OutputProgramGraphNode* outputNode = static_cast<OutputProgramGraphNode*>(TryGetNode(nodeLookup, outputNodeIndex, SerializedNodeType::Output));
+    if (outputNode == nullptr || outputNode->Processor() != nullptr)
+      { return false; }
+
+    ProgramGraphNodeModifier::SetOutputNodeProcessor(outputNode, processorNode);
+    setOutput(outputNode);
+    return true;
+  }
+
   std::optional<Program> Program::Deserialize(Span<const u8> bytes)
+    { return DeserializeInternal(bytes, false); }
+
+  std::optional<Program> Program::DeserializeInPlace(Span<const u8> bytes)
+    { return DeserializeInternal(bytes, true); }
+
+  std::optional<Program> Program::DeserializeInternal(Span<const u8> bytes, bool referenceBytes)
   {
     Program program;
     BinaryReader reader(bytes, std::endian::little);
@@ -49,7 +364,7 @@ namespace Chord
     if (std::memcmp(header.Elements(), Header, sizeof(Header)) != 0)
       { return std::nullopt; }
 
-    if (version != Version)
+    if (version != NodeStreamVersion && version != NodeTableVersion)
       { return std::nullopt; }
 
     u32 nativeLibraryDependencyCount;
@@ -91,6 +406,34 @@ namespace Chord
 
     program.m_instrumentProperties.m_effectActivationMode = EffectActivationMode(effectActivationMode);
 
+    if (version == NodeStreamVersion)
+    {
+      std::optional<NodeStreamLookup> nodeLookup = DeserializeNodeStream(reader, program);
+      if (!nodeLookup.has_value() || !DeserializeGraph(reader, nodeLookup.value(), program))
+        { return std::nullopt; }
+    }
+    else
+    {
+      std::optional<NodeTableLookup> nodeLookup = DeserializeNodeTable(reader, bytes, referenceBytes, program);
+      if (!nodeLookup.has_value() || !DeserializeGraph(reader, nodeLookup.value(), program))
+        { return std::nullopt; }
+    }
+
+    if (reader.GetOffset() != bytes.Count())
+      { return std::nullopt; }
+
+    auto computedContentHash = CalculateContentHashInternal(bytes);
+    if (std::memcmp(contentHash.Elements(), computedContentHash.Elements(), contentHash.Count()) != 0)
+      { return std::nullopt; }
+
+    program.m_contentHash = contentHash;
+    program.m_structureHash = TryReadStructureHash(bytes);
+    ASSERT(program.m_structureHash.has_value() == (version == NodeTableVersion));
+    return std::move(program);
+  }
+
+  std::optional<Program::NodeStreamLookup> Program::DeserializeNodeStream(BinaryReader& reader, Program& program)
+  {
     u32 nodeCount;
     if (!reader.Read(&nodeCount))
       { return std::nullopt; }
@@ -180,95 +523,12 @@ namespace Chord
       nodeCounts[EnumValue(nodeTypes[nodeIndex])]++;
     }
 
-    auto AttachProcessorInputNode =
-      [&](u32 inputNodeIndex, IProcessorProgramGraphNode* processorNode, auto&& setInput) -> bool
-      {
-        if (inputNodeIndex >= nodeCount || nodeTypes[inputNodeIndex] != SerializedNodeType::Input)
-          { return false; }
-
-        InputProgramGraphNode* inputNode = static_cast<InputProgramGraphNode*>(nodesFromIndices[inputNodeIndex]);
-        if (inputNode->Processor() != nullptr)
-          { return false; }
-
-        ProgramGraphNodeModifier::SetInputNodeProcessor(inputNode, processorNode);
-        setInput(inputNode);
-        return true;
-      };
-
-    auto AttachProcessorOutputNode =
-      [&](u32 outputNodeIndex, IProcessorProgramGraphNode* processorNode, auto&& setOutput) -> bool
-      {
-        if (outputNodeIndex >= nodeCount || nodeTypes[outputNodeIndex] != SerializedNodeType::Output)
-          { return false; }
-
-        OutputProgramGraphNode* outputNode = static_cast<OutputProgramGraphNode*>(nodesFromIndices[outputNodeIndex]);
-        if (outputNode->Processor() != nullptr)
-          { return false; }
-
-        ProgramGraphNodeModifier::SetOutputNodeProcessor(outputNode, processorNode);
-        setOutput(outputNode);
-        return true;
-      };
-
-    auto TryGetProcessorNode =
-      [&](u32 nodeIndex, const IProcessorProgramGraphNode** processorNodePointer) -> bool
-      {
-        if (nodeIndex >= nodeCount)
-          { return false; }
-        switch (nodeTypes[nodeIndex])
-        {
-        case SerializedNodeType::Input:
-          return false;
-
-        case SerializedNodeType::Output:
-          return false;
-
-        case SerializedNodeType::FloatConstant:
-          *processorNodePointer = static_cast<FloatConstantProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        case SerializedNodeType::DoubleConstant:
-          *processorNodePointer = static_cast<DoubleConstantProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        case SerializedNodeType::IntConstant:
-          *processorNodePointer = static_cast<IntConstantProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        case SerializedNodeType::BoolConstant:
-          *processorNodePointer = static_cast<BoolConstantProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        case SerializedNodeType::StringConstant:
-          *processorNodePointer = static_cast<StringConstantProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        case SerializedNodeType::Array:
-          *processorNodePointer = static_cast<ArrayProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        case SerializedNodeType::NativeModuleCall:
-          *processorNodePointer = static_cast<NativeModuleCallProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        case SerializedNodeType::GraphInput:
-          *processorNodePointer = static_cast<GraphInputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        case SerializedNodeType::GraphOutput:
-          *processorNodePointer = static_cast<GraphOutputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
-          return true;
-
-        default:
-          ASSERT(false);
-          return false;
-        }
-      };
+    NodeStreamLookup nodeLookup(std::move(nodeTypes), std::move(nodesFromIndices));
 
     // Read node data
     for (u32 nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
     {
-      switch (nodeTypes[nodeIndex])
+      switch (nodeLookup.GetNodeType(nodeIndex))
       {
       case SerializedNodeType::Input:
         program.m_inputNodes.AppendNew();
@@ -284,11 +544,13 @@ namespace Chord
           for (u32 i = 0; i < connectionCount; i++)
           {
             u32 connectionNodeIndex;
-            if (!reader.Read(&connectionNodeIndex)
-              || connectionNodeIndex >= nodeCount
-              || nodeTypes[connectionNodeIndex] != SerializedNodeType::Input)
+            if (!reader.Read(&connectionNodeIndex))
               { return std::nullopt; }
-            ProgramGraphNodeModifier::SetOutputNodeConnection(&node, i, static_cast<InputProgramGraphNode*>(nodesFromIndices[connectionNodeIndex]));
+
+            InputProgramGraphNode* connectionNode = static_cast<InputProgramGraphNode*>(TryGetNode(nodeLookup, connectionNodeIndex, SerializedNodeType::Input));
+            if (connectionNode == nullptr)
+              { return std::nullopt; }
+            ProgramGraphNodeModifier::SetOutputNodeConnection(&node, i, connectionNode);
           }
 
           break;
@@ -303,6 +565,7 @@ namespace Chord
 
           FloatConstantProgramGraphNode& node = program.m_floatConstantNodes.AppendNew(value);
           if (!AttachProcessorOutputNode(
+            nodeLookup,
             outputNodeIndex,
             &node,
             [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
@@ -320,6 +583,7 @@ namespace Chord
 
           DoubleConstantProgramGraphNode& node = program.m_doubleConstantNodes.AppendNew(value);
           if (!AttachProcessorOutputNode(
+            nodeLookup,
             outputNodeIndex,
             &node,
             [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
@@ -337,6 +601,7 @@ namespace Chord
 
           IntConstantProgramGraphNode& node = program.m_intConstantNodes.AppendNew(value);
           if (!AttachProcessorOutputNode(
+            nodeLookup,
             outputNodeIndex,
             &node,
             [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
@@ -354,6 +619,7 @@ namespace Chord
 
           BoolConstantProgramGraphNode& node = program.m_boolConstantNodes.AppendNew(value != 0);
           if (!AttachProcessorOutputNode(
+            nodeLookup,
             outputNodeIndex,
             &node,
             [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
@@ -375,6 +641,7 @@ namespace Chord
 
           StringConstantProgramGraphNode& node = program.m_stringConstantNodes.AppendNew(value);
           if (!AttachProcessorOutputNode(
+            nodeLookup,
             outputNodeIndex,
             &node,
             [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
@@ -395,6 +662,7 @@ namespace Chord
             u32 elementNodeIndex;
             if (!reader.Read(&elementNodeIndex)
               || !AttachProcessorInputNode(
+                nodeLookup,
                 elementNodeIndex,
                 &node,
                 [&](const IInputProgramGraphNode* inputNode) { ProgramGraphNodeModifier::SetArrayNodeElement(&node, i, inputNode); }))
@@ -404,6 +672,7 @@ namespace Chord
           u32 outputNodeIndex;
           if (!reader.Read(&outputNodeIndex)
             || !AttachProcessorOutputNode(
+              nodeLookup,
               outputNodeIndex,
               &node,
               [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetArrayNodeOutput(&node, outputNode); }))
@@ -455,6 +724,7 @@ namespace Chord
             u32 inputNodeIndex;
             if (!reader.Read(&inputNodeIndex)
               || !AttachProcessorInputNode(
+                nodeLookup,
                 inputNodeIndex,
                 &node,
                 [&](const IInputProgramGraphNode* inputNode) { ProgramGraphNodeModifier::SetNativeModuleCallNodeInput(&node, i, inputNode); }))
@@ -466,6 +736,7 @@ namespace Chord
             u32 outputNodeIndex;
             if (!reader.Read(&outputNodeIndex)
               || !AttachProcessorOutputNode(
+                nodeLookup,
                 outputNodeIndex,
                 &node,
                 [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetNativeModuleCallNodeOutput(&node, i, outputNode); }))
@@ -482,6 +753,7 @@ namespace Chord
           u32 outputNodeIndex;
           if (!reader.Read(&outputNodeIndex)
             || !AttachProcessorOutputNode(
+              nodeLookup,
               outputNodeIndex,
               &node,
               [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetGraphInputNodeOutput(&node, outputNode); }))
@@ -497,6 +769,7 @@ namespace Chord
           u32 inputNodeIndex;
           if (!reader.Read(&inputNodeIndex)
             || !AttachProcessorInputNode(
+              nodeLookup,
               inputNodeIndex,
               &node,
               [&](const IInputProgramGraphNode* inputNode) { ProgramGraphNodeModifier::SetGraphOutputNodeInput(&node, inputNode); }))
@@ -511,17 +784,361 @@ namespace Chord
       }
     }
 
+    return std::move(nodeLookup);
+  }
+
+  std::optional<Program::NodeTableLookup> Program::DeserializeNodeTable(BinaryReader& reader, Span<const u8> bytes, bool referenceBytes, Program& program)
+  {
+    FixedArray<u32, EnumCount<SerializedNodeType>()> nodeTypeCounts;
+    u32 referenceCount;
+    u32 stringPoolLength;
+    if (!reader.Read(Span<u32>(nodeTypeCounts))
+      || !reader.Read(&referenceCount)
+      || !reader.Read(&stringPoolLength))
+      { return std::nullopt; }
+
+    // Every section has a fixed size derived from the counts above so the entire layout can be bounds-checked before any node is created
+    u64 totalNodeCount = 0;
+    usz nodeRecordsByteCount = 0;
+    for (usz i = 0; i < nodeTypeCounts.Count(); i++)
+    {
+      totalNodeCount += nodeTypeCounts[i];
+      nodeRecordsByteCount += usz(nodeTypeCounts[i]) * NodeRecordByteCounts[i];
+    }
+
+    usz referencesOffset = reader.GetOffset() + nodeRecordsByteCount;
+    usz stringPoolOffset = referencesOffset + usz(referenceCount) * sizeof(u32);
+    usz graphDataOffset = stringPoolOffset + usz(stringPoolLength) * sizeof(char32_t);
+    if (totalNodeCount > std::numeric_limits<u32>::max() || graphDataOffset > bytes.Count())
+      { return std::nullopt; }
+
+    // Input records are empty so the layout check above doesn't bound the Input count. Every input node is referenced by the output node it connects to,
+    // so there can't be more input nodes than references.
+    if (nodeTypeCounts[EnumValue(SerializedNodeType::Input)] > referenceCount)
+      { return std::nullopt; }
+
+    NodeTableLookup nodeLookup(&program, nodeTypeCounts);
+
+    program.m_inputNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::Input)]);
+    program.m_outputNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::Output)]);
+    program.m_floatConstantNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::FloatConstant)]);
+    program.m_doubleConstantNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::DoubleConstant)]);
+    program.m_intConstantNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::IntConstant)]);
+    program.m_boolConstantNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::BoolConstant)]);
+    program.m_stringConstantNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::StringConstant)]);
+    program.m_arrayNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::Array)]);
+    program.m_nativeModuleCallNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::NativeModuleCall)]);
+    program.m_graphInputNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::GraphInput)]);
+    program.m_graphOutputNodes = InitializeCapacity(nodeTypeCounts[EnumValue(SerializedNodeType::GraphOutput)]);
+
+    // When the caller keeps the bytes alive (e.g. a memory-mapped program file), string constants can point directly at the string pool. Otherwise, the
+    // pool is copied once and string constants point into the copy rather than each string being allocated separately.
+    Span<const char32_t> stringPool;
+    const u8* stringPoolBytes = bytes.Elements() + stringPoolOffset;
+    if (referenceBytes && std::endian::native == std::endian::little && IsAlignedPointer(stringPoolBytes, alignof(char32_t)))
+      { stringPool = Span(reinterpret_cast<const char32_t*>(stringPoolBytes), usz(stringPoolLength)); }
+    else
+    {
+      program.m_stringPool = InitializeCapacity(stringPoolLength);
+      BinaryReader stringPoolReader(Span(bytes, stringPoolOffset, usz(stringPoolLength) * sizeof(char32_t)), std::endian::little);
+      if (!stringPoolReader.Read(Span<char32_t>(program.m_stringPool)))
+        { return std::nullopt; }
+      stringPool = program.m_stringPool;
+    }
+
+    auto IsReferenceRangeValid =
+      [&](u32 firstReferenceIndex, u64 referenceRangeCount)
+        { return u64(firstReferenceIndex) + referenceRangeCount <= referenceCount; };
+
+    auto TryReadReference =
+      [&](usz referenceIndex, u32* nodeIndex) -> bool
+      {
+        BinaryReader referenceReader(Span(bytes, referencesOffset + referenceIndex * sizeof(u32), sizeof(u32)), std::endian::little);
+        return referenceReader.Read(nodeIndex);
+      };
+
+    // Because node types appear in SerializedNodeType order, every node referenced by a record (Input and Output nodes for processors, Input nodes for
+    // Output nodes) has already been constructed by the time the record is read
+    for (usz nodeTypeIndex = 0; nodeTypeIndex < nodeTypeCounts.Count(); nodeTypeIndex++)
+    {
+      for (u32 recordIndex = 0; recordIndex < nodeTypeCounts[nodeTypeIndex]; recordIndex++)
+      {
+        switch (SerializedNodeType(nodeTypeIndex))
+        {
+        case SerializedNodeType::Input:
+          program.m_inputNodes.AppendNew();
+          break;
+
+        case SerializedNodeType::Output:
+          {
+            u32 connectionCount;
+            u32 firstConnectionReferenceIndex;
+            if (!reader.Read(&connectionCount)
+              || !reader.Read(&firstConnectionReferenceIndex)
+              || !IsReferenceRangeValid(firstConnectionReferenceIndex, connectionCount))
+              { return std::nullopt; }
+
+            OutputProgramGraphNode& node = program.m_outputNodes.AppendNew(connectionCount);
+            for (u32 i = 0; i < connectionCount; i++)
+            {
+              u32 connectionNodeIndex;
+              if (!TryReadReference(usz(firstConnectionReferenceIndex) + i, &connectionNodeIndex))
+                { return std::nullopt; }
+
+              auto connectionNode = static_cast<InputProgramGraphNode*>(TryGetNode(nodeLookup, connectionNodeIndex, SerializedNodeType::Input));
+              if (connectionNode == nullptr)
+                { return std::nullopt; }
+              ProgramGraphNodeModifier::SetOutputNodeConnection(&node, i, connectionNode);
+            }
+
+            break;
+          }
+
+        case SerializedNodeType::FloatConstant:
+          {
+            u32 outputNodeIndex;
+            f32 value;
+            if (!reader.Read(&outputNodeIndex) || !reader.Read(&value))
+              { return std::nullopt; }
+
+            FloatConstantProgramGraphNode& node = program.m_floatConstantNodes.AppendNew(value);
+            if (!AttachProcessorOutputNode(
+              nodeLookup,
+              outputNodeIndex,
+              &node,
+              [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
+              { return std::nullopt; }
+
+            break;
+          }
+
+        case SerializedNodeType::DoubleConstant:
+          {
+            u32 outputNodeIndex;
+            f64 value;
+            if (!reader.Read(&outputNodeIndex) || !reader.Read(&value))
+              { return std::nullopt; }
+
+            DoubleConstantProgramGraphNode& node = program.m_doubleConstantNodes.AppendNew(value);
+            if (!AttachProcessorOutputNode(
+              nodeLookup,
+              outputNodeIndex,
+              &node,
+              [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
+              { return std::nullopt; }
+
+            break;
+          }
+
+        case SerializedNodeType::IntConstant:
+          {
+            u32 outputNodeIndex;
+            s32 value;
+            if (!reader.Read(&outputNodeIndex) || !reader.Read(&value))
+              { return std::nullopt; }
+
+            IntConstantProgramGraphNode& node = program.m_intConstantNodes.AppendNew(value);
+            if (!AttachProcessorOutputNode(
+              nodeLookup,
+              outputNodeIndex,
+              &node,
+              [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
+              { return std::nullopt; }
+
+            break;
+          }
+
+        case SerializedNodeType::BoolConstant:
+          {
+            u32 outputNodeIndex;
+            u32 value;
+            if (!reader.Read(&outputNodeIndex) || !reader.Read(&value) || value > 1)
+              { return std::nullopt; }
+
+            BoolConstantProgramGraphNode& node = program.m_boolConstantNodes.AppendNew(value != 0);
+            if (!AttachProcessorOutputNode(
+              nodeLookup,
+              outputNodeIndex,
+              &node,
+              [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
+              { return std::nullopt; }
+
+            break;
+          }
+
+        case SerializedNodeType::StringConstant:
+          {
+            u32 outputNodeIndex;
+            u32 stringPoolIndex;
+            u32 length;
+            if (!reader.Read(&outputNodeIndex)
+              || !reader.Read(&stringPoolIndex)
+              || !reader.Read(&length)
+              || u64(stringPoolIndex) + length > stringPoolLength)
+              { return std::nullopt; }
+
+            UnicodeString value(Unmanaged, Span(stringPool, usz(stringPoolIndex), usz(length)));
+            StringConstantProgramGraphNode& node = program.m_stringConstantNodes.AppendNew(value);
+            if (!AttachProcessorOutputNode(
+              nodeLookup,
+              outputNodeIndex,
+              &node,
+              [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetConstantNodeOutput(&node, outputNode); }))
+              { return std::nullopt; }
+
+            break;
+          }
+
+        case SerializedNodeType::Array:
+          {
+            u32 elementCount;
+            u32 firstElementReferenceIndex;
+            u32 outputNodeIndex;
+            if (!reader.Read(&elementCount)
+              || !reader.Read(&firstElementReferenceIndex)
+              || !reader.Read(&outputNodeIndex)
+              || !IsReferenceRangeValid(firstElementReferenceIndex, elementCount))
+              { return std::nullopt; }
+
+            ArrayProgramGraphNode& node = program.m_arrayNodes.AppendNew(elementCount);
+            for (u32 i = 0; i < elementCount; i++)
+            {
+              u32 elementNodeIndex;
+              if (!TryReadReference(usz(firstElementReferenceIndex) + i, &elementNodeIndex)
+                || !AttachProcessorInputNode(
+                  nodeLookup,
+                  elementNodeIndex,
+                  &node,
+                  [&](const IInputProgramGraphNode* inputNode) { ProgramGraphNodeModifier::SetArrayNodeElement(&node, i, inputNode); }))
+                { return std::nullopt; }
+            }
+
+            if (!AttachProcessorOutputNode(
+              nodeLookup,
+              outputNodeIndex,
+              &node,
+              [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetArrayNodeOutput(&node, outputNode); }))
+              { return std::nullopt; }
+
+            break;
+          }
+
+        case SerializedNodeType::NativeModuleCall:
+          {
+            // The native library is referenced by its index in the dependency list so no search is needed to validate it
+            u32 nativeLibraryDependencyIndex;
+            FixedArray<u8, Guid::ByteCount> nativeModuleIdBytes;
+            u32 inputCount;
+            u32 outputCount;
+            s32 upsampleFactor;
+            u32 firstReferenceIndex;
+            if (!reader.Read(&nativeLibraryDependencyIndex)
+              || !reader.Read(Span<u8>(nativeModuleIdBytes))
+              || !reader.Read(&inputCount)
+              || !reader.Read(&outputCount)
+              || !reader.Read(&upsampleFactor)
+              || !reader.Read(&firstReferenceIndex)
+              || nativeLibraryDependencyIndex >= program.m_nativeLibraryDependencies.Count()
+              || upsampleFactor <= 0
+              || !IsReferenceRangeValid(firstReferenceIndex, u64(inputCount) + outputCount))
+              { return std::nullopt; }
+
+            NativeModuleCallProgramGraphNode& node = program.m_nativeModuleCallNodes.AppendNew(
+              program.m_nativeLibraryDependencies[nativeLibraryDependencyIndex].m_id,
+              Guid::FromBytes(nativeModuleIdBytes),
+              inputCount,
+              outputCount,
+              upsampleFactor);
+
+            // Inputs are followed immediately by outputs in the reference table
+            for (u32 i = 0; i < inputCount; i++)
+            {
+              u32 inputNodeIndex;
+              if (!TryReadReference(usz(firstReferenceIndex) + i, &inputNodeIndex)
+                || !AttachProcessorInputNode(
+                  nodeLookup,
+                  inputNodeIndex,
+                  &node,
+                  [&](const IInputProgramGraphNode* inputNode) { ProgramGraphNodeModifier::SetNativeModuleCallNodeInput(&node, i, inputNode); }))
+                { return std::nullopt; }
+            }
+
+            for (u32 i = 0; i < outputCount; i++)
+            {
+              u32 outputNodeIndex;
+              if (!TryReadReference(usz(firstReferenceIndex) + inputCount + i, &outputNodeIndex)
+                || !AttachProcessorOutputNode(
+                  nodeLookup,
+                  outputNodeIndex,
+                  &node,
+                  [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetNativeModuleCallNodeOutput(&node, i, outputNode); }))
+                { return std::nullopt; }
+            }
+
+            break;
+          }
+
+        case SerializedNodeType::GraphInput:
+          {
+            GraphInputProgramGraphNode& node = program.m_graphInputNodes.AppendNew();
+
+            u32 outputNodeIndex;
+            if (!reader.Read(&outputNodeIndex)
+              || !AttachProcessorOutputNode(
+                nodeLookup,
+                outputNodeIndex,
+                &node,
+                [&](const IOutputProgramGraphNode* outputNode) { ProgramGraphNodeModifier::SetGraphInputNodeOutput(&node, outputNode); }))
+              { return std::nullopt; }
+
+            break;
+          }
+
+        case SerializedNodeType::GraphOutput:
+          {
+            GraphOutputProgramGraphNode& node = program.m_graphOutputNodes.AppendNew();
+
+            u32 inputNodeIndex;
+            if (!reader.Read(&inputNodeIndex)
+              || !AttachProcessorInputNode(
+                nodeLookup,
+                inputNodeIndex,
+                &node,
+                [&](const IInputProgramGraphNode* inputNode) { ProgramGraphNodeModifier::SetGraphOutputNodeInput(&node, inputNode); }))
+              { return std::nullopt; }
+
+            break;
+          }
+
+        default:
+          ASSERT(false);
+          break;
+        }
+      }
+    }
+
+    // The reference table and string pool were consumed in place so skip over them
+    ASSERT(reader.GetOffset() == referencesOffset);
+    if (!reader.Seek(graphDataOffset))
+      { return std::nullopt; }
+
+    return std::move(nodeLookup);
+  }
+
+  template<typename TNodeLookup>
+  bool Program::DeserializeGraph(BinaryReader& reader, const TNodeLookup& nodeLookup, Program& program)
+  {
     // Fill in the input side of connections
     for (const OutputProgramGraphNode& outputNode : program.m_outputNodes)
     {
       if (outputNode.Processor() == nullptr)
-        { return std::nullopt; }
+        { return false; }
 
       for (const IInputProgramGraphNode* inputNode : outputNode.Connections())
       {
         InputProgramGraphNode* typedInputNode = static_cast<InputProgramGraphNode*>(const_cast<IInputProgramGraphNode*>(inputNode));
         if (typedInputNode->Connection() != nullptr)
-          { return std::nullopt; }
+          { return false; }
         ProgramGraphNodeModifier::SetInputNodeConnection(typedInputNode, &outputNode);
       }
     }
@@ -529,12 +1146,12 @@ namespace Chord
     for (const InputProgramGraphNode& inputNode : program.m_inputNodes)
     {
       if (inputNode.Processor() == nullptr || inputNode.Connection() == nullptr)
-        { return std::nullopt; }
+        { return false; }
     }
 
     u8 hasInputChannelsFloat;
     if (!reader.Read(&hasInputChannelsFloat) || hasInputChannelsFloat > 1)
-      { return std::nullopt; }
+      { return false; }
     if (hasInputChannelsFloat != 0)
     {
       program.m_inputChannelsFloat = InitializeCapacity(usz(program.m_programVariantProperties.m_inputChannelCount));
@@ -542,15 +1159,15 @@ namespace Chord
       for (const GraphInputProgramGraphNode*& nodePointer : program.m_inputChannelsFloat)
       {
         u32 nodeIndex;
-        if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || nodeTypes[nodeIndex] != SerializedNodeType::GraphInput)
-          { return std::nullopt; }
-        nodePointer = static_cast<const GraphInputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
+        if (!reader.Read(&nodeIndex) || TryGetNode(nodeLookup, nodeIndex, SerializedNodeType::GraphInput) == nullptr)
+          { return false; }
+        nodePointer = static_cast<const GraphInputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
       }
     }
 
     u8 hasInputChannelsDouble;
     if (!reader.Read(&hasInputChannelsDouble) || hasInputChannelsDouble > 1)
-      { return std::nullopt; }
+      { return false; }
     if (hasInputChannelsDouble != 0)
     {
       program.m_inputChannelsDouble = InitializeCapacity(usz(program.m_programVariantProperties.m_inputChannelCount));
@@ -558,18 +1175,18 @@ namespace Chord
       for (const GraphInputProgramGraphNode*& nodePointer : program.m_inputChannelsDouble)
       {
         u32 nodeIndex;
-        if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || nodeTypes[nodeIndex] != SerializedNodeType::GraphInput)
-          { return std::nullopt; }
-        nodePointer = static_cast<const GraphInputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
+        if (!reader.Read(&nodeIndex) || TryGetNode(nodeLookup, nodeIndex, SerializedNodeType::GraphInput) == nullptr)
+          { return false; }
+        nodePointer = static_cast<const GraphInputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
       }
     }
 
     u8 outputChannelPrimitiveTypeU8;
     if (!reader.Read<u8>(&outputChannelPrimitiveTypeU8))
-      { return std::nullopt; }
+      { return false; }
 
     if (outputChannelPrimitiveTypeU8 != PrimitiveTypeFloat && outputChannelPrimitiveTypeU8 != PrimitiveTypeDouble)
-      { return std::nullopt; }
+      { return false; }
 
     program.m_programGraph.m_outputChannelPrimitiveType = PrimitiveType(outputChannelPrimitiveTypeU8);
 
@@ -578,36 +1195,36 @@ namespace Chord
     for (const GraphOutputProgramGraphNode*& nodePointer : program.m_outputChannels)
     {
       u32 nodeIndex;
-      if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || nodeTypes[nodeIndex] != SerializedNodeType::GraphOutput)
-        { return std::nullopt; }
-      nodePointer = static_cast<const GraphOutputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
+      if (!reader.Read(&nodeIndex) || TryGetNode(nodeLookup, nodeIndex, SerializedNodeType::GraphOutput) == nullptr)
+        { return false; }
+      nodePointer = static_cast<const GraphOutputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
     }
 
     u8 hasVoiceRemainActive;
     if (!reader.Read(&hasVoiceRemainActive) || hasVoiceRemainActive > 1)
-      { return std::nullopt; }
+      { return false; }
     if (hasVoiceRemainActive)
     {
       u32 nodeIndex;
-      if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || nodeTypes[nodeIndex] != SerializedNodeType::GraphOutput)
-        { return std::nullopt; }
-      program.m_programGraph.m_voiceRemainActive = static_cast<const GraphOutputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
+      if (!reader.Read(&nodeIndex) || TryGetNode(nodeLookup, nodeIndex, SerializedNodeType::GraphOutput) == nullptr)
+        { return false; }
+      program.m_programGraph.m_voiceRemainActive = static_cast<const GraphOutputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
     }
 
     u8 hasEffectRemainActive;
     if (!reader.Read(&hasEffectRemainActive) || hasEffectRemainActive > 1)
-      { return std::nullopt; }
+      { return false; }
     if (hasEffectRemainActive)
     {
       u32 nodeIndex;
-      if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || nodeTypes[nodeIndex] != SerializedNodeType::GraphOutput)
-        { return std::nullopt; }
-      program.m_programGraph.m_effectRemainActive = static_cast<const GraphOutputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
+      if (!reader.Read(&nodeIndex) || TryGetNode(nodeLookup, nodeIndex, SerializedNodeType::GraphOutput) == nullptr)
+        { return false; }
+      program.m_programGraph.m_effectRemainActive = static_cast<const GraphOutputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
     }
 
     u32 voiceToEffectCount;
     if (!reader.Read(&voiceToEffectCount))
-      { return std::nullopt; }
+      { return false; }
 
     program.m_voiceToEffectPrimitiveTypes = InitializeCapacity(voiceToEffectCount);
     program.m_programGraph.m_voiceToEffectPrimitiveTypes = program.m_voiceToEffectPrimitiveTypes;
@@ -615,13 +1232,13 @@ namespace Chord
     {
       u8 primitiveTypeU8;
       if (!reader.Read<u8>(&primitiveTypeU8))
-        { return std::nullopt; }
+        { return false; }
 
       if (primitiveTypeU8 != PrimitiveTypeFloat
         && primitiveTypeU8 != PrimitiveTypeDouble
         && primitiveTypeU8 != PrimitiveTypeInt
         && primitiveTypeU8 != PrimitiveTypeBool)
-        { return std::nullopt; }
+        { return false; }
 
       primitiveType = PrimitiveType(primitiveTypeU8);
     }
@@ -631,9 +1248,9 @@ namespace Chord
     for (const GraphOutputProgramGraphNode*& nodePointer : program.m_voiceToEffectOutputs)
     {
       u32 nodeIndex;
-      if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || nodeTypes[nodeIndex] != SerializedNodeType::GraphOutput)
-        { return std::nullopt; }
-      nodePointer = static_cast<const GraphOutputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
+      if (!reader.Read(&nodeIndex) || TryGetNode(nodeLookup, nodeIndex, SerializedNodeType::GraphOutput) == nullptr)
+        { return false; }
+      nodePointer = static_cast<const GraphOutputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
     }
 
     program.m_voiceToEffectInputs = InitializeCapacity(voiceToEffectCount);
@@ -641,63 +1258,316 @@ namespace Chord
     for (const GraphInputProgramGraphNode*& nodePointer : program.m_voiceToEffectInputs)
     {
       u32 nodeIndex;
-      if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || nodeTypes[nodeIndex] != SerializedNodeType::GraphInput)
-        { return std::nullopt; }
-      nodePointer = static_cast<const GraphInputProgramGraphNode*>(nodesFromIndices[nodeIndex]);
+      if (!reader.Read(&nodeIndex) || TryGetNode(nodeLookup, nodeIndex, SerializedNodeType::GraphInput) == nullptr)
+        { return false; }
+      nodePointer = static_cast<const GraphInputProgramGraphNode*>(nodeLookup.GetNode(nodeIndex));
     }
 
     u8 hasVoiceGraph;
     if (!reader.Read(&hasVoiceGraph) || hasVoiceGraph > 1)
-      { return std::nullopt; }
+      { return false; }
     if (hasVoiceGraph)
     {
       u32 voiceGraphCount;
       if (!reader.Read(&voiceGraphCount))
-        { return std::nullopt; }
+        { return false; }
       program.m_voiceGraph = InitializeCapacity(voiceGraphCount);
       program.m_programGraph.m_voiceGraph = program.m_voiceGraph;
       for (const IProcessorProgramGraphNode*& nodePointer : program.m_voiceGraph)
       {
         u32 nodeIndex;
-        if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || !TryGetProcessorNode(nodeIndex, &nodePointer))
-          { return std::nullopt; }
+        if (!reader.Read(&nodeIndex) || nodeIndex >= nodeLookup.NodeCount() || !TryGetProcessorNode(nodeLookup, nodeIndex, &nodePointer))
+          { return false; }
       }
     }
 
     u8 hasEffectGraph;
     if (!reader.Read(&hasEffectGraph) || hasEffectGraph > 1)
-      { return std::nullopt; }
+      { return false; }
     if (hasEffectGraph)
     {
       u32 effectGraphCount;
       if (!reader.Read(&effectGraphCount))
-        { return std::nullopt; }
+        { return false; }
       program.m_effectGraph = InitializeCapacity(effectGraphCount);
       program.m_programGraph.m_effectGraph = program.m_effectGraph;
       for (const IProcessorProgramGraphNode*& nodePointer : program.m_effectGraph)
       {
         u32 nodeIndex;
-        if (!reader.Read(&nodeIndex) || nodeIndex >= nodeCount || !TryGetProcessorNode(nodeIndex, &nodePointer))
-          { return std::nullopt; }
+        if (!reader.Read(&nodeIndex) || nodeIndex >= nodeLookup.NodeCount() || !TryGetProcessorNode(nodeLookup, nodeIndex, &nodePointer))
+          { return false; }
       }
     }
 
-    if (reader.GetOffset() != bytes.Count())
+    return true;
+  }
+
+  std::optional<FixedArray<u8, Sha256ByteCount>> Program::TryReadContentHash(Span<const u8> bytes)
+  {
+    BinaryReader reader(bytes, std::endian::little);
+
+    FixedArray<char, sizeof(Header)> header;
+    u32 version;
+    FixedArray<u8, Sha256ByteCount> contentHash;
+    if (!reader.Read(Span<char>(header))
+      || !reader.Read<u32>(&version)
+      || !reader.Read(Span<u8>(contentHash)))
+      { return std::nullopt; }
+
+    if (std::memcmp(header.Elements(), Header, sizeof(Header)) != 0)
       { return std::nullopt; }
 
-    // For simplicity, append the content bytes and the hash salt bytes together so we can do a non-incremental SHA256 hash in a single call
-    static constexpr usz HeaderByteCount = sizeof(Header) + sizeof(u32) + Sha256ByteCount;
-    usz contentByteCount = bytes.Count() - HeaderByteCount;
-    FixedArray<u8> hashInputBytes = InitializeCapacity(contentByteCount + sizeof(HashSalt));
-    Span<u8>(hashInputBytes, 0, contentByteCount).CopyElementsFrom(Span(bytes, HeaderByteCount, contentByteCount));
-    Span<u8>(hashInputBytes, contentByteCount, sizeof(HashSalt)).CopyElementsFrom(HashSalt);
-    auto computedContentHash = CalculateSha256(hashInputBytes);
+    if (version != NodeStreamVersion && version != NodeTableVersion)
+      { return std::nullopt; }
+
+    auto computedContentHash = CalculateContentHashInternal(bytes);
     if (std::memcmp(contentHash.Elements(), computedContentHash.Elements(), contentHash.Count()) != 0)
       { return std::nullopt; }
 
+    return contentHash;
+  }
+
+  std::optional<FixedArray<u8, Sha256ByteCount>> Program::TryReadStructureHash(Span<const u8> bytes)
+  {
+    auto recordOffsets = TryGetNodeRecordOffsets(bytes);
+    if (!recordOffsets.has_value())
+      { return std::nullopt; }
+
+    return CalculateStructureHashInternal(bytes, recordOffsets.value());
+  }
+
+  std::optional<Program> Program::DeserializeConstantVariant(std::shared_ptr<const Program> sharedGraph, Span<const u8> bytes)
+  {
+    ASSERT(!sharedGraph->m_isSimplified && sharedGraph->m_sharedGraph == nullptr);
+    if (!sharedGraph->m_structureHash.has_value())
+      { return std::nullopt; }
+
+    auto contentHash = TryReadContentHash(bytes);
+    auto recordOffsets = TryGetNodeRecordOffsets(bytes);
+    if (!contentHash.has_value() || !recordOffsets.has_value())
+      { return std::nullopt; }
+
+    // Node counts, connections, and everything else outside of the constant values are covered by the structure hash so the shared nodes match the bytes
+    auto structureHash = CalculateStructureHashInternal(bytes, recordOffsets.value());
+    if (std::memcmp(structureHash.Elements(), sharedGraph->m_structureHash->Elements(), structureHash.Count()) != 0)
+      { return std::nullopt; }
+
+    Program program;
+    if (!TryReadConstantValues<f32, f32>(
+        GetNodeRecordBytes(bytes, recordOffsets.value(), SerializedNodeType::FloatConstant),
+        program.m_floatConstantValues)
+      || !TryReadConstantValues<f64, f64>(
+        GetNodeRecordBytes(bytes, recordOffsets.value(), SerializedNodeType::DoubleConstant),
+        program.m_doubleConstantValues)
+      || !TryReadConstantValues<s32, s32>(
+        GetNodeRecordBytes(bytes, recordOffsets.value(), SerializedNodeType::IntConstant),
+        program.m_intConstantValues)
+      || !TryReadConstantValues<bool, u32>(
+        GetNodeRecordBytes(bytes, recordOffsets.value(), SerializedNodeType::BoolConstant),
+        program.m_boolConstantValues))
+      { return std::nullopt; }
+
+    ASSERT(program.m_floatConstantValues.Count() == sharedGraph->m_floatConstantNodes.Count());
+    ASSERT(program.m_doubleConstantValues.Count() == sharedGraph->m_doubleConstantNodes.Count());
+    ASSERT(program.m_intConstantValues.Count() == sharedGraph->m_intConstantNodes.Count());
+    ASSERT(program.m_boolConstantValues.Count() == sharedGraph->m_boolConstantNodes.Count());
+
+    program.m_contentHash = contentHash.value();
+    program.m_structureHash = structureHash;
+    program.m_nativeLibraryDependencies = sharedGraph->m_nativeLibraryDependencies;
+    program.m_programVariantProperties = sharedGraph->m_programVariantProperties;
+    program.m_instrumentProperties = sharedGraph->m_instrumentProperties;
+    program.m_programGraph = sharedGraph->m_programGraph;
+    program.m_sharedGraph = std::move(sharedGraph);
     return std::move(program);
   }
 
+  // Compares the records of a single constant node type and collects the indices and new values of the nodes whose values differ. Returns false if anything
+  // other than a value differs or if a new value is invalid.
+  template<typename TValue, typename TSerializedValue>
+  static bool FindChangedConstants(Span<const u8> baseRecordBytes, Span<const u8> targetRecordBytes, UnboundedArray<std::tuple<usz, TValue>>& changes)
+  {
+    static constexpr usz RecordByteCount = sizeof(u32) + sizeof(TSerializedValue);
+    ASSERT(baseRecordBytes.Count() % RecordByteCount == 0 && targetRecordBytes.Count() == baseRecordBytes.Count());
+
+    for (usz recordOffset = 0; recordOffset < baseRecordBytes.Count(); recordOffset += RecordByteCount)
+    {
+      // The output node index precedes the value
+      if (std::memcmp(baseRecordBytes.Elements() + recordOffset, targetRecordBytes.Elements() + recordOffset, sizeof(u32)) != 0)
+        { return false; }
+
+      usz valueOffset = recordOffset + sizeof(u32);
+      if (std::memcmp(baseRecordBytes.Elements() + valueOffset, targetRecordBytes.Elements() + valueOffset, sizeof(TSerializedValue)) == 0)
+        { continue; }
+
+      TSerializedValue value;
+      BinaryReader reader(Span(targetRecordBytes, valueOffset, sizeof(TSerializedValue)), std::endian::little);
+      bool readResult = reader.Read(&value);
+      ASSERT(readResult);
+
+      if constexpr (std::same_as<TValue, bool>)
+      {
+        if (value > 1)
+          { return false; }
+        changes.Append({ recordOffset / RecordByteCount, value != 0 });
+      }
+      else
+        { changes.Append({ recordOffset / RecordByteCount, value }); }
+    }
+
+    return true;
+  }
+
+  // Each change is written to the per-program value table if there is one and to the constant node otherwise
+  template<typename TValue, typename TNode>
+  static void CommitConstantChanges(
+    BoundedArray<TNode>& nodes,
+    FixedArray<TValue>& values,
+    bool sharesGraph,
+    const UnboundedArray<std::tuple<usz, TValue>>& changes)
+  {
+    for (auto [index, value] : changes)
+    {
+      if (sharesGraph)
+        { values[index] = value; }
+      else
+        { ProgramGraphNodeModifier::SetConstantNodeValue(&nodes[index], value); }
+    }
+  }
+
+  std::optional<Program::ConstantUpdate> Program::TryPrepareConstantUpdate(Span<const u8> baseBytes, Span<const u8> targetBytes) const
+  {
+    // Simplify() may have folded constants into the results of native module calls so changing them afterward would have no effect
+    if (m_isSimplified || baseBytes.Count() != targetBytes.Count())
+      { return std::nullopt; }
+
+    auto baseContentHash = TryReadContentHash(baseBytes);
+    auto targetContentHash = TryReadContentHash(targetBytes);
+    if (!baseContentHash.has_value()
+      || !targetContentHash.has_value()
+      || std::memcmp(baseContentHash->Elements(), m_contentHash.Elements(), m_contentHash.Count()) != 0)
+      { return std::nullopt; }
+
+    // Only version 1 programs store constants in fixed-size records whose locations can be computed without parsing the rest of the program
+    auto recordOffsetsResult = TryGetNodeRecordOffsets(baseBytes);
+    if (!recordOffsetsResult.has_value())
+      { return std::nullopt; }
+
+    const NodeRecordOffsets& recordOffsets = recordOffsetsResult.value();
+
+    // Numeric constant records are contiguous so everything before and after them must be unchanged
+    usz constantsStartOffset = recordOffsets[EnumValue(SerializedNodeType::FloatConstant)];
+    usz constantsEndOffset = recordOffsets[EnumValue(SerializedNodeType::BoolConstant) + 1];
+    if (std::memcmp(baseBytes.Elements() + HeaderByteCount, targetBytes.Elements() + HeaderByteCount, constantsStartOffset - HeaderByteCount) != 0
+      || std::memcmp(baseBytes.Elements() + constantsEndOffset, targetBytes.Elements() + constantsEndOffset, baseBytes.Count() - constantsEndOffset) != 0)
+      { return std::nullopt; }
+
+    auto GetRecordBytes =
+      [&](Span<const u8> bytes, SerializedNodeType nodeType)
+        { return GetNodeRecordBytes(bytes, recordOffsets, nodeType); };
+
+    ConstantUpdate update;
+    update.m_baseContentHash = baseContentHash.value();
+    update.m_targetContentHash = targetContentHash.value();
+    if (!FindChangedConstants<f32, f32>(
+        GetRecordBytes(baseBytes, SerializedNodeType::FloatConstant),
+        GetRecordBytes(targetBytes, SerializedNodeType::FloatConstant),
+        update.m_floatChanges)
+      || !FindChangedConstants<f64, f64>(
+        GetRecordBytes(baseBytes, SerializedNodeType::DoubleConstant),
+        GetRecordBytes(targetBytes, SerializedNodeType::DoubleConstant),
+        update.m_doubleChanges)
+      || !FindChangedConstants<s32, s32>(
+        GetRecordBytes(baseBytes, SerializedNodeType::IntConstant),
+        GetRecordBytes(targetBytes, SerializedNodeType::IntConstant),
+        update.m_intChanges)
+      || !FindChangedConstants<bool, u32>(
+        GetRecordBytes(baseBytes, SerializedNodeType::BoolConstant),
+        GetRecordBytes(targetBytes, SerializedNodeType::BoolConstant),
+        update.m_boolChanges))
+      { return std::nullopt; }
+
+    // The base bytes match this program's content hash so the records line up with the constant nodes, which belong to the shared program if there is one
+    const Program* graphProgram = m_sharedGraph != nullptr ? m_sharedGraph.get() : this;
+    auto AppendChangedNodes =
+      [&](const auto& nodes, const auto& changes)
+      {
+        for (const auto& change : changes)
+          { update.m_changedNodes.Append(&nodes[std::get<0>(change)]); }
+      };
+
+    AppendChangedNodes(graphProgram->m_floatConstantNodes, update.m_floatChanges);
+    AppendChangedNodes(graphProgram->m_doubleConstantNodes, update.m_doubleChanges);
+    AppendChangedNodes(graphProgram->m_intConstantNodes, update.m_intChanges);
+    AppendChangedNodes(graphProgram->m_boolConstantNodes, update.m_boolChanges);
+
+    return update;
+  }
+
+  void Program::CommitConstantUpdate(const ConstantUpdate& update)
+  {
+    ASSERT(
+      std::memcmp(update.m_baseContentHash.Elements(), m_contentHash.Elements(), m_contentHash.Count()) == 0,
+      "The update was prepared for a different program");
+
+    bool sharesGraph = m_sharedGraph != nullptr;
+    CommitConstantChanges(m_floatConstantNodes, m_floatConstantValues, sharesGraph, update.m_floatChanges);
+    CommitConstantChanges(m_doubleConstantNodes, m_doubleConstantValues, sharesGraph, update.m_doubleChanges);
+    CommitConstantChanges(m_intConstantNodes, m_intConstantValues, sharesGraph, update.m_intChanges);
+    CommitConstantChanges(m_boolConstantNodes, m_boolConstantValues, sharesGraph, update.m_boolChanges);
+    m_contentHash = update.m_targetContentHash;
+  }
+
+  f32 Program::ConstantValue(const FloatConstantProgramGraphNode* node) const
+  {
+    return m_sharedGraph == nullptr
+      ? node->Value()
+      : m_floatConstantValues[GetNodeIndex(m_sharedGraph->m_floatConstantNodes, node)];
+  }
+
+  f64 Program::ConstantValue(const DoubleConstantProgramGraphNode* node) const
+  {
+    return m_sharedGraph == nullptr
+      ? node->Value()
+      : m_doubleConstantValues[GetNodeIndex(m_sharedGraph->m_doubleConstantNodes, node)];
+  }
+
+  s32 Program::ConstantValue(const IntConstantProgramGraphNode* node) const
+  {
+    return m_sharedGraph == nullptr
+      ? node->Value()
+      : m_intConstantValues[GetNodeIndex(m_sharedGraph->m_intConstantNodes, node)];
+  }
+
+  bool Program::ConstantValue(const BoolConstantProgramGraphNode* node) const
+  {
+    return m_sharedGraph == nullptr
+      ? node->Value()
+      : m_boolConstantValues[GetNodeIndex(m_sharedGraph->m_boolConstantNodes, node)];
+  }
+
+  usz Program::NodeCount() const
+  {
+    if (m_sharedGraph != nullptr)
+      { return m_sharedGraph->NodeCount(); }
+
+    return m_inputNodes.Count()
+      + m_outputNodes.Count()
+      + m_floatConstantNodes.Count()
+      + m_doubleConstantNodes.Count()
+      + m_intConstantNodes.Count()
+      + m_boolConstantNodes.Count()
+      + m_stringConstantNodes.Count()
+      + m_arrayNodes.Count()
+      + m_nativeModuleCallNodes.Count()
+      + m_graphInputNodes.Count()
+      + m_graphOutputNodes.Count()
+      + m_foldedFloatConstantNodes.Count()
+      + m_foldedDoubleConstantNodes.Count()
+      + m_foldedIntConstantNodes.Count()
+      + m_foldedBoolConstantNodes.Count();
+  }
+
   bool Program::Validate(NativeLibraryRegistry* nativeLibraryRegistry) const
   {
     for (const NativeLibraryDependency& nativeLibraryDependency : m_nativeLibraryDependencies)
@@ -25,12 +25,56 @@ namespace Chord
         u32 m_patchVersion = 0;
       };
 
+      struct SimplificationResult
+      {
+        // Native module calls which were invoked once at load time and replaced with constants
+        usz m_foldedNativeModuleCallCount = 0;
+
+        // The reduction in the number of tasks and task output buffers instantiated for each voice or effect stage, including folded native module calls
+        usz m_removedTaskCount = 0;
+        usz m_removedBufferCount = 0;
+
+        // Input channel nodes (of either primitive type) which are no longer read by any stage and therefore no longer need input buffers
+        usz m_removedInputChannelCount = 0;
+      };
+
+      // A set of constant value changes returned by TryPrepareConstantUpdate() which hasn't been applied to the program yet
+      class ConstantUpdate
+      {
+      public:
+        // The constant nodes whose values change
+        Span<const IProcessorProgramGraphNode*> ChangedNodes() const
+          { return m_changedNodes; }
+
+      private:
+        friend class Program;
+
+        FixedArray<u8, Sha256ByteCount> m_baseContentHash;
+        FixedArray<u8, Sha256ByteCount> m_targetContentHash;
+        UnboundedArray<const IProcessorProgramGraphNode*> m_changedNodes;
+
+        // Each change holds the index of the changed node within its constant node type and the new value
+        UnboundedArray<std::tuple<usz, f32>> m_floatChanges;
+        UnboundedArray<std::tuple<usz, f64>> m_doubleChanges;
+        UnboundedArray<std::tuple<usz, s32>> m_intChanges;
+        UnboundedArray<std::tuple<usz, bool>> m_boolChanges;
+      };
+
       Program(const Program&) = delete;
       Program& operator=(const Program&) = delete;
 
       Program(Program&& other) noexcept
-        : m_nativeLibraryDependencies(std::exchange(other.m_nativeLibraryDependencies, {}))
+        : m_contentHash(other.m_contentHash)
+        , m_structureHash(std::exchange(other.m_structureHash, std::nullopt))
+        , m_sharedGraph(std::exchange(other.m_sharedGraph, nullptr))
+        , m_floatConstantValues(std::exchange(other.m_floatConstantValues, {}))
+        , m_doubleConstantValues(std::exchange(other.m_doubleConstantValues, {}))
+        , m_intConstantValues(std::exchange(other.m_intConstantValues, {}))
+        , m_boolConstantValues(std::exchange(other.m_boolConstantValues, {}))
+        , m_nativeLibraryDependencies(std::exchange(other.m_nativeLibraryDependencies, {}))
+        , m_stringPool(std::exchange(other.m_stringPool, {}))
         , m_programVariantProperties(std::exchange(other.m_programVariantProperties, {}))
+        , m_instrumentProperties(std::exchange(other.m_instrumentProperties, {}))
         , m_programGraph(std::exchange(other.m_programGraph, {}))
         , m_inputNodes(std::exchange(other.m_inputNodes, {}))
         , m_outputNodes(std::exchange(other.m_outputNodes, {}))
@@ -43,19 +87,34 @@ namespace Chord
         , m_nativeModuleCallNodes(std::exchange(other.m_nativeModuleCallNodes, {}))
         , m_graphInputNodes(std::exchange(other.m_graphInputNodes, {}))
         , m_graphOutputNodes(std::exchange(other.m_graphOutputNodes, {}))
+        , m_foldedFloatConstantNodes(std::exchange(other.m_foldedFloatConstantNodes, {}))
+        , m_foldedDoubleConstantNodes(std::exchange(other.m_foldedDoubleConstantNodes, {}))
+        , m_foldedIntConstantNodes(std::exchange(other.m_foldedIntConstantNodes, {}))
+        , m_foldedBoolConstantNodes(std::exchange(other.m_foldedBoolConstantNodes, {}))
         , m_inputChannelsFloat(std::exchange(other.m_inputChannelsFloat, {}))
         , m_inputChannelsDouble(std::exchange(other.m_inputChannelsDouble, {}))
         , m_outputChannels(std::exchange(other.m_outputChannels, {}))
+        , m_voiceToEffectPrimitiveTypes(std::exchange(other.m_voiceToEffectPrimitiveTypes, {}))
         , m_voiceToEffectOutputs(std::exchange(other.m_voiceToEffectOutputs, {}))
         , m_voiceToEffectInputs(std::exchange(other.m_voiceToEffectInputs, {}))
         , m_voiceGraph(std::exchange(other.m_voiceGraph, {}))
         , m_effectGraph(std::exchange(other.m_effectGraph, {}))
+        , m_isSimplified(std::exchange(other.m_isSimplified, false))
         { }
 
       Program& operator=(Program&& other) noexcept
       {
+        m_contentHash = other.m_contentHash;
+        m_structureHash = std::exchange(other.m_structureHash, std::nullopt);
+        m_sharedGraph = std::exchange(other.m_sharedGraph, nullptr);
+        m_floatConstantValues = std::exchange(other.m_floatConstantValues, {});
+        m_doubleConstantValues = std::exchange(other.m_doubleConstantValues, {});
+        m_intConstantValues = std::exchange(other.m_intConstantValues, {});
+        m_boolConstantValues = std::exchange(other.m_boolConstantValues, {});
         m_nativeLibraryDependencies = std::exchange(other.m_nativeLibraryDependencies, {});
+        m_stringPool = std::exchange(other.m_stringPool, {});
         m_programVariantProperties = std::exchange(other.m_programVariantProperties, {});
+        m_instrumentProperties = std::exchange(other.m_instrumentProperties, {});
         m_programGraph = std::exchange(other.m_programGraph, {});
         m_inputNodes = std::exchange(other.m_inputNodes, {});
         m_outputNodes = std::exchange(other.m_outputNodes, {});
@@ -68,21 +127,74 @@ namespace Chord
         m_nativeModuleCallNodes = std::exchange(other.m_nativeModuleCallNodes, {});
         m_graphInputNodes = std::exchange(other.m_graphInputNodes, {});
         m_graphOutputNodes = std::exchange(other.m_graphOutputNodes, {});
+        m_foldedFloatConstantNodes = std::exchange(other.m_foldedFloatConstantNodes, {});
+        m_foldedDoubleConstantNodes = std::exchange(other.m_foldedDoubleConstantNodes, {});
+        m_foldedIntConstantNodes = std::exchange(other.m_foldedIntConstantNodes, {});
+        m_foldedBoolConstantNodes = std::exchange(other.m_foldedBoolConstantNodes, {});
         m_inputChannelsFloat = std::exchange(other.m_inputChannelsFloat, {});
         m_inputChannelsDouble = std::exchange(other.m_inputChannelsDouble, {});
         m_outputChannels = std::exchange(other.m_outputChannels, {});
+        m_voiceToEffectPrimitiveTypes = std::exchange(other.m_voiceToEffectPrimitiveTypes, {});
         m_voiceToEffectOutputs = std::exchange(other.m_voiceToEffectOutputs, {});
         m_voiceToEffectInputs = std::exchange(other.m_voiceToEffectInputs, {});
         m_voiceGraph = std::exchange(other.m_voiceGraph, {});
         m_effectGraph = std::exchange(other.m_effectGraph, {});
+        m_isSimplified = std::exchange(other.m_isSimplified, false);
         return *this;
       }
 
       static std::optional<Program> Deserialize(Span<const u8> bytes);
 
+      // Like Deserialize but data which can be used directly from the serialized bytes (currently string constants in version 1 programs) is referenced
+      // rather than copied. This is intended for memory-mapped program files, which must remain mapped for the lifetime of the returned program.
+      static std::optional<Program> DeserializeInPlace(Span<const u8> bytes);
+
+      // Verifies the header and content hash of a serialized program without deserializing it and returns the content hash. This allows callers which cache
+      // programs to detect duplicates before paying for deserialization.
+      static std::optional<FixedArray<u8, Sha256ByteCount>> TryReadContentHash(Span<const u8> bytes);
+
+      // Returns a hash of everything in a serialized version 1 program except for the values of float, double, int, and bool constants, or nullopt for
+      // version 0 programs. Programs with the same structure hash can share graph nodes through DeserializeConstantVariant(). The content hash is not verified.
+      static std::optional<FixedArray<u8, Sha256ByteCount>> TryReadStructureHash(Span<const u8> bytes);
+
+      // Deserializes a program which differs from sharedGraph only in the values of float, double, int, and bool constants. The returned program references
+      // sharedGraph's nodes and only holds its own constant values, which must be read through ConstantValue(). sharedGraph must be an unsimplified version 1
+      // program which was deserialized normally and it must not be modified while the returned program exists. Returns nullopt if the bytes are invalid or if
+      // their structure hash doesn't match sharedGraph.
+      static std::optional<Program> DeserializeConstantVariant(std::shared_ptr<const Program> sharedGraph, Span<const u8> bytes);
+
+      // Encodes a serialized program as a compact binary patch against another serialized program. This is a generic byte diff for transferring or
+      // storing program revisions; it doesn't describe node or connection changes and structural changes can't be applied to a live program or processor.
+      // The patch is tied to the base program's content hash so it can only be applied to the program it was created from. Returns nullopt if either
+      // program is invalid.
+      static std::optional<UnboundedArray<u8>> CreatePatch(Span<const u8> baseBytes, Span<const u8> targetBytes);
+
+      // Rebuilds the target program's serialized bytes from the base program's bytes and a patch returned by CreatePatch(). Returns nullopt if the patch was
+      // created against a different base program or if the result doesn't match the target program's content hash.
+      static std::optional<UnboundedArray<u8>> ApplyPatch(Span<const u8> baseBytes, Span<const u8> patchBytes);
+
+      // If this program was deserialized from baseBytes and targetBytes only change the values of float, double, int, or bool constants, returns the changes
+      // without modifying anything. Otherwise (including for any structural change), the target must be loaded as a new program. This is only supported for
+      // unsimplified version 1 programs. The intended sequence is to check every processor built from this program with
+      // ProgramProcessor::CanUpdateConstants(), then call CommitConstantUpdate(), then call ProgramProcessor::UpdateConstants() on every processor, so that a
+      // rejected update leaves both untouched.
+      std::optional<ConstantUpdate> TryPrepareConstantUpdate(Span<const u8> baseBytes, Span<const u8> targetBytes) const;
+
+      // Applies an update returned by TryPrepareConstantUpdate(), after which this program is equivalent to one deserialized from the target bytes. This must
+      // not be called while a processor built from this program is processing.
+      void CommitConstantUpdate(const ConstantUpdate& update);
+
       // Returns whether all required native libraries are present
       bool Validate(NativeLibraryRegistry* nativeLibraryRegistry) const;
 
+      // Simplifies the graph against the loaded native libraries. Native module calls whose inputs are all constant are invoked once and replaced with
+      // constants (following the same rules the compiler uses for constant-folding) and nodes whose results never reach a graph output are disconnected so
+      // that they are never instantiated. This can only be called once, after validation and before any ProgramProcessor is constructed from this program.
+      SimplificationResult Simplify(NativeLibraryRegistry* nativeLibraryRegistry);
+
+      // The SHA-256 hash of the serialized program content, which identifies the program independently of where it was loaded from
+      Span<const u8> ContentHash() const
+        { return m_contentHash; }
       Span<const NativeLibraryDependency> NativeLibraryDependencies() const
         { return m_nativeLibraryDependencies; }
       const ProgramVariantProperties& ProgramVariantProperties() const
@@ -91,11 +203,65 @@ namespace Chord
         { return m_instrumentProperties; }
       const ProgramGraph& ProgramGraph() const
         { return m_programGraph; }
+      bool IsSimplified() const
+        { return m_isSimplified; }
+
+      // Whether this program was created by DeserializeConstantVariant() and references another program's graph nodes
+      bool SharesGraph() const
+        { return m_sharedGraph != nullptr; }
+
+      // The value of a numeric constant node in this program. Processors must read constants through these rather than from the nodes themselves because
+      // programs which share a graph share its constant nodes but not their values.
+      f32 ConstantValue(const FloatConstantProgramGraphNode* node) const;
+      f64 ConstantValue(const DoubleConstantProgramGraphNode* node) const;
+      s32 ConstantValue(const IntConstantProgramGraphNode* node) const;
+      bool ConstantValue(const BoolConstantProgramGraphNode* node) const;
+
+      // The total number of graph nodes owned by this program (or by the program whose graph it shares), including nodes which Simplify() has disconnected
+      usz NodeCount() const;
+
+      // The number of bytes of constant values held by this program if it shares its graph
+      usz ConstantValueByteCount() const
+      {
+        return m_floatConstantValues.Count() * sizeof(f32)
+          + m_doubleConstantValues.Count() * sizeof(f64)
+          + m_intConstantValues.Count() * sizeof(s32)
+          + m_boolConstantValues.Count() * sizeof(bool);
+      }
 
     private:
       Program() = default;
 
+      // Resolve serialized node indices for version 0 (node stream) and version 1 (node table) programs
+      class NodeStreamLookup;
+      class NodeTableLookup;
+
+      // DeserializeInternal() reads the header, native library dependencies, and properties shared by both versions, then hands off to the version's node
+      // reader. DeserializeGraph() reads the graph data which follows the nodes in both versions.
+      static std::optional<Program> DeserializeInternal(Span<const u8> bytes, bool referenceBytes);
+      static std::optional<NodeStreamLookup> DeserializeNodeStream(BinaryReader& reader, Program& program);
+      static std::optional<NodeTableLookup> DeserializeNodeTable(BinaryReader& reader, Span<const u8> bytes, bool referenceBytes, Program& program);
+
+      template<typename TNodeLookup>
+      static bool DeserializeGraph(BinaryReader& reader, const TNodeLookup& nodeLookup, Program& program);
+
+      FixedArray<u8, Sha256ByteCount> m_contentHash;
+
+      // This is only computed for version 1 programs
+      std::optional<FixedArray<u8, Sha256ByteCount>> m_structureHash;
+
+      // Set by DeserializeConstantVariant(). The graph below (but none of the node arrays) is copied from the shared program and numeric constant values are
+      // indexed in the same order as the shared program's constant nodes.
+      std::shared_ptr<const Program> m_sharedGraph;
+      FixedArray<f32> m_floatConstantValues;
+      FixedArray<f64> m_doubleConstantValues;
+      FixedArray<s32> m_intConstantValues;
+      FixedArray<bool> m_boolConstantValues;
+
       FixedArray<NativeLibraryDependency> m_nativeLibraryDependencies;
+
+      // Holds version 1 string constants unless they reference the serialized bytes directly
+      FixedArray<char32_t> m_stringPool;
       Chord::ProgramVariantProperties m_programVariantProperties;
       Chord::InstrumentProperties m_instrumentProperties;
       Chord::ProgramGraph m_programGraph;
@@ -112,6 +278,12 @@ namespace Chord
       BoundedArray<GraphInputProgramGraphNode> m_graphInputNodes;
       BoundedArray<GraphOutputProgramGraphNode> m_graphOutputNodes;
 
+      // Constants produced by Simplify() to replace the outputs of folded native module calls
+      BoundedArray<FloatConstantProgramGraphNode> m_foldedFloatConstantNodes;
+      BoundedArray<DoubleConstantProgramGraphNode> m_foldedDoubleConstantNodes;
+      BoundedArray<IntConstantProgramGraphNode> m_foldedIntConstantNodes;
+      BoundedArray<BoolConstantProgramGraphNode> m_foldedBoolConstantNodes;
+
       FixedArray<const GraphInputProgramGraphNode*> m_inputChannelsFloat;
       FixedArray<const GraphInputProgramGraphNode*> m_inputChannelsDouble;
       FixedArray<const GraphOutputProgramGraphNode*> m_outputChannels;
@@ -120,6 +292,8 @@ namespace Chord
       FixedArray<const GraphInputProgramGraphNode*> m_voiceToEffectInputs;
       FixedArray<const IProcessorProgramGraphNode*> m_voiceGraph;
       FixedArray<const IProcessorProgramGraphNode*> m_effectGraph;
+
+      bool m_isSimplified = false;
     };
   }
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 export module Chord.Engine:Program.ProgramGraphNodes.ProgramGraphNodeModifier;
 
+import std;
 
 import Chord.Foundation;
 import :Program.ProgramGraphNodes.ArrayProgramGraphNode;
@@ -31,6 +32,8 @@ namespace Chord
         { outputNode->m_processor = processorNode; }
       static void SetOutputNodeConnection(OutputProgramGraphNode* outputNode, usz index, const IInputProgramGraphNode* inputNode)
         { outputNode->m_connections[index] = inputNode; }
+      static void SetOutputNodeConnections(OutputProgramGraphNode* outputNode, FixedArray<const IInputProgramGraphNode*>&& inputNodes)
+        { outputNode->m_connections = std::move(inputNodes); }
 
       static void SetConstantNodeOutput(FloatConstantProgramGraphNode* constantNode, const IOutputProgramGraphNode* outputNode)
         { constantNode->m_output = outputNode; }
@@ -43,6 +46,15 @@ namespace Chord
       static void SetConstantNodeOutput(StringConstantProgramGraphNode* constantNode, const IOutputProgramGraphNode* outputNode)
         { constantNode->m_output = outputNode; }
 
+      static void SetConstantNodeValue(FloatConstantProgramGraphNode* constantNode, f32 value)
+        { constantNode->m_value = value; }
+      static void SetConstantNodeValue(DoubleConstantProgramGraphNode* constantNode, f64 value)
+        { constantNode->m_value = value; }
+      static void SetConstantNodeValue(IntConstantProgramGraphNode* constantNode, s32 value)
+        { constantNode->m_value = value; }
+      static void SetConstantNodeValue(BoolConstantProgramGraphNode* constantNode, bool value)
+        { constantNode->m_value = value; }
+
       static void SetArrayNodeElement(ArrayProgramGraphNode* arrayNode, usz index, const IInputProgramGraphNode* inputNode)
         { arrayNode->m_elements[index] = inputNode; }
       static void SetArrayNodeOutput(ArrayProgramGraphNode* arrayNode, const IOutputProgramGraphNode* outputNode)
@@ -0,0 +1,213 @@
+module Chord.Engine;
+
+import std;
+
+import Chord.Foundation;
+
+namespace Chord
+{
+  // A patch is a generic binary diff which rebuilds the target program's serialized bytes from a sequence of operations which either copy a range of the
+  // base program's bytes or insert bytes stored in the patch itself. It carries no typed node operations: structural changes (added or removed nodes and
+  // rewired connections) are encoded as byte edits to the node table and constant changes as small inserts between long copies. Applying a patch only
+  // produces bytes, which are then loaded as a new program or passed to Program::TryPrepareConstantUpdate():
+  // - Header, version, base content hash, target content hash, target byte count (u64), operation count (u32)
+  // - Copy: operation type (u8), base offset (u64), byte count (u64)
+  // - Insert: operation type (u8), byte count (u64), bytes
+  static constexpr char PatchHeader[] = { 'C', 'H', 'O', 'R', 'D', 'P', 'A', 'T', 'C', 'H' };
+  static constexpr u32 PatchVersion = 0;
+
+  enum class PatchOperationType : u8
+  {
+    Copy,
+    Insert,
+  };
+
+  // Matches are found by indexing the base program in blocks of this size. Version 1 node records are 4-byte aligned and at least 4 bytes long so a
+  // constant change only breaks the blocks which overlap it.
+  static constexpr usz PatchBlockByteCount = 16;
+
+  using PatchBlock = std::tuple<u64, u64>;
+
+  static PatchBlock ReadPatchBlock(Span<const u8> bytes, usz offset)
+  {
+    u64 low;
+    u64 high;
+    std::memcpy(&low, bytes.Elements() + offset, sizeof(low));
+    std::memcpy(&high, bytes.Elements() + offset + sizeof(low), sizeof(high));
+    return { low, high };
+  }
+
+  std::optional<UnboundedArray<u8>> Program::CreatePatch(Span<const u8> baseBytes, Span<const u8> targetBytes)
+  {
+    auto baseContentHash = TryReadContentHash(baseBytes);
+    auto targetContentHash = TryReadContentHash(targetBytes);
+    if (!baseContentHash.has_value() || !targetContentHash.has_value())
+      { return std::nullopt; }
+
+    struct PatchOperation
+    {
+      PatchOperationType m_type = PatchOperationType::Copy;
+
+      // Copy operations reference the base bytes and insert operations reference the target bytes
+      usz m_offset = 0;
+      usz m_count = 0;
+    };
+
+    // When several blocks have the same content, the first one is used
+    HashMap<PatchBlock, usz> baseBlockOffsets = InitializeCapacity(baseBytes.Count() / PatchBlockByteCount);
+    for (usz baseOffset = 0; baseOffset + PatchBlockByteCount <= baseBytes.Count(); baseOffset += PatchBlockByteCount)
+    {
+      PatchBlock block = ReadPatchBlock(baseBytes, baseOffset);
+      if (!baseBlockOffsets.ContainsKey(block))
+        { baseBlockOffsets.Insert(block, baseOffset); }
+    }
+
+    // Every target offset is checked against the base blocks. Matches are extended backward over unmatched bytes and forward as far as possible so that
+    // copies aren't limited to block boundaries.
+    UnboundedArray<PatchOperation> operations;
+    usz targetOffset = 0;
+    usz insertStartOffset = 0;
+    while (targetOffset + PatchBlockByteCount <= targetBytes.Count())
+    {
+      const usz* matchingBaseOffset = baseBlockOffsets.TryGet(ReadPatchBlock(targetBytes, targetOffset));
+      if (matchingBaseOffset == nullptr)
+      {
+        targetOffset++;
+        continue;
+      }
+
+      usz baseOffset = *matchingBaseOffset;
+      while (targetOffset > insertStartOffset && baseOffset > 0 && baseBytes[baseOffset - 1] == targetBytes[targetOffset - 1])
+      {
+        baseOffset--;
+        targetOffset--;
+      }
+
+      usz matchCount = 0;
+      while (baseOffset + matchCount < baseBytes.Count()
+        && targetOffset + matchCount < targetBytes.Count()
+        && baseBytes[baseOffset + matchCount] == targetBytes[targetOffset + matchCount])
+        { matchCount++; }
+
+      if (targetOffset > insertStartOffset)
+        { operations.Append({ .m_type = PatchOperationType::Insert, .m_offset = insertStartOffset, .m_count = targetOffset - insertStartOffset }); }
+      operations.Append({ .m_type = PatchOperationType::Copy, .m_offset = baseOffset, .m_count = matchCount });
+
+      targetOffset += matchCount;
+      insertStartOffset = targetOffset;
+    }
+
+    if (targetBytes.Count() > insertStartOffset)
+      { operations.Append({ .m_type = PatchOperationType::Insert, .m_offset = insertStartOffset, .m_count = targetBytes.Count() - insertStartOffset }); }
+
+    UnboundedArray<u8> bytes;
+    auto Write =
+      [&](auto value)
+        { bytes.AppendMultiple(Span(reinterpret_cast<const u8*>(&value), sizeof(value))); };
+
+    bytes.AppendMultiple(Span(reinterpret_cast<const u8*>(PatchHeader), sizeof(PatchHeader)));
+    Write(PatchVersion);
+    bytes.AppendMultiple(Span<const u8>(baseContentHash.value()));
+    bytes.AppendMultiple(Span<const u8>(targetContentHash.value()));
+    Write(u64(targetBytes.Count()));
+    Write(u32(operations.Count()));
+    for (const PatchOperation& operation : operations)
+    {
+      Write(u8(operation.m_type));
+      if (operation.m_type == PatchOperationType::Copy)
+      {
+        Write(u64(operation.m_offset));
+        Write(u64(operation.m_count));
+      }
+      else
+      {
+        Write(u64(operation.m_count));
+        bytes.AppendMultiple(Span(targetBytes, operation.m_offset, operation.m_count));
+      }
+    }
+
+    return bytes;
+  }
+
+  std::optional<UnboundedArray<u8>> Program::ApplyPatch(Span<const u8> baseBytes, Span<const u8> patchBytes)
+  {
+    BinaryReader reader(patchBytes, std::endian::little);
+
+    FixedArray<char, sizeof(PatchHeader)> header;
+    u32 version;
+    FixedArray<u8, Sha256ByteCount> baseContentHash;
+    FixedArray<u8, Sha256ByteCount> targetContentHash;
+    u64 targetByteCount;
+    u32 operationCount;
+    if (!reader.Read(Span<char>(header))
+      || !reader.Read(&version)
+      || !reader.Read(Span<u8>(baseContentHash))
+      || !reader.Read(Span<u8>(targetContentHash))
+      || !reader.Read(&targetByteCount)
+      || !reader.Read(&operationCount))
+      { return std::nullopt; }
+
+    if (std::memcmp(header.Elements(), PatchHeader, sizeof(PatchHeader)) != 0 || version != PatchVersion)
+      { return std::nullopt; }
+
+    // A patch can only be applied to the program it was created from
+    auto actualBaseContentHash = TryReadContentHash(baseBytes);
+    if (!actualBaseContentHash.has_value() || std::memcmp(actualBaseContentHash->Elements(), baseContentHash.Elements(), baseContentHash.Count()) != 0)
+      { return std::nullopt; }
+
+    // The target byte count is untrusted so only reserve as much memory as the operations could produce without repeating base bytes
+    UnboundedArray<u8> bytes = InitializeCapacity(usz(Min(targetByteCount, u64(baseBytes.Count() + patchBytes.Count()))));
+    for (u32 operationIndex = 0; operationIndex < operationCount; operationIndex++)
+    {
+      u8 operationType;
+      if (!reader.Read(&operationType))
+        { return std::nullopt; }
+
+      u64 remainingTargetByteCount = targetByteCount - bytes.Count();
+      switch (PatchOperationType(operationType))
+      {
+      case PatchOperationType::Copy:
+        {
+          u64 baseOffset;
+          u64 count;
+          if (!reader.Read(&baseOffset)
+            || !reader.Read(&count)
+            || baseOffset > baseBytes.Count()
+            || count > baseBytes.Count() - baseOffset
+            || count > remainingTargetByteCount)
+            { return std::nullopt; }
+
+          bytes.AppendMultiple(Span(baseBytes, usz(baseOffset), usz(count)));
+          break;
+        }
+
+      case PatchOperationType::Insert:
+        {
+          u64 count;
+          if (!reader.Read(&count)
+            || count > patchBytes.Count() - reader.GetOffset()
+            || count > remainingTargetByteCount)
+            { return std::nullopt; }
+
+          bytes.AppendMultiple(Span(patchBytes, reader.GetOffset(), usz(count)));
+          reader.Seek(reader.GetOffset() + usz(count));
+          break;
+        }
+
+      default:
+        return std::nullopt;
+      }
+    }
+
+    if (reader.GetOffset() != patchBytes.Count() || bytes.Count() != targetByteCount)
+      { return std::nullopt; }
+
+    // The result must be exactly the program the patch was created for
+    auto actualTargetContentHash = TryReadContentHash(bytes);
+    if (!actualTargetContentHash.has_value()
+      || std::memcmp(actualTargetContentHash->Elements(), targetContentHash.Elements(), targetContentHash.Count()) != 0)
+      { return std::nullopt; }
+
+    return bytes;
+  }
+}
\ No newline at end of file
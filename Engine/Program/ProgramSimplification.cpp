@@ -0,0 +1,653 @@
+module;
+
+#include "../../NativeLibraryApi/ChordNativeLibraryApi.h"
+
+module Chord.Engine;
+
+import std;
+
+import Chord.Foundation;
+import :ProgramProcessing.BufferMemory;
+import :ProgramProcessing.ConstantManager;
+import :ProgramProcessing.ProgramGraphUtilities;
+
+namespace Chord
+{
+  using FoldedConstant = std::variant<f32, f64, s32, bool>;
+
+  static const NativeModule* FindNativeModule(const NativeLibraryRegistry* nativeLibraryRegistry, const NativeModuleCallProgramGraphNode* node)
+  {
+    // The program should have been validated before being simplified so these can be asserts
+    auto nativeLibraryAndContext = nativeLibraryRegistry->TryGetNativeLibraryAndContext(node->NativeLibraryId());
+    ASSERT(nativeLibraryAndContext.has_value(), "Native library not found");
+    const NativeLibrary* nativeLibrary = std::get<0>(nativeLibraryAndContext.value());
+    for (usz nativeModuleIndex = 0; nativeModuleIndex < nativeLibrary->m_nativeModuleCount; nativeModuleIndex++)
+    {
+      if (Guid::FromBytes(nativeLibrary->m_nativeModules[nativeModuleIndex]->m_id) == node->NativeModuleId())
+        { return nativeLibrary->m_nativeModules[nativeModuleIndex]; }
+    }
+
+    ASSERT(false, "Native module not found");
+    return nullptr;
+  }
+
+  // These are the same conditions under which the compiler invokes a native module. Only outputs which can exist at runtime (non-array, non-string buffers)
+  // are supported.
+  static bool CanFoldNativeModule(const NativeModule* nativeModule)
+  {
+    if (nativeModule->m_alwaysRuntime || nativeModule->m_hasSideEffects)
+      { return false; }
+
+    for (usz parameterIndex = 0; parameterIndex < nativeModule->m_signature.m_parameterCount; parameterIndex++)
+    {
+      const NativeModuleParameter& parameter = nativeModule->m_signature.m_parameters[parameterIndex];
+      if (parameter.m_dataType.m_runtimeMutability == RuntimeMutabilityVariable)
+        { return false; }
+
+      if (parameter.m_direction == ModuleParameterDirectionOut
+        && (parameter.m_dataType.m_isArray || parameter.m_dataType.m_primitiveType == PrimitiveTypeString))
+        { return false; }
+    }
+
+    return true;
+  }
+
+  static bool IsConstantNode(const IProcessorProgramGraphNode* node)
+  {
+    switch (node->Type())
+    {
+    case ProgramGraphNodeType::FloatConstant:
+    case ProgramGraphNodeType::DoubleConstant:
+    case ProgramGraphNodeType::IntConstant:
+    case ProgramGraphNodeType::BoolConstant:
+    case ProgramGraphNodeType::StringConstant:
+      return true;
+
+    case ProgramGraphNodeType::Array:
+      for (const IInputProgramGraphNode* elementNode : static_cast<const ArrayProgramGraphNode*>(node)->Elements())
+      {
+        if (!IsConstantNode(elementNode->Connection()->Processor()))
+          { return false; }
+      }
+
+      return true;
+
+    default:
+      return false;
+    }
+  }
+
+  template<typename TElement>
+  static TElement GetConstantValue(const IProcessorProgramGraphNode* node)
+  {
+    if constexpr (std::same_as<TElement, f32>)
+    {
+      ASSERT(node->Type() == ProgramGraphNodeType::FloatConstant);
+      return static_cast<const FloatConstantProgramGraphNode*>(node)->Value();
+    }
+    else if constexpr (std::same_as<TElement, f64>)
+    {
+      ASSERT(node->Type() == ProgramGraphNodeType::DoubleConstant);
+      return static_cast<const DoubleConstantProgramGraphNode*>(node)->Value();
+    }
+    else if constexpr (std::same_as<TElement, s32>)
+    {
+      ASSERT(node->Type() == ProgramGraphNodeType::IntConstant);
+      return static_cast<const IntConstantProgramGraphNode*>(node)->Value();
+    }
+    else
+    {
+      static_assert(std::same_as<TElement, bool>);
+      ASSERT(node->Type() == ProgramGraphNodeType::BoolConstant);
+      return static_cast<const BoolConstantProgramGraphNode*>(node)->Value();
+    }
+  }
+
+  template<typename TElement, typename TBuffer>
+  static TBuffer BuildConstantBuffer(ConstantManager* constantManager, const IProcessorProgramGraphNode* node, usz sampleCount)
+  {
+    TBuffer buffer = constantManager->EnsureConstantBuffer(GetConstantValue<TElement>(node));
+    buffer.m_sampleCount = sampleCount;
+    return buffer;
+  }
+
+  template<typename TElement, typename TBuffer>
+  static FixedArray<TBuffer> BuildConstantBufferArray(ConstantManager* constantManager, const IProcessorProgramGraphNode* node, usz sampleCount)
+  {
+    ASSERT(node->Type() == ProgramGraphNodeType::Array);
+    const ArrayProgramGraphNode* arrayNode = static_cast<const ArrayProgramGraphNode*>(node);
+    FixedArray<TBuffer> buffers = InitializeCapacity(arrayNode->Elements().Count());
+    for (usz i = 0; i < buffers.Count(); i++)
+      { buffers[i] = BuildConstantBuffer<TElement, TBuffer>(constantManager, arrayNode->Elements()[i]->Connection()->Processor(), sampleCount); }
+    return buffers;
+  }
+
+  static void ReportFoldingMessage(void* context, ReportingSeverity reportingSeverity, [[maybe_unused]] const char32_t* message, [[maybe_unused]] size_t length)
+  {
+    if (reportingSeverity == ReportingSeverityError)
+      { *static_cast<bool*>(context) = true; }
+  }
+
+  // Invokes a native module call whose inputs are all constant and returns the constant value of each output. Nothing is returned if the native module reports
+  // an error or produces a non-constant output, in which case the call is simply left in the graph to be evaluated (and to report) at runtime.
+  static std::optional<FixedArray<FoldedConstant>> TryFoldNativeModuleCall(
+    const NativeLibraryRegistry* nativeLibraryRegistry,
+    const ProgramVariantProperties& programVariantProperties,
+    const NativeModuleCallProgramGraphNode* node,
+    const NativeModule* nativeModule)
+  {
+    auto [nativeLibrary, nativeLibraryContext] = nativeLibraryRegistry->TryGetNativeLibraryAndContext(node->NativeLibraryId()).value();
+
+    // Evaluation happens as if processing a single sample at the base sample rate
+    usz upsampledSampleCount = Coerce<usz>(node->UpsampleFactor());
+
+    ConstantManager constantManager;
+    UnboundedArray<FixedArray<InputFloatBuffer>> floatBufferArrays;
+    UnboundedArray<FixedArray<InputDoubleBuffer>> doubleBufferArrays;
+    UnboundedArray<FixedArray<InputIntBuffer>> intBufferArrays;
+    UnboundedArray<FixedArray<InputBoolBuffer>> boolBufferArrays;
+    UnboundedArray<BufferMemory> outputBufferMemory = InitializeCapacity(node->Outputs().Count());
+
+    FixedArray<NativeModuleArgument> arguments = InitializeCapacity(nativeModule->m_signature.m_parameterCount);
+    usz inputIndex = 0;
+    for (usz parameterIndex = 0; parameterIndex < nativeModule->m_signature.m_parameterCount; parameterIndex++)
+    {
+      const NativeModuleParameter& parameter = nativeModule->m_signature.m_parameters[parameterIndex];
+      NativeModuleArgument& argument = arguments[parameterIndex];
+      if (parameter.m_direction == ModuleParameterDirectionOut)
+      {
+        usz sampleCount = upsampledSampleCount * Coerce<usz>(parameter.m_dataType.m_upsampleFactor);
+        BufferMemory& memory = outputBufferMemory.AppendNew(AlignInt(Max(MinBufferByteCount, sampleCount * sizeof(f64)), MaxSimdAlignment));
+        memory.AsType<u8>().ZeroElements();
+
+        // Outputs start out constant and native modules are expected to leave them that way when all of their inputs are constant
+        switch (parameter.m_dataType.m_primitiveType)
+        {
+        case PrimitiveTypeFloat:
+          argument.m_floatBufferOut = { .m_sampleCount = sampleCount, .m_isConstant = true, .m_samples = memory.AsType<f32>().Elements() };
+          break;
+
+        case PrimitiveTypeDouble:
+          argument.m_doubleBufferOut = { .m_sampleCount = sampleCount, .m_isConstant = true, .m_samples = memory.AsType<f64>().Elements() };
+          break;
+
+        case PrimitiveTypeInt:
+          argument.m_intBufferOut = { .m_sampleCount = sampleCount, .m_isConstant = true, .m_samples = memory.AsType<s32>().Elements() };
+          break;
+
+        case PrimitiveTypeBool:
+          argument.m_boolBufferOut = { .m_sampleCount = sampleCount, .m_isConstant = true, .m_samples = memory.AsType<u8>().Elements() };
+          break;
+
+        default:
+          ASSERT(false);
+        }
+
+        continue;
+      }
+
+      const IProcessorProgramGraphNode* inputProcessorNode = node->Inputs()[inputIndex]->Connection()->Processor();
+      inputIndex++;
+
+      if (parameter.m_dataType.m_runtimeMutability == RuntimeMutabilityConstant)
+      {
+        if (parameter.m_dataType.m_isArray)
+        {
+          ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::Array);
+          const ArrayProgramGraphNode* arrayNode = static_cast<const ArrayProgramGraphNode*>(inputProcessorNode);
+          switch (parameter.m_dataType.m_primitiveType)
+          {
+          case PrimitiveTypeFloat:
+            argument.m_floatConstantArrayIn = constantManager.EnsureFloatConstantArray(arrayNode);
+            break;
+
+          case PrimitiveTypeDouble:
+            argument.m_doubleConstantArrayIn = constantManager.EnsureDoubleConstantArray(arrayNode);
+            break;
+
+          case PrimitiveTypeInt:
+            argument.m_intConstantArrayIn = constantManager.EnsureIntConstantArray(arrayNode);
+            break;
+
+          case PrimitiveTypeBool:
+            argument.m_boolConstantArrayIn = constantManager.EnsureBoolConstantArray(arrayNode);
+            break;
+
+          case PrimitiveTypeString:
+            argument.m_stringConstantArrayIn = constantManager.EnsureStringConstantArray(arrayNode);
+            break;
+
+          default:
+            ASSERT(false);
+          }
+        }
+        else
+        {
+          switch (parameter.m_dataType.m_primitiveType)
+          {
+          case PrimitiveTypeFloat:
+            argument.m_floatConstantIn = GetConstantValue<f32>(inputProcessorNode);
+            break;
+
+          case PrimitiveTypeDouble:
+            argument.m_doubleConstantIn = GetConstantValue<f64>(inputProcessorNode);
+            break;
+
+          case PrimitiveTypeInt:
+            argument.m_intConstantIn = GetConstantValue<s32>(inputProcessorNode);
+            break;
+
+          case PrimitiveTypeBool:
+            argument.m_boolConstantIn = GetConstantValue<bool>(inputProcessorNode);
+            break;
+
+          case PrimitiveTypeString:
+            ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::StringConstant);
+            argument.m_stringConstantIn = constantManager.EnsureString(static_cast<const StringConstantProgramGraphNode*>(inputProcessorNode)->Value());
+            break;
+
+          default:
+            ASSERT(false);
+          }
+        }
+      }
+      else
+      {
+        usz sampleCount = upsampledSampleCount * Coerce<usz>(parameter.m_dataType.m_upsampleFactor);
+        if (parameter.m_dataType.m_isArray)
+        {
+          switch (parameter.m_dataType.m_primitiveType)
+          {
+          case PrimitiveTypeFloat:
+            {
+              auto& buffers = floatBufferArrays.Append(BuildConstantBufferArray<f32, InputFloatBuffer>(&constantManager, inputProcessorNode, sampleCount));
+              argument.m_floatBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = buffers.Count() };
+              break;
+            }
+
+          case PrimitiveTypeDouble:
+            {
+              auto& buffers = doubleBufferArrays.Append(BuildConstantBufferArray<f64, InputDoubleBuffer>(&constantManager, inputProcessorNode, sampleCount));
+              argument.m_doubleBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = buffers.Count() };
+              break;
+            }
+
+          case PrimitiveTypeInt:
+            {
+              auto& buffers = intBufferArrays.Append(BuildConstantBufferArray<s32, InputIntBuffer>(&constantManager, inputProcessorNode, sampleCount));
+              argument.m_intBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = buffers.Count() };
+              break;
+            }
+
+          case PrimitiveTypeBool:
+            {
+              auto& buffers = boolBufferArrays.Append(BuildConstantBufferArray<bool, InputBoolBuffer>(&constantManager, inputProcessorNode, sampleCount));
+              argument.m_boolBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = buffers.Count() };
+              break;
+            }
+
+          default:
+            ASSERT(false);
+          }
+        }
+        else
+        {
+          switch (parameter.m_dataType.m_primitiveType)
+          {
+          case PrimitiveTypeFloat:
+            argument.m_floatBufferIn = BuildConstantBuffer<f32, InputFloatBuffer>(&constantManager, inputProcessorNode, sampleCount);
+            break;
+
+          case PrimitiveTypeDouble:
+            argument.m_doubleBufferIn = BuildConstantBuffer<f64, InputDoubleBuffer>(&constantManager, inputProcessorNode, sampleCount);
+            break;
+
+          case PrimitiveTypeInt:
+            argument.m_intBufferIn = BuildConstantBuffer<s32, InputIntBuffer>(&constantManager, inputProcessorNode, sampleCount);
+            break;
+
+          case PrimitiveTypeBool:
+            argument.m_boolBufferIn = BuildConstantBuffer<bool, InputBoolBuffer>(&constantManager, inputProcessorNode, sampleCount);
+            break;
+
+          default:
+            ASSERT(false);
+          }
+        }
+      }
+    }
+
+    // Spin up a temporary voice for this call, mirroring what the compiler does when it invokes a native module
+    bool errorReported = false;
+    void* nativeLibraryVoiceContext = nativeLibrary->m_initializeVoice != nullptr ? nativeLibrary->m_initializeVoice(nativeLibraryContext) : nullptr;
+    NativeModuleContext nativeModuleContext =
+    {
+      .m_nativeLibraryContext = nativeLibraryContext,
+      .m_nativeLibraryVoiceContext = nativeLibraryVoiceContext,
+      .m_voiceContext = nullptr,
+
+      .m_sampleRate = programVariantProperties.m_sampleRate,
+      .m_inputChannelCount = programVariantProperties.m_inputChannelCount,
+      .m_outputChannelCount = programVariantProperties.m_outputChannelCount,
+      .m_upsampleFactor = node->UpsampleFactor(),
+      .m_maxSampleCount = upsampledSampleCount,
+      .m_sampleCount = 0,
+      .m_voiceStartSampleOffset = 0,
+      .m_isCompileTime = true,
+
+      .m_reportingContext = &errorReported,
+      .m_report = &ReportFoldingMessage,
+    };
+
+    NativeModuleArguments nativeModuleArguments = { .m_arguments = arguments.Elements(), .m_argumentCount = arguments.Count() };
+
+    MemoryRequirement scratchMemoryRequirement = { .m_size = 0, .m_alignment = 0 };
+    if (nativeModule->m_initializeVoice != nullptr)
+      { nativeModuleContext.m_voiceContext = nativeModule->m_initializeVoice(&nativeModuleContext, &nativeModuleArguments, &scratchMemoryRequirement); }
+
+    bool validScratchMemoryRequirement = scratchMemoryRequirement.m_size == 0 || IsPowerOfTwo(scratchMemoryRequirement.m_alignment);
+    if (!errorReported && validScratchMemoryRequirement)
+    {
+      if (nativeModule->m_setVoiceActive != nullptr)
+        { nativeModule->m_setVoiceActive(&nativeModuleContext, true); }
+
+      nativeModuleContext.m_sampleCount = upsampledSampleCount;
+      if (nativeModule->m_invokeCompileTime != nullptr)
+        { nativeModule->m_invokeCompileTime(&nativeModuleContext, &nativeModuleArguments); }
+      else
+      {
+        ASSERT(nativeModule->m_invoke != nullptr);
+        void* scratchMemory = scratchMemoryRequirement.m_size > 0
+          ? ::operator new(scratchMemoryRequirement.m_size, std::align_val_t(scratchMemoryRequirement.m_alignment))
+          : nullptr;
+        nativeModule->m_invoke(&nativeModuleContext, &nativeModuleArguments, scratchMemory, scratchMemoryRequirement.m_size);
+        if (scratchMemory != nullptr)
+          { ::operator delete(scratchMemory, std::align_val_t(scratchMemoryRequirement.m_alignment)); }
+      }
+
+      nativeModuleContext.m_sampleCount = 0;
+      if (nativeModule->m_setVoiceActive != nullptr)
+        { nativeModule->m_setVoiceActive(&nativeModuleContext, false); }
+    }
+
+    if (nativeModule->m_deinitializeVoice != nullptr)
+      { nativeModule->m_deinitializeVoice(&nativeModuleContext); }
+    if (nativeLibrary->m_deinitializeVoice != nullptr)
+      { nativeLibrary->m_deinitializeVoice(nativeLibraryContext, nativeLibraryVoiceContext); }
+
+    if (errorReported || !validScratchMemoryRequirement)
+      { return std::nullopt; }
+
+    FixedArray<FoldedConstant> foldedConstants = InitializeCapacity(node->Outputs().Count());
+    usz outputIndex = 0;
+    for (usz parameterIndex = 0; parameterIndex < nativeModule->m_signature.m_parameterCount; parameterIndex++)
+    {
+      const NativeModuleParameter& parameter = nativeModule->m_signature.m_parameters[parameterIndex];
+      if (parameter.m_direction != ModuleParameterDirectionOut)
+        { continue; }
+
+      const NativeModuleArgument& argument = arguments[parameterIndex];
+      switch (parameter.m_dataType.m_primitiveType)
+      {
+      case PrimitiveTypeFloat:
+        if (!argument.m_floatBufferOut.m_isConstant)
+          { return std::nullopt; }
+        foldedConstants[outputIndex] = argument.m_floatBufferOut.m_samples[0];
+        break;
+
+      case PrimitiveTypeDouble:
+        if (!argument.m_doubleBufferOut.m_isConstant)
+          { return std::nullopt; }
+        foldedConstants[outputIndex] = argument.m_doubleBufferOut.m_samples[0];
+        break;
+
+      case PrimitiveTypeInt:
+        if (!argument.m_intBufferOut.m_isConstant)
+          { return std::nullopt; }
+        foldedConstants[outputIndex] = argument.m_intBufferOut.m_samples[0];
+        break;
+
+      case PrimitiveTypeBool:
+        if (!argument.m_boolBufferOut.m_isConstant)
+          { return std::nullopt; }
+        foldedConstants[outputIndex] = (argument.m_boolBufferOut.m_samples[0] & 1) != 0;
+        break;
+
+      default:
+        ASSERT(false);
+      }
+
+      outputIndex++;
+    }
+
+    return foldedConstants;
+  }
+
+  Program::SimplificationResult Program::Simplify(NativeLibraryRegistry* nativeLibraryRegistry)
+  {
+    // Folding would bake this program's constant values into nodes which may be shared with other programs
+    ASSERT(!m_isSimplified && m_sharedGraph == nullptr);
+    m_isSimplified = true;
+
+    SimplificationResult result;
+
+    std::optional<Span<const IProcessorProgramGraphNode*>> stageGraphs[] = { m_programGraph.m_voiceGraph, m_programGraph.m_effectGraph };
+
+    // This counts the tasks and task output buffers that ProgramStageTaskManager instantiates for each stage
+    auto CountTasksAndBuffers =
+      [&](usz* taskCount, usz* bufferCount)
+      {
+        *taskCount = 0;
+        *bufferCount = 0;
+        for (const std::optional<Span<const IProcessorProgramGraphNode*>>& stageGraph : stageGraphs)
+        {
+          if (!stageGraph.has_value())
+            { continue; }
+
+          IterateGraphTopological(
+            FindGraphRootNodes(*stageGraph),
+            [&](const IProcessorProgramGraphNode* node)
+            {
+              if (node->Type() == ProgramGraphNodeType::NativeModuleCall)
+              {
+                (*taskCount)++;
+                *bufferCount += static_cast<const NativeModuleCallProgramGraphNode*>(node)->Outputs().Count();
+              }
+            });
+        }
+      };
+
+    usz initialTaskCount;
+    usz initialBufferCount;
+    CountTasksAndBuffers(&initialTaskCount, &initialBufferCount);
+
+    auto RemoveConnections =
+      [](const IOutputProgramGraphNode* outputNode, auto&& shouldRemove)
+      {
+        usz remainingConnectionCount = 0;
+        for (const IInputProgramGraphNode* inputNode : outputNode->Connections())
+          { remainingConnectionCount += shouldRemove(inputNode) ? 0 : 1; }
+        if (remainingConnectionCount == outputNode->Connections().Count())
+          { return; }
+
+        FixedArray<const IInputProgramGraphNode*> remainingConnections = InitializeCapacity(remainingConnectionCount);
+        usz remainingConnectionIndex = 0;
+        for (const IInputProgramGraphNode* inputNode : outputNode->Connections())
+        {
+          if (!shouldRemove(inputNode))
+          {
+            remainingConnections[remainingConnectionIndex] = inputNode;
+            remainingConnectionIndex++;
+          }
+        }
+
+        // We own all of the nodes so it's safe to modify them here
+        auto typedOutputNode = static_cast<OutputProgramGraphNode*>(const_cast<IOutputProgramGraphNode*>(outputNode));
+        ProgramGraphNodeModifier::SetOutputNodeConnections(typedOutputNode, std::move(remainingConnections));
+      };
+
+    // Folded constants need stable addresses so reserve space for every output of every native module call which could possibly be folded
+    FixedArray<usz, 4> foldableOutputCounts;
+    foldableOutputCounts.ZeroElements();
+    for (const NativeModuleCallProgramGraphNode& node : m_nativeModuleCallNodes)
+    {
+      const NativeModule* nativeModule = FindNativeModule(nativeLibraryRegistry, &node);
+      if (!CanFoldNativeModule(nativeModule))
+        { continue; }
+
+      for (usz parameterIndex = 0; parameterIndex < nativeModule->m_signature.m_parameterCount; parameterIndex++)
+      {
+        const NativeModuleParameter& parameter = nativeModule->m_signature.m_parameters[parameterIndex];
+        if (parameter.m_direction == ModuleParameterDirectionOut)
+          { foldableOutputCounts[usz(parameter.m_dataType.m_primitiveType)]++; }
+      }
+    }
+
+    m_foldedFloatConstantNodes = InitializeCapacity(foldableOutputCounts[usz(PrimitiveTypeFloat)]);
+    m_foldedDoubleConstantNodes = InitializeCapacity(foldableOutputCounts[usz(PrimitiveTypeDouble)]);
+    m_foldedIntConstantNodes = InitializeCapacity(foldableOutputCounts[usz(PrimitiveTypeInt)]);
+    m_foldedBoolConstantNodes = InitializeCapacity(foldableOutputCounts[usz(PrimitiveTypeBool)]);
+
+    // Fold native module calls in topological order so that folding one call can make its successors foldable
+    for (const std::optional<Span<const IProcessorProgramGraphNode*>>& stageGraph : stageGraphs)
+    {
+      if (!stageGraph.has_value())
+        { continue; }
+
+      UnboundedArray<const NativeModuleCallProgramGraphNode*> nativeModuleCallNodes;
+      IterateGraphTopological(
+        FindGraphRootNodes(*stageGraph),
+        [&](const IProcessorProgramGraphNode* node)
+        {
+          if (node->Type() == ProgramGraphNodeType::NativeModuleCall)
+            { nativeModuleCallNodes.Append(static_cast<const NativeModuleCallProgramGraphNode*>(node)); }
+        });
+
+      for (const NativeModuleCallProgramGraphNode* node : nativeModuleCallNodes)
+      {
+        const NativeModule* nativeModule = FindNativeModule(nativeLibraryRegistry, node);
+        if (!CanFoldNativeModule(nativeModule))
+          { continue; }
+
+        bool allInputsConstant = true;
+        for (const IInputProgramGraphNode* inputNode : node->Inputs())
+          { allInputsConstant &= IsConstantNode(inputNode->Connection()->Processor()); }
+        if (!allInputsConstant)
+          { continue; }
+
+        auto foldedConstants = TryFoldNativeModuleCall(nativeLibraryRegistry, m_programVariantProperties, node, nativeModule);
+        if (!foldedConstants.has_value())
+          { continue; }
+
+        // Each output node is handed over to a new constant node so that downstream connections don't need to change
+        for (usz outputIndex = 0; outputIndex < node->Outputs().Count(); outputIndex++)
+        {
+          auto outputNode = static_cast<OutputProgramGraphNode*>(const_cast<IOutputProgramGraphNode*>(node->Outputs()[outputIndex]));
+          const IProcessorProgramGraphNode* constantNode = std::visit(
+            [&](auto value) -> const IProcessorProgramGraphNode*
+            {
+              using TValue = decltype(value);
+              if constexpr (std::same_as<TValue, f32>)
+              {
+                FloatConstantProgramGraphNode& typedConstantNode = m_foldedFloatConstantNodes.AppendNew(value);
+                ProgramGraphNodeModifier::SetConstantNodeOutput(&typedConstantNode, outputNode);
+                return &typedConstantNode;
+              }
+              else if constexpr (std::same_as<TValue, f64>)
+              {
+                DoubleConstantProgramGraphNode& typedConstantNode = m_foldedDoubleConstantNodes.AppendNew(value);
+                ProgramGraphNodeModifier::SetConstantNodeOutput(&typedConstantNode, outputNode);
+                return &typedConstantNode;
+              }
+              else if constexpr (std::same_as<TValue, s32>)
+              {
+                IntConstantProgramGraphNode& typedConstantNode = m_foldedIntConstantNodes.AppendNew(value);
+                ProgramGraphNodeModifier::SetConstantNodeOutput(&typedConstantNode, outputNode);
+                return &typedConstantNode;
+              }
+              else
+              {
+                BoolConstantProgramGraphNode& typedConstantNode = m_foldedBoolConstantNodes.AppendNew(value);
+                ProgramGraphNodeModifier::SetConstantNodeOutput(&typedConstantNode, outputNode);
+                return &typedConstantNode;
+              }
+            },
+            (*foldedConstants)[outputIndex]);
+          ProgramGraphNodeModifier::SetOutputNodeProcessor(outputNode, constantNode);
+        }
+
+        // Detach the folded call from its inputs so that it is no longer reachable
+        for (const IInputProgramGraphNode* inputNode : node->Inputs())
+          { RemoveConnections(inputNode->Connection(), [&](const IInputProgramGraphNode* connection) { return connection == inputNode; }); }
+
+        result.m_foldedNativeModuleCallCount++;
+      }
+    }
+
+    // A node is live if some graph output or native module call with side effects depends on it. Anything else can be reached from a root node (e.g. a
+    // native module call whose results are only consumed by a discarded computation) but can't affect the program's output so its connections are removed.
+    HashSet<const IProcessorProgramGraphNode*> liveNodes;
+    UnboundedArray<const IProcessorProgramGraphNode*> nodeStack;
+    for (const std::optional<Span<const IProcessorProgramGraphNode*>>& stageGraph : stageGraphs)
+    {
+      if (!stageGraph.has_value())
+        { continue; }
+
+      for (const IProcessorProgramGraphNode* node : *stageGraph)
+      {
+        if (liveNodes.Ensure(node))
+          { nodeStack.Append(node); }
+      }
+    }
+
+    while (!nodeStack.IsEmpty())
+    {
+      const IProcessorProgramGraphNode* node = nodeStack[nodeStack.Count() - 1];
+      nodeStack.RemoveByIndex(nodeStack.Count() - 1);
+      IterateNodeInputs(
+        node,
+        [&](const IInputProgramGraphNode* inputNode)
+        {
+          const IProcessorProgramGraphNode* inputProcessor = inputNode->Connection()->Processor();
+          if (liveNodes.Ensure(inputProcessor))
+            { nodeStack.Append(inputProcessor); }
+        });
+    }
+
+    for (const IProcessorProgramGraphNode* node : liveNodes)
+    {
+      IterateNodeOutputs(
+        node,
+        [&](const IOutputProgramGraphNode* outputNode)
+          { RemoveConnections(outputNode, [&](const IInputProgramGraphNode* connection) { return !liveNodes.Contains(connection->Processor()); }); });
+    }
+
+    // If no stage reads input channels of a given type then the processor doesn't need to provide input buffers of that type
+    auto RemoveUnusedInputChannels =
+      [&](std::optional<Span<const GraphInputProgramGraphNode*>>& inputChannels)
+      {
+        if (!inputChannels.has_value())
+          { return; }
+
+        for (const GraphInputProgramGraphNode* node : *inputChannels)
+        {
+          if (liveNodes.Contains(node))
+            { return; }
+        }
+
+        result.m_removedInputChannelCount += inputChannels->Count();
+        inputChannels.reset();
+      };
+
+    RemoveUnusedInputChannels(m_programGraph.m_inputChannelsFloat);
+    RemoveUnusedInputChannels(m_programGraph.m_inputChannelsDouble);
+
+    usz taskCount;
+    usz bufferCount;
+    CountTasksAndBuffers(&taskCount, &bufferCount);
+    ASSERT(taskCount <= initialTaskCount && bufferCount <= initialBufferCount);
+    result.m_removedTaskCount = initialTaskCount - taskCount;
+    result.m_removedBufferCount = initialBufferCount - bufferCount;
+    return result;
+  }
+}
\ No newline at end of file
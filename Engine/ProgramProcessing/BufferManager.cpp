@@ -4,6 +4,8 @@ module;
 
 module Chord.Engine;
 
+import std;
+
 import Chord.Foundation;
 
 namespace Chord
@@ -166,12 +168,19 @@ namespace Chord
   }
 
   // Note: for bool buffers, some bits at the end of the buffer may be unused
-  static usz CalculateBufferByteCount(PrimitiveType primitiveType, usz nonUpsampledSampleCount, s32 upsampleFactor)
+  usz BufferManager::CalculateBufferByteCount(PrimitiveType primitiveType, usz nonUpsampledSampleCount, s32 upsampleFactor)
   {
     usz elementBitCount = PrimitiveTypeBitCount(primitiveType);
     return AlignInt((nonUpsampledSampleCount * Coerce<usz>(upsampleFactor) * elementBitCount + 7) / 8, MaxSimdAlignment);
   }
 
+  static usz CalculateSampleOffsetAlignment(PrimitiveType primitiveType, s32 upsampleFactor)
+  {
+    usz alignmentBitCount = MaxSimdAlignment * 8;
+    usz upsampledElementBitCount = PrimitiveTypeBitCount(primitiveType) * Coerce<usz>(upsampleFactor);
+    return alignmentBitCount / std::gcd(alignmentBitCount, upsampledElementBitCount);
+  }
+
   BufferManager::BufferHandle BufferManager::AddBuffer(PrimitiveType primitiveType, usz nonUpsampledSampleCount, s32 upsampleFactor)
   {
     auto bufferHandle = BufferHandle(m_buffers.Count());
@@ -191,68 +200,125 @@ namespace Chord
     { m_buffers[usz(bufferHandle)].m_outputTaskForSharing = outputTaskForSharing; }
 
   void BufferManager::AddBufferInputTask(BufferHandle bufferHandle, const void* inputTask, bool canShareWithOutput)
+    { m_buffers[usz(bufferHandle)].m_inputTaskUsages.Append({ .m_task = inputTask, .m_canShareWithOutput = canShareWithOutput }); }
+
+  void BufferManager::SetBufferFinalInputTask(BufferHandle bufferHandle, const void* finalInputTask)
   {
     BufferData& buffer = m_buffers[usz(bufferHandle)];
-    buffer.m_inputTaskUsageCount++;
-    if (canShareWithOutput && buffer.m_inputTaskForSharing == nullptr)
-      { buffer.m_inputTaskForSharing = inputTask; }
+    ASSERT(std::ranges::any_of(buffer.m_inputTaskUsages, [&](const InputTaskUsage& usage) { return usage.m_task == finalInputTask; }));
+    buffer.m_finalInputTask = finalInputTask;
   }
 
   const BufferManager::Buffer& BufferManager::GetBuffer(BufferHandle bufferHandle) const
     { return m_buffers[usz(bufferHandle)]; }
 
+  void BufferManager::SetBufferExternalMemory(BufferHandle bufferHandle, void* memory, usz byteCount)
+  {
+    BufferData& buffer = m_buffers[usz(bufferHandle)];
+    ASSERT(buffer.m_memory != nullptr, "Buffers must be allocated before using external memory");
+    ASSERT(!buffer.m_isSharedAsInput && !buffer.m_isSharedAsOutput);
+    ASSERT(IsAlignedPointer(memory, MaxSimdAlignment));
+    ASSERT(byteCount % MaxSimdAlignment == 0 && byteCount <= (buffer.m_usesExternalMemory ? buffer.m_allocatedBufferByteCount : buffer.m_byteCount));
+
+    if (!buffer.m_usesExternalMemory)
+    {
+      buffer.m_allocatedBufferByteCount = buffer.m_byteCount;
+      buffer.m_usesExternalMemory = true;
+    }
+
+    buffer.m_memory = memory;
+    buffer.m_byteCount = byteCount;
+  }
+
+  void BufferManager::ClearBufferExternalMemory(BufferHandle bufferHandle)
+  {
+    BufferData& buffer = m_buffers[usz(bufferHandle)];
+    if (!buffer.m_usesExternalMemory)
+      { return; }
+
+    buffer.m_memory = m_sharedBufferMemoryEntries[buffer.m_sharedBufferMemoryIndex].m_memory.Elements();
+    buffer.m_byteCount = buffer.m_allocatedBufferByteCount;
+    buffer.m_usesExternalMemory = false;
+  }
+
+  usz BufferManager::GetBufferSampleOffsetAlignment(BufferHandle bufferHandle) const
+  {
+    const BufferData& buffer = m_buffers[usz(bufferHandle)];
+    return CalculateSampleOffsetAlignment(buffer.m_primitiveType, buffer.m_upsampleFactor);
+  }
+
+  BufferManager::Buffer BufferManager::Buffer::GetSubBuffer(usz nonUpsampledSampleOffset) const
+  {
+    ASSERT(nonUpsampledSampleOffset % CalculateSampleOffsetAlignment(m_primitiveType, m_upsampleFactor) == 0);
+    usz byteOffset = nonUpsampledSampleOffset * Coerce<usz>(m_upsampleFactor) * PrimitiveTypeBitCount(m_primitiveType) / 8;
+    ASSERT(byteOffset <= m_byteCount);
+
+    Buffer subBuffer = *this;
+    subBuffer.m_byteCount = m_byteCount - byteOffset;
+    subBuffer.m_memory = static_cast<u8*>(m_memory) + byteOffset;
+    return subBuffer;
+  }
+
   void BufferManager::SetBufferConstant(BufferHandle bufferHandle, bool isConstant)
+    { SetBufferConstant(bufferHandle, isConstant, 0); }
+
+  void BufferManager::SetBufferConstant(BufferHandle bufferHandle, bool isConstant, usz constantNonUpsampledSampleOffset)
   {
-    Buffer& buffer = m_buffers[usz(bufferHandle)];
+    BufferData& buffer = m_buffers[usz(bufferHandle)];
     buffer.m_isConstant = isConstant;
+    if (!isConstant)
+      { return; }
+
+    // Capture the constant value so that consumers never need to read it from buffer memory
+    ASSERT(buffer.m_constantValueMemory != nullptr);
+    Buffer constantBuffer = buffer.GetSubBuffer(constantNonUpsampledSampleOffset);
+    ASSERT(constantBuffer.m_byteCount >= BufferConstantValueByteCount);
+    Span<u8> constantValueMemory = { static_cast<u8*>(buffer.m_constantValueMemory), BufferConstantValueByteCount };
+    constantValueMemory.CopyElementsFrom(Span<const u8>(static_cast<const u8*>(constantBuffer.m_memory), BufferConstantValueByteCount));
 
     #if CHORD_ASSERTS_ENABLED
-      if (isConstant)
+      // Make sure that the first BufferConstantValueByteCount worth of elements are identical. For float types, we'll perform checks using bit_cast integers
+      // to properly handle NaN.
+      switch (buffer.m_primitiveType)
       {
-        // Make sure that the first BufferConstantValueByteCount worth of elements are identical. For float types, we'll perform checks using bit_cast integers
-        // to properly handle NaN.
-        switch (buffer.m_primitiveType)
+      case PrimitiveTypeFloat:
         {
-        case PrimitiveTypeFloat:
-          {
-            auto constantElements = buffer.Get<f32>(BufferConstantValueByteCount / sizeof(f32));
-            for (f32 value : constantElements)
-              { ASSERT(std::bit_cast<u32>(value) == std::bit_cast<u32>(constantElements[0])); }
-            break;
-          }
-
-        case PrimitiveTypeDouble:
-          {
-            auto constantElements = buffer.Get<f64>(BufferConstantValueByteCount / sizeof(f64));
-            for (f64 value : constantElements)
-              { ASSERT(std::bit_cast<u64>(value) == std::bit_cast<u64>(constantElements[0])); }
-            break;
-          }
-
-        case PrimitiveTypeInt:
-          {
-            auto constantElements = buffer.Get<s32>(BufferConstantValueByteCount / sizeof(s32));
-            for (s32 value : constantElements)
-              { ASSERT(value == constantElements[0]); }
-            break;
-          }
+          auto constantElements = Span(reinterpret_cast<const u32*>(constantValueMemory.Elements()), BufferConstantValueByteCount / sizeof(u32));
+          for (u32 value : constantElements)
+            { ASSERT(value == constantElements[0]); }
+          break;
+        }
 
-        case PrimitiveTypeBool:
-          {
-            auto constantElements = buffer.Get<u8>(BufferConstantValueByteCount);
-            ASSERT(constantElements[0] == 0x00_u8 || constantElements[0] == 0xff_u8);
-            for (u8 value : constantElements)
-              { ASSERT(value == constantElements[0]); }
-            break;
-          }
+      case PrimitiveTypeDouble:
+        {
+          auto constantElements = Span(reinterpret_cast<const u64*>(constantValueMemory.Elements()), BufferConstantValueByteCount / sizeof(u64));
+          for (u64 value : constantElements)
+            { ASSERT(value == constantElements[0]); }
+          break;
+        }
 
-        case PrimitiveTypeString:
-          ASSERT(false);
+      case PrimitiveTypeInt:
+        {
+          auto constantElements = Span(reinterpret_cast<const s32*>(constantValueMemory.Elements()), BufferConstantValueByteCount / sizeof(s32));
+          for (s32 value : constantElements)
+            { ASSERT(value == constantElements[0]); }
           break;
+        }
 
-        default:
-          ASSERT(false);
+      case PrimitiveTypeBool:
+        {
+          ASSERT(constantValueMemory[0] == 0x00_u8 || constantValueMemory[0] == 0xff_u8);
+          for (u8 value : constantValueMemory)
+            { ASSERT(value == constantValueMemory[0]); }
+          break;
         }
+
+      case PrimitiveTypeString:
+        ASSERT(false);
+        break;
+
+      default:
+        ASSERT(false);
       }
     #endif
   }
@@ -299,14 +365,13 @@ namespace Chord
     SharedBufferMemoryGroupManager groupManager(m_buffers.Count());
 
     // First, we handle condition (2). We're going to determine which buffers can be shared across an input and an output of the same native module call. Start
-    // by building up the set of input buffers which may be shareable within each task. Note that we also check that the buffer's output task is not null
-    // because buffers not produced by tasks (e.g. graph input buffers) cannot be shared in this manner (because we don't keep track of how these buffers might
-    // branch to other tasks or other parts of the graph).
+    // by building up the set of input buffers which may be shareable within each task.
     HashMap<const void*, UnboundedArray<usz>> shareableTaskInputBuffers;
     for (usz bufferIndex = 0; bufferIndex < m_buffers.Count(); bufferIndex++)
     {
-      const BufferData& buffer = m_buffers[bufferIndex];
-      if (buffer.m_inputTaskUsageCount == 1 && buffer.m_inputTaskForSharing != nullptr && buffer.m_outputTaskForSharing != nullptr)
+      BufferData& buffer = m_buffers[bufferIndex];
+      buffer.m_inPlaceInputSharingResult = ResolveInputTaskForSharing(buffer);
+      if (buffer.m_inputTaskForSharing != nullptr)
       {
         auto entry = shareableTaskInputBuffers.TryGet(buffer.m_inputTaskForSharing);
         if (entry == nullptr)
@@ -315,28 +380,78 @@ namespace Chord
       }
     }
 
-    // Now go through each output buffer and try to share it with an input buffer within the same task
     for (usz bufferIndex = 0; bufferIndex < m_buffers.Count(); bufferIndex++)
     {
       BufferData& buffer = m_buffers[bufferIndex];
-      if (buffer.m_outputTaskForSharing == nullptr)
-        { continue; }
-
-      auto shareableInputBuffers = shareableTaskInputBuffers.TryGet(buffer.m_outputTaskForSharing);
-      if (shareableInputBuffers == nullptr)
-        { continue; }
+      buffer.m_inPlaceOutputSharingResult = buffer.m_outputTaskForSharing == nullptr
+        ? InPlaceSharingResult::Disallowed
+        : InPlaceSharingResult::NoCandidates;
+    }
 
-      for (usz i = 0; i < shareableInputBuffers->Count(); i++)
+    // Now go through each output buffer and try to share it with an input buffer within the same task. On the first pass, we only share buffers which are
+    // iterated at identical rates. On the second pass, narrower outputs (i.e. bool outputs) are allowed to take any leftover wider inputs. Doing this in two
+    // passes prevents a bool output from claiming an input which an output of the same width could have used instead.
+    for (bool allowNarrowerOutput : { false, true })
+    {
+      for (usz bufferIndex = 0; bufferIndex < m_buffers.Count(); bufferIndex++)
       {
-        usz inputBufferIndex = (*shareableInputBuffers)[i];
-        if (!CanBuffersShareMemoryWithinTask(bufferIndex, inputBufferIndex))
+        BufferData& buffer = m_buffers[bufferIndex];
+        if (buffer.m_outputTaskForSharing == nullptr || buffer.m_isSharedAsOutput)
           { continue; }
 
-        buffer.m_isSharedAsOutput = true;
-        m_buffers[inputBufferIndex].m_isSharedAsInput = true;
+        auto shareableInputBuffers = shareableTaskInputBuffers.TryGet(buffer.m_outputTaskForSharing);
+        if (shareableInputBuffers == nullptr)
+          { continue; }
 
-        // Remove this input buffer from the list of shareable buffers because a buffer can only be shared once per task
-        shareableInputBuffers->RemoveByIndex(i);
+        // If multiple inputs are compatible, choose the smallest one so that larger inputs remain available for larger outputs
+        std::optional<usz> bestInputBufferIndex;
+        bool anyCompatibleInputs = false;
+        for (usz inputBufferIndex : *shareableInputBuffers)
+        {
+          BufferData& inputBuffer = m_buffers[inputBufferIndex];
+          if (!CanBuffersShareMemoryWithinTask(bufferIndex, inputBufferIndex, allowNarrowerOutput))
+          {
+            if (inputBuffer.m_inPlaceInputSharingResult == InPlaceSharingResult::NoCandidates)
+              { inputBuffer.m_inPlaceInputSharingResult = InPlaceSharingResult::IncompatibleCandidates; }
+            continue;
+          }
+
+          anyCompatibleInputs = true;
+          if (inputBuffer.m_isSharedAsInput)
+            { continue; }
+
+          if (!bestInputBufferIndex.has_value() || inputBuffer.m_byteCount < m_buffers[*bestInputBufferIndex].m_byteCount)
+            { bestInputBufferIndex = inputBufferIndex; }
+        }
+
+        if (!bestInputBufferIndex.has_value())
+        {
+          buffer.m_inPlaceOutputSharingResult = anyCompatibleInputs
+            ? InPlaceSharingResult::CandidatesClaimed
+            : InPlaceSharingResult::IncompatibleCandidates;
+          continue;
+        }
+
+        usz inputBufferIndex = bestInputBufferIndex.value();
+        BufferData& inputBuffer = m_buffers[inputBufferIndex];
+
+        // Any other compatible inputs lost out to the one we chose
+        for (usz otherInputBufferIndex : *shareableInputBuffers)
+        {
+          BufferData& otherInputBuffer = m_buffers[otherInputBufferIndex];
+          if (otherInputBufferIndex != inputBufferIndex
+            && !otherInputBuffer.m_isSharedAsInput
+            && CanBuffersShareMemoryWithinTask(bufferIndex, otherInputBufferIndex, allowNarrowerOutput))
+            { otherInputBuffer.m_inPlaceInputSharingResult = InPlaceSharingResult::CandidatesClaimed; }
+        }
+
+        // Note: a buffer can only be shared once per task, which is enforced by the m_isSharedAsInput and m_isSharedAsOutput checks above
+        buffer.m_isSharedAsOutput = true;
+        buffer.m_inPlaceOutputSharingResult = InPlaceSharingResult::Shared;
+        buffer.m_inPlaceSharedBufferIndex = inputBufferIndex;
+        inputBuffer.m_isSharedAsInput = true;
+        inputBuffer.m_inPlaceInputSharingResult = InPlaceSharingResult::Shared;
+        inputBuffer.m_inPlaceSharedBufferIndex = bufferIndex;
 
         // Add the two buffers to the same group
         auto groupIndex = groupManager.GetBufferGroupIndex(bufferIndex);
@@ -351,9 +466,6 @@ namespace Chord
           { groupManager.AddBufferToGroup(groupIndex, inputBufferIndex); }
         else
           { groupManager.MergeGroups(groupIndex, inputGroupIndex); }
-
-        // We've successfully shared with one input buffer so we can't share with another
-        break;
       }
     }
 
@@ -383,80 +495,248 @@ namespace Chord
       }
     }
 
-    // Now, actually allocate the memory
-    usz sharedBufferMemoryCount = 0;
-    usz totalByteCount = 0;
+    // Now assign shared buffer memory to each group which contains buffers. Buffers shared in-place may have different sizes so each group reserves enough
+    // memory for its largest buffer.
+    UnboundedArray<usz> sharedBufferMemoryByteCounts;
     for (usz groupIndex = 0; groupIndex < groupManager.GroupCount(); groupIndex++)
     {
-      bool anyBuffers = false;
-      usz groupByteCount = 0;
+      std::optional<usz> groupSharedBufferMemoryIndex;
       groupManager.ForEachBuffer(
         SharedBufferMemoryGroupManager::GroupIndex(groupIndex),
         [&](usz bufferIndex)
         {
-          const BufferData& buffer = m_buffers[bufferIndex];
-          if (anyBuffers)
+          BufferData& buffer = m_buffers[bufferIndex];
+          if (!groupSharedBufferMemoryIndex.has_value())
           {
-            ASSERT(groupByteCount == buffer.m_byteCount);
-            return;
+            groupSharedBufferMemoryIndex = sharedBufferMemoryByteCounts.Count();
+            sharedBufferMemoryByteCounts.Append(0);
           }
 
-          // This group has at least one buffer so we need to reserve memory
-          anyBuffers = true;
-          ASSERT(IsAlignedInt(buffer.m_byteCount, MaxSimdAlignment));
-          groupByteCount = buffer.m_byteCount;
-          totalByteCount += groupByteCount;
+          buffer.m_sharedBufferMemoryIndex = groupSharedBufferMemoryIndex.value();
+          usz& groupByteCount = sharedBufferMemoryByteCounts[groupSharedBufferMemoryIndex.value()];
+          groupByteCount = Max(groupByteCount, buffer.m_byteCount);
+        });
+    }
+
+    AllocateSharedBufferMemory(sharedBufferMemoryByteCounts);
+  }
 
-          #if BUFFER_GUARDS_ENABLED
-            // Add a guard at the end of the buffer so we can check for overwrites
-            totalByteCount += BufferGuardByteCount;
-          #endif
+  BufferManager::AllocationPlan BufferManager::GetAllocationPlan() const
+  {
+    AllocationPlan plan =
+    {
+      .m_buffers = InitializeCapacity(m_buffers.Count()),
+      .m_sharedBufferMemoryByteCounts = InitializeCapacity(m_sharedBufferMemoryEntries.Count()),
+    };
 
-          sharedBufferMemoryCount++;
-        });
+    for (usz bufferIndex = 0; bufferIndex < m_buffers.Count(); bufferIndex++)
+    {
+      const BufferData& buffer = m_buffers[bufferIndex];
+      plan.m_buffers[bufferIndex] =
+      {
+        .m_primitiveType = buffer.m_primitiveType,
+        .m_upsampleFactor = buffer.m_upsampleFactor,
+        .m_byteCount = buffer.m_usesExternalMemory ? buffer.m_allocatedBufferByteCount : buffer.m_byteCount,
+        .m_sharedBufferMemoryIndex = buffer.m_sharedBufferMemoryIndex,
+        .m_inPlaceOutputSharingResult = buffer.m_inPlaceOutputSharingResult,
+        .m_inPlaceInputSharingResult = buffer.m_inPlaceInputSharingResult,
+        .m_inPlaceSharedBufferIndex = buffer.m_inPlaceSharedBufferIndex,
+      };
+    }
+
+    for (usz sharedBufferMemoryIndex = 0; sharedBufferMemoryIndex < m_sharedBufferMemoryEntries.Count(); sharedBufferMemoryIndex++)
+      { plan.m_sharedBufferMemoryByteCounts[sharedBufferMemoryIndex] = m_sharedBufferMemoryEntries[sharedBufferMemoryIndex].m_memory.Count(); }
+
+    return plan;
+  }
+
+  bool BufferManager::TryAllocateBuffers(const AllocationPlan& plan)
+  {
+    // The plan is validated in full before any buffer is assigned memory so that the caller can fall back to AllocateBuffers() if it doesn't match. Sharing
+    // memory across tasks can't be validated without the buffer concurrency analysis that the plan exists to skip so it is trusted as long as every buffer
+    // matches. Plans from other engine builds are rejected beforehand by the plan key, which includes the plan version, and by the plan checksum.
+    if (plan.m_buffers.Count() != m_buffers.Count())
+      { return false; }
+
+    // Resolving input tasks is deterministic so this doesn't affect a subsequent call to AllocateBuffers()
+    for (BufferData& buffer : m_buffers)
+      { ResolveInputTaskForSharing(buffer); }
+
+    for (usz byteCount : plan.m_sharedBufferMemoryByteCounts)
+    {
+      if (!IsAlignedInt(byteCount, MaxSimdAlignment))
+        { return false; }
+    }
+
+    for (usz bufferIndex = 0; bufferIndex < m_buffers.Count(); bufferIndex++)
+    {
+      const BufferData& buffer = m_buffers[bufferIndex];
+      const AllocationPlan::PlannedBuffer& plannedBuffer = plan.m_buffers[bufferIndex];
+      if (plannedBuffer.m_primitiveType != buffer.m_primitiveType
+        || plannedBuffer.m_upsampleFactor != buffer.m_upsampleFactor
+        || plannedBuffer.m_byteCount != buffer.m_byteCount
+        || plannedBuffer.m_sharedBufferMemoryIndex >= plan.m_sharedBufferMemoryByteCounts.Count()
+        || plannedBuffer.m_byteCount > plan.m_sharedBufferMemoryByteCounts[plannedBuffer.m_sharedBufferMemoryIndex])
+        { return false; }
+
+      bool isSharedAsOutput = plannedBuffer.m_inPlaceOutputSharingResult == InPlaceSharingResult::Shared;
+      bool isSharedAsInput = plannedBuffer.m_inPlaceInputSharingResult == InPlaceSharingResult::Shared;
+      if ((isSharedAsOutput || isSharedAsInput) != plannedBuffer.m_inPlaceSharedBufferIndex.has_value())
+        { return false; }
+
+      if (!plannedBuffer.m_inPlaceSharedBufferIndex.has_value())
+        { continue; }
+
+      // In-place sharing only depends on the tasks which produce and consume each buffer so it is cheap to confirm that it is still valid
+      usz sharedBufferIndex = plannedBuffer.m_inPlaceSharedBufferIndex.value();
+      if (isSharedAsOutput == isSharedAsInput
+        || sharedBufferIndex >= m_buffers.Count()
+        || plan.m_buffers[sharedBufferIndex].m_inPlaceSharedBufferIndex != bufferIndex
+        || plan.m_buffers[sharedBufferIndex].m_sharedBufferMemoryIndex != plannedBuffer.m_sharedBufferMemoryIndex)
+        { return false; }
+
+      if (isSharedAsOutput)
+      {
+        if (plan.m_buffers[sharedBufferIndex].m_inPlaceInputSharingResult != InPlaceSharingResult::Shared
+          || buffer.m_outputTaskForSharing == nullptr
+          || m_buffers[sharedBufferIndex].m_inputTaskForSharing != buffer.m_outputTaskForSharing
+          || !CanBuffersShareMemoryWithinTask(bufferIndex, sharedBufferIndex, true))
+          { return false; }
+      }
+    }
+
+    for (usz bufferIndex = 0; bufferIndex < m_buffers.Count(); bufferIndex++)
+    {
+      BufferData& buffer = m_buffers[bufferIndex];
+      const AllocationPlan::PlannedBuffer& plannedBuffer = plan.m_buffers[bufferIndex];
+      buffer.m_isSharedAsOutput = plannedBuffer.m_inPlaceOutputSharingResult == InPlaceSharingResult::Shared;
+      buffer.m_isSharedAsInput = plannedBuffer.m_inPlaceInputSharingResult == InPlaceSharingResult::Shared;
+      buffer.m_inPlaceOutputSharingResult = plannedBuffer.m_inPlaceOutputSharingResult;
+      buffer.m_inPlaceInputSharingResult = plannedBuffer.m_inPlaceInputSharingResult;
+      buffer.m_inPlaceSharedBufferIndex = plannedBuffer.m_inPlaceSharedBufferIndex;
+      buffer.m_sharedBufferMemoryIndex = plannedBuffer.m_sharedBufferMemoryIndex;
+    }
+
+    AllocateSharedBufferMemory(plan.m_sharedBufferMemoryByteCounts);
+    return true;
+  }
+
+  void BufferManager::AllocateSharedBufferMemory(Span<const usz> sharedBufferMemoryByteCounts)
+  {
+    m_allocatedByteCount = 0;
+    usz totalByteCount = 0;
+    for (usz byteCount : sharedBufferMemoryByteCounts)
+    {
+      ASSERT(IsAlignedInt(byteCount, MaxSimdAlignment));
+      totalByteCount += byteCount;
+      m_allocatedByteCount += byteCount;
+
+      #if BUFFER_GUARDS_ENABLED
+        // Add a guard at the end of the buffer so we can check for overwrites
+        totalByteCount += BufferGuardByteCount;
+      #endif
     }
 
     m_bufferMemory = { totalByteCount };
     auto bufferMemory = m_bufferMemory.AsType<u8>();
 
-    m_sharedBufferMemoryEntries = InitializeCapacity(sharedBufferMemoryCount);
+    m_sharedBufferMemoryEntries = InitializeCapacity(sharedBufferMemoryByteCounts.Count());
 
-    usz sharedBufferMemoryIndex = 0;
     usz totalByteOffset = 0;
-    for (usz groupIndex = 0; groupIndex < groupManager.GroupCount(); groupIndex++)
+    for (usz sharedBufferMemoryIndex = 0; sharedBufferMemoryIndex < sharedBufferMemoryByteCounts.Count(); sharedBufferMemoryIndex++)
     {
-      std::optional<usz> groupSharedBufferMemoryIndex;
-      groupManager.ForEachBuffer(
-        SharedBufferMemoryGroupManager::GroupIndex(groupIndex),
-        [&](usz bufferIndex)
-        {
-          BufferData& buffer = m_buffers[bufferIndex];
-          if (!groupSharedBufferMemoryIndex.has_value())
-          {
-            groupSharedBufferMemoryIndex = sharedBufferMemoryIndex;
-            SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[sharedBufferMemoryIndex];
-            sharedBufferMemory.m_memory = Span(bufferMemory, totalByteOffset, buffer.m_byteCount);
+      usz byteCount = sharedBufferMemoryByteCounts[sharedBufferMemoryIndex];
+      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[sharedBufferMemoryIndex];
+      sharedBufferMemory.m_memory = Span(bufferMemory, totalByteOffset, byteCount);
+
+      #if BUFFER_GUARDS_ENABLED
+        sharedBufferMemory.m_memoryWithGuard = Span(bufferMemory, totalByteOffset, byteCount + BufferGuardByteCount);
+        totalByteOffset += BufferGuardByteCount;
+      #endif
+      totalByteOffset += byteCount;
+    }
 
-            #if BUFFER_GUARDS_ENABLED
-            sharedBufferMemory.m_memoryWithGuard = Span(bufferMemory, totalByteOffset, buffer.m_byteCount + BufferGuardByteCount);
-              totalByteOffset += BufferGuardByteCount;
-            #endif
-            totalByteOffset += buffer.m_byteCount;
+    ASSERT(totalByteOffset == totalByteCount);
 
-            sharedBufferMemoryIndex++;
-          }
+    for (BufferData& buffer : m_buffers)
+    {
+      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[buffer.m_sharedBufferMemoryIndex];
+      ASSERT(buffer.m_byteCount <= sharedBufferMemory.m_memory.Count());
+      buffer.m_memory = sharedBufferMemory.m_memory.Elements();
+
+      #if BUFFER_GUARDS_ENABLED
+        sharedBufferMemory.m_maxUpsampledElementBitCount = Max(
+          sharedBufferMemory.m_maxUpsampledElementBitCount,
+          PrimitiveTypeBitCount(buffer.m_primitiveType) * Coerce<usz>(buffer.m_upsampleFactor));
+      #endif
+    }
 
-          SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[groupSharedBufferMemoryIndex.value()];
-          buffer.m_sharedBufferMemoryIndex = groupSharedBufferMemoryIndex.value();
-          buffer.m_memory = sharedBufferMemory.m_memory.Elements();
-        });
+    // Each buffer gets a small dedicated region to hold its constant value. These are packed together so that constant values used by a stage share cache
+    // lines rather than each being read from the start of a separate buffer.
+    if (m_buffers.Count() > 0)
+    {
+      m_constantValueMemory = { m_buffers.Count() * BufferConstantValueByteCount };
+      auto constantValueMemory = m_constantValueMemory.AsType<u8>();
+      for (usz bufferIndex = 0; bufferIndex < m_buffers.Count(); bufferIndex++)
+        { m_buffers[bufferIndex].m_constantValueMemory = &constantValueMemory[bufferIndex * BufferConstantValueByteCount]; }
     }
+  }
 
-    ASSERT(sharedBufferMemoryIndex == sharedBufferMemoryCount);
-    ASSERT(totalByteOffset == totalByteCount);
+  usz BufferManager::GetUnsharedByteCount() const
+  {
+    usz byteCount = 0;
+    for (const BufferData& buffer : m_buffers)
+      { byteCount += buffer.m_byteCount; }
+    return byteCount;
+  }
+
+  usz BufferManager::GetMetadataByteCount() const
+  {
+    usz byteCount = m_buffers.Count() * sizeof(BufferData)
+      + m_bufferConcurrencyMatrix.Count() * sizeof(bool)
+      + m_sharedBufferMemoryEntries.Count() * sizeof(SharedBufferMemory);
+    for (const BufferData& buffer : m_buffers)
+      { byteCount += buffer.m_inputTaskUsages.Count() * sizeof(InputTaskUsage); }
+
+    for (const FixedArray<InputFloatBuffer>& bufferArray : m_inputFloatBufferArrays)
+      { byteCount += bufferArray.Count() * sizeof(InputFloatBuffer); }
+    for (const FixedArray<InputDoubleBuffer>& bufferArray : m_inputDoubleBufferArrays)
+      { byteCount += bufferArray.Count() * sizeof(InputDoubleBuffer); }
+    for (const FixedArray<InputIntBuffer>& bufferArray : m_inputIntBufferArrays)
+      { byteCount += bufferArray.Count() * sizeof(InputIntBuffer); }
+    for (const FixedArray<InputBoolBuffer>& bufferArray : m_inputBoolBufferArrays)
+      { byteCount += bufferArray.Count() * sizeof(InputBoolBuffer); }
+
+    return byteCount;
+  }
+
+  usz BufferManager::EstimateMetadataByteCount(usz bufferCount)
+  {
+    // Buffer concurrency is tracked between every pair of buffers so this grows quadratically
+    return bufferCount * sizeof(BufferData) + bufferCount * bufferCount * sizeof(bool);
+  }
+
+  BufferManager::BufferSharingDiagnostic BufferManager::GetBufferSharingDiagnostic(BufferHandle bufferHandle) const
+  {
+    const BufferData& buffer = m_buffers[usz(bufferHandle)];
+    return
+    {
+      .m_inPlaceOutputSharingResult = buffer.m_inPlaceOutputSharingResult,
+      .m_inPlaceInputSharingResult = buffer.m_inPlaceInputSharingResult,
+      .m_inPlaceSharedBufferHandle = buffer.m_inPlaceSharedBufferIndex.has_value()
+        ? std::optional(BufferHandle(buffer.m_inPlaceSharedBufferIndex.value()))
+        : std::nullopt,
+      .m_sharedBufferMemoryIndex = buffer.m_sharedBufferMemoryIndex,
+    };
   }
 
   #if BUFFER_GUARDS_ENABLED
+    usz BufferManager::CalculateGuardOffset(const SharedBufferMemory& sharedBufferMemory) const
+    {
+      usz byteCount = (m_processingSampleCount * sharedBufferMemory.m_maxUpsampledElementBitCount + 7) / 8;
+      return AlignInt(byteCount, MaxSimdAlignment);
+    }
+
     void BufferManager::StartProcessing(usz sampleCount)
       { m_processingSampleCount = sampleCount; }
 
@@ -477,13 +757,13 @@ namespace Chord
       if (buffer.m_isSharedAsOutput)
         { ASSERT(task == buffer.m_outputTaskForSharing); }
 
-      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[usz(bufferHandle)];
+      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[buffer.m_sharedBufferMemoryIndex];
       const void* expectedWriteTask = nullptr;
       VERIFY(sharedBufferMemory.m_writeTask.compare_exchange_weak(expectedWriteTask, task, std::memory_order_relaxed));
       const void* readTask = sharedBufferMemory.m_readTask.load(std::memory_order_relaxed);
       usz readCount = sharedBufferMemory.m_readCount.load(std::memory_order_relaxed);
 
-      if (buffer.m_isSharedAsInput)
+      if (buffer.m_isSharedAsOutput)
       {
         // If this output is being shared with an input, the same task may be reading it
         ASSERT(readTask == task || readTask == nullptr);
@@ -497,7 +777,7 @@ namespace Chord
       }
 
       // Fill this buffer's guard area with a pattern so we can detect overwrites
-      usz guardOffset = CalculateBufferByteCount(buffer.m_primitiveType, m_processingSampleCount, buffer.m_upsampleFactor);
+      usz guardOffset = CalculateGuardOffset(sharedBufferMemory);
       auto guardMemory = Span(sharedBufferMemory.m_memory, guardOffset, ToEnd);
       guardMemory.Fill(BufferGuardMemoryByte);
     }
@@ -508,13 +788,13 @@ namespace Chord
       if (buffer.m_isSharedAsOutput)
         { ASSERT(task == buffer.m_outputTaskForSharing); }
 
-      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[usz(bufferHandle)];
+      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[buffer.m_sharedBufferMemoryIndex];
       const void* expectedWriteTask = task;
       VERIFY(sharedBufferMemory.m_writeTask.compare_exchange_weak(expectedWriteTask, nullptr, std::memory_order_relaxed));
       const void* readTask = sharedBufferMemory.m_readTask.load(std::memory_order_relaxed);
       usz readCount = sharedBufferMemory.m_readCount.load(std::memory_order_relaxed);
 
-      if (buffer.m_isSharedAsInput)
+      if (buffer.m_isSharedAsOutput)
       {
         // If this output is being shared with an input, the same task may be reading it
         ASSERT(readTask == task || readTask == nullptr);
@@ -528,7 +808,7 @@ namespace Chord
       }
 
       // Make sure this buffer's guard area has not been overwritten
-      usz guardOffset = CalculateBufferByteCount(buffer.m_primitiveType, m_processingSampleCount, buffer.m_upsampleFactor);
+      usz guardOffset = CalculateGuardOffset(sharedBufferMemory);
       auto guardMemory = Span(sharedBufferMemory.m_memory, guardOffset, ToEnd);
       for (u8 byte : guardMemory)
         { ASSERT(byte == BufferGuardMemoryByte); }
@@ -537,14 +817,16 @@ namespace Chord
     void BufferManager::StartBufferRead(BufferHandle bufferHandle, const void* task)
     {
       const BufferData& buffer = m_buffers[usz(bufferHandle)];
-      if (buffer.m_isSharedAsInput)
-        { ASSERT(task == buffer.m_inputTaskForSharing); }
 
-      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[usz(bufferHandle)];
+      // If this input is shared with an output, only its final input task reads it alongside that output. Other input tasks are guaranteed to finish before
+      // the final input task starts.
+      bool isSharedWithTaskOutput = buffer.m_isSharedAsInput && task == buffer.m_inputTaskForSharing;
+
+      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[buffer.m_sharedBufferMemoryIndex];
       const void* writeTask = sharedBufferMemory.m_writeTask.load(std::memory_order_relaxed);
       usz oldReadCount = sharedBufferMemory.m_readCount.fetch_add(1, std::memory_order_relaxed);
 
-      if (buffer.m_isSharedAsInput)
+      if (isSharedWithTaskOutput)
       {
         // If this input is being shared with an output, the same task may be writing it and nothing else should be reading it
         ASSERT(writeTask == task || writeTask == nullptr);
@@ -563,15 +845,14 @@ namespace Chord
     void BufferManager::FinishBufferRead(BufferHandle bufferHandle, const void* task)
     {
       const BufferData& buffer = m_buffers[usz(bufferHandle)];
-      if (buffer.m_isSharedAsInput)
-        { ASSERT(task == buffer.m_inputTaskForSharing); }
+      bool isSharedWithTaskOutput = buffer.m_isSharedAsInput && task == buffer.m_inputTaskForSharing;
 
-      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[usz(bufferHandle)];
+      SharedBufferMemory& sharedBufferMemory = m_sharedBufferMemoryEntries[buffer.m_sharedBufferMemoryIndex];
       const void* writeTask = sharedBufferMemory.m_writeTask.load(std::memory_order_relaxed);
       usz oldReadCount = sharedBufferMemory.m_readCount.fetch_sub(1, std::memory_order_relaxed);
       ASSERT(oldReadCount != 0);
 
-      if (buffer.m_isSharedAsInput)
+      if (isSharedWithTaskOutput)
       {
         // If this input is being shared with an output, the same task may be writing it and nothing else should be reading it
         ASSERT(writeTask == task || writeTask == nullptr);
@@ -588,15 +869,67 @@ namespace Chord
     }
   #endif
 
-  bool BufferManager::CanBuffersShareMemoryWithinTask(usz bufferIndexA, usz bufferIndexB) const
+  BufferManager::InPlaceSharingResult BufferManager::ResolveInputTaskForSharing(BufferData& buffer) const
   {
-    const BufferData& bufferA = m_buffers[bufferIndexA];
-    const BufferData& bufferB = m_buffers[bufferIndexB];
+    if (buffer.m_inputTaskUsages.Count() == 0)
+      { return InPlaceSharingResult::NotApplicable; }
+
+    // Buffers not produced by tasks (e.g. graph input buffers) cannot be shared in this manner because we don't keep track of how these buffers might branch
+    // to other tasks or other parts of the graph
+    if (buffer.m_outputTaskForSharing == nullptr)
+      { return InPlaceSharingResult::UntrackedProducer; }
+
+    // Every reader must allow sharing, not just the final one. Readers which aren't native module call tasks (e.g. graph outputs, which are read after all
+    // tasks have finished) are registered as disallowing sharing so a buffer which also feeds one of them is never overwritten in-place.
+    for (const InputTaskUsage& usage : buffer.m_inputTaskUsages)
+    {
+      if (!usage.m_canShareWithOutput)
+        { return InPlaceSharingResult::Disallowed; }
+    }
+
+    // If the buffer is only read by a single task, that task is where the buffer dies. Otherwise, we can only share the buffer in the final task that reads it,
+    // which must run after all other tasks reading it have finished.
+    const void* inputTask = buffer.m_inputTaskUsages[0].m_task;
+    for (const InputTaskUsage& usage : buffer.m_inputTaskUsages)
+    {
+      if (usage.m_task != inputTask)
+      {
+        inputTask = buffer.m_finalInputTask;
+        break;
+      }
+    }
+
+    if (inputTask == nullptr)
+      { return InPlaceSharingResult::NoFinalInputTask; }
+
+    usz usageCount = 0;
+    for (const InputTaskUsage& usage : buffer.m_inputTaskUsages)
+      { usageCount += (usage.m_task == inputTask ? 1 : 0); }
+
+    if (usageCount > 1)
+      { return InPlaceSharingResult::MultipleUsagesInTask; }
+
+    buffer.m_inputTaskForSharing = inputTask;
+    return InPlaceSharingResult::NoCandidates;
+  }
+
+  bool BufferManager::CanBuffersShareMemoryWithinTask(usz outputBufferIndex, usz inputBufferIndex, bool allowNarrowerOutput) const
+  {
+    const BufferData& outputBuffer = m_buffers[outputBufferIndex];
+    const BufferData& inputBuffer = m_buffers[inputBufferIndex];
+    if (outputBuffer.m_upsampleFactor != inputBuffer.m_upsampleFactor)
+      { return false; }
 
     // We should only share memory within a task if the iteration step size within the buffer is identical, i.e. you read 1 sample of input for every 1 sample
     // of output.
-    return PrimitiveTypeBitCount(bufferA.m_primitiveType) == PrimitiveTypeBitCount(bufferB.m_primitiveType)
-      && bufferA.m_upsampleFactor == bufferB.m_upsampleFactor;
+    usz outputBitCount = PrimitiveTypeBitCount(outputBuffer.m_primitiveType);
+    usz inputBitCount = PrimitiveTypeBitCount(inputBuffer.m_primitiveType);
+    if (outputBitCount == inputBitCount)
+      { return true; }
+
+    // The exception is bool outputs. Because they're written at 1 bit per sample, the write position always trails the read position of a wider input, so any
+    // element that gets overwritten has already been read.
+    return allowNarrowerOutput && outputBuffer.m_primitiveType == PrimitiveTypeBool && outputBitCount < inputBitCount;
   }
 
   bool BufferManager::CanBuffersShareMemoryAcrossTasks(usz bufferIndexA, usz bufferIndexB) const
@@ -5,6 +5,8 @@ module;
 
 export module Chord.Engine:ProgramProcessing.BufferManager;
 
+import std;
+
 import Chord.Foundation;
 import :ProgramProcessing.BufferMemory;
 
@@ -48,23 +50,164 @@ namespace Chord
           }
         }
 
+        // When m_isConstant is true, the constant value is read from m_constantValueMemory rather than from buffer memory
+        template<typename TElement>
+        TElement GetConstant() const
+        {
+          ASSERT(m_isConstant);
+          if constexpr (std::same_as<TElement, f32>)
+            { ASSERT(m_primitiveType == PrimitiveTypeFloat); }
+          else if constexpr (std::same_as<TElement, f64>)
+            { ASSERT(m_primitiveType == PrimitiveTypeDouble); }
+          else if constexpr (std::same_as<TElement, s32>)
+            { ASSERT(m_primitiveType == PrimitiveTypeInt); }
+          else if constexpr (std::same_as<TElement, bool>)
+            { ASSERT(m_primitiveType == PrimitiveTypeBool); }
+          else
+            { ASSERT(AlwaysFalse<TElement>, "Unsupported element type"); }
+
+          if constexpr (std::same_as<TElement, bool>)
+            { return (*static_cast<const u8*>(m_constantValueMemory) & 1) != 0; }
+          else
+            { return *static_cast<const TElement*>(m_constantValueMemory); }
+        }
+
+        // Returns a view of this buffer starting at the given sample. This is used when a buffer is processed as a sequence of sub-blocks. The offset must be
+        // a multiple of the buffer's sample offset alignment.
+        Buffer GetSubBuffer(usz nonUpsampledSampleOffset) const;
+
         PrimitiveType m_primitiveType;
         s32 m_upsampleFactor = 0;
         usz m_byteCount = 0;
         void* m_memory = nullptr;
         bool m_isConstant = false;
+
+        // Constant values are tracked separately from buffer memory (repeated to fill BufferConstantValueByteCount bytes) so that consumers of a constant
+        // buffer never touch buffer memory and can simply broadcast the value
+        void* m_constantValueMemory = nullptr;
+      };
+
+      // Describes the outcome of attempting to share a buffer's memory in-place with a buffer of the opposite direction within the same task
+      enum class InPlaceSharingResult
+      {
+        // The buffer is never used in this direction
+        NotApplicable,
+
+        // The buffer shares memory with a buffer of the opposite direction
+        Shared,
+
+        // The native module parameter which produces or consumes the buffer disallows sharing
+        Disallowed,
+
+        // (Input only) The buffer is not produced by a task which allows sharing so its other usages can't be tracked
+        UntrackedProducer,
+
+        // (Input only) The buffer is used by more than one input within the task in which it is last used
+        MultipleUsagesInTask,
+
+        // (Input only) The buffer is used by multiple tasks and no single one of them is guaranteed to run after all of the others
+        NoFinalInputTask,
+
+        // There are no shareable buffers of the opposite direction within the same task
+        NoCandidates,
+
+        // All shareable buffers of the opposite direction within the same task are iterated at an incompatible rate
+        IncompatibleCandidates,
+
+        // All compatible buffers of the opposite direction within the same task were shared with other buffers
+        CandidatesClaimed,
+      };
+
+      struct BufferSharingDiagnostic
+      {
+        InPlaceSharingResult m_inPlaceOutputSharingResult = InPlaceSharingResult::NotApplicable;
+        InPlaceSharingResult m_inPlaceInputSharingResult = InPlaceSharingResult::NotApplicable;
+        std::optional<BufferHandle> m_inPlaceSharedBufferHandle;
+
+        // Buffers with the same shared buffer memory index use the same memory, whether due to in-place sharing or due to never being used concurrently
+        usz m_sharedBufferMemoryIndex = 0;
+      };
+
+      // Records how AllocateBuffers() assigned buffers to memory so that the same assignment can be applied to an identical set of buffers later without
+      // analyzing buffer concurrency
+      struct AllocationPlan
+      {
+        struct PlannedBuffer
+        {
+          PrimitiveType m_primitiveType;
+          s32 m_upsampleFactor = 0;
+          usz m_byteCount = 0;
+          usz m_sharedBufferMemoryIndex = 0;
+          InPlaceSharingResult m_inPlaceOutputSharingResult = InPlaceSharingResult::NotApplicable;
+          InPlaceSharingResult m_inPlaceInputSharingResult = InPlaceSharingResult::NotApplicable;
+          std::optional<usz> m_inPlaceSharedBufferIndex;
+        };
+
+        FixedArray<PlannedBuffer> m_buffers;
+        FixedArray<usz> m_sharedBufferMemoryByteCounts;
       };
 
       BufferManager() = default;
       BufferManager(const BufferManager&) = delete;
       BufferManager& operator=(const BufferManager&) = delete;
 
+      // Returns the number of bytes that AddBuffer() will reserve for a buffer with the given properties (excluding buffer guards)
+      static usz CalculateBufferByteCount(PrimitiveType primitiveType, usz nonUpsampledSampleCount, s32 upsampleFactor);
+
       BufferHandle AddBuffer(PrimitiveType primitiveType, usz nonUpsampledSampleCount, s32 upsampleFactor);
       void SetBufferOutputTaskForSharing(BufferHandle bufferHandle, const void* outputTaskForSharing);
+
+      // Readers which aren't native module call tasks (e.g. a stage reading a graph output) must pass canShareWithOutput = false. A buffer is only shared
+      // in-place if every one of its readers allows it.
       void AddBufferInputTask(BufferHandle bufferHandle, const void* inputTask, bool canShareWithOutput);
+
+      // Declares that all other input tasks of this buffer are guaranteed to finish before finalInputTask starts. This allows finalInputTask to share the
+      // buffer with one of its outputs even though the buffer is read by multiple tasks.
+      void SetBufferFinalInputTask(BufferHandle bufferHandle, const void* finalInputTask);
+
       const Buffer& GetBuffer(BufferHandle bufferHandle) const;
 
+      // When isConstant is true, the constant value is captured from the start of buffer memory (or from the start of the sub-block at the given offset when a
+      // buffer is processed as a sequence of sub-blocks)
       void SetBufferConstant(BufferHandle bufferHandle, bool isConstant);
+      void SetBufferConstant(BufferHandle bufferHandle, bool isConstant, usz constantNonUpsampledSampleOffset);
+
+      // Marks the buffer as constant without touching buffer memory
+      template<typename TElement>
+      void SetBufferConstantValue(BufferHandle bufferHandle, TElement value)
+      {
+        BufferData& buffer = m_buffers[usz(bufferHandle)];
+        ASSERT(buffer.m_constantValueMemory != nullptr);
+        if constexpr (std::same_as<TElement, f32>)
+          { ASSERT(buffer.m_primitiveType == PrimitiveTypeFloat); }
+        else if constexpr (std::same_as<TElement, f64>)
+          { ASSERT(buffer.m_primitiveType == PrimitiveTypeDouble); }
+        else if constexpr (std::same_as<TElement, s32>)
+          { ASSERT(buffer.m_primitiveType == PrimitiveTypeInt); }
+        else if constexpr (std::same_as<TElement, bool>)
+          { ASSERT(buffer.m_primitiveType == PrimitiveTypeBool); }
+        else
+          { ASSERT(AlwaysFalse<TElement>, "Unsupported element type"); }
+
+        if constexpr (std::same_as<TElement, bool>)
+          { Span(static_cast<u8*>(buffer.m_constantValueMemory), BufferConstantValueByteCount).Fill(value ? 0xff_u8 : 0x00_u8); }
+        else
+          { Span(static_cast<TElement*>(buffer.m_constantValueMemory), BufferConstantValueByteCount / sizeof(TElement)).Fill(value); }
+
+        buffer.m_isConstant = true;
+      }
+
+      // Points a buffer at memory it doesn't own (such as a host channel buffer) in place of its allocated memory until ClearBufferExternalMemory() is called.
+      // The memory must be aligned to MaxSimdAlignment and byteCount must be a multiple of MaxSimdAlignment so that native modules can process whole
+      // vectors. The buffer must not share its memory in-place with any other buffer. Buffer guards don't cover external memory.
+      void SetBufferExternalMemory(BufferHandle bufferHandle, void* memory, usz byteCount);
+
+      // Restores a buffer's allocated memory. This does nothing if the buffer isn't using external memory.
+      void ClearBufferExternalMemory(BufferHandle bufferHandle);
+
+      // Returns the smallest non-upsampled sample count which spans a multiple of MaxSimdAlignment bytes within the buffer. Sub-blocks must start at multiples
+      // of this value so that native modules always receive aligned memory.
+      usz GetBufferSampleOffsetAlignment(BufferHandle bufferHandle) const;
 
       Span<InputFloatBuffer> AddFloatBufferArray(usz count);
       Span<InputDoubleBuffer> AddDoubleBufferArray(usz count);
@@ -77,6 +220,25 @@ namespace Chord
       void SetBufferConcurrentWithAll(BufferHandle bufferHandle);
       void AllocateBuffers();
 
+      // Allocates buffers using a plan retrieved from GetAllocationPlan() on a previous run. Buffer concurrency does not need to be declared. Returns false
+      // without allocating anything if the plan doesn't describe the current buffers, in which case AllocateBuffers() should be used instead.
+      bool TryAllocateBuffers(const AllocationPlan& plan);
+      AllocationPlan GetAllocationPlan() const;
+
+      // These can be used after buffers are allocated to determine how effectively buffer memory was shared. The allocated byte count excludes buffer guards.
+      usz GetBufferCount() const
+        { return m_buffers.Count(); }
+      usz GetAllocatedByteCount() const
+        { return m_allocatedByteCount; }
+      usz GetUnsharedByteCount() const;
+      usz GetConstantValueByteCount() const
+        { return m_buffers.Count() * BufferConstantValueByteCount; }
+
+      // Returns the number of bytes used to track buffers, buffer arrays, and buffer concurrency
+      usz GetMetadataByteCount() const;
+      static usz EstimateMetadataByteCount(usz bufferCount);
+      BufferSharingDiagnostic GetBufferSharingDiagnostic(BufferHandle bufferHandle) const;
+
       #if BUFFER_GUARDS_ENABLED
         void StartProcessing(usz sampleCount);
         void FinishProcessing();
@@ -101,20 +263,35 @@ namespace Chord
       #endif
 
     private:
+      struct InputTaskUsage
+      {
+        const void* m_task = nullptr;
+        bool m_canShareWithOutput = false;
+      };
+
       struct BufferData : public Buffer
       {
         // These fields are used to determine whether an input buffer can be shared with an output buffer within the same task. This is allowed as an
         // optimization for operations like a = b + 1, where a and b are being iterated at the same time and each element in a will never be re-read. In order
-        // to be able to do this, the input buffer must only be used one time in exactly one task; it cannot branch off to another task or to a different input
-        // within the same task.
+        // to be able to do this, the input buffer must be used only one time in the task where it is last used; it cannot branch off to a different input
+        // within the same task or to another task which may run at the same time. m_inputTaskForSharing is resolved from the other fields when buffers are
+        // allocated.
         const void* m_outputTaskForSharing = nullptr;
+        UnboundedArray<InputTaskUsage> m_inputTaskUsages;
+        const void* m_finalInputTask = nullptr;
         const void* m_inputTaskForSharing = nullptr;
-        usz m_inputTaskUsageCount = 0;
 
         bool m_isSharedAsOutput = false;
         bool m_isSharedAsInput = false;
+        InPlaceSharingResult m_inPlaceOutputSharingResult = InPlaceSharingResult::NotApplicable;
+        InPlaceSharingResult m_inPlaceInputSharingResult = InPlaceSharingResult::NotApplicable;
+        std::optional<usz> m_inPlaceSharedBufferIndex;
 
         usz m_sharedBufferMemoryIndex = 0;
+
+        // While a buffer uses external memory, m_byteCount describes the external memory so the allocated byte count is saved here
+        bool m_usesExternalMemory = false;
+        usz m_allocatedBufferByteCount = 0;
       };
 
       struct SharedBufferMemory
@@ -128,13 +305,23 @@ namespace Chord
         #if BUFFER_GUARDS_ENABLED
           Span<u8> m_memoryWithGuard;
 
+          // Buffers iterated at different rates can share memory in-place (e.g. a bool output written over a float input) so the guard area must start after
+          // the largest buffer within the memory
+          usz m_maxUpsampledElementBitCount = 0;
+
           std::atomic<const void*> m_writeTask = nullptr;
           std::atomic<const void*> m_readTask = nullptr;
           std::atomic<usz> m_readCount = 0;
         #endif
       };
 
-      bool CanBuffersShareMemoryWithinTask(usz bufferIndexA, usz bufferIndexB) const;
+      #if BUFFER_GUARDS_ENABLED
+        usz CalculateGuardOffset(const SharedBufferMemory& sharedBufferMemory) const;
+      #endif
+
+      void AllocateSharedBufferMemory(Span<const usz> sharedBufferMemoryByteCounts);
+      InPlaceSharingResult ResolveInputTaskForSharing(BufferData& buffer) const;
+      bool CanBuffersShareMemoryWithinTask(usz outputBufferIndex, usz inputBufferIndex, bool allowNarrowerOutput) const;
       bool CanBuffersShareMemoryAcrossTasks(usz bufferIndexA, usz bufferIndexB) const;
 
       UnboundedArray<BufferData> m_buffers;
@@ -146,6 +333,8 @@ namespace Chord
       UnboundedArray<FixedArray<InputBoolBuffer>> m_inputBoolBufferArrays;
 
       BufferMemory m_bufferMemory;
+      BufferMemory m_constantValueMemory;
+      usz m_allocatedByteCount = 0;
       FixedArray<SharedBufferMemory> m_sharedBufferMemoryEntries;
 
       #if BUFFER_GUARDS_ENABLED
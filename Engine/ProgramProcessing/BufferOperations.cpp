@@ -15,13 +15,18 @@ namespace Chord
     Span<const usz> activeVoiceIndices,
     Span<const usz> voiceSampleOffsets,
     BufferManager& bufferManager,
-    usz outputIndex)
+    usz outputIndex,
+    Span<const bool> voiceFadeOuts)
   {
     for (usz voiceIndex : activeVoiceIndices)
     {
       if (voiceSampleOffsets[voiceIndex] != 0)
         { return false; }
 
+      // A fade applies a gain ramp which makes the result non-constant
+      if (!voiceFadeOuts.IsEmpty() && voiceFadeOuts[voiceIndex])
+        { return false; }
+
       const ProgramStageTaskManager& voice = voices[voiceIndex];
       auto output = voice.GetOutput(outputIndex);
       if (auto outputBufferHandle = std::get_if<BufferManager::BufferHandle>(&output); outputBufferHandle != nullptr)
@@ -39,31 +44,79 @@ namespace Chord
   }
 
   template<typename TElement>
-  void AccumulateOutputsAsConstant(
+  TElement AccumulateOutputsAsConstant(
     Span<const ProgramStageTaskManager>& voices,
     Span<const usz> activeVoiceIndices,
     BufferManager& bufferManager,
     usz outputIndex,
-    const BufferManager::Buffer& buffer)
+    Span<f32> voicePeakLevels)
   {
     TElement result = TElement(0);
     for (usz voiceIndex : activeVoiceIndices)
     {
+      TElement value;
       const ProgramStageTaskManager& voice = voices[voiceIndex];
       auto output = voice.GetOutput(outputIndex);
       if (auto outputBufferHandle = std::get_if<BufferManager::BufferHandle>(&output); outputBufferHandle != nullptr)
       {
         bufferManager.StartBufferRead(*outputBufferHandle, nullptr);
         const BufferManager::Buffer& outputBuffer = bufferManager.GetBuffer(*outputBufferHandle);
-        ASSERT(outputBuffer.m_isConstant);
-        result += *static_cast<const TElement*>(outputBuffer.m_memory);
+        value = outputBuffer.GetConstant<TElement>();
         bufferManager.FinishBufferRead(*outputBufferHandle, nullptr);
       }
       else
-        { result += std::get<TElement>(output); }
+        { value = std::get<TElement>(output); }
+
+      result += value;
+      if (!voicePeakLevels.IsEmpty())
+        { voicePeakLevels[voiceIndex] = f32(Abs(value)); }
+    }
+
+    return result;
+  }
+
+  template<typename TElement>
+  void AccumulateVoiceOutputToSamples(
+    const ProgramStageTaskManager& voice,
+    usz voiceIndex,
+    usz voiceSampleOffset,
+    BufferManager& bufferManager,
+    usz outputIndex,
+    Span<TElement> destination,
+    bool isFirstAccumulation,
+    Span<f32> voicePeakLevels,
+    bool fadeOut)
+  {
+    auto output = voice.GetOutput(outputIndex);
+    if (auto outputBufferHandle = std::get_if<BufferManager::BufferHandle>(&output); outputBufferHandle != nullptr)
+    {
+      bufferManager.StartBufferRead(*outputBufferHandle, nullptr);
+      const BufferManager::Buffer& outputBuffer = bufferManager.GetBuffer(*outputBufferHandle);
+
+      // The peak level is measured in the same pass over the voice's samples as accumulation
+      TElement peakLevel = TElement(0);
+      TElement* peakLevelPointer = voicePeakLevels.IsEmpty() ? nullptr : &peakLevel;
+      if (fadeOut)
+        { AccumulateToBufferFadingOut(destination, outputBuffer, isFirstAccumulation, voiceSampleOffset, peakLevelPointer); }
+      else
+        { AccumulateToBuffer(destination, outputBuffer, isFirstAccumulation, voiceSampleOffset, peakLevelPointer); }
+
+      if (!voicePeakLevels.IsEmpty())
+        { voicePeakLevels[voiceIndex] = f32(peakLevel); }
+
+      bufferManager.FinishBufferRead(*outputBufferHandle, nullptr);
     }
+    else
+    {
+      TElement value = std::get<TElement>(output);
+      if (fadeOut)
+        { AccumulateToBufferFadingOut(destination, value, isFirstAccumulation, voiceSampleOffset); }
+      else
+        { AccumulateToBuffer(destination, value, isFirstAccumulation, voiceSampleOffset); }
 
-    buffer.Get<TElement>(BufferConstantValueByteCount / sizeof(TElement)).Fill(result);
+      if (!voicePeakLevels.IsEmpty())
+        { voicePeakLevels[voiceIndex] = f32(Abs(value)); }
+    }
   }
 
   template<typename TElement>
@@ -74,56 +127,175 @@ namespace Chord
     BufferManager& bufferManager,
     usz outputIndex,
     const BufferManager::Buffer& buffer,
-    usz sampleCount)
+    usz sampleCount,
+    Span<f32> voicePeakLevels,
+    Span<const bool> voiceFadeOuts)
   {
     Span<TElement> bufferSamples = buffer.Get<TElement>(sampleCount);
 
     for (usz i = 0; i < activeVoiceIndices.Count(); i++)
     {
       usz voiceIndex = activeVoiceIndices[i];
-      usz voiceSampleOffset = voiceSampleOffsets[voiceIndex];
+      AccumulateVoiceOutputToSamples(
+        voices[voiceIndex],
+        voiceIndex,
+        voiceSampleOffsets[voiceIndex],
+        bufferManager,
+        outputIndex,
+        bufferSamples,
+        i == 0,
+        voicePeakLevels,
+        !voiceFadeOuts.IsEmpty() && voiceFadeOuts[voiceIndex]);
+    }
+  }
 
-      const ProgramStageTaskManager& voice = voices[voiceIndex];
-      auto output = voice.GetOutput(outputIndex);
-      if (auto outputBufferHandle = std::get_if<BufferManager::BufferHandle>(&output); outputBufferHandle != nullptr)
+  // Returns true if any sample's absolute value exceeds the threshold (or reaches it, if inclusive is true). Host buffers may be unaligned so this uses unaligned
+  // loads throughout.
+  template<typename TElement>
+  static bool AnySampleExceedsThreshold(Span<const TElement> samples, TElement threshold, bool inclusive)
+  {
+    using Vector = AccumulationVector<TElement>;
+    Vector thresholdVector = Vector(threshold);
+    usz vectorEndIndex = samples.Count() / Vector::ElementCount * Vector::ElementCount;
+    for (usz sampleIndex = 0; sampleIndex < vectorEndIndex; sampleIndex += Vector::ElementCount)
+    {
+      Vector value = Abs(Vector::LoadUnaligned(samples, sampleIndex));
+      if (TestMaskAny(inclusive ? value >= thresholdVector : value > thresholdVector))
+        { return true; }
+    }
+
+    for (usz sampleIndex = vectorEndIndex; sampleIndex < samples.Count(); sampleIndex++)
+    {
+      TElement value = Abs(samples[sampleIndex]);
+      if (inclusive ? value >= threshold : value > threshold)
+        { return true; }
+    }
+
+    return false;
+  }
+
+  template<typename TReadSample>
+  static bool AnyStridedSampleExceedsThreshold(usz sampleCount, f64 threshold, TReadSample&& readSample)
+  {
+    for (usz sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++)
+    {
+      if (Abs(readSample(sampleIndex)) > threshold)
+        { return true; }
+    }
+
+    return false;
+  }
+
+  SampleStatistics MeasureInputChannelBuffer(const InputChannelBuffer& inputChannelBuffer, usz blockSampleOffset, usz blockSampleCount)
+  {
+    usz sampleStride = inputChannelBuffer.m_sampleStride;
+    usz byteStride = sampleStride * SampleTypeSize(inputChannelBuffer.m_sampleType);
+    const u8* sourceBytes = inputChannelBuffer.m_samples.Elements() + blockSampleOffset * byteStride;
+
+    auto MeasureStridedSamples = [&](auto&& readSample)
+    {
+      SampleStatistics statistics = { .m_sampleCount = blockSampleCount };
+      for (usz sampleIndex = 0; sampleIndex < blockSampleCount; sampleIndex++)
       {
-        bufferManager.StartBufferRead(*outputBufferHandle, nullptr);
-        AccumulateToBuffer(bufferSamples, bufferManager.GetBuffer(*outputBufferHandle), i == 0, voiceSampleOffset);
-        bufferManager.FinishBufferRead(*outputBufferHandle, nullptr);
+        f64 value = readSample(sampleIndex);
+        statistics.m_peak = Max(statistics.m_peak, Abs(value));
+        statistics.m_sumOfSquares += value * value;
       }
-      else
-        { AccumulateToBuffer(bufferSamples, std::get<TElement>(output), i == 0, voiceSampleOffset); }
+
+      return statistics;
+    };
+
+    auto MeasureFloatSamples = [&]<typename TElement>()
+    {
+      const TElement* source = reinterpret_cast<const TElement*>(sourceBytes);
+      if (sampleStride == 1)
+        { return MeasureSamples(Span(source, blockSampleCount)); }
+      return MeasureStridedSamples([&](usz sampleIndex) { return f64(source[sampleIndex * sampleStride]); });
+    };
+
+    auto MeasureIntegerSamples = [&]<SampleType TSampleType>()
+    {
+      f64 scale = 1.0 / IntegerSampleFullScale(TSampleType);
+      return MeasureStridedSamples(
+        [&](usz sampleIndex) { return f64(ReadIntegerSample<TSampleType>(sourceBytes + sampleIndex * byteStride)) * scale; });
+    };
+
+    switch (inputChannelBuffer.m_sampleType)
+    {
+    case SampleType::Float32:
+      return MeasureFloatSamples.template operator()<f32>();
+
+    case SampleType::Float64:
+      return MeasureFloatSamples.template operator()<f64>();
+
+    case SampleType::Int16:
+      return MeasureIntegerSamples.template operator()<SampleType::Int16>();
+
+    case SampleType::Int24:
+      return MeasureIntegerSamples.template operator()<SampleType::Int24>();
+
+    case SampleType::Int32:
+      return MeasureIntegerSamples.template operator()<SampleType::Int32>();
+
+    default:
+      ASSERT(false, "Unsupported sample type");
     }
+
+    return {};
   }
 
   bool ShouldActivateEffect(const InputChannelBuffer& inputChannelBuffer, f64 effectActivationThreshold, usz blockSampleOffset, usz blockSampleCount)
   {
+    usz sampleStride = inputChannelBuffer.m_sampleStride;
+    usz byteStride = sampleStride * SampleTypeSize(inputChannelBuffer.m_sampleType);
+    const u8* sourceBytes = inputChannelBuffer.m_samples.Elements() + blockSampleOffset * byteStride;
+
+    // Integer samples are compared exactly (in f64) against the threshold scaled to full scale
+    auto IntegerSampleExceedsThreshold = [&]<SampleType TSampleType>()
+    {
+      f64 threshold = effectActivationThreshold * IntegerSampleFullScale(TSampleType);
+      return AnyStridedSampleExceedsThreshold(
+        blockSampleCount,
+        threshold,
+        [&](usz sampleIndex) { return f64(ReadIntegerSample<TSampleType>(sourceBytes + sampleIndex * byteStride)); });
+    };
+
     switch (inputChannelBuffer.m_sampleType)
     {
     case SampleType::Float32:
       {
-        auto source = Span(reinterpret_cast<const f32*>(inputChannelBuffer.m_samples.Elements()), inputChannelBuffer.m_samples.Count() * sizeof(f32));
-        auto sourceBlock = Span(source, blockSampleOffset, blockSampleCount);
-        for (f32 value : sourceBlock)
+        const f32* source = reinterpret_cast<const f32*>(sourceBytes);
+        if (sampleStride != 1)
         {
-          if (Abs(value) > effectActivationThreshold)
-            { return true; }
+          return AnyStridedSampleExceedsThreshold(
+            blockSampleCount,
+            effectActivationThreshold,
+            [&](usz sampleIndex) { return f64(source[sampleIndex * sampleStride]); });
         }
-        break;
+
+        // Compare in f32 so that twice as many samples fit in a vector. An f32 sample exceeds the f64 threshold exactly when it exceeds the nearest f32 value
+        // or, if rounding moved the threshold up, when it reaches the rounded threshold.
+        f32 threshold = f32(effectActivationThreshold);
+        return AnySampleExceedsThreshold(Span(source, blockSampleCount), threshold, f64(threshold) > effectActivationThreshold);
       }
 
     case SampleType::Float64:
       {
-        auto source = Span(reinterpret_cast<const f64*>(inputChannelBuffer.m_samples.Elements()), inputChannelBuffer.m_samples.Count() * sizeof(f64));
-        auto sourceBlock = Span(source, blockSampleOffset, blockSampleCount);
-        for (f64 value : sourceBlock)
-        {
-          if (Abs(value) > effectActivationThreshold)
-            { return true; }
-        }
-        break;
+        const f64* source = reinterpret_cast<const f64*>(sourceBytes);
+        if (sampleStride != 1)
+          { return AnyStridedSampleExceedsThreshold(blockSampleCount, effectActivationThreshold, [&](usz sampleIndex) { return source[sampleIndex * sampleStride]; }); }
+        return AnySampleExceedsThreshold(Span(source, blockSampleCount), effectActivationThreshold, false);
       }
 
+    case SampleType::Int16:
+      return IntegerSampleExceedsThreshold.template operator()<SampleType::Int16>();
+
+    case SampleType::Int24:
+      return IntegerSampleExceedsThreshold.template operator()<SampleType::Int24>();
+
+    case SampleType::Int32:
+      return IntegerSampleExceedsThreshold.template operator()<SampleType::Int32>();
+
     default:
       ASSERT(false, "Unsupported sample type");
     }
@@ -140,10 +312,21 @@ namespace Chord
     Span<const u8> byteValues = buffer.Get<u8>(sampleCount);
 
     if (buffer.m_isConstant)
-      { return (byteValues[0] & 1) != 0; }
+      { return buffer.GetConstant<bool>(); }
 
+    // Compare whole vectors of bytes against all ones first, then finish with the remaining bytes
     usz fullByteCount = sampleCount / 8;
-    for (usz byteIndex = 0; byteIndex < fullByteCount; byteIndex++)
+    static constexpr usz VectorByteCount = s32xM::ElementCount * sizeof(s32);
+    usz vectorEndByteIndex = fullByteCount / VectorByteCount * VectorByteCount;
+    auto words = Span(reinterpret_cast<const s32*>(byteValues.Elements()), vectorEndByteIndex / sizeof(s32));
+    s32xM allOnes = s32xM(-1);
+    for (usz wordIndex = 0; wordIndex < words.Count(); wordIndex += s32xM::ElementCount)
+    {
+      if (TestMaskAny(s32xM::LoadUnaligned(words, wordIndex) != allOnes))
+        { return false; }
+    }
+
+    for (usz byteIndex = vectorEndByteIndex; byteIndex < fullByteCount; byteIndex++)
     {
       if (byteValues[byteIndex] != 0xff_u8)
         { return false; }
@@ -161,6 +344,35 @@ namespace Chord
     return value == 0xff_u8;
   }
 
+  void ExpandConstantBuffer(const BufferManager::Buffer& buffer, usz sampleCount)
+  {
+    switch (buffer.m_primitiveType)
+    {
+    case PrimitiveTypeFloat:
+      buffer.Get<f32>(sampleCount).Fill(buffer.GetConstant<f32>());
+      break;
+
+    case PrimitiveTypeDouble:
+      buffer.Get<f64>(sampleCount).Fill(buffer.GetConstant<f64>());
+      break;
+
+    case PrimitiveTypeInt:
+      buffer.Get<s32>(sampleCount).Fill(buffer.GetConstant<s32>());
+      break;
+
+    case PrimitiveTypeBool:
+      buffer.Get<u8>(sampleCount).Fill(buffer.GetConstant<bool>() ? 0xff_u8 : 0x00_u8);
+      break;
+
+    case PrimitiveTypeString:
+      ASSERT(false);
+      break;
+
+    default:
+      ASSERT(false);
+    }
+  }
+
   void AccumulateVoiceOutputs(
     Span<const ProgramStageTaskManager> voices,
     Span<const usz> activeVoiceIndices,
@@ -168,56 +380,163 @@ namespace Chord
     BufferManager& bufferManager,
     usz outputIndex,
     BufferManager::BufferHandle bufferHandle,
-    usz sampleCount)
+    usz sampleCount,
+    Span<f32> voicePeakLevels,
+    Span<const bool> voiceFadeOuts)
   {
     bufferManager.StartBufferWrite(bufferHandle, nullptr);
     const BufferManager::Buffer& buffer = bufferManager.GetBuffer(bufferHandle);
 
-    if (activeVoiceIndices.IsEmpty())
+    // If all voices have 0 offset and are constant (including when no voices are active), we can simply sum up constants without touching buffer memory
+    bool canAccumulateOutputsAsConstant = CanAccumulateOutputsAsConstant(
+      voices,
+      activeVoiceIndices,
+      voiceSampleOffsets,
+      bufferManager,
+      outputIndex,
+      voiceFadeOuts);
+    auto Accumulate =
+      [&]<typename TElement>()
+      {
+        if (canAccumulateOutputsAsConstant)
+          { bufferManager.SetBufferConstantValue(bufferHandle, AccumulateOutputsAsConstant<TElement>(voices, activeVoiceIndices, bufferManager, outputIndex, voicePeakLevels)); }
+        else
+        {
+          AccumulateOutputsAsNonConstant<TElement>(
+            voices,
+            activeVoiceIndices,
+            voiceSampleOffsets,
+            bufferManager,
+            outputIndex,
+            buffer,
+            sampleCount,
+            voicePeakLevels,
+            voiceFadeOuts);
+          bufferManager.SetBufferConstant(bufferHandle, false);
+        }
+      };
+
+    switch (buffer.m_primitiveType)
     {
-      // If no voices are active, we can simply set the buffer to a zero constant value
-      Span<u8> constantValue = { static_cast<u8*>(buffer.m_memory), BufferConstantValueByteCount };
-      constantValue.ZeroElements();
-      bufferManager.SetBufferConstant(bufferHandle, true);
+    case PrimitiveTypeFloat:
+      Accumulate.operator()<f32>();
+      break;
+
+    case PrimitiveTypeDouble:
+      Accumulate.operator()<f64>();
+      break;
+
+    case PrimitiveTypeInt:
+      Accumulate.operator()<s32>();
+      break;
+
+    case PrimitiveTypeBool:
+    case PrimitiveTypeString:
+      ASSERT(false);
+      break;
+
+    default:
+      ASSERT(false);
+      break;
     }
-    else
+
+    bufferManager.FinishBufferWrite(bufferHandle, nullptr);
+  }
+
+  void AccumulateVoiceOutputToPartialSum(
+    const ProgramStageTaskManager& voice,
+    usz voiceIndex,
+    usz voiceSampleOffset,
+    BufferManager& bufferManager,
+    usz outputIndex,
+    const BufferManager::Buffer& partialSum,
+    bool isFirstAccumulation,
+    usz sampleCount,
+    Span<f32> voicePeakLevels,
+    bool fadeOut)
+  {
+    ASSERT(!partialSum.m_isConstant);
+    auto Accumulate =
+      [&]<typename TElement>()
+      {
+        AccumulateVoiceOutputToSamples(
+          voice,
+          voiceIndex,
+          voiceSampleOffset,
+          bufferManager,
+          outputIndex,
+          partialSum.Get<TElement>(sampleCount),
+          isFirstAccumulation,
+          voicePeakLevels,
+          fadeOut);
+      };
+
+    switch (partialSum.m_primitiveType)
     {
-      // If all voices have 0 offset and are constant, we can simply sum up constants
-      bool canAccumulateOutputsAsConstant = CanAccumulateOutputsAsConstant(voices, activeVoiceIndices, voiceSampleOffsets, bufferManager, outputIndex);
-      switch (buffer.m_primitiveType)
+    case PrimitiveTypeFloat:
+      Accumulate.operator()<f32>();
+      break;
+
+    case PrimitiveTypeDouble:
+      Accumulate.operator()<f64>();
+      break;
+
+    case PrimitiveTypeInt:
+      Accumulate.operator()<s32>();
+      break;
+
+    case PrimitiveTypeBool:
+    case PrimitiveTypeString:
+      ASSERT(false);
+      break;
+
+    default:
+      ASSERT(false);
+      break;
+    }
+  }
+
+  void ReduceVoiceOutputPartialSums(
+    BufferManager& bufferManager,
+    BufferManager::BufferHandle bufferHandle,
+    Span<const BufferManager::Buffer> partialSums,
+    Span<const bool> partialSumsAccumulated,
+    usz sampleCount)
+  {
+    bufferManager.StartBufferWrite(bufferHandle, nullptr);
+    const BufferManager::Buffer& buffer = bufferManager.GetBuffer(bufferHandle);
+
+    auto Reduce =
+      [&]<typename TElement>()
       {
-      case PrimitiveTypeFloat:
-        if (canAccumulateOutputsAsConstant)
-          { AccumulateOutputsAsNonConstant<f32>(voices, activeVoiceIndices, voiceSampleOffsets, bufferManager, outputIndex, buffer, sampleCount); }
+        if (ReducePartialSums(buffer.Get<TElement>(sampleCount), partialSums, partialSumsAccumulated))
+          { bufferManager.SetBufferConstant(bufferHandle, false); }
         else
-          { AccumulateOutputsAsConstant<f32>(voices, activeVoiceIndices, bufferManager, outputIndex, buffer); }
-        break;
+          { bufferManager.SetBufferConstantValue(bufferHandle, TElement(0)); }
+      };
 
-      case PrimitiveTypeDouble:
-        if (canAccumulateOutputsAsConstant)
-          { AccumulateOutputsAsNonConstant<f64>(voices, activeVoiceIndices, voiceSampleOffsets, bufferManager, outputIndex, buffer, sampleCount); }
-        else
-          { AccumulateOutputsAsConstant<f64>(voices, activeVoiceIndices, bufferManager, outputIndex, buffer); }
-        break;
+    switch (buffer.m_primitiveType)
+    {
+    case PrimitiveTypeFloat:
+      Reduce.operator()<f32>();
+      break;
 
-      case PrimitiveTypeInt:
-        if (canAccumulateOutputsAsConstant)
-          { AccumulateOutputsAsNonConstant<s32>(voices, activeVoiceIndices, voiceSampleOffsets, bufferManager, outputIndex, buffer, sampleCount); }
-        else
-          { AccumulateOutputsAsConstant<s32>(voices, activeVoiceIndices, bufferManager, outputIndex, buffer); }
-        break;
+    case PrimitiveTypeDouble:
+      Reduce.operator()<f64>();
+      break;
 
-      case PrimitiveTypeBool:
-      case PrimitiveTypeString:
-        ASSERT(false);
-        break;
+    case PrimitiveTypeInt:
+      Reduce.operator()<s32>();
+      break;
 
-      default:
-        ASSERT(false);
-        break;
-      }
+    case PrimitiveTypeBool:
+    case PrimitiveTypeString:
+      ASSERT(false);
+      break;
 
-      bufferManager.SetBufferConstant(bufferHandle, canAccumulateOutputsAsConstant);
+    default:
+      ASSERT(false);
+      break;
     }
 
     bufferManager.FinishBufferWrite(bufferHandle, nullptr);
@@ -227,72 +546,26 @@ namespace Chord
     const OutputChannelBuffer& outputChannelBuffer,
     const BufferManager::Buffer& sourceBuffer,
     usz blockSampleOffset,
-    usz blockSampleCount)
+    usz blockSampleCount,
+    u32* ditherState)
   {
     ASSERT(!sourceBuffer.m_isConstant);
-    switch (outputChannelBuffer.m_sampleType)
+    switch (sourceBuffer.m_primitiveType)
     {
-    case SampleType::Float32:
-      {
-        auto samples = Span(reinterpret_cast<f32*>(outputChannelBuffer.m_samples.Elements()), outputChannelBuffer.m_samples.Count() * sizeof(f32));
-        auto destination = Span(samples, blockSampleOffset, blockSampleCount);
-
-        switch (sourceBuffer.m_primitiveType)
-        {
-        case PrimitiveTypeFloat:
-          destination.CopyElementsFrom(sourceBuffer.Get<f32>(blockSampleCount));
-          break;
-
-        case PrimitiveTypeDouble:
-          {
-            Span<const f64> sourceSamples = sourceBuffer.Get<f64>(blockSampleCount);
-            for (usz i = 0; i < destination.Count(); i++)
-              { destination[i] = f32(sourceSamples[i]); }
-            break;
-          }
-
-        case PrimitiveTypeInt:
-        case PrimitiveTypeBool:
-        case PrimitiveTypeString:
-        default:
-          ASSERT(false);
-          break;
-        }
-
-        break;
-      }
-
-    case SampleType::Float64:
-      {
-        auto samples = Span(reinterpret_cast<f64*>(outputChannelBuffer.m_samples.Elements()), outputChannelBuffer.m_samples.Count() * sizeof(f64));
-        auto destination = Span(samples, blockSampleOffset, blockSampleCount);
+    case PrimitiveTypeFloat:
+      WriteOutputChannelBufferSamples(outputChannelBuffer, Span<const f32>(sourceBuffer.Get<f32>(blockSampleCount)), blockSampleOffset, ditherState);
+      break;
 
-        switch (sourceBuffer.m_primitiveType)
-        {
-        case PrimitiveTypeFloat:
-          {
-            Span<const f32> sourceSamples = sourceBuffer.Get<f32>(blockSampleCount);
-            for (usz i = 0; i < destination.Count(); i++)
-              { destination[i] = f32(sourceSamples[i]); }
-            break;
-          }
-
-        case PrimitiveTypeDouble:
-          destination.CopyElementsFrom(sourceBuffer.Get<f64>(blockSampleCount));
-          break;
-
-        case PrimitiveTypeInt:
-        case PrimitiveTypeBool:
-        case PrimitiveTypeString:
-        default:
-          ASSERT(false);
-          break;
-        }
-      }
+    case PrimitiveTypeDouble:
+      WriteOutputChannelBufferSamples(outputChannelBuffer, Span<const f64>(sourceBuffer.Get<f64>(blockSampleCount)), blockSampleOffset, ditherState);
       break;
 
+    case PrimitiveTypeInt:
+    case PrimitiveTypeBool:
+    case PrimitiveTypeString:
     default:
-      ASSERT(false, "Unsupported sample type");
+      ASSERT(false);
+      break;
     }
   }
 }
\ No newline at end of file
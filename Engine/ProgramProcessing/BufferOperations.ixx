@@ -1,5 +1,7 @@
 export module Chord.Engine:ProgramProcessing.BufferOperations;
 
+import std;
+
 import Chord.Foundation;
 import :ProgramProcessing.BufferManager;
 import :ProgramProcessing.ProgramProcessorTypes;
@@ -9,6 +11,145 @@ namespace Chord
 {
   export
   {
+    // Returns the number of leading elements which must be processed before the remaining elements are aligned to the given alignment. If the remaining
+    // elements can never become aligned, all elements are leading elements.
+    template<typename TElement>
+    usz CountUnalignedLeadingElements(const TElement* elements, usz elementCount, usz alignment)
+    {
+      usz misalignment = usz(std::uintptr_t(elements) & (alignment - 1));
+      if (misalignment == 0)
+        { return 0; }
+      if (misalignment % sizeof(TElement) != 0)
+        { return elementCount; }
+      return Min((alignment - misalignment) / sizeof(TElement), elementCount);
+    }
+
+    // Engine buffers are always SIMD-aligned but host channel buffers and voice outputs at a sample offset may not be. This calls scalarIteration(sampleIndex)
+    // for leading samples until destination is aligned for TVector, then vectorIteration(sampleIndex) for each whole vector of samples (with destination
+    // aligned), then scalarIteration for the remaining samples. Sources should be read with unaligned loads.
+    template<typename TVector, typename TElement, typename TScalarIteration, typename TVectorIteration>
+    void IterateSamplesVectorized(Span<TElement> destination, TScalarIteration&& scalarIteration, TVectorIteration&& vectorIteration)
+    {
+      usz headCount = CountUnalignedLeadingElements(destination.Elements(), destination.Count(), alignof(TVector));
+      usz vectorEndIndex = headCount + (destination.Count() - headCount) / TVector::ElementCount * TVector::ElementCount;
+
+      for (usz sampleIndex = 0; sampleIndex < headCount; sampleIndex++)
+        { scalarIteration(sampleIndex); }
+      for (usz sampleIndex = headCount; sampleIndex < vectorEndIndex; sampleIndex += TVector::ElementCount)
+        { vectorIteration(sampleIndex); }
+      for (usz sampleIndex = vectorEndIndex; sampleIndex < destination.Count(); sampleIndex++)
+        { scalarIteration(sampleIndex); }
+    }
+
+    template<typename TDestination, typename TSource>
+    void ConvertSamples(Span<TDestination> destination, Span<const TSource> source)
+    {
+      ASSERT(destination.Count() == source.Count());
+      if constexpr (std::same_as<TDestination, TSource>)
+        { destination.CopyElementsFrom(source); }
+      else
+      {
+        // Conversions between f32 and f64 change the vector width so use 4 elements for both sides
+        using DestinationVector = Vector<TDestination, 4>;
+        using SourceVector = Vector<TSource, 4>;
+        IterateSamplesVectorized<DestinationVector>(
+          destination,
+          [&](usz sampleIndex) { destination[sampleIndex] = TDestination(source[sampleIndex]); },
+          [&](usz sampleIndex)
+            { DestinationVector(SourceVector::LoadUnaligned(source, sampleIndex)).StoreAligned(destination, sampleIndex); });
+      }
+    }
+
+    // Integer samples are divided by this value to normalize them to [-1, 1)
+    constexpr f64 IntegerSampleFullScale(SampleType sampleType)
+    {
+      switch (sampleType)
+      {
+      case SampleType::Int16:
+        return f64(1_s32 << 15);
+
+      case SampleType::Int24:
+        return f64(1_s32 << 23);
+
+      case SampleType::Int32:
+        return f64(1_s64 << 31);
+
+      default:
+        ASSERT(false, "Not an integer sample type");
+        return 1.0;
+      }
+    }
+
+    template<SampleType TSampleType>
+    s32 ReadIntegerSample(const u8* source)
+    {
+      if constexpr (TSampleType == SampleType::Int16)
+        { return s16(u16(source[0]) | u16(source[1] << 8)); }
+      else if constexpr (TSampleType == SampleType::Int24)
+      {
+        // Place the sample in the upper 3 bytes and shift it back down to sign-extend it
+        return s32(u32(source[0]) << 8 | u32(source[1]) << 16 | u32(source[2]) << 24) >> 8;
+      }
+      else
+      {
+        static_assert(TSampleType == SampleType::Int32);
+        return s32(u32(source[0]) | u32(source[1]) << 8 | u32(source[2]) << 16 | u32(source[3]) << 24);
+      }
+    }
+
+    template<SampleType TSampleType>
+    void WriteIntegerSample(u8* destination, s32 value)
+    {
+      static_assert(TSampleType == SampleType::Int16 || TSampleType == SampleType::Int24 || TSampleType == SampleType::Int32);
+      destination[0] = u8(value);
+      destination[1] = u8(value >> 8);
+      if constexpr (TSampleType != SampleType::Int16)
+        { destination[2] = u8(value >> 16); }
+      if constexpr (TSampleType == SampleType::Int32)
+        { destination[3] = u8(value >> 24); }
+    }
+
+    // Returns triangular (TPDF) dither in (-1, 1) and advances the generator state. This is a plain LCG which is more than random enough for dither.
+    inline f64 NextTriangularDither(u32& state)
+    {
+      auto NextUniform = [&]()
+      {
+        state = state * 1664525_u32 + 1013904223_u32;
+        return f64(state) * (1.0 / 4294967296.0);
+      };
+
+      f64 a = NextUniform();
+      return a - NextUniform();
+    }
+
+    // Converts the samples returned by readSample(sampleIndex) into destination, multiplying integer samples by scale. Host samples may be interleaved or
+    // 3 bytes wide so each vector is assembled from scalar reads, but conversion, scaling, and stores are vectorized so that deinterleaving and conversion
+    // happen in a single pass over the host buffer.
+    template<typename TDestination, typename TSource, typename TReadSample>
+    void ConvertStridedSamples(Span<TDestination> destination, TDestination scale, TReadSample&& readSample)
+    {
+      using DestinationVector = Vector<TDestination, 4>;
+      using SourceVector = Vector<TSource, 4>;
+      DestinationVector scaleVector = DestinationVector(scale);
+      IterateSamplesVectorized<DestinationVector>(
+        destination,
+        [&](usz sampleIndex)
+        {
+          if constexpr (std::integral<TSource>)
+            { destination[sampleIndex] = TDestination(readSample(sampleIndex)) * scale; }
+          else
+            { destination[sampleIndex] = TDestination(readSample(sampleIndex)); }
+        },
+        [&](usz sampleIndex)
+        {
+          SourceVector source = { readSample(sampleIndex), readSample(sampleIndex + 1), readSample(sampleIndex + 2), readSample(sampleIndex + 3) };
+          if constexpr (std::integral<TSource>)
+            { (DestinationVector(source) * scaleVector).StoreAligned(destination, sampleIndex); }
+          else
+            { DestinationVector(source).StoreAligned(destination, sampleIndex); }
+        });
+    }
+
     template<typename TElement>
     void InitializeFromInputChannelBuffer(
       const InputChannelBuffer& inputChannelBuffer,
@@ -17,42 +158,176 @@ namespace Chord
       usz blockSampleCount)
     {
       auto destination = buffer.Get<TElement>(blockSampleCount);
+      usz sampleStride = inputChannelBuffer.m_sampleStride;
+      usz byteStride = sampleStride * SampleTypeSize(inputChannelBuffer.m_sampleType);
+      ASSERT(
+        blockSampleOffset * byteStride + ChannelBufferByteCount(inputChannelBuffer.m_sampleType, sampleStride, blockSampleCount)
+          <= inputChannelBuffer.m_samples.Count());
+      const u8* sourceBytes = inputChannelBuffer.m_samples.Elements() + blockSampleOffset * byteStride;
+
+      auto ConvertFloatSamples = [&]<typename TSource>()
+      {
+        // Interleaved float channels still start on a whole float so they can be read as floats
+        const TSource* source = reinterpret_cast<const TSource*>(sourceBytes);
+        if (sampleStride == 1)
+          { ConvertSamples(destination, Span(source, blockSampleCount)); }
+        else
+          { ConvertStridedSamples<TElement, TSource>(destination, TElement(1), [&](usz sampleIndex) { return source[sampleIndex * sampleStride]; }); }
+      };
+
+      auto ConvertIntegerSamples = [&]<SampleType TSampleType>()
+      {
+        ConvertStridedSamples<TElement, s32>(
+          destination,
+          TElement(1.0 / IntegerSampleFullScale(TSampleType)),
+          [&](usz sampleIndex) { return ReadIntegerSample<TSampleType>(sourceBytes + sampleIndex * byteStride); });
+      };
+
       switch (inputChannelBuffer.m_sampleType)
       {
       case SampleType::Float32:
-        {
-          auto source = Span(reinterpret_cast<const f32*>(inputChannelBuffer.m_samples.Elements()), inputChannelBuffer.m_samples.Count() * sizeof(f32));
-          if constexpr (std::same_as<TElement, f32>)
-            { destination.CopyElementsFrom(Span(source, blockSampleOffset, blockSampleCount)); }
-          else
-          {
-            for (usz i = 0; i < blockSampleCount; i++)
-              { destination[i] = source[blockSampleOffset + i]; }
-          }
-          break;
-        }
+        ConvertFloatSamples.template operator()<f32>();
+        break;
 
       case SampleType::Float64:
-        {
-          auto source = Span(reinterpret_cast<const f64*>(inputChannelBuffer.m_samples.Elements()), inputChannelBuffer.m_samples.Count() * sizeof(f64));
-          if constexpr (std::same_as<TElement, f32>)
-          {
-            for (usz i = 0; i < blockSampleCount; i++)
-              { destination[i] = f32(source[blockSampleOffset + i]); }
-          }
-          else
-            { destination.CopyElementsFrom(Span(source, blockSampleOffset, blockSampleCount)); }
-          break;
-        }
+        ConvertFloatSamples.template operator()<f64>();
+        break;
+
+      case SampleType::Int16:
+        ConvertIntegerSamples.template operator()<SampleType::Int16>();
+        break;
+
+      case SampleType::Int24:
+        ConvertIntegerSamples.template operator()<SampleType::Int24>();
+        break;
+
+      case SampleType::Int32:
+        ConvertIntegerSamples.template operator()<SampleType::Int32>();
+        break;
 
       default:
         ASSERT(false, "Unsupported sample type");
       }
     }
 
+    template<typename TElement>
+    using AccumulationVector = std::conditional_t<std::same_as<TElement, f32>, f32xM, std::conditional_t<std::same_as<TElement, f64>, f64xM, s32xM>>;
+
+    // Measures the peak and sum of squares in a single pass using a vector max-abs reduction alongside a vector sum of squares. The sum of squares is always
+    // accumulated in f64 (f32 samples are widened before squaring) so that it matches the precision of the scalar tail.
+    template<typename TElement>
+    SampleStatistics MeasureSamples(Span<const TElement> samples)
+    {
+      using Vector = AccumulationVector<TElement>;
+      using SumOfSquaresVector = AccumulationVector<f64>;
+      Vector peak = Zero;
+      SumOfSquaresVector sumOfSquares = Zero;
+      usz vectorEndIndex = samples.Count() / Vector::ElementCount * Vector::ElementCount;
+      for (usz sampleIndex = 0; sampleIndex < vectorEndIndex; sampleIndex += Vector::ElementCount)
+      {
+        Vector value = Vector::LoadUnaligned(samples, sampleIndex);
+        peak = Max(peak, Abs(value));
+        if constexpr (std::same_as<TElement, f32>)
+        {
+          static_assert(SumOfSquaresVector::ElementCount * 2 == Vector::ElementCount);
+          auto [lower, upper] = value.WidenAndSplit();
+          sumOfSquares += lower * lower + upper * upper;
+        }
+        else
+          { sumOfSquares += value * value; }
+      }
+
+      FixedArray<TElement, Vector::ElementCount> peakElements;
+      peak.StoreUnaligned(peakElements);
+
+      SampleStatistics statistics = { .m_sumOfSquares = SumElements(sumOfSquares).FirstElement(), .m_sampleCount = samples.Count() };
+      for (TElement peakElement : peakElements)
+        { statistics.m_peak = Max(statistics.m_peak, f64(peakElement)); }
+
+      for (usz sampleIndex = vectorEndIndex; sampleIndex < samples.Count(); sampleIndex++)
+      {
+        f64 value = f64(samples[sampleIndex]);
+        statistics.m_peak = Max(statistics.m_peak, Abs(value));
+        statistics.m_sumOfSquares += value * value;
+      }
+
+      return statistics;
+    }
+
+    // Integer samples are measured after normalization. The peak is the magnitude of an actual sample so comparing it against the effect activation threshold
+    // gives the same result as ShouldActivateEffect().
+    SampleStatistics MeasureInputChannelBuffer(const InputChannelBuffer& inputChannelBuffer, usz blockSampleOffset, usz blockSampleCount);
+
     bool ShouldActivateEffect(const InputChannelBuffer& inputChannelBuffer, f64 effectActivationThreshold, usz blockSampleOffset, usz blockSampleCount);
     bool ProcessRemainActiveOutput(const BufferManager::Buffer& buffer, usz sampleCount);
 
+    // Writes a constant buffer's constant value across all of its samples so that it can be treated as non-constant
+    void ExpandConstantBuffer(const BufferManager::Buffer& buffer, usz sampleCount);
+
+    // Voice start offsets which are multiples of this keep accumulation SIMD-aligned for all accumulated sample types
+    constexpr usz VoiceStartSampleAlignment = MaxSimdAlignment / sizeof(f32);
+
+    template<typename TElement>
+    void AddSamples(Span<TElement> destination, Span<const TElement> source)
+    {
+      using Vector = AccumulationVector<TElement>;
+      ASSERT(destination.Count() == source.Count());
+
+      // When the voice sample offset is aligned (which is always the case for voices which didn't start in this block), both spans start on SIMD boundaries
+      // and there are no leading scalar iterations
+      IterateSamplesVectorized<Vector>(
+        destination,
+        [&](usz sampleIndex) { destination[sampleIndex] += source[sampleIndex]; },
+        [&](usz sampleIndex)
+          { (Vector::LoadAligned(destination, sampleIndex) + Vector::LoadUnaligned(source, sampleIndex)).StoreAligned(destination, sampleIndex); });
+    }
+
+    // Adds source to destination (or copies it if isFirstAccumulation is true) and returns the peak absolute value of the source samples. The peak is reduced
+    // with vector max-abs operations in the same pass so that measuring voice peak levels doesn't require another pass over voice output samples.
+    template<typename TElement>
+    TElement AccumulateSamplesMeasuringPeak(Span<TElement> destination, Span<const TElement> source, bool isFirstAccumulation)
+    {
+      using Vector = AccumulationVector<TElement>;
+      ASSERT(destination.Count() == source.Count());
+
+      Vector peakVector = Zero;
+      TElement peak = TElement(0);
+      IterateSamplesVectorized<Vector>(
+        destination,
+        [&](usz sampleIndex)
+        {
+          TElement value = source[sampleIndex];
+          peak = Max(peak, Abs(value));
+          destination[sampleIndex] = isFirstAccumulation ? value : destination[sampleIndex] + value;
+        },
+        [&](usz sampleIndex)
+        {
+          Vector value = Vector::LoadUnaligned(source, sampleIndex);
+          peakVector = Max(peakVector, Abs(value));
+          if (isFirstAccumulation)
+            { value.StoreAligned(destination, sampleIndex); }
+          else
+            { (Vector::LoadAligned(destination, sampleIndex) + value).StoreAligned(destination, sampleIndex); }
+        });
+
+      FixedArray<TElement, Vector::ElementCount> peakElements;
+      peakVector.StoreUnaligned(peakElements);
+      for (TElement peakElement : peakElements)
+        { peak = Max(peak, peakElement); }
+      return peak;
+    }
+
+    template<typename TElement>
+    void AddValue(Span<TElement> destination, TElement value)
+    {
+      using Vector = AccumulationVector<TElement>;
+      Vector valueVector = Vector(value);
+      IterateSamplesVectorized<Vector>(
+        destination,
+        [&](usz sampleIndex) { destination[sampleIndex] += value; },
+        [&](usz sampleIndex) { (Vector::LoadAligned(destination, sampleIndex) + valueVector).StoreAligned(destination, sampleIndex); });
+    }
+
     template<typename TElement>
     void AccumulateToBuffer(Span<TElement> destination, TElement value, bool isFirstAccumulation, usz voiceSampleOffset)
     {
@@ -64,30 +339,123 @@ namespace Chord
         offsetDestination.Fill(value);
       }
       else
-      {
-        for (usz sampleIndex = 0; sampleIndex < offsetDestination.Count(); sampleIndex++)
-          { offsetDestination[sampleIndex] += value; }
-      }
+        { AddValue(offsetDestination, value); }
     }
 
+    // If peakLevel is not null, the peak absolute value of the source samples is measured while accumulating and written to it
     template<typename TElement>
-    void AccumulateToBuffer(Span<TElement> destination, const BufferManager::Buffer& sourceBuffer, bool isFirstAccumulation, usz voiceSampleOffset)
+    void AccumulateToBuffer(
+      Span<TElement> destination,
+      const BufferManager::Buffer& sourceBuffer,
+      bool isFirstAccumulation,
+      usz voiceSampleOffset,
+      TElement* peakLevel)
     {
+      // Constant values are broadcast rather than read from buffer memory
+      if (sourceBuffer.m_isConstant)
+      {
+        TElement value = sourceBuffer.GetConstant<TElement>();
+        AccumulateToBuffer(destination, value, isFirstAccumulation, voiceSampleOffset);
+        if (peakLevel != nullptr)
+          { *peakLevel = Abs(value); }
+        return;
+      }
+
       Span<TElement> offsetDestination = { destination, voiceSampleOffset, ToEnd };
       auto source = sourceBuffer.Get<TElement>(offsetDestination.Count());
+
+      // If this is the first accumulation into this buffer, we need to initialize and copy rather than add
+      if (isFirstAccumulation)
+        { Span<TElement>(destination, 0, voiceSampleOffset).ZeroElements(); }
+
+      if (peakLevel != nullptr)
+        { *peakLevel = AccumulateSamplesMeasuringPeak(offsetDestination, Span<const TElement>(source), isFirstAccumulation); }
+      else if (isFirstAccumulation)
+        { offsetDestination.CopyElementsFrom(source); }
+      else
+        { AddSamples(offsetDestination, Span<const TElement>(source)); }
+    }
+
+    // Accumulates with a linear gain ramp from full gain down to silence on the final sample so that a voice which is being shed doesn't click. getSample is
+    // called with the index of each sample following the voice sample offset.
+    template<typename TElement, typename TGetSample>
+    void AccumulateSamplesFadingOut(Span<TElement> destination, TGetSample&& getSample, bool isFirstAccumulation, usz voiceSampleOffset)
+    {
+      Span<TElement> offsetDestination = { destination, voiceSampleOffset, ToEnd };
+      if (isFirstAccumulation)
+        { Span<TElement>(destination, 0, voiceSampleOffset).ZeroElements(); }
+
+      if (offsetDestination.IsEmpty())
+        { return; }
+
+      TElement gainStep = TElement(1) / TElement(offsetDestination.Count());
       if (isFirstAccumulation)
       {
-        // If this is the first accumulation into this buffer, we need to initialize and copy rather than add
-        Span<TElement>(destination, 0, voiceSampleOffset).ZeroElements();
-        offsetDestination.CopyElementsFrom(source);
+        for (usz sampleIndex = 0; sampleIndex < offsetDestination.Count(); sampleIndex++)
+          { offsetDestination[sampleIndex] = getSample(sampleIndex) * (TElement(1) - TElement(sampleIndex + 1) * gainStep); }
       }
       else
       {
         for (usz sampleIndex = 0; sampleIndex < offsetDestination.Count(); sampleIndex++)
-          { offsetDestination[sampleIndex] += source[sampleIndex]; }
+          { offsetDestination[sampleIndex] += getSample(sampleIndex) * (TElement(1) - TElement(sampleIndex + 1) * gainStep); }
+      }
+    }
+
+    // Integer outputs aren't faded
+    template<typename TElement>
+    void AccumulateToBufferFadingOut(Span<TElement> destination, TElement value, bool isFirstAccumulation, usz voiceSampleOffset)
+    {
+      if constexpr (std::floating_point<TElement>)
+        { AccumulateSamplesFadingOut(destination, [&](usz) { return value; }, isFirstAccumulation, voiceSampleOffset); }
+      else
+        { AccumulateToBuffer(destination, value, isFirstAccumulation, voiceSampleOffset); }
+    }
+
+    // If peakLevel is not null, the peak absolute value of the source samples (before the fade is applied) is measured while accumulating and written to it
+    template<typename TElement>
+    void AccumulateToBufferFadingOut(
+      Span<TElement> destination,
+      const BufferManager::Buffer& sourceBuffer,
+      bool isFirstAccumulation,
+      usz voiceSampleOffset,
+      TElement* peakLevel)
+    {
+      if constexpr (std::floating_point<TElement>)
+      {
+        if (sourceBuffer.m_isConstant)
+        {
+          TElement value = sourceBuffer.GetConstant<TElement>();
+          AccumulateToBufferFadingOut(destination, value, isFirstAccumulation, voiceSampleOffset);
+          if (peakLevel != nullptr)
+            { *peakLevel = Abs(value); }
+          return;
+        }
+
+        auto source = sourceBuffer.Get<TElement>(destination.Count() - voiceSampleOffset);
+        if (peakLevel != nullptr)
+        {
+          TElement peak = TElement(0);
+          AccumulateSamplesFadingOut(
+            destination,
+            [&](usz sampleIndex)
+            {
+              TElement value = source[sampleIndex];
+              peak = Max(peak, Abs(value));
+              return value;
+            },
+            isFirstAccumulation,
+            voiceSampleOffset);
+          *peakLevel = peak;
+        }
+        else
+          { AccumulateSamplesFadingOut(destination, [&](usz sampleIndex) { return source[sampleIndex]; }, isFirstAccumulation, voiceSampleOffset); }
       }
+      else
+        { AccumulateToBuffer(destination, sourceBuffer, isFirstAccumulation, voiceSampleOffset, peakLevel); }
     }
 
+    // If voicePeakLevels is not empty, the peak absolute value of each active voice's output is written to it, indexed by voice index. If voiceFadeOuts is not
+    // empty, voices flagged in it (indexed by voice index) are faded out across the block.
     void AccumulateVoiceOutputs(
       Span<const ProgramStageTaskManager> voices,
       Span<const usz> activeVoiceIndices,
@@ -95,44 +463,200 @@ namespace Chord
       BufferManager& bufferManager,
       usz outputIndex,
       BufferManager::BufferHandle bufferHandle,
-      usz sampleCount);
+      usz sampleCount,
+      Span<f32> voicePeakLevels,
+      Span<const bool> voiceFadeOuts);
+
+    // These are used for parallel voice output accumulation: as each voice finishes processing, the worker thread that finished it sums the voice's outputs
+    // into that thread's partial sums. Once all voices have finished, the partial sums for each output are reduced into the output accumulation buffer.
+    // Partial sums are non-constant buffers which are not tracked by the buffer manager.
+    void AccumulateVoiceOutputToPartialSum(
+      const ProgramStageTaskManager& voice,
+      usz voiceIndex,
+      usz voiceSampleOffset,
+      BufferManager& bufferManager,
+      usz outputIndex,
+      const BufferManager::Buffer& partialSum,
+      bool isFirstAccumulation,
+      usz sampleCount,
+      Span<f32> voicePeakLevels,
+      bool fadeOut);
 
+    // Partial sums whose partialSumsAccumulated entry is false had no voices accumulated into them this block and are skipped. Returns false (leaving
+    // destination untouched) if all partial sums were skipped.
     template<typename TElement>
-    void FillOutputChannelBuffer(const OutputChannelBuffer& outputChannelBuffer, TElement value, usz blockSampleOffset, usz blockSampleCount)
+    bool ReducePartialSums(Span<TElement> destination, Span<const BufferManager::Buffer> partialSums, Span<const bool> partialSumsAccumulated)
     {
-      switch (outputChannelBuffer.m_sampleType)
+      ASSERT(partialSums.Count() == partialSumsAccumulated.Count());
+      bool isFirstAccumulation = true;
+      for (usz i = 0; i < partialSums.Count(); i++)
       {
-      case SampleType::Float32:
+        if (!partialSumsAccumulated[i])
+          { continue; }
+
+        AccumulateToBuffer(destination, partialSums[i], isFirstAccumulation, 0, static_cast<TElement*>(nullptr));
+        isFirstAccumulation = false;
+      }
+
+      return !isFirstAccumulation;
+    }
+
+    // The accumulation buffer becomes a constant 0 if no partial sums were accumulated
+    void ReduceVoiceOutputPartialSums(
+      BufferManager& bufferManager,
+      BufferManager::BufferHandle bufferHandle,
+      Span<const BufferManager::Buffer> partialSums,
+      Span<const bool> partialSumsAccumulated,
+      usz sampleCount);
+
+    // Rounds and clamps samples to an integer sample type's full-scale range. If ditherState is not null, triangular dither of up to 1 LSB is added before
+    // rounding. Integer samples are computed in f64 for Int32 so that the upper clamp is exact. Each vector of samples is converted with vector instructions
+    // and then written out with scalar stores, interleaving the samples in the same pass.
+    template<SampleType TSampleType, typename TSource>
+    void ConvertToIntegerSamples(u8* destination, usz byteStride, Span<const TSource> source, u32* ditherState)
+    {
+      using Work = std::conditional_t<TSampleType == SampleType::Int32, f64, TSource>;
+      using SourceVector = Vector<TSource, 4>;
+      using WorkVector = Vector<Work, 4>;
+
+      static constexpr Work FullScale = Work(IntegerSampleFullScale(TSampleType));
+      WorkVector fullScale = WorkVector(FullScale);
+      WorkVector minValue = WorkVector(-FullScale);
+      WorkVector maxValue = WorkVector(FullScale - Work(1));
+
+      usz vectorEndIndex = source.Count() / 4 * 4;
+      for (usz sampleIndex = 0; sampleIndex < vectorEndIndex; sampleIndex += 4)
+      {
+        WorkVector value = WorkVector(SourceVector::LoadUnaligned(source, sampleIndex)) * fullScale;
+        if (ditherState != nullptr)
         {
-          auto samples = Span(reinterpret_cast<f32*>(outputChannelBuffer.m_samples.Elements()), outputChannelBuffer.m_samples.Count() * sizeof(f32));
-          auto destination = Span(samples, blockSampleOffset, blockSampleCount);
-          if (value == TElement(0))
-            { destination.ZeroElements(); }
-          else
-            { destination.Fill(f32(value)); }
-          break;
+          // Braced initialization evaluates the dither values in order
+          value += WorkVector
+          {
+            Work(NextTriangularDither(*ditherState)),
+            Work(NextTriangularDither(*ditherState)),
+            Work(NextTriangularDither(*ditherState)),
+            Work(NextTriangularDither(*ditherState)),
+          };
         }
 
-      case SampleType::Float64:
+        FixedArray<s32, 4> integerValues;
+        Vector<s32, 4>(Min(Max(Round(value), minValue), maxValue)).StoreUnaligned(integerValues);
+        for (usz i = 0; i < 4; i++)
+          { WriteIntegerSample<TSampleType>(destination + (sampleIndex + i) * byteStride, integerValues[i]); }
+      }
+
+      for (usz sampleIndex = vectorEndIndex; sampleIndex < source.Count(); sampleIndex++)
+      {
+        Work value = Work(source[sampleIndex]) * FullScale;
+        if (ditherState != nullptr)
+          { value += Work(NextTriangularDither(*ditherState)); }
+        WriteIntegerSample<TSampleType>(destination + sampleIndex * byteStride, s32(Min(Max(Round(value), -FullScale), FullScale - Work(1))));
+      }
+    }
+
+    // Writes source samples into an output channel buffer starting at blockSampleOffset, converting and interleaving them as needed. ditherState is only used
+    // for integer sample types and may be null to disable dither.
+    template<typename TSource>
+    void WriteOutputChannelBufferSamples(const OutputChannelBuffer& outputChannelBuffer, Span<const TSource> source, usz blockSampleOffset, u32* ditherState)
+    {
+      usz sampleStride = outputChannelBuffer.m_sampleStride;
+      usz byteStride = sampleStride * SampleTypeSize(outputChannelBuffer.m_sampleType);
+      ASSERT(
+        blockSampleOffset * byteStride + ChannelBufferByteCount(outputChannelBuffer.m_sampleType, sampleStride, source.Count())
+          <= outputChannelBuffer.m_samples.Count());
+      u8* destinationBytes = outputChannelBuffer.m_samples.Elements() + blockSampleOffset * byteStride;
+
+      auto WriteFloatSamples = [&]<typename TDestination>()
+      {
+        TDestination* destination = reinterpret_cast<TDestination*>(destinationBytes);
+        if (sampleStride == 1)
+          { ConvertSamples(Span(destination, source.Count()), source); }
+        else
         {
-          auto samples = Span(reinterpret_cast<f64*>(outputChannelBuffer.m_samples.Elements()), outputChannelBuffer.m_samples.Count() * sizeof(f64));
-          auto destination = Span(samples, blockSampleOffset, blockSampleCount);
-          if (value == TElement(0))
-            { destination.ZeroElements(); }
-          else
-            { destination.Fill(f64(value)); }
-          break;
+          for (usz sampleIndex = 0; sampleIndex < source.Count(); sampleIndex++)
+            { destination[sampleIndex * sampleStride] = TDestination(source[sampleIndex]); }
         }
+      };
+
+      switch (outputChannelBuffer.m_sampleType)
+      {
+      case SampleType::Float32:
+        WriteFloatSamples.template operator()<f32>();
+        break;
+
+      case SampleType::Float64:
+        WriteFloatSamples.template operator()<f64>();
+        break;
+
+      case SampleType::Int16:
+        ConvertToIntegerSamples<SampleType::Int16>(destinationBytes, byteStride, source, ditherState);
+        break;
+
+      case SampleType::Int24:
+        ConvertToIntegerSamples<SampleType::Int24>(destinationBytes, byteStride, source, ditherState);
+        break;
+
+      case SampleType::Int32:
+        ConvertToIntegerSamples<SampleType::Int32>(destinationBytes, byteStride, source, ditherState);
+        break;
 
       default:
         ASSERT(false, "Unsupported sample type");
       }
     }
 
+    // Constant values are never dithered so that silence stays digital silence
+    template<typename TElement>
+    void FillOutputChannelBuffer(const OutputChannelBuffer& outputChannelBuffer, TElement value, usz blockSampleOffset, usz blockSampleCount)
+    {
+      usz sampleStride = outputChannelBuffer.m_sampleStride;
+      usz sampleSize = SampleTypeSize(outputChannelBuffer.m_sampleType);
+      ASSERT(
+        blockSampleOffset * sampleStride * sampleSize + ChannelBufferByteCount(outputChannelBuffer.m_sampleType, sampleStride, blockSampleCount)
+          <= outputChannelBuffer.m_samples.Count());
+
+      if (sampleStride == 1 && value == TElement(0))
+      {
+        // Zero is represented by zero bytes in all sample types
+        Span<u8>(outputChannelBuffer.m_samples, blockSampleOffset * sampleSize, blockSampleCount * sampleSize).ZeroElements();
+        return;
+      }
+
+      if (sampleStride == 1 && (outputChannelBuffer.m_sampleType == SampleType::Float32 || outputChannelBuffer.m_sampleType == SampleType::Float64))
+      {
+        if (outputChannelBuffer.m_sampleType == SampleType::Float32)
+        {
+          auto samples = Span(reinterpret_cast<f32*>(outputChannelBuffer.m_samples.Elements()), outputChannelBuffer.m_samples.Count() / sizeof(f32));
+          Span(samples, blockSampleOffset, blockSampleCount).Fill(f32(value));
+        }
+        else
+        {
+          auto samples = Span(reinterpret_cast<f64*>(outputChannelBuffer.m_samples.Elements()), outputChannelBuffer.m_samples.Count() / sizeof(f64));
+          Span(samples, blockSampleOffset, blockSampleCount).Fill(f64(value));
+        }
+
+        return;
+      }
+
+      // Convert the value once and then copy its bytes into each sample
+      FixedArray<u8, sizeof(f64)> sampleBytes;
+      OutputChannelBuffer sampleBuffer = { .m_sampleType = outputChannelBuffer.m_sampleType, .m_samples = sampleBytes, .m_sampleStride = 1 };
+      WriteOutputChannelBufferSamples(sampleBuffer, Span<const TElement>(&value, 1), 0, nullptr);
+
+      u8* destination = outputChannelBuffer.m_samples.Elements() + blockSampleOffset * sampleStride * sampleSize;
+      for (usz sampleIndex = 0; sampleIndex < blockSampleCount; sampleIndex++)
+      {
+        for (usz byteIndex = 0; byteIndex < sampleSize; byteIndex++)
+          { destination[sampleIndex * sampleStride * sampleSize + byteIndex] = sampleBytes[byteIndex]; }
+      }
+    }
+
     void FillOutputChannelBuffer(
       const OutputChannelBuffer& outputChannelBuffer,
       const BufferManager::Buffer& sourceBuffer,
       usz blockSampleOffset,
-      usz blockSampleCount);
+      usz blockSampleCount,
+      u32* ditherState);
   }
 }
\ No newline at end of file
@@ -10,83 +10,117 @@ import Chord.Foundation;
 
 namespace Chord
 {
-  template<typename TConstantArray, typename TElement, typename TConstantNode, ProgramGraphNodeType ConstantNodeType>
-  TConstantArray EnsureConstantArray(const ArrayProgramGraphNode* node, HashMap<ConstantArrayKey, UnboundedArray<FixedArray<TElement>>>& constantArrays)
+  template<typename TConstantArray, typename TElement>
+  TConstantArray EnsureConstantArray(
+    FixedArray<TElement> elements,
+    HashMap<ConstantArrayKey, UnboundedArray<FixedArray<TElement>>>& constantArrays,
+    HashMap<const void*, usz>& referenceCounts)
   {
-    // First, generate a hash of the array contents
-    HashGenerator hashGenerator;
-    hashGenerator.Append(node->Elements().Count());
-    for (const IInputProgramGraphNode* elementNode : node->Elements())
-    {
-      const IProcessorProgramGraphNode* elementProcessorNode = elementNode->Connection()->Processor();
-      ASSERT(elementProcessorNode->Type() == ConstantNodeType);
-      hashGenerator.Append(static_cast<const TConstantNode*>(elementProcessorNode)->Value());
-    }
+    auto AddReference =
+      [&](const FixedArray<TElement>& array) -> TConstantArray
+      {
+        // Empty arrays own no memory so they are never released
+        if (!array.IsEmpty())
+        {
+          usz* referenceCount = referenceCounts.TryGet(array.Elements());
+          if (referenceCount == nullptr)
+            { referenceCounts.Insert(array.Elements(), 1); }
+          else
+            { (*referenceCount)++; }
+        }
+
+        return { .m_elements = array.Elements(), .m_count = array.Count() };
+      };
+
+    // The array contents are in contiguous memory so that they can be hashed and compared in bulk
+    Span<const u8> elementBytes = Span(reinterpret_cast<const u8*>(elements.Elements()), elements.Count() * sizeof(TElement));
 
     // For each generated hash, we maintain a list of arrays. This is because multiple arrays may hash to the same value.
-    ConstantArrayKey key = { .m_hashKey = hashGenerator.GetHashKey() };
+    ConstantArrayKey key = { .m_hashKey = CalculateBytesHashKey(elementBytes) };
     UnboundedArray<FixedArray<TElement>>* arraysForKey = constantArrays.TryGet(key);
     if (arraysForKey == nullptr)
       { arraysForKey = constantArrays.Insert(key, {}); }
 
-    // Check if an existing array already matches
+    // Check if an existing array already matches. Elements are compared bitwise so arrays which only differ by the sign of a zero are not merged.
     for (const FixedArray<TElement>& existingArray : *arraysForKey)
     {
-      if (existingArray.Count() != node->Elements().Count())
-        { continue; }
-      for (usz i = 0; i < existingArray.Count(); i++)
-      {
-        if (existingArray[i] != static_cast<const TConstantNode*>(node->Elements()[i]->Connection()->Processor())->Value())
-          { continue; }
-      }
-
-      return { .m_elements = existingArray.Elements(), .m_count = existingArray.Count() };
+      if (existingArray.Count() == elements.Count()
+        && (elementBytes.IsEmpty() || std::memcmp(existingArray.Elements(), elementBytes.Elements(), elementBytes.Count()) == 0))
+        { return AddReference(existingArray); }
     }
 
-    // No matching array already existed so allocate a new one
-    FixedArray<TElement>& newArray = arraysForKey->AppendNew(InitializeCapacity(node->Elements().Count()));
-    for (usz i = 0; i < node->Elements().Count(); i++)
-      { newArray[i] = static_cast<const TConstantNode*>(node->Elements()[i]->Connection()->Processor())->Value(); }
+    // No matching array already existed so keep the gathered one
+    return AddReference(arraysForKey->AppendNew(std::move(elements)));
+  }
 
-    return { .m_elements = newArray.Elements(), .m_count = newArray.Count() };
+  ConstantManager::ConstantManager(SharedConstantPool* sharedConstantPool)
+    : m_sharedConstantPool(sharedConstantPool)
+    { }
+
+  ConstantManager::~ConstantManager() noexcept
+  {
+    for (auto [constant, referenceCount] : m_sharedConstantReferenceCounts)
+      { m_sharedConstantPool->Release(constant); }
   }
 
   InputString ConstantManager::EnsureString(const UnicodeString& string)
   {
+    if (m_sharedConstantPool != nullptr)
+    {
+      Span<const char32_t> sharedString = m_sharedConstantPool->EnsureString(string.AsSpan());
+      return { .m_value = TrackSharedConstant(sharedString.Elements()), .m_length = sharedString.Count() };
+    }
+
     m_strings.Ensure(string);
     const UnicodeString* existingString = m_strings.TryGet(string);
     ASSERT(existingString != nullptr);
     return { .m_value = existingString->CharPtr(), .m_length = existingString->Length() };
   }
 
-  InputFloatConstantArray ConstantManager::EnsureFloatConstantArray(const ArrayProgramGraphNode* node)
+  InputFloatConstantArray ConstantManager::EnsureFloatConstantArray(FixedArray<f32> elements)
   {
-    return EnsureConstantArray<InputFloatConstantArray, f32, FloatConstantProgramGraphNode, ProgramGraphNodeType::FloatConstant>(
-      node,
-      m_floatConstantArrays);
+    if (m_sharedConstantPool != nullptr)
+      { return EnsureSharedConstantArray<InputFloatConstantArray>(Span<const f32>(elements)); }
+
+    return EnsureConstantArray<InputFloatConstantArray>(std::move(elements), m_floatConstantArrays, m_constantArrayReferenceCounts);
   }
 
-  InputDoubleConstantArray ConstantManager::EnsureDoubleConstantArray(const ArrayProgramGraphNode* node)
+  InputDoubleConstantArray ConstantManager::EnsureDoubleConstantArray(FixedArray<f64> elements)
   {
-    return EnsureConstantArray<InputDoubleConstantArray, f64, DoubleConstantProgramGraphNode, ProgramGraphNodeType::DoubleConstant>(
-      node,
-      m_doubleConstantArrays);
+    if (m_sharedConstantPool != nullptr)
+      { return EnsureSharedConstantArray<InputDoubleConstantArray>(Span<const f64>(elements)); }
+
+    return EnsureConstantArray<InputDoubleConstantArray>(std::move(elements), m_doubleConstantArrays, m_constantArrayReferenceCounts);
   }
 
-  InputIntConstantArray ConstantManager::EnsureIntConstantArray(const ArrayProgramGraphNode* node)
+  InputIntConstantArray ConstantManager::EnsureIntConstantArray(FixedArray<s32> elements)
   {
-    return EnsureConstantArray<InputIntConstantArray, s32, IntConstantProgramGraphNode, ProgramGraphNodeType::IntConstant>(
-      node,
-      m_intConstantArrays);
+    if (m_sharedConstantPool != nullptr)
+      { return EnsureSharedConstantArray<InputIntConstantArray>(Span<const s32>(elements)); }
+
+    return EnsureConstantArray<InputIntConstantArray>(std::move(elements), m_intConstantArrays, m_constantArrayReferenceCounts);
   }
 
-  InputBoolConstantArray ConstantManager::EnsureBoolConstantArray(const ArrayProgramGraphNode* node)
+  InputBoolConstantArray ConstantManager::EnsureBoolConstantArray(FixedArray<bool> elements)
   {
-    return EnsureConstantArray<InputBoolConstantArray, bool, BoolConstantProgramGraphNode, ProgramGraphNodeType::BoolConstant>(
-      node,
-      m_boolConstantArrays);
+    if (m_sharedConstantPool != nullptr)
+      { return EnsureSharedConstantArray<InputBoolConstantArray>(Span<const bool>(elements)); }
+
+    return EnsureConstantArray<InputBoolConstantArray>(std::move(elements), m_boolConstantArrays, m_constantArrayReferenceCounts);
   }
 
+  void ConstantManager::ReleaseConstantArray(InputFloatConstantArray array)
+    { ReleaseConstantArray(array.m_elements, array.m_count, m_floatConstantArrays); }
+
+  void ConstantManager::ReleaseConstantArray(InputDoubleConstantArray array)
+    { ReleaseConstantArray(array.m_elements, array.m_count, m_doubleConstantArrays); }
+
+  void ConstantManager::ReleaseConstantArray(InputIntConstantArray array)
+    { ReleaseConstantArray(array.m_elements, array.m_count, m_intConstantArrays); }
+
+  void ConstantManager::ReleaseConstantArray(InputBoolConstantArray array)
+    { ReleaseConstantArray(array.m_elements, array.m_count, m_boolConstantArrays); }
+
   InputStringConstantArray ConstantManager::EnsureStringConstantArray(const ArrayProgramGraphNode* node)
   {
     // Strings required a bit of extra logic since they're not primitives so we can't simply call EnsureConstantArray()
@@ -114,14 +148,16 @@ namespace Chord
     {
       if (existingArray.Count() != node->Elements().Count())
         { continue; }
-      for (usz i = 0; i < existingArray.Count(); i++)
+
+      bool matches = true;
+      for (usz i = 0; matches && i < existingArray.Count(); i++)
       {
         UnicodeString existingString = { Unmanaged, Span(existingArray[i].m_value, existingArray[i].m_length) };
-        if (existingString != static_cast<const StringConstantProgramGraphNode*>(node->Elements()[i]->Connection()->Processor())->Value())
-          { continue; }
+        matches = existingString == static_cast<const StringConstantProgramGraphNode*>(node->Elements()[i]->Connection()->Processor())->Value();
       }
 
-      return { .m_elements = existingArray.Elements(), .m_count = existingArray.Count() };
+      if (matches)
+        { return { .m_elements = existingArray.Elements(), .m_count = existingArray.Count() }; }
     }
 
     // No matching array already existed so allocate a new one
@@ -134,6 +170,12 @@ namespace Chord
 
   InputFloatBuffer ConstantManager::EnsureConstantBuffer(f32 value)
   {
+    if (m_sharedConstantPool != nullptr)
+    {
+      const auto* samples = TrackSharedConstant(m_sharedConstantPool->EnsureConstantBuffer(value));
+      return { .m_sampleCount = 0, .m_isConstant = true, .m_samples = samples };
+    }
+
     BufferMemory* memory = m_constantFloatBufferMemory.TryGet(value);
     if (memory == nullptr)
     {
@@ -146,6 +188,12 @@ namespace Chord
 
   InputDoubleBuffer ConstantManager::EnsureConstantBuffer(f64 value)
   {
+    if (m_sharedConstantPool != nullptr)
+    {
+      const auto* samples = TrackSharedConstant(m_sharedConstantPool->EnsureConstantBuffer(value));
+      return { .m_sampleCount = 0, .m_isConstant = true, .m_samples = samples };
+    }
+
     BufferMemory* memory = m_constantDoubleBufferMemory.TryGet(value);
     if (memory == nullptr)
     {
@@ -158,6 +206,12 @@ namespace Chord
 
   InputIntBuffer ConstantManager::EnsureConstantBuffer(s32 value)
   {
+    if (m_sharedConstantPool != nullptr)
+    {
+      const auto* samples = TrackSharedConstant(m_sharedConstantPool->EnsureConstantBuffer(value));
+      return { .m_sampleCount = 0, .m_isConstant = true, .m_samples = samples };
+    }
+
     BufferMemory* memory = m_constantIntBufferMemory.TryGet(value);
     if (memory == nullptr)
     {
@@ -170,6 +224,12 @@ namespace Chord
 
   InputBoolBuffer ConstantManager::EnsureConstantBuffer(bool value)
   {
+    if (m_sharedConstantPool != nullptr)
+    {
+      const auto* samples = TrackSharedConstant(m_sharedConstantPool->EnsureConstantBuffer(value));
+      return { .m_sampleCount = 0, .m_isConstant = true, .m_samples = samples };
+    }
+
     BufferMemory* memory = m_constantBoolBufferMemory.TryGet(value);
     if (memory == nullptr)
     {
@@ -179,4 +239,105 @@ namespace Chord
 
     return { .m_sampleCount = 0, .m_isConstant = true, .m_samples = memory->AsType<u8>().Elements() };
   }
+
+  template<typename TConstantArray, typename TElement>
+  TConstantArray ConstantManager::EnsureSharedConstantArray(Span<const TElement> elements)
+  {
+    Span<const TElement> sharedElements = m_sharedConstantPool->EnsureConstantArray(elements);
+    return { .m_elements = TrackSharedConstant(sharedElements.Elements()), .m_count = sharedElements.Count() };
+  }
+
+  template<typename T>
+  const T* ConstantManager::TrackSharedConstant(const T* constant)
+  {
+    usz* referenceCount = m_sharedConstantReferenceCounts.TryGet(constant);
+    if (referenceCount == nullptr)
+      { m_sharedConstantReferenceCounts.Insert(constant, 1); }
+    else
+    {
+      m_sharedConstantPool->Release(constant);
+      (*referenceCount)++;
+    }
+
+    return constant;
+  }
+
+  template<typename TElement>
+  void ConstantManager::ReleaseConstantArray(
+    const TElement* elements,
+    usz count,
+    HashMap<ConstantArrayKey, UnboundedArray<FixedArray<TElement>>>& constantArrays)
+  {
+    if (m_sharedConstantPool != nullptr)
+    {
+      usz* referenceCount = m_sharedConstantReferenceCounts.TryGet(elements);
+      ASSERT(referenceCount != nullptr && *referenceCount > 0, "Constant array was not provided by this ConstantManager");
+      (*referenceCount)--;
+      if (*referenceCount == 0)
+      {
+        m_sharedConstantReferenceCounts.Remove(elements);
+        m_sharedConstantPool->Release(elements);
+      }
+
+      return;
+    }
+
+    if (count == 0)
+      { return; }
+
+    usz* referenceCount = m_constantArrayReferenceCounts.TryGet(elements);
+    ASSERT(referenceCount != nullptr && *referenceCount > 0, "Constant array was not provided by this ConstantManager");
+    (*referenceCount)--;
+    if (*referenceCount > 0)
+      { return; }
+
+    m_constantArrayReferenceCounts.Remove(elements);
+
+    // The key must be calculated before the array is removed because removing it frees the elements
+    ConstantArrayKey key = { .m_hashKey = CalculateBytesHashKey(Span(reinterpret_cast<const u8*>(elements), count * sizeof(TElement))) };
+    UnboundedArray<FixedArray<TElement>>* arraysForKey = constantArrays.TryGet(key);
+    ASSERT(arraysForKey != nullptr);
+    for (usz i = 0; i < arraysForKey->Count(); i++)
+    {
+      if ((*arraysForKey)[i].Elements() == elements)
+      {
+        arraysForKey->RemoveByIndexUnordered(i);
+        break;
+      }
+    }
+
+    if (arraysForKey->IsEmpty())
+      { constantArrays.Remove(key); }
+  }
+
+  usz ConstantManager::GetByteCount() const
+  {
+    usz byteCount = 0;
+    for (const UnicodeString& string : m_strings)
+      { byteCount += string.Length() * sizeof(char32_t); }
+
+    auto AddConstantArrays =
+      [&]<typename TElement>(const HashMap<ConstantArrayKey, UnboundedArray<FixedArray<TElement>>>& constantArrays)
+      {
+        for (auto [key, arrays] : constantArrays)
+        {
+          for (const FixedArray<TElement>& array : arrays)
+            { byteCount += array.Count() * sizeof(TElement); }
+        }
+      };
+
+    AddConstantArrays(m_floatConstantArrays);
+    AddConstantArrays(m_doubleConstantArrays);
+    AddConstantArrays(m_intConstantArrays);
+    AddConstantArrays(m_boolConstantArrays);
+    AddConstantArrays(m_stringConstantArrays);
+
+    usz constantBufferCount = m_constantFloatBufferMemory.Count()
+      + m_constantDoubleBufferMemory.Count()
+      + m_constantIntBufferMemory.Count()
+      + m_constantBoolBufferMemory.Count();
+    byteCount += constantBufferCount * MaxSimdAlignment;
+
+    return byteCount;
+  }
 }
\ No newline at end of file
@@ -7,12 +7,12 @@ export module Chord.Engine:ProgramProcessing.ConstantManager;
 import Chord.Foundation;
 import :Program.ProgramGraphNodes;
 import :ProgramProcessing.BufferMemory;
+import :ProgramProcessing.SharedConstantPool;
 
 namespace Chord
 {
-  // Okay, we're going to store arrays in a hash map, but we don't want to have to construct the whole array before checking whether it already exists. To get
-  // around this, the keys are going to actually be a hash of the length and all the element values. This will point to a list of all arrays with that same hash
-  // key and we can check there to see if the array has already been constructed.
+  // Arrays are stored in a hash map keyed by a hash of their contents. Each key points to a list of all arrays with that same hash key, which is searched to see
+  // if the array has already been constructed.
   struct ConstantArrayKey
   {
     HashKey m_hashKey;
@@ -30,23 +30,57 @@ namespace Chord
     {
     public:
       ConstantManager() = default;
+
+      // If a shared constant pool is provided, strings, primitive constant arrays, and constant buffers are stored in the pool (and released when this
+      // ConstantManager is destroyed) rather than being stored locally. The pool must outlive this ConstantManager.
+      ConstantManager(SharedConstantPool* sharedConstantPool);
       ConstantManager(const ConstantManager&) = delete;
       ConstantManager& operator=(const ConstantManager&) = delete;
 
+      ~ConstantManager() noexcept;
+
       InputString EnsureString(const UnicodeString& string);
 
-      InputFloatConstantArray EnsureFloatConstantArray(const ArrayProgramGraphNode* node);
-      InputDoubleConstantArray EnsureDoubleConstantArray(const ArrayProgramGraphNode* node);
-      InputIntConstantArray EnsureIntConstantArray(const ArrayProgramGraphNode* node);
-      InputBoolConstantArray EnsureBoolConstantArray(const ArrayProgramGraphNode* node);
+      // String constants are part of a program's structure so they are read directly from the array's element nodes
       InputStringConstantArray EnsureStringConstantArray(const ArrayProgramGraphNode* node);
 
+      // These take element values which were already gathered by the caller through Program::ConstantValue(). Constant nodes can be shared with other
+      // programs which only differ by their constant values, so the values are never read from the nodes directly.
+      InputFloatConstantArray EnsureFloatConstantArray(FixedArray<f32> elements);
+      InputDoubleConstantArray EnsureDoubleConstantArray(FixedArray<f64> elements);
+      InputIntConstantArray EnsureIntConstantArray(FixedArray<s32> elements);
+      InputBoolConstantArray EnsureBoolConstantArray(FixedArray<bool> elements);
+
+      // Each call to Ensure*ConstantArray() adds a reference to the returned array. When an array is replaced (e.g. when constants are updated in place), the
+      // previous array should be released so that its memory (or its shared constant pool reference) is freed once no other argument references it.
+      void ReleaseConstantArray(InputFloatConstantArray array);
+      void ReleaseConstantArray(InputDoubleConstantArray array);
+      void ReleaseConstantArray(InputIntConstantArray array);
+      void ReleaseConstantArray(InputBoolConstantArray array);
+
       InputFloatBuffer EnsureConstantBuffer(f32 value);
       InputDoubleBuffer EnsureConstantBuffer(f64 value);
       InputIntBuffer EnsureConstantBuffer(s32 value);
       InputBoolBuffer EnsureConstantBuffer(bool value);
 
+      // Returns the number of bytes held by strings, constant arrays, and constant buffers, not including constants held by the shared constant pool
+      usz GetByteCount() const;
+
     private:
+      template<typename TConstantArray, typename TElement>
+      TConstantArray EnsureSharedConstantArray(Span<const TElement> elements);
+
+      // Each shared constant is referenced only once in the pool by this ConstantManager so any additional reference returned by the pool is released
+      // immediately and counted locally instead
+      template<typename T>
+      const T* TrackSharedConstant(const T* constant);
+
+      template<typename TElement>
+      void ReleaseConstantArray(const TElement* elements, usz count, HashMap<ConstantArrayKey, UnboundedArray<FixedArray<TElement>>>& constantArrays);
+
+      SharedConstantPool* m_sharedConstantPool = nullptr;
+      HashMap<const void*, usz> m_sharedConstantReferenceCounts;
+
       HashSet<UnicodeString> m_strings;
 
       HashMap<ConstantArrayKey, UnboundedArray<FixedArray<f32>>> m_floatConstantArrays;
@@ -55,6 +89,9 @@ namespace Chord
       HashMap<ConstantArrayKey, UnboundedArray<FixedArray<bool>>> m_boolConstantArrays;
       HashMap<ConstantArrayKey, UnboundedArray<FixedArray<InputString>>> m_stringConstantArrays;
 
+      // Reference counts of local (non-empty) primitive constant arrays, keyed by their elements
+      HashMap<const void*, usz> m_constantArrayReferenceCounts;
+
       HashMap<f32, BufferMemory> m_constantFloatBufferMemory;
       HashMap<f64, BufferMemory> m_constantDoubleBufferMemory;
       HashMap<s32, BufferMemory> m_constantIntBufferMemory;
@@ -0,0 +1,74 @@
+module Chord.Engine;
+
+import std;
+
+import Chord.Foundation;
+
+namespace Chord
+{
+  OverloadGovernor::OverloadGovernor(const OverloadGovernorSettings& settings, usz maxVoiceCount)
+    : m_settings(settings)
+    , m_maxVoiceCount(maxVoiceCount)
+    , m_voiceLimit(maxVoiceCount)
+  {
+    ASSERT(m_settings.m_recoveryLoad < m_settings.m_overloadLoad);
+    ASSERT(m_settings.m_loadSmoothing > 0.0 && m_settings.m_loadSmoothing <= 1.0);
+    ASSERT(m_settings.m_recoveryVoiceCount > 0);
+    m_settings.m_minVoiceLimit = Max(Min(m_settings.m_minVoiceLimit, maxVoiceCount), 1_usz);
+  }
+
+  usz OverloadGovernor::Update(f64 load, usz activeVoiceCount)
+  {
+    OverloadState previousState = m_state;
+    usz previousVoiceLimit = m_voiceLimit;
+
+    m_smoothedLoad += (load - m_smoothedLoad) * m_settings.m_loadSmoothing;
+
+    if (load >= m_settings.m_overloadLoad)
+    {
+      // Assume that load scales with the number of active voices and shed enough voices to land halfway between the recovery and overload thresholds.
+      // Always shed at least one voice so that repeated overloads make progress even if voices aren't the main cost.
+      if (m_voiceLimit > m_settings.m_minVoiceLimit)
+      {
+        f64 targetLoad = (m_settings.m_overloadLoad + m_settings.m_recoveryLoad) * 0.5;
+        usz targetVoiceCount = usz(f64(Min(activeVoiceCount, m_voiceLimit)) * targetLoad / load);
+        m_voiceLimit = Max(Min(targetVoiceCount, m_voiceLimit - 1), m_settings.m_minVoiceLimit);
+      }
+
+      m_recoveryBlockCounter = 0;
+      m_state = OverloadState::Overloaded;
+    }
+    else if (m_voiceLimit < m_maxVoiceCount)
+    {
+      if (m_smoothedLoad < m_settings.m_recoveryLoad)
+      {
+        m_recoveryBlockCounter++;
+        if (m_recoveryBlockCounter >= m_settings.m_recoveryBlockCount)
+        {
+          m_voiceLimit = Min(m_voiceLimit + m_settings.m_recoveryVoiceCount, m_maxVoiceCount);
+          m_recoveryBlockCounter = 0;
+        }
+      }
+      else
+        { m_recoveryBlockCounter = 0; }
+
+      m_state = m_voiceLimit < m_maxVoiceCount ? OverloadState::Recovering : OverloadState::Normal;
+    }
+    else
+      { m_state = OverloadState::Normal; }
+
+    if ((m_state != previousState || m_voiceLimit != previousVoiceLimit) && m_settings.m_eventCallback.IsValid())
+    {
+      m_settings.m_eventCallback(
+        {
+          .m_state = m_state,
+          .m_load = load,
+          .m_smoothedLoad = m_smoothedLoad,
+          .m_voiceLimit = m_voiceLimit,
+          .m_maxVoiceCount = m_maxVoiceCount,
+        });
+    }
+
+    return m_voiceLimit;
+  }
+}
\ No newline at end of file
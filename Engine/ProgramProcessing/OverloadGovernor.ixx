@@ -0,0 +1,85 @@
+export module Chord.Engine:ProgramProcessing.OverloadGovernor;
+
+import std;
+
+import Chord.Foundation;
+
+namespace Chord
+{
+  export
+  {
+    enum class OverloadState
+    {
+      // The voice limit is at its maximum
+      Normal,
+
+      // The most recent block reached the overload threshold. The voice limit is lowered unless it is already at its minimum.
+      Overloaded,
+
+      // The voice limit is below its maximum and is waiting for load to drop before it is raised
+      Recovering,
+    };
+
+    struct OverloadEvent
+    {
+      OverloadState m_state = OverloadState::Normal;
+
+      // Block processing time as a fraction of the block's real-time duration, both for the most recent block and smoothed across blocks
+      f64 m_load = 0.0;
+      f64 m_smoothedLoad = 0.0;
+
+      usz m_voiceLimit = 0;
+      usz m_maxVoiceCount = 0;
+    };
+
+    struct OverloadGovernorSettings
+    {
+      // When the load of a single block reaches this value, the voice limit is lowered so that load is expected to land between the two thresholds
+      f64 m_overloadLoad = 0.85;
+
+      // Once the smoothed load stays below this value for m_recoveryBlockCount consecutive blocks, the voice limit is raised by m_recoveryVoiceCount voices
+      f64 m_recoveryLoad = 0.5;
+      usz m_recoveryBlockCount = 64;
+      usz m_recoveryVoiceCount = 1;
+
+      // The weight of the most recent block when updating the smoothed load
+      f64 m_loadSmoothing = 0.1;
+
+      // The voice limit is never lowered below this value
+      usz m_minVoiceLimit = 1;
+
+      // Called from the processing thread whenever the state or voice limit changes so it should not block
+      Callable<void(const OverloadEvent& event)> m_eventCallback;
+    };
+
+    // Tracks processing load across blocks and lowers the number of voices allowed to play when processing approaches the real-time deadline
+    class OverloadGovernor
+    {
+    public:
+      OverloadGovernor(const OverloadGovernorSettings& settings, usz maxVoiceCount);
+      OverloadGovernor(const OverloadGovernor&) = delete;
+      OverloadGovernor& operator=(const OverloadGovernor&) = delete;
+
+      // Updates the governor with the load of a block during which activeVoiceCount voices were processed and returns the new voice limit
+      usz Update(f64 load, usz activeVoiceCount);
+
+      OverloadState GetState() const
+        { return m_state; }
+
+      usz GetVoiceLimit() const
+        { return m_voiceLimit; }
+
+      f64 GetSmoothedLoad() const
+        { return m_smoothedLoad; }
+
+    private:
+      OverloadGovernorSettings m_settings;
+      usz m_maxVoiceCount = 0;
+
+      OverloadState m_state = OverloadState::Normal;
+      usz m_voiceLimit = 0;
+      f64 m_smoothedLoad = 0.0;
+      usz m_recoveryBlockCounter = 0;
+    };
+  }
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+module Chord.Engine;
+
+import std;
+
+import Chord.Foundation;
+
+namespace Chord
+{
+  ProgramBank::ProgramBank(NativeLibraryRegistry* nativeLibraryRegistry, bool simplifyPrograms)
+    : m_nativeLibraryRegistry(nativeLibraryRegistry)
+    , m_simplifyPrograms(simplifyPrograms)
+    { }
+
+  ProgramBank::~ProgramBank() noexcept
+    { ASSERT(m_statistics.m_referenceCount == 0, "Not all programs were released"); }
+
+  const Program* ProgramBank::AcquireProgram(Span<const u8> bytes)
+  {
+    // This verifies the content hash so corrupted bytes can never alias a program which is already held
+    std::optional<FixedArray<u8, Sha256ByteCount>> contentHash = Program::TryReadContentHash(bytes);
+    if (!contentHash.has_value())
+      { return nullptr; }
+
+    ProgramBankKey key = { .m_contentHash = contentHash.value() };
+
+    {
+      std::unique_lock lock(m_mutex);
+      const Program* existingProgram = TryAddReference(key);
+      if (existingProgram != nullptr)
+        { return existingProgram; }
+    }
+
+    // Simplification folds constant values into the graph so simplified programs can't share a graph with programs that have different constant values
+    std::optional<ProgramBankKey> graphKey;
+    std::shared_ptr<const Program> graph;
+    if (!m_simplifyPrograms)
+    {
+      std::optional<FixedArray<u8, Sha256ByteCount>> structureHash = Program::TryReadStructureHash(bytes);
+      if (structureHash.has_value())
+      {
+        graphKey = ProgramBankKey { .m_contentHash = structureHash.value() };
+
+        std::unique_lock lock(m_mutex);
+        const GraphEntry* graphEntry = m_graphs.TryGet(graphKey.value());
+        if (graphEntry != nullptr)
+          { graph = graphEntry->m_program; }
+      }
+    }
+
+    // Deserialization, validation, and simplification happen without holding the lock
+    std::unique_ptr<Program> program = graphKey.has_value() ? LoadConstantVariant(bytes, graph) : LoadProgram(bytes);
+    if (program == nullptr)
+      { return nullptr; }
+
+    std::unique_lock lock(m_mutex);
+
+    // Another thread may have loaded the same program in the meantime, in which case the program that was just loaded is discarded
+    const Program* existingProgram = TryAddReference(key);
+    if (existingProgram != nullptr)
+      { return existingProgram; }
+
+    Entry newEntry =
+    {
+      .m_program = std::move(program),
+      .m_referenceCount = 1,
+      .m_nodeCount = 0,
+      .m_byteCount = bytes.Count(),
+    };
+
+    newEntry.m_nodeCount = newEntry.m_program->NodeCount();
+    newEntry.m_constantValueByteCount = newEntry.m_program->ConstantValueByteCount();
+
+    if (graphKey.has_value())
+    {
+      GraphEntry* graphEntry = m_graphs.TryGet(graphKey.value());
+      if (graphEntry == nullptr)
+      {
+        graphEntry = m_graphs.Insert(graphKey.value(), { .m_program = graph, .m_programCount = 0, .m_nodeCount = graph->NodeCount() });
+        m_statistics.m_graphCount++;
+        m_statistics.m_nodeCount += graphEntry->m_nodeCount;
+      }
+
+      // If another thread registered a graph with the same structure while this program was loading, this program simply keeps its own graph
+      if (graphEntry->m_program == graph)
+      {
+        if (graphEntry->m_programCount > 0)
+          { m_statistics.m_sharedNodeCount += graphEntry->m_nodeCount; }
+        graphEntry->m_programCount++;
+        newEntry.m_graphKey = graphKey;
+      }
+    }
+
+    if (!newEntry.m_graphKey.has_value())
+    {
+      m_statistics.m_graphCount++;
+      m_statistics.m_nodeCount += newEntry.m_nodeCount;
+    }
+
+    m_statistics.m_programCount++;
+    m_statistics.m_referenceCount++;
+    m_statistics.m_byteCount += newEntry.m_byteCount;
+    m_statistics.m_constantValueByteCount += newEntry.m_constantValueByteCount;
+    return m_entries.Insert(key, std::move(newEntry))->m_program.get();
+  }
+
+  void ProgramBank::ReleaseProgram(const Program* program)
+  {
+    ProgramBankKey key;
+    ASSERT(program->ContentHash().Count() == Sha256ByteCount);
+    Copy(key.m_contentHash.Elements(), program->ContentHash().Elements(), Sha256ByteCount);
+
+    std::unique_lock lock(m_mutex);
+    Entry* entry = m_entries.TryGet(key);
+    ASSERT(entry != nullptr && entry->m_program.get() == program, "Program was not acquired from this bank");
+    ASSERT(entry->m_referenceCount > 0);
+
+    entry->m_referenceCount--;
+    m_statistics.m_referenceCount--;
+    if (entry->m_referenceCount > 0)
+    {
+      m_statistics.m_sharedNodeCount -= entry->m_nodeCount;
+      m_statistics.m_sharedByteCount -= entry->m_byteCount;
+      return;
+    }
+
+    m_statistics.m_programCount--;
+    m_statistics.m_byteCount -= entry->m_byteCount;
+    m_statistics.m_constantValueByteCount -= entry->m_constantValueByteCount;
+
+    if (entry->m_graphKey.has_value())
+    {
+      GraphEntry* graphEntry = m_graphs.TryGet(entry->m_graphKey.value());
+      ASSERT(graphEntry != nullptr && graphEntry->m_programCount > 0);
+      graphEntry->m_programCount--;
+      if (graphEntry->m_programCount > 0)
+        { m_statistics.m_sharedNodeCount -= graphEntry->m_nodeCount; }
+      else
+      {
+        m_statistics.m_graphCount--;
+        m_statistics.m_nodeCount -= graphEntry->m_nodeCount;
+        m_graphs.Remove(entry->m_graphKey.value());
+      }
+    }
+    else
+    {
+      m_statistics.m_graphCount--;
+      m_statistics.m_nodeCount -= entry->m_nodeCount;
+    }
+
+    m_entries.Remove(key);
+  }
+
+  ProgramBank::Statistics ProgramBank::GetStatistics() const
+  {
+    std::unique_lock lock(m_mutex);
+    return m_statistics;
+  }
+
+  const Program* ProgramBank::TryAddReference(const ProgramBankKey& key)
+  {
+    Entry* entry = m_entries.TryGet(key);
+    if (entry == nullptr)
+      { return nullptr; }
+
+    entry->m_referenceCount++;
+    m_statistics.m_referenceCount++;
+    m_statistics.m_sharedNodeCount += entry->m_nodeCount;
+    m_statistics.m_sharedByteCount += entry->m_byteCount;
+    return entry->m_program.get();
+  }
+
+  std::unique_ptr<Program> ProgramBank::LoadConstantVariant(Span<const u8> bytes, std::shared_ptr<const Program>& graph) const
+  {
+    // The first program with a given structure provides the graph. Native library dependencies are part of the structure so the graph is only validated
+    // once.
+    if (graph == nullptr)
+    {
+      std::unique_ptr<Program> graphProgram = LoadProgram(bytes);
+      if (graphProgram == nullptr)
+        { return nullptr; }
+      graph = std::move(graphProgram);
+    }
+
+    std::optional<Program> program = Program::DeserializeConstantVariant(graph, bytes);
+    if (!program.has_value())
+      { return nullptr; }
+
+    return std::make_unique<Program>(std::move(program.value()));
+  }
+
+  std::unique_ptr<Program> ProgramBank::LoadProgram(Span<const u8> bytes) const
+  {
+    std::optional<Program> program = Program::Deserialize(bytes);
+    if (!program.has_value() || !program->Validate(m_nativeLibraryRegistry))
+      { return nullptr; }
+
+    if (m_simplifyPrograms)
+      { program->Simplify(m_nativeLibraryRegistry); }
+
+    return std::make_unique<Program>(std::move(program.value()));
+  }
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+export module Chord.Engine:ProgramProcessing.ProgramBank;
+
+import std;
+
+import Chord.Foundation;
+import :Native.NativeLibraryRegistry;
+import :Program;
+
+namespace Chord
+{
+  struct ProgramBankKey
+  {
+    FixedArray<u8, Sha256ByteCount> m_contentHash;
+
+    bool operator==(const ProgramBankKey& other) const
+      { return std::memcmp(m_contentHash.Elements(), other.m_contentHash.Elements(), Sha256ByteCount) == 0; }
+  };
+
+  HashKey CalculateHashKey(const ProgramBankKey& value)
+  {
+    // The content hash is already uniformly distributed so its leading bytes can be used directly
+    u64 hashKey;
+    std::memcpy(&hashKey, value.m_contentHash.Elements(), sizeof(hashKey));
+    return HashKey(hashKey);
+  }
+
+  export
+  {
+    // Hosts which load many instruments (e.g. a sample library with one processor per patch) frequently load the same program more than once, or many
+    // programs which differ only in constant values. A ProgramBank deserializes each distinct program (identified by its content hash) only once and hands out
+    // the same immutable Program to every ProgramProcessor which uses it. Unless programs are simplified, distinct version 1 programs which differ only in the
+    // values of float, double, int, or bool constants also share a single set of graph nodes and only hold their own constant values (see
+    // Program::DeserializeConstantVariant()). Native library contexts are already shared process-wide through the NativeLibraryRegistry.
+    class ProgramBank
+    {
+    public:
+      struct Statistics
+      {
+        // The number of distinct programs currently held and the total number of outstanding acquisitions of those programs
+        usz m_programCount = 0;
+        usz m_referenceCount = 0;
+
+        // The number of distinct graphs held. Programs which differ only in constant values share a graph.
+        usz m_graphCount = 0;
+
+        // The number of graph nodes held by distinct graphs and the number of serialized bytes of distinct programs
+        usz m_nodeCount = 0;
+        usz m_byteCount = 0;
+
+        // The number of graph nodes which would have been deserialized again had each acquisition loaded its own copy of the program, including nodes shared
+        // by programs which differ only in constant values, and the number of serialized bytes which would have been deserialized again
+        usz m_sharedNodeCount = 0;
+        usz m_sharedByteCount = 0;
+
+        // The number of bytes of constant values held separately by programs which share a graph
+        usz m_constantValueByteCount = 0;
+      };
+
+      // If simplifyPrograms is true, each distinct program is simplified once after validation (see Program::Simplify())
+      ProgramBank(NativeLibraryRegistry* nativeLibraryRegistry, bool simplifyPrograms);
+      ProgramBank(const ProgramBank&) = delete;
+      ProgramBank& operator=(const ProgramBank&) = delete;
+
+      // All acquired programs must be released before the bank is destroyed
+      ~ProgramBank() noexcept;
+
+      // Returns a program which remains valid until it is released, or null if the program could not be deserialized or validated. The bytes are only read
+      // during this call. Programs are loaded without holding the bank's lock so concurrent acquisitions of different programs don't wait on each other.
+      const Program* AcquireProgram(Span<const u8> bytes);
+      void ReleaseProgram(const Program* program);
+
+      Statistics GetStatistics() const;
+
+    private:
+      struct Entry
+      {
+        // Programs are heap-allocated so that their addresses remain stable as the entry map grows
+        std::unique_ptr<Program> m_program;
+        usz m_referenceCount = 0;
+        usz m_nodeCount = 0;
+        usz m_byteCount = 0;
+
+        // Set if the program shares the graph held in m_graphs under this key
+        std::optional<ProgramBankKey> m_graphKey;
+        usz m_constantValueByteCount = 0;
+      };
+
+      // A graph shared by all programs with the same structure hash
+      struct GraphEntry
+      {
+        std::shared_ptr<const Program> m_program;
+        usz m_programCount = 0;
+        usz m_nodeCount = 0;
+      };
+
+      // Returns the existing entry's program with an additional reference or null if there is no entry for the key. m_mutex must be held.
+      const Program* TryAddReference(const ProgramBankKey& key);
+
+      // Loads a program which shares graph, or loads graph first if it is null. graph is set to the graph that was used.
+      std::unique_ptr<Program> LoadConstantVariant(Span<const u8> bytes, std::shared_ptr<const Program>& graph) const;
+      std::unique_ptr<Program> LoadProgram(Span<const u8> bytes) const;
+
+      NativeLibraryRegistry* m_nativeLibraryRegistry = nullptr;
+      bool m_simplifyPrograms = false;
+
+      mutable std::mutex m_mutex;
+      HashMap<ProgramBankKey, Entry> m_entries;
+      HashMap<ProgramBankKey, GraphEntry> m_graphs;
+      Statistics m_statistics;
+    };
+  }
+}
\ No newline at end of file
@@ -123,25 +123,51 @@ namespace Chord
     return rootNodes;
   }
 
-  HashSet<std::tuple<const IProcessorProgramGraphNode*, const IProcessorProgramGraphNode*>> CalculateGraphNodeReachability(
-    Span<const IProcessorProgramGraphNode*> rootNodes)
+  GraphNodeReachability::GraphNodeReachability(Span<const IProcessorProgramGraphNode*> rootNodes)
   {
-    // To determine graph reachability, we'll simply perform DFS starting at each possible node
-    HashSet<std::tuple<const IProcessorProgramGraphNode*, const IProcessorProgramGraphNode*>> reachableNodes;
-
+    // $TODO $FEEDBACK when we add feedback edges, the graph will no longer have a topological order and we'll need to collapse cycles (e.g. using Tarjan's
+    // algorithm) before building the closure
+    UnboundedArray<const IProcessorProgramGraphNode*> topologicalNodes;
     IterateGraphTopological(
       rootNodes,
       [&](const IProcessorProgramGraphNode* node)
       {
-        // $TODO $FEEDBACK when we add feedback edges, we'll need to call a more general DFS iteration method that takes those into account. For now, calling
-        // IterateGraphTopological will work.
-        IterateGraphTopological(
-          Span(&node, 1),
-          [&](const IProcessorProgramGraphNode* reachableNode)
-            { reachableNodes.Insert(std::make_tuple(node, reachableNode)); });
+        m_nodeIndices.Insert(node, topologicalNodes.Count());
+        topologicalNodes.Append(node);
       });
 
-    return reachableNodes;
+    m_rowWordCount = (topologicalNodes.Count() + 63) / 64;
+    m_reachabilityRows = FixedArray<u64>(topologicalNodes.Count() * m_rowWordCount, 0);
+
+    // Visit nodes in reverse topological order so that every successor's row is complete by the time it gets OR-ed into its predecessors' rows. This costs
+    // O(V * E / 64) word operations rather than a separate DFS per node.
+    for (usz nodeIndex = topologicalNodes.Count(); nodeIndex-- > 0;)
+    {
+      Span<u64> row(m_reachabilityRows, nodeIndex * m_rowWordCount, m_rowWordCount);
+      row[nodeIndex / 64] |= 1_u64 << (nodeIndex % 64);
+
+      IterateNodeOutputs(
+        topologicalNodes[nodeIndex],
+        [&](const IOutputProgramGraphNode* output)
+        {
+          for (const IInputProgramGraphNode* input : output->Connections())
+          {
+            usz successorIndex = m_nodeIndices[input->Processor()];
+            ASSERT(successorIndex > nodeIndex);
+            OrBits(row, Span<const u64>(m_reachabilityRows, successorIndex * m_rowWordCount, m_rowWordCount));
+          }
+        });
+    }
+  }
+
+  bool GraphNodeReachability::IsReachable(const IProcessorProgramGraphNode* fromNode, const IProcessorProgramGraphNode* toNode) const
+  {
+    const usz* fromIndex = m_nodeIndices.TryGet(fromNode);
+    const usz* toIndex = m_nodeIndices.TryGet(toNode);
+    if (fromIndex == nullptr || toIndex == nullptr)
+      { return false; }
+
+    return ((m_reachabilityRows[*fromIndex * m_rowWordCount + *toIndex / 64] >> (*toIndex % 64)) & 1) != 0;
   }
 
   usz GetGraphOutputIndex(const ProgramGraph& programGraph, const GraphOutputProgramGraphNode* graphOutput)
@@ -11,6 +11,98 @@ namespace Chord
     usz GetNodeInputCount(const IProcessorProgramGraphNode* node);
     UnboundedArray<const IProcessorProgramGraphNode*> FindGraphRootNodes(Span<const IProcessorProgramGraphNode*> outputNodes);
 
+    template<callable_as<void(const IOutputProgramGraphNode*)> VisitOutput>
+    void IterateNodeOutputs(const IProcessorProgramGraphNode* node, VisitOutput&& visitOutput)
+    {
+      switch (node->Type())
+      {
+      case ProgramGraphNodeType::Input:
+      case ProgramGraphNodeType::Output:
+        // These are not processor nodes
+        ASSERT(false);
+        break;
+
+      case ProgramGraphNodeType::FloatConstant:
+        visitOutput(static_cast<const FloatConstantProgramGraphNode*>(node)->Output());
+        break;
+
+      case ProgramGraphNodeType::DoubleConstant:
+        visitOutput(static_cast<const DoubleConstantProgramGraphNode*>(node)->Output());
+        break;
+
+      case ProgramGraphNodeType::IntConstant:
+        visitOutput(static_cast<const IntConstantProgramGraphNode*>(node)->Output());
+        break;
+
+      case ProgramGraphNodeType::BoolConstant:
+        visitOutput(static_cast<const BoolConstantProgramGraphNode*>(node)->Output());
+        break;
+
+      case ProgramGraphNodeType::StringConstant:
+        visitOutput(static_cast<const StringConstantProgramGraphNode*>(node)->Output());
+        break;
+
+      case ProgramGraphNodeType::Array:
+        visitOutput(static_cast<const ArrayProgramGraphNode*>(node)->Output());
+        break;
+
+      case ProgramGraphNodeType::NativeModuleCall:
+        for (const IOutputProgramGraphNode* outputNode : static_cast<const NativeModuleCallProgramGraphNode*>(node)->Outputs())
+          { visitOutput(outputNode); }
+        break;
+
+      case ProgramGraphNodeType::GraphInput:
+        visitOutput(static_cast<const GraphInputProgramGraphNode*>(node)->Output());
+        break;
+
+      case ProgramGraphNodeType::GraphOutput:
+        break;
+
+      default:
+        ASSERT(false);
+      }
+    }
+
+    template<callable_as<void(const IInputProgramGraphNode*)> VisitInput>
+    void IterateNodeInputs(const IProcessorProgramGraphNode* node, VisitInput&& visitInput)
+    {
+      switch (node->Type())
+      {
+      case ProgramGraphNodeType::Input:
+      case ProgramGraphNodeType::Output:
+        // These are not processor nodes
+        ASSERT(false);
+        break;
+
+      case ProgramGraphNodeType::FloatConstant:
+      case ProgramGraphNodeType::DoubleConstant:
+      case ProgramGraphNodeType::IntConstant:
+      case ProgramGraphNodeType::BoolConstant:
+      case ProgramGraphNodeType::StringConstant:
+        break;
+
+      case ProgramGraphNodeType::Array:
+        for (const IInputProgramGraphNode* elementNode : static_cast<const ArrayProgramGraphNode*>(node)->Elements())
+          { visitInput(elementNode); }
+        break;
+
+      case ProgramGraphNodeType::NativeModuleCall:
+        for (const IInputProgramGraphNode* inputNode : static_cast<const NativeModuleCallProgramGraphNode*>(node)->Inputs())
+          { visitInput(inputNode); }
+        break;
+
+      case ProgramGraphNodeType::GraphInput:
+        break;
+
+      case ProgramGraphNodeType::GraphOutput:
+        visitInput(static_cast<const GraphOutputProgramGraphNode*>(node)->Input());
+        break;
+
+      default:
+        ASSERT(false);
+      }
+    }
+
     template<callable_as<void(const IProcessorProgramGraphNode*)> VisitNode>
     void IterateGraphTopological(Span<const IProcessorProgramGraphNode*> rootNodes, VisitNode&& visitNode)
     {
@@ -26,7 +118,8 @@ namespace Chord
 
         visitNode(node);
 
-        auto ProcessOutput =
+        IterateNodeOutputs(
+          node,
           [&](const IOutputProgramGraphNode* output)
           {
             for (const IInputProgramGraphNode* input : output->Connections())
@@ -36,66 +129,29 @@ namespace Chord
               if (unvisitedInputCount == nullptr)
                 { unvisitedInputCount = unvisitedInputCounts.Insert(inputProcessor, GetNodeInputCount(inputProcessor)); }
               ASSERT(*unvisitedInputCount > 0);
-              *unvisitedInputCount--;
+              (*unvisitedInputCount)--;
 
               if (*unvisitedInputCount == 0)
                 { nodeStack.Append(inputProcessor); }
             }
-          };
-
-        switch (node->Type())
-        {
-        case ProgramGraphNodeType::Input:
-        case ProgramGraphNodeType::Output:
-          // These are not processor nodes
-          ASSERT(false);
-          break;
-
-        case ProgramGraphNodeType::FloatConstant:
-          ProcessOutput(static_cast<const FloatConstantProgramGraphNode*>(node)->Output());
-          break;
-
-        case ProgramGraphNodeType::DoubleConstant:
-          ProcessOutput(static_cast<const DoubleConstantProgramGraphNode*>(node)->Output());
-          break;
-
-        case ProgramGraphNodeType::IntConstant:
-          ProcessOutput(static_cast<const IntConstantProgramGraphNode*>(node)->Output());
-          break;
-
-        case ProgramGraphNodeType::BoolConstant:
-          ProcessOutput(static_cast<const BoolConstantProgramGraphNode*>(node)->Output());
-          break;
-
-        case ProgramGraphNodeType::StringConstant:
-          ProcessOutput(static_cast<const StringConstantProgramGraphNode*>(node)->Output());
-          break;
-
-        case ProgramGraphNodeType::Array:
-          ProcessOutput(static_cast<const ArrayProgramGraphNode*>(node)->Output());
-          break;
-
-        case ProgramGraphNodeType::NativeModuleCall:
-          for (const IOutputProgramGraphNode* outputNode : static_cast<const NativeModuleCallProgramGraphNode*>(node)->Outputs())
-            { ProcessOutput(outputNode); }
-          break;
-
-        case ProgramGraphNodeType::GraphInput:
-          ProcessOutput(static_cast<const GraphInputProgramGraphNode*>(node)->Output());
-          break;
-
-        case ProgramGraphNodeType::GraphOutput:
-          break;
-
-        default:
-          ASSERT(false);
-        }
+          });
       }
     }
 
-    // In the resulting HashSet, if (X, Y) is an element, then there is some path from X to Y
-    HashSet<std::tuple<const IProcessorProgramGraphNode*, const IProcessorProgramGraphNode*>> CalculateGraphNodeReachability(
-      Span<const IProcessorProgramGraphNode*> rootNodes);
+    // Holds the transitive closure of a graph as one bit row per node, indexed by topological order. IsReachable(X, Y) returns true if there is some path
+    // from X to Y (every node is considered reachable from itself).
+    class GraphNodeReachability
+    {
+    public:
+      GraphNodeReachability(Span<const IProcessorProgramGraphNode*> rootNodes);
+
+      bool IsReachable(const IProcessorProgramGraphNode* fromNode, const IProcessorProgramGraphNode* toNode) const;
+
+    private:
+      HashMap<const IProcessorProgramGraphNode*, usz> m_nodeIndices;
+      usz m_rowWordCount = 0;
+      FixedArray<u64> m_reachabilityRows;
+    };
 
     usz GetGraphOutputIndex(const ProgramGraph& programGraph, const GraphOutputProgramGraphNode* graphOutput);
   }
@@ -4,8 +4,12 @@ export import :ProgramProcessing.BufferOperations;
 export import :ProgramProcessing.BufferManager;
 export import :ProgramProcessing.BufferMemory;
 export import :ProgramProcessing.ConstantManager;
+export import :ProgramProcessing.OverloadGovernor;
+export import :ProgramProcessing.ProgramBank;
 export import :ProgramProcessing.ProgramGraphUtilities;
 export import :ProgramProcessing.ProgramProcessor;
+export import :ProgramProcessing.ProgramProcessorPlan;
 export import :ProgramProcessing.ProgramProcessorTypes;
 export import :ProgramProcessing.ProgramStageTaskManager;
+export import :ProgramProcessing.SharedConstantPool;
 export import :ProgramProcessing.VoiceAllocator;
\ No newline at end of file
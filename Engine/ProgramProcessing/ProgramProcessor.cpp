@@ -12,29 +12,123 @@ import :ProgramProcessing.ProgramGraphUtilities;
 
 namespace Chord
 {
-  static usz SampleTypeSize(SampleType sampleType)
+  // Returns the bytes of a host channel buffer which an engine buffer of the given type can alias for a block, or an empty span if samples must be copied
+  template<typename TByte>
+  static Span<TByte> GetAliasableChannelBytes(
+    SampleType sampleType,
+    Span<TByte> samples,
+    usz sampleStride,
+    PrimitiveType primitiveType,
+    usz blockSampleOffset,
+    usz blockSampleCount)
   {
-    switch (sampleType)
-    {
-    case SampleType::Float32:
-      return sizeof(f32);
+    bool typesMatch = (sampleType == SampleType::Float32 && primitiveType == PrimitiveTypeFloat)
+      || (sampleType == SampleType::Float64 && primitiveType == PrimitiveTypeDouble);
+    if (!typesMatch || sampleStride != 1)
+      { return {}; }
+
+    // Native modules may read and write whole vectors so the host memory must extend to the next multiple of MaxSimdAlignment. This usually isn't the case
+    // for the final partial block of a Process() call.
+    usz sampleSize = SampleTypeSize(sampleType);
+    usz byteOffset = blockSampleOffset * sampleSize;
+    usz byteCount = AlignInt(blockSampleCount * sampleSize, MaxSimdAlignment);
+    if (byteOffset + byteCount > samples.Count() || !IsAlignedPointer(samples.Elements() + byteOffset, MaxSimdAlignment))
+      { return {}; }
+
+    return Span<TByte>(samples, byteOffset, byteCount);
+  }
 
-    case SampleType::Float64:
-      return sizeof(f64);
+  // This is an upper bound because constants which are deduplicated or which are never stored in a constant buffer or constant array are still counted
+  static usz EstimateConstantByteCount(Span<const IProcessorProgramGraphNode*> rootNodes)
+  {
+    usz byteCount = 0;
+    IterateGraphTopological(
+      rootNodes,
+      [&](const IProcessorProgramGraphNode* node)
+      {
+        switch (node->Type())
+        {
+        case ProgramGraphNodeType::FloatConstant:
+        case ProgramGraphNodeType::DoubleConstant:
+        case ProgramGraphNodeType::IntConstant:
+        case ProgramGraphNodeType::BoolConstant:
+          byteCount += MaxSimdAlignment;
+          break;
 
-    default:
-      ASSERT(false, "Unsupported sample type");
-      return 0;
-    }
+        case ProgramGraphNodeType::StringConstant:
+          byteCount += static_cast<const StringConstantProgramGraphNode*>(node)->Value().Length() * sizeof(char32_t);
+          break;
+
+        case ProgramGraphNodeType::Array:
+          for (const IInputProgramGraphNode* elementNode : static_cast<const ArrayProgramGraphNode*>(node)->Elements())
+          {
+            switch (elementNode->Connection()->Processor()->Type())
+            {
+            case ProgramGraphNodeType::FloatConstant:
+              byteCount += sizeof(f32);
+              break;
+
+            case ProgramGraphNodeType::DoubleConstant:
+              byteCount += sizeof(f64);
+              break;
+
+            case ProgramGraphNodeType::IntConstant:
+              byteCount += sizeof(s32);
+              break;
+
+            case ProgramGraphNodeType::BoolConstant:
+              byteCount += sizeof(bool);
+              break;
+
+            case ProgramGraphNodeType::StringConstant:
+              byteCount += sizeof(InputString);
+              break;
+
+            default:
+              // Non-constant elements are passed as buffer arrays rather than constant arrays
+              break;
+            }
+          }
+
+          break;
+
+        default:
+          break;
+        }
+      });
+
+    return byteCount;
   }
 
+  struct StageInitializationContext
+  {
+    usz m_stageCount = 0;
+    usz m_initializedStageCount = 0;
+    Callable<void(usz initializedStageCount, usz stageCount)> m_progressCallback;
+    std::mutex m_mutex;
+    std::condition_variable m_conditionVariable;
+  };
+
   ProgramProcessor::ProgramProcessor(
     TaskExecutor* taskExecutor,
     NativeLibraryRegistry* nativeLibraryRegistry,
     const Program* program,
     const ProgramProcessorSettings& settings)
     : m_taskExecutor(taskExecutor)
+    , m_nativeLibraryRegistry(nativeLibraryRegistry)
     , m_bufferSampleCount(settings.m_bufferSampleCount)
+    , m_sampleRate(program->ProgramVariantProperties().m_sampleRate)
+    , m_alignVoiceStarts(settings.m_alignVoiceStarts)
+    , m_ditherIntegerOutputs(settings.m_ditherIntegerOutputs)
+    , m_zeroCopyChannelBuffers(settings.m_zeroCopyChannelBuffers)
+    , m_reportCallback(settings.m_reportCallback)
+    , m_serializedReportCallback(
+      [this](ReportingSeverity severity, const UnicodeString& message)
+      {
+        std::unique_lock lock(m_reportCallbackMutex);
+        m_reportCallback(severity, message);
+      })
+    , m_constantManager(settings.m_sharedConstantPool)
   {
     ASSERT(settings.m_bufferSampleCount > 0);
 
@@ -64,6 +158,17 @@ namespace Chord
       }
     }
 
+    // Give each output channel a distinct dither seed so that channels don't receive correlated dither
+    m_outputChannelDitherStates = InitializeCapacity(outputChannelCount);
+    for (usz outputChannelIndex = 0; outputChannelIndex < outputChannelCount; outputChannelIndex++)
+      { m_outputChannelDitherStates[outputChannelIndex] = u32(outputChannelIndex + 1) * 0x9e3779b9_u32; }
+
+    if (settings.m_measureChannelLevels)
+    {
+      m_inputChannelLevels = InitializeCapacity(inputChannelCount);
+      m_outputChannelLevels = InitializeCapacity(outputChannelCount);
+    }
+
     // Reserve voice output accumulation buffers
     if (programGraph.m_effectGraph.has_value())
     {
@@ -97,28 +202,41 @@ namespace Chord
         [&](const IProcessorProgramGraphNode* node)
           { nativeModuleCallNodeCount += (node->Type() == ProgramGraphNodeType::NativeModuleCall ? 1 : 0); });
 
-      m_voiceAllocator.emplace(voiceCount);
+      m_voiceAllocator.emplace(voiceCount, settings.m_voiceStealingPolicy);
       m_voices = InitializeCapacity(voiceCount);
       m_voiceSampleOffsets = InitializeCapacity(voiceCount);
       m_voiceSampleOffsets.ZeroElements();
+      if (settings.m_voiceStealingPolicy == VoiceStealingPolicy::Quietest || settings.m_silentVoiceDetectionSettings.has_value())
+        { m_voiceOutputPeakLevels = FixedArray<f32>(m_voiceOutputAccumulationBuffers.Count() * voiceCount, 0.0f); }
+
+      if (settings.m_silentVoiceDetectionSettings.has_value())
+      {
+        ASSERT(settings.m_silentVoiceDetectionSettings->m_blockCount > 0);
+        m_silentVoiceDetectionSettings = settings.m_silentVoiceDetectionSettings;
+        m_voiceSilentBlockCounts = FixedArray<usz>(voiceCount, 0_usz);
+      }
+
+      if (settings.m_overloadGovernorSettings.has_value())
+      {
+        ASSERT(m_sampleRate > 0);
+        m_overloadGovernor.emplace(settings.m_overloadGovernorSettings.value(), voiceCount);
+        m_voiceFadeOuts = FixedArray<bool>(voiceCount, false);
+      }
       for (usz i = 0; i < voiceCount; i++)
       {
         m_voices.AppendNew(
           nativeLibraryRegistry,
-          settings.m_reportCallback,
+          m_serializedReportCallback,
           program,
           true,
           &m_constantManager,
           &m_bufferManager,
           m_bufferSampleCount,
+          settings.m_tileSampleCount,
           m_inputChannelBuffersFloat.has_value() ? std::optional(Span<const BufferManager::BufferHandle>(*m_inputChannelBuffersFloat)) : std::nullopt,
           m_inputChannelBuffersDouble.has_value() ? std::optional(Span<const BufferManager::BufferHandle>(*m_inputChannelBuffersDouble)) : std::nullopt,
           nativeModuleCallNodeCount,
           rootNodes);
-
-        auto stageScratchMemoryRequirement = m_voices[m_voices.Count() - 1].GetScratchMemoryRequirement();
-        scratchMemoryRequirement.m_size = Max(scratchMemoryRequirement.m_size, stageScratchMemoryRequirement.m_size);
-        scratchMemoryRequirement.m_alignment = Max(scratchMemoryRequirement.m_alignment, stageScratchMemoryRequirement.m_alignment);
       }
     }
 
@@ -139,24 +257,82 @@ namespace Chord
 
       m_effect.emplace(
         nativeLibraryRegistry,
-        settings.m_reportCallback,
+        m_serializedReportCallback,
         program,
         false,
         &m_constantManager,
         &m_bufferManager,
         m_bufferSampleCount,
+        settings.m_tileSampleCount,
         m_inputChannelBuffersFloat.has_value() ? std::optional(Span<const BufferManager::BufferHandle>(*m_inputChannelBuffersFloat)) : std::nullopt,
         m_inputChannelBuffersDouble.has_value() ? std::optional(Span<const BufferManager::BufferHandle>(*m_inputChannelBuffersDouble)) : std::nullopt,
         nativeModuleCallNodeCount,
         rootNodes);
+    }
 
-      auto stageScratchMemoryRequirement = m_effect->GetScratchMemoryRequirement();
-      scratchMemoryRequirement.m_size = Max(scratchMemoryRequirement.m_size, stageScratchMemoryRequirement.m_size);
-      scratchMemoryRequirement.m_alignment = Max(scratchMemoryRequirement.m_alignment, stageScratchMemoryRequirement.m_alignment);
+    // An effect stage which activates based on its input level can be initialized in the background when it first activates. Voice-activated effect stages
+    // are initialized eagerly because deferring them would drop the note which first activates them.
+    bool deferEffectInitialization = m_effect.has_value()
+      && m_effectActivationMode == EffectActivationMode::Threshold
+      && settings.m_effectStageWarmUpPolicy == EffectStageWarmUpPolicy::OnFirstActivation;
+
+    // Native module voice initialization often allocates and clears large amounts of memory. Stages are independent of one another so their voice contexts
+    // are initialized on task threads while buffers are allocated on this thread.
+    ASSERT(!GetTaskThreadIndex().has_value(), "Waiting for stage initialization from a task thread could deadlock");
+    StageInitializationContext stageInitializationContext =
+    {
+      .m_stageCount = m_voices.Count() + (m_effect.has_value() && !deferEffectInitialization ? 1 : 0),
+      .m_progressCallback = settings.m_initializationProgressCallback,
+    };
+
+    FixedArray<Task> stageInitializationTasks = InitializeCapacity(stageInitializationContext.m_stageCount);
+    for (usz stageIndex = 0; stageIndex < stageInitializationContext.m_stageCount; stageIndex++)
+    {
+      ProgramStageTaskManager* stage = stageIndex < m_voices.Count() ? &m_voices[stageIndex] : &m_effect.value();
+      stageInitializationTasks[stageIndex].Initialize(
+        [stage, context = &stageInitializationContext]()
+        {
+          stage->InitializeVoiceContexts();
+
+          // The callback is invoked while holding the lock so that progress is reported in order. This also keeps the context alive until the constructor has
+          // been notified.
+          std::unique_lock lock(context->m_mutex);
+          context->m_initializedStageCount++;
+          if (context->m_progressCallback.IsValid())
+            { context->m_progressCallback(context->m_initializedStageCount, context->m_stageCount); }
+          if (context->m_initializedStageCount == context->m_stageCount)
+            { context->m_conditionVariable.notify_one(); }
+        });
+      m_taskExecutor->EnqueueTask(&stageInitializationTasks[stageIndex]);
     }
 
     // Now that tasks and buffers have been assigned, we can allocate buffer memory
-    AllocateBuffers(programGraph);
+    m_planKey = CalculateProgramProcessorPlanKey(nativeLibraryRegistry, program, m_bufferSampleCount, m_taskExecutor->GetThreadCount());
+    AllocateBuffers(programGraph, settings.m_cachedPlan);
+
+    {
+      std::unique_lock lock(stageInitializationContext.m_mutex);
+      stageInitializationContext.m_conditionVariable.wait(
+        lock,
+        [&]() { return stageInitializationContext.m_initializedStageCount == stageInitializationContext.m_stageCount; });
+    }
+
+    // Scratch memory requirements are reported by native modules during voice initialization
+    auto AddScratchMemoryRequirement =
+      [&](const ProgramStageTaskManager& stage)
+      {
+        auto stageScratchMemoryRequirement = stage.GetScratchMemoryRequirement();
+        scratchMemoryRequirement.m_size = Max(scratchMemoryRequirement.m_size, stageScratchMemoryRequirement.m_size);
+        scratchMemoryRequirement.m_alignment = Max(scratchMemoryRequirement.m_alignment, stageScratchMemoryRequirement.m_alignment);
+      };
+
+    for (const ProgramStageTaskManager& voice : m_voices)
+      { AddScratchMemoryRequirement(voice); }
+    if (m_effect.has_value() && !deferEffectInitialization)
+      { AddScratchMemoryRequirement(*m_effect); }
+
+    if (settings.m_reportBufferSharing)
+      { ReportBufferSharing(m_serializedReportCallback); }
 
     // Allocate scratch memory
     m_threadScratchMemoryAllocations = InitializeCapacity(m_taskExecutor->GetThreadCount());
@@ -170,6 +346,39 @@ namespace Chord
       }
     }
 
+    // Allocate per-thread partial sums for each voice output accumulation buffer
+    if (settings.m_parallelVoiceOutputAccumulation && programGraph.m_voiceGraph.has_value() && !m_voiceOutputAccumulationBuffers.IsEmpty())
+    {
+      usz threadCount = m_taskExecutor->GetThreadCount();
+      usz partialSumsByteCount = 0;
+      for (BufferManager::BufferHandle bufferHandle : m_voiceOutputAccumulationBuffers)
+        { partialSumsByteCount += BufferManager::CalculateBufferByteCount(m_bufferManager.GetBuffer(bufferHandle).m_primitiveType, m_bufferSampleCount, 1); }
+
+      m_voiceOutputPartialSumAllocations = InitializeCapacity(threadCount);
+      m_voiceOutputPartialSums = InitializeCapacity(m_voiceOutputAccumulationBuffers.Count() * threadCount);
+      m_threadVoiceOutputPartialSumsAccumulated = FixedArray<bool>(threadCount, false);
+      for (usz threadIndex = 0; threadIndex < threadCount; threadIndex++)
+      {
+        m_voiceOutputPartialSumAllocations[threadIndex] = { partialSumsByteCount, MaxSimdAlignment };
+        usz byteOffset = 0;
+        for (usz outputIndex = 0; outputIndex < m_voiceOutputAccumulationBuffers.Count(); outputIndex++)
+        {
+          PrimitiveType primitiveType = m_bufferManager.GetBuffer(m_voiceOutputAccumulationBuffers[outputIndex]).m_primitiveType;
+          usz byteCount = BufferManager::CalculateBufferByteCount(primitiveType, m_bufferSampleCount, 1);
+          m_voiceOutputPartialSums[outputIndex * threadCount + threadIndex] =
+          {
+            .m_primitiveType = primitiveType,
+            .m_upsampleFactor = 1,
+            .m_byteCount = byteCount,
+            .m_memory = m_voiceOutputPartialSumAllocations[threadIndex].m_memory.Elements() + byteOffset,
+            .m_isConstant = false,
+          };
+
+          byteOffset += byteCount;
+        }
+      }
+    }
+
     // Now we set up tasks
     auto startProcessBlockTaskHandle = m_taskGraph.AddTask({ this, &ProgramProcessor::StartProcessBlock });
 
@@ -219,10 +428,33 @@ namespace Chord
     m_taskGraph.AddDependency(fillOutputChannelBuffersTaskHandle, finishProcessBlockTaskHandle);
 
     m_taskGraph.FinalizeTasks();
+
+    if (deferEffectInitialization)
+      { m_effectInitializationState.store(EffectInitializationState::NotRequested, std::memory_order_relaxed); }
   }
 
   ProgramProcessor::~ProgramProcessor()
   {
+    // The deferred effect initialization task references this processor so if it has been enqueued, we need to make sure it's no longer pending. If it's still
+    // in the background queue, we pull it out rather than waiting behind other processors' background work. Otherwise, it has been dequeued and we wait for it
+    // (if it hasn't started initializing yet, it skips initialization).
+    {
+      std::unique_lock lock(m_effectInitializationMutex);
+      if (m_effectInitializationState.load(std::memory_order_relaxed) == EffectInitializationState::Requested
+        && m_taskExecutor->TryRemoveBackgroundTask(&m_effectInitializationTask))
+        { m_effectInitializationState.store(EffectInitializationState::NotRequested, std::memory_order_relaxed); }
+
+      auto expectedState = EffectInitializationState::Requested;
+      m_effectInitializationState.compare_exchange_strong(expectedState, EffectInitializationState::Cancelling, std::memory_order_relaxed);
+      m_effectInitializationConditionVariable.wait(
+        lock,
+        [&]()
+        {
+          auto state = m_effectInitializationState.load(std::memory_order_relaxed);
+          return state == EffectInitializationState::NotRequested || state == EffectInitializationState::Initialized;
+        });
+    }
+
     // This would happen automatically but I'm setting up a destructor to be explicit about when native library/module contexts get deinitialized
     m_effect.reset();
 
@@ -230,6 +462,131 @@ namespace Chord
     m_voices.Clear();
   }
 
+  ProgramProcessorMemoryFootprint ProgramProcessor::EstimateMemoryFootprint(
+    const NativeLibraryRegistry* nativeLibraryRegistry,
+    const Program* program,
+    const ProgramProcessorSettings& settings,
+    usz threadCount)
+  {
+    ASSERT(settings.m_bufferSampleCount > 0);
+
+    const ProgramGraph& programGraph = program->ProgramGraph();
+    usz inputChannelCount = Coerce<usz>(program->ProgramVariantProperties().m_inputChannelCount);
+    usz outputChannelCount = Coerce<usz>(program->ProgramVariantProperties().m_outputChannelCount);
+    usz voiceCount = program->InstrumentProperties().m_maxVoices;
+
+    ProgramProcessorMemoryFootprint footprint =
+    {
+      .m_threadCount = threadCount,
+      .m_voiceCount = programGraph.m_voiceGraph.has_value() ? voiceCount : 0,
+    };
+
+    usz bufferCount = 0;
+    auto AddBuffers =
+      [&](PrimitiveType primitiveType, usz count)
+      {
+        bufferCount += count;
+        footprint.m_unsharedBufferByteCount += count * BufferManager::CalculateBufferByteCount(primitiveType, settings.m_bufferSampleCount, 1);
+      };
+
+    // These mirror the input channel and voice output accumulation buffers reserved in the constructor
+    if (programGraph.m_inputChannelsFloat.has_value())
+      { AddBuffers(PrimitiveTypeFloat, inputChannelCount); }
+    if (programGraph.m_inputChannelsDouble.has_value())
+      { AddBuffers(PrimitiveTypeDouble, inputChannelCount); }
+
+    if (programGraph.m_effectGraph.has_value())
+    {
+      for (PrimitiveType primitiveType : programGraph.m_voiceToEffectPrimitiveTypes)
+        { AddBuffers(primitiveType, 1); }
+    }
+    else
+      { AddBuffers(programGraph.m_outputChannelPrimitiveType, outputChannelCount); }
+
+    // Each thread holds a partial sum for each voice output accumulation buffer when parallel voice output accumulation is enabled. These aren't managed by
+    // the buffer manager so they don't count towards the buffer count.
+    if (settings.m_parallelVoiceOutputAccumulation && programGraph.m_voiceGraph.has_value())
+    {
+      if (programGraph.m_effectGraph.has_value())
+      {
+        for (PrimitiveType primitiveType : programGraph.m_voiceToEffectPrimitiveTypes)
+          { footprint.m_unsharedBufferByteCount += threadCount * BufferManager::CalculateBufferByteCount(primitiveType, settings.m_bufferSampleCount, 1); }
+      }
+      else
+      {
+        footprint.m_unsharedBufferByteCount +=
+          threadCount * outputChannelCount * BufferManager::CalculateBufferByteCount(programGraph.m_outputChannelPrimitiveType, settings.m_bufferSampleCount, 1);
+      }
+    }
+
+    auto AddStage =
+      [&](Span<const IProcessorProgramGraphNode*> outputNodes, usz instanceCount)
+      {
+        auto rootNodes = FindGraphRootNodes(outputNodes);
+        auto stageFootprint = ProgramStageTaskManager::EstimateMemoryFootprint(nativeLibraryRegistry, settings.m_bufferSampleCount, rootNodes);
+        bufferCount += instanceCount * stageFootprint.m_bufferCount;
+        footprint.m_unsharedBufferByteCount += instanceCount * stageFootprint.m_unsharedBufferByteCount;
+        footprint.m_unreportedNativeModuleVoiceContextCount += instanceCount * stageFootprint.m_unreportedNativeModuleVoiceContextCount;
+        footprint.m_taskMetadataByteCount += instanceCount * (sizeof(ProgramStageTaskManager) + stageFootprint.m_taskMetadataByteCount);
+
+        // Constants are shared by all instances of a stage
+        footprint.m_constantByteCount += EstimateConstantByteCount(rootNodes);
+      };
+
+    if (programGraph.m_voiceGraph.has_value())
+      { AddStage(*programGraph.m_voiceGraph, voiceCount); }
+    if (programGraph.m_effectGraph.has_value())
+      { AddStage(*programGraph.m_effectGraph, 1); }
+
+    footprint.m_sharedBufferByteCount = footprint.m_unsharedBufferByteCount;
+    footprint.m_constantByteCount += bufferCount * BufferConstantValueByteCount;
+    footprint.m_taskMetadataByteCount += BufferManager::EstimateMetadataByteCount(bufferCount);
+    return footprint;
+  }
+
+  ProgramProcessorMemoryFootprint ProgramProcessor::GetMemoryFootprint() const
+  {
+    ProgramProcessorMemoryFootprint footprint =
+    {
+      .m_sharedBufferByteCount = m_bufferManager.GetAllocatedByteCount(),
+      .m_unsharedBufferByteCount = m_bufferManager.GetUnsharedByteCount(),
+      .m_constantByteCount = m_constantManager.GetByteCount() + m_bufferManager.GetConstantValueByteCount(),
+      .m_threadCount = m_threadScratchMemory.Count(),
+      .m_scratchByteCountPerThread = m_threadScratchMemory.IsEmpty() ? 0 : m_threadScratchMemory[0].Count(),
+      .m_voiceCount = m_voices.Count(),
+      .m_taskMetadataByteCount = m_bufferManager.GetMetadataByteCount() + m_voiceSampleOffsets.Count() * sizeof(usz),
+    };
+
+    // Partial sums for parallel voice output accumulation are never shared
+    for (const ScratchMemoryAllocation& allocation : m_voiceOutputPartialSumAllocations)
+    {
+      footprint.m_sharedBufferByteCount += allocation.m_memory.Count();
+      footprint.m_unsharedBufferByteCount += allocation.m_memory.Count();
+    }
+
+    auto AddStage =
+      [&](const ProgramStageTaskManager& stage)
+      {
+        auto stageFootprint = stage.GetMemoryFootprint(&m_bufferManager);
+        footprint.m_nativeModuleVoiceContextByteCount += stageFootprint.m_nativeModuleVoiceContextByteCount;
+        footprint.m_unreportedNativeModuleVoiceContextCount += stageFootprint.m_unreportedNativeModuleVoiceContextCount;
+        footprint.m_taskMetadataByteCount += sizeof(ProgramStageTaskManager) + stageFootprint.m_taskMetadataByteCount;
+      };
+
+    for (const ProgramStageTaskManager& voice : m_voices)
+      { AddStage(voice); }
+
+    // A deferred effect stage's voice contexts may still be initializing so it is excluded until initialization finishes
+    if (m_effect.has_value() && m_effectInitializationState.load(std::memory_order_acquire) == EffectInitializationState::Initialized)
+    {
+      AddStage(*m_effect);
+      if (!m_effectThreadScratchMemory.IsEmpty())
+        { footprint.m_scratchByteCountPerThread += m_effectThreadScratchMemory[0].Count(); }
+    }
+
+    return footprint;
+  }
+
   void ProgramProcessor::Process(
     usz sampleCount,
     Span<const InputChannelBuffer> inputChannelBuffers,
@@ -239,9 +596,17 @@ namespace Chord
     ASSERT(inputChannelBuffers.Count() == m_inputChannelBuffers.Count());
     ASSERT(outputChannelBuffers.Count() == m_outputChannelBuffers.Count());
     for (auto& inputChannelBuffer : inputChannelBuffers)
-      { ASSERT(inputChannelBuffer.m_samples.Count() == sampleCount * SampleTypeSize(inputChannelBuffer.m_sampleType)); }
+    {
+      // Interleaved channel buffers may extend past their own final sample into the other channels' samples in the final frame
+      usz byteCount = ChannelBufferByteCount(inputChannelBuffer.m_sampleType, inputChannelBuffer.m_sampleStride, sampleCount);
+      ASSERT(inputChannelBuffer.m_sampleStride == 1 ? inputChannelBuffer.m_samples.Count() == byteCount : inputChannelBuffer.m_samples.Count() >= byteCount);
+    }
+
     for (auto& outputChannelBuffer : outputChannelBuffers)
-      { ASSERT(outputChannelBuffer.m_samples.Count() == sampleCount * SampleTypeSize(outputChannelBuffer.m_sampleType)); }
+    {
+      usz byteCount = ChannelBufferByteCount(outputChannelBuffer.m_sampleType, outputChannelBuffer.m_sampleStride, sampleCount);
+      ASSERT(outputChannelBuffer.m_sampleStride == 1 ? outputChannelBuffer.m_samples.Count() == byteCount : outputChannelBuffer.m_samples.Count() >= byteCount);
+    }
 
     for (usz i = 0; i < voiceTriggers.Count(); i++)
     {
@@ -258,6 +623,9 @@ namespace Chord
     m_outputChannelBuffers = outputChannelBuffers;
     m_voiceTriggers = voiceTriggers;
 
+    m_inputChannelLevels.Fill(SampleStatistics());
+    m_outputChannelLevels.Fill(SampleStatistics());
+
     // Kicking off processing
     m_taskGraph.Run(m_taskExecutor);
 
@@ -266,8 +634,73 @@ namespace Chord
     m_processingConditionVariable.wait(lock, [this]() { return !m_processing; });
   }
 
-  void ProgramProcessor::AllocateBuffers(const ProgramGraph& programGraph)
+  UnboundedArray<u8> ProgramProcessor::SerializePlan() const
+  {
+    ProgramProcessorPlan plan =
+    {
+      .m_key = m_planKey,
+      .m_bufferAllocationPlan = m_bufferManager.GetAllocationPlan(),
+    };
+
+    return SerializeProgramProcessorPlan(plan);
+  }
+
+  bool ProgramProcessor::CanUpdateConstants(Span<const IProcessorProgramGraphNode*> changedNodes) const
+  {
+    HashSet<const IProcessorProgramGraphNode*> constantNodes = BuildConstantNodeSet(changedNodes);
+    for (const ProgramStageTaskManager& voice : m_voices)
+    {
+      if (!voice.CanUpdateConstants(constantNodes))
+        { return false; }
+    }
+
+    return !m_effect.has_value() || m_effect->CanUpdateConstants(constantNodes);
+  }
+
+  void ProgramProcessor::UpdateConstants(const Program* program, Span<const IProcessorProgramGraphNode*> changedNodes)
+  {
+    // A deferred effect stage may still be initializing its voice contexts on another thread but that only reads the arguments of native modules with voice
+    // contexts, which are never updated
+    HashSet<const IProcessorProgramGraphNode*> constantNodes = BuildConstantNodeSet(changedNodes);
+    for (ProgramStageTaskManager& voice : m_voices)
+    {
+      ASSERT(voice.CanUpdateConstants(constantNodes));
+      voice.UpdateConstants(&m_constantManager, constantNodes);
+    }
+
+    if (m_effect.has_value())
+    {
+      ASSERT(m_effect->CanUpdateConstants(constantNodes));
+      m_effect->UpdateConstants(&m_constantManager, constantNodes);
+    }
+
+    // The plan key includes the content hash, which the update changed. Tasks and buffers are unchanged so the plan itself is still valid.
+    m_planKey = CalculateProgramProcessorPlanKey(m_nativeLibraryRegistry, program, m_bufferSampleCount, m_taskExecutor->GetThreadCount());
+  }
+
+  HashSet<const IProcessorProgramGraphNode*> ProgramProcessor::BuildConstantNodeSet(Span<const IProcessorProgramGraphNode*> changedNodes)
   {
+    HashSet<const IProcessorProgramGraphNode*> constantNodes = InitializeCapacity(changedNodes.Count());
+    for (const IProcessorProgramGraphNode* node : changedNodes)
+      { constantNodes.Ensure(node); }
+    return constantNodes;
+  }
+
+  void ProgramProcessor::AllocateBuffers(const ProgramGraph& programGraph, std::optional<Span<const u8>> cachedPlan)
+  {
+    // Buffer concurrency analysis grows quadratically with the number of buffers so skip it if a matching plan was provided
+    if (cachedPlan.has_value())
+    {
+      auto plan = DeserializeProgramProcessorPlan(cachedPlan.value());
+      if (plan.has_value()
+        && std::memcmp(plan->m_key.Elements(), m_planKey.Elements(), m_planKey.Count()) == 0
+        && m_bufferManager.TryAllocateBuffers(plan->m_bufferAllocationPlan))
+      {
+        m_isUsingCachedPlan = true;
+        return;
+      }
+    }
+
     // Before allocating buffers, we need to determine buffer concurrency
     m_bufferManager.InitializeBufferConcurrency();
 
@@ -308,8 +741,50 @@ namespace Chord
     m_bufferManager.AllocateBuffers();
   }
 
+  void ProgramProcessor::ReportBufferSharing(const Callable<void(ReportingSeverity severity, const UnicodeString& message)>& reportCallback) const
+  {
+    using InPlaceSharingResult = BufferManager::InPlaceSharingResult;
+
+    // Tally up how each buffer fared as an in-place input, since inputs are where most sharing opportunities are lost
+    usz unsharedByteCount = 0;
+    usz inPlaceSharedCount = 0;
+    FixedArray<usz> inputResultCounts = InitializeCapacity(usz(InPlaceSharingResult::CandidatesClaimed) + 1);
+    inputResultCounts.ZeroElements();
+    for (usz bufferIndex = 0; bufferIndex < m_bufferManager.GetBufferCount(); bufferIndex++)
+    {
+      auto bufferHandle = BufferManager::BufferHandle(bufferIndex);
+      unsharedByteCount += m_bufferManager.GetBuffer(bufferHandle).m_byteCount;
+
+      auto diagnostic = m_bufferManager.GetBufferSharingDiagnostic(bufferHandle);
+      inputResultCounts[usz(diagnostic.m_inPlaceInputSharingResult)]++;
+      if (diagnostic.m_inPlaceOutputSharingResult == InPlaceSharingResult::Shared)
+        { inPlaceSharedCount++; }
+    }
+
+    reportCallback(
+      ReportingSeverityInfo,
+      Format(
+        U"Allocated ${} bytes for ${} buffers (${} bytes without sharing); ${} buffers were shared in-place. In-place sharing was not possible for inputs due to: "
+          U"disallowed (${}), untracked producer (${}), multiple usages in task (${}), no final input task (${}), no candidates (${}), incompatible "
+          U"candidates (${}), candidates claimed (${})",
+        m_bufferManager.GetAllocatedByteCount(),
+        m_bufferManager.GetBufferCount(),
+        unsharedByteCount,
+        inPlaceSharedCount,
+        inputResultCounts[usz(InPlaceSharingResult::Disallowed)],
+        inputResultCounts[usz(InPlaceSharingResult::UntrackedProducer)],
+        inputResultCounts[usz(InPlaceSharingResult::MultipleUsagesInTask)],
+        inputResultCounts[usz(InPlaceSharingResult::NoFinalInputTask)],
+        inputResultCounts[usz(InPlaceSharingResult::NoCandidates)],
+        inputResultCounts[usz(InPlaceSharingResult::IncompatibleCandidates)],
+        inputResultCounts[usz(InPlaceSharingResult::CandidatesClaimed)]));
+  }
+
   void ProgramProcessor::StartProcessBlock()
   {
+    if (m_overloadGovernor.has_value())
+      { m_blockStartTime = std::chrono::steady_clock::now(); }
+
     m_bufferManager.StartProcessing(m_blockSampleCount);
 
     ASSERT(m_blockSampleOffset < m_processSampleCount);
@@ -317,38 +792,74 @@ namespace Chord
 
     if (m_effectActivationThreshold.has_value())
       { m_shouldActivateEffect.store(false, std::memory_order_relaxed); }
+
+    m_threadVoiceOutputPartialSumsAccumulated.ZeroElements();
+
+    // Without an effect stage, voice outputs are accumulated directly into the output channel buffers when possible
+    if (m_zeroCopyChannelBuffers && !m_effect.has_value())
+    {
+      for (usz outputChannelIndex = 0; outputChannelIndex < m_outputChannelBuffers.Count(); outputChannelIndex++)
+      {
+        const OutputChannelBuffer& outputChannelBuffer = m_outputChannelBuffers[outputChannelIndex];
+        BufferManager::BufferHandle bufferHandle = m_voiceOutputAccumulationBuffers[outputChannelIndex];
+        Span<u8> aliasableBytes = GetAliasableChannelBytes(
+          outputChannelBuffer.m_sampleType,
+          outputChannelBuffer.m_samples,
+          outputChannelBuffer.m_sampleStride,
+          m_bufferManager.GetBuffer(bufferHandle).m_primitiveType,
+          m_blockSampleOffset,
+          m_blockSampleCount);
+        if (!aliasableBytes.IsEmpty())
+          { m_bufferManager.SetBufferExternalMemory(bufferHandle, aliasableBytes.Elements(), aliasableBytes.Count()); }
+      }
+    }
   }
 
   void ProgramProcessor::InitializeInputChannelBuffer(usz inputChannelIndex)
   {
-    if (m_inputChannelBuffersFloat.has_value())
+    auto InitializeBuffer = [&]<typename TElement>(BufferManager::BufferHandle bufferHandle)
     {
-      BufferManager::BufferHandle bufferHandle = m_inputChannelBuffersFloat.value()[inputChannelIndex];
+      const InputChannelBuffer& inputChannelBuffer = m_inputChannelBuffers[inputChannelIndex];
+      if (m_zeroCopyChannelBuffers)
+      {
+        Span<const u8> aliasableBytes = GetAliasableChannelBytes(
+          inputChannelBuffer.m_sampleType,
+          inputChannelBuffer.m_samples,
+          inputChannelBuffer.m_sampleStride,
+          m_bufferManager.GetBuffer(bufferHandle).m_primitiveType,
+          m_blockSampleOffset,
+          m_blockSampleCount);
+        if (!aliasableBytes.IsEmpty())
+        {
+          // Input channel buffers are never written by native modules because they have no producing task to share memory in-place with
+          m_bufferManager.SetBufferExternalMemory(bufferHandle, const_cast<u8*>(aliasableBytes.Elements()), aliasableBytes.Count());
+          return;
+        }
+      }
+
       m_bufferManager.StartBufferWrite(bufferHandle, nullptr);
-      InitializeFromInputChannelBuffer<f32>(
-        m_inputChannelBuffers[inputChannelIndex],
-        m_bufferManager.GetBuffer(bufferHandle),
-        m_blockSampleOffset,
-        m_blockSampleCount);
+      InitializeFromInputChannelBuffer<TElement>(inputChannelBuffer, m_bufferManager.GetBuffer(bufferHandle), m_blockSampleOffset, m_blockSampleCount);
       m_bufferManager.FinishBufferWrite(bufferHandle, nullptr);
-    }
+    };
 
+    if (m_inputChannelBuffersFloat.has_value())
+      { InitializeBuffer.template operator()<f32>(m_inputChannelBuffersFloat.value()[inputChannelIndex]); }
     if (m_inputChannelBuffersDouble.has_value())
+      { InitializeBuffer.template operator()<f64>(m_inputChannelBuffersDouble.value()[inputChannelIndex]); }
+
+    // If needed, determine if effect processing should be activated by checking for silence. When levels are being measured, the measured peak is used so
+    // that the input is only scanned once.
+    bool checkEffectActivation = m_effectActivationThreshold.has_value() && !m_effect->IsActive();
+    auto& inputChannelBuffer = m_inputChannelBuffers[inputChannelIndex];
+    if (!m_inputChannelLevels.IsEmpty())
     {
-      BufferManager::BufferHandle bufferHandle = m_inputChannelBuffersDouble.value()[inputChannelIndex];
-      m_bufferManager.StartBufferWrite(bufferHandle, nullptr);
-      InitializeFromInputChannelBuffer<f64>(
-        m_inputChannelBuffers[inputChannelIndex],
-        m_bufferManager.GetBuffer(bufferHandle),
-        m_blockSampleOffset,
-        m_blockSampleCount);
-      m_bufferManager.FinishBufferWrite(bufferHandle, nullptr);
+      SampleStatistics statistics = MeasureInputChannelBuffer(inputChannelBuffer, m_blockSampleOffset, m_blockSampleCount);
+      m_inputChannelLevels[inputChannelIndex].Combine(statistics);
+      if (checkEffectActivation && statistics.m_peak > m_effectActivationThreshold.value())
+        { m_shouldActivateEffect.store(true, std::memory_order_relaxed); }
     }
-
-    // If needed, determine if effect processing should be activated by checking for silence
-    if (m_effectActivationThreshold.has_value() && !m_effect->IsActive())
+    else if (checkEffectActivation)
     {
-      auto& inputChannelBuffer = m_inputChannelBuffers[inputChannelIndex];
       if (ShouldActivateEffect(inputChannelBuffer, m_effectActivationThreshold.value(), m_blockSampleOffset, m_blockSampleCount))
         { m_shouldActivateEffect.store(true, std::memory_order_relaxed); }
     }
@@ -367,7 +878,27 @@ namespace Chord
         { break; }
 
       ASSERT(voiceTrigger.m_sampleIndex >= m_blockSampleOffset);
-      m_voiceAllocator->TriggerVoice(voiceTrigger.m_sampleIndex - m_blockSampleOffset);
+      usz sampleIndex = voiceTrigger.m_sampleIndex - m_blockSampleOffset;
+      switch (voiceTrigger.m_type)
+      {
+      case VoiceTriggerType::Trigger:
+        {
+          usz voiceIndex = voiceTrigger.m_voiceId.has_value()
+            ? m_voiceAllocator->TriggerVoice(sampleIndex, voiceTrigger.m_voiceId.value())
+            : m_voiceAllocator->TriggerVoice(sampleIndex);
+          m_voiceAllocator->SetVoicePriority(voiceIndex, voiceTrigger.m_priority);
+          break;
+        }
+
+      case VoiceTriggerType::Release:
+        ASSERT(voiceTrigger.m_voiceId.has_value());
+        m_voiceAllocator->ReleaseVoice(voiceTrigger.m_voiceId.value());
+        break;
+
+      default:
+        ASSERT(false);
+        break;
+      }
     }
 
     // We'll process the remaining voice triggers when we process the next block
@@ -379,20 +910,86 @@ namespace Chord
 
     for (const VoiceAllocator::ActivatedVoice& activatedVoice : m_voiceAllocator->GetActivatedVoices())
     {
-      m_voices[activatedVoice.m_voiceIndex].SetActive(true);
-      m_voiceSampleOffsets[activatedVoice.m_voiceIndex] = activatedVoice.m_sampleIndex;
+      ProgramStageTaskManager& voice = m_voices[activatedVoice.m_voiceIndex];
+      usz voiceSampleOffset = activatedVoice.m_sampleIndex;
+      if (m_alignVoiceStarts)
+      {
+        usz voiceStartSampleOffset = voiceSampleOffset % VoiceStartSampleAlignment;
+        voiceSampleOffset -= voiceStartSampleOffset;
+        voice.SetVoiceStartSampleOffset(voiceStartSampleOffset);
+      }
+
+      voice.SetActive(true);
+      m_voiceSampleOffsets[activatedVoice.m_voiceIndex] = voiceSampleOffset;
+      if (!m_voiceSilentBlockCounts.IsEmpty())
+        { m_voiceSilentBlockCounts[activatedVoice.m_voiceIndex] = 0; }
+    }
+
+    // Stolen voices may have been fading out so refresh the fade flags of all active voices
+    if (!m_voiceFadeOuts.IsEmpty())
+    {
+      for (usz voiceIndex : m_voiceAllocator->GetActiveVoiceIndices())
+        { m_voiceFadeOuts[voiceIndex] = m_voiceAllocator->IsVoiceFadingOut(voiceIndex); }
     }
   }
 
   void ProgramProcessor::StartVoiceProcessing(usz activeVoiceIndex, StaticTaskGraph::TaskCompleter& taskCompleter)
   {
     usz voiceIndex = m_voiceAllocator->GetActiveVoiceIndices()[activeVoiceIndex];
-    m_voices[voiceIndex].Process(
-      m_taskExecutor,
-      &m_bufferManager,
-      m_blockSampleCount - m_voiceSampleOffsets[voiceIndex],
-      m_threadScratchMemory,
-      [&taskCompleter]() { taskCompleter.CompleteTask(); });
+    if (m_voiceOutputPartialSums.IsEmpty())
+    {
+      m_voices[voiceIndex].Process(
+        m_taskExecutor,
+        &m_bufferManager,
+        m_blockSampleCount - m_voiceSampleOffsets[voiceIndex],
+        m_threadScratchMemory,
+        [&taskCompleter]() { taskCompleter.CompleteTask(); });
+    }
+    else
+    {
+      // Accumulate outputs on whichever thread finishes the voice so that accumulation overlaps with voices that are still processing
+      m_voices[voiceIndex].Process(
+        m_taskExecutor,
+        &m_bufferManager,
+        m_blockSampleCount - m_voiceSampleOffsets[voiceIndex],
+        m_threadScratchMemory,
+        [this, voiceIndex, &taskCompleter]()
+        {
+          AccumulateVoiceOutputsToPartialSums(voiceIndex);
+          taskCompleter.CompleteTask();
+        });
+    }
+  }
+
+  void ProgramProcessor::AccumulateVoiceOutputsToPartialSums(usz voiceIndex)
+  {
+    auto taskThreadIndex = GetTaskThreadIndex();
+    ASSERT(taskThreadIndex.has_value());
+    usz threadIndex = taskThreadIndex.value();
+    usz threadCount = m_threadVoiceOutputPartialSumsAccumulated.Count();
+
+    // The voice has finished processing so its outputs can be published early
+    ProgramStageTaskManager& voice = m_voices[voiceIndex];
+    voice.PublishOutputs();
+
+    bool isFirstAccumulation = !m_threadVoiceOutputPartialSumsAccumulated[threadIndex];
+    bool fadeOut = !m_voiceFadeOuts.IsEmpty() && m_voiceFadeOuts[voiceIndex];
+    for (usz outputIndex = 0; outputIndex < m_voiceOutputAccumulationBuffers.Count(); outputIndex++)
+    {
+      AccumulateVoiceOutputToPartialSum(
+        voice,
+        voiceIndex,
+        m_voiceSampleOffsets[voiceIndex],
+        m_bufferManager,
+        outputIndex,
+        m_voiceOutputPartialSums[outputIndex * threadCount + threadIndex],
+        isFirstAccumulation,
+        m_blockSampleCount,
+        m_voiceOutputPeakLevels.IsEmpty() ? Span<f32>() : Span(m_voiceOutputPeakLevels, outputIndex * m_voices.Count(), m_voices.Count()),
+        fadeOut);
+    }
+
+    m_threadVoiceOutputPartialSumsAccumulated[threadIndex] = true;
   }
 
   void ProgramProcessor::FinishVoiceProcessing()
@@ -407,6 +1004,18 @@ namespace Chord
 
   void ProgramProcessor::AccumulateVoiceOutput(usz outputIndex)
   {
+    if (!m_voiceOutputPartialSums.IsEmpty())
+    {
+      usz threadCount = m_threadVoiceOutputPartialSumsAccumulated.Count();
+      ReduceVoiceOutputPartialSums(
+        m_bufferManager,
+        m_voiceOutputAccumulationBuffers[outputIndex],
+        Span(m_voiceOutputPartialSums, outputIndex * threadCount, threadCount),
+        m_threadVoiceOutputPartialSumsAccumulated,
+        m_blockSampleCount);
+      return;
+    }
+
     AccumulateVoiceOutputs(
       m_voices,
       m_voiceAllocator->GetActiveVoiceIndices(),
@@ -414,7 +1023,56 @@ namespace Chord
       m_bufferManager,
       outputIndex,
       m_voiceOutputAccumulationBuffers[outputIndex],
-      m_blockSampleCount);
+      m_blockSampleCount,
+      m_voiceOutputPeakLevels.IsEmpty() ? Span<f32>() : Span(m_voiceOutputPeakLevels, outputIndex * m_voices.Count(), m_voices.Count()),
+      m_voiceFadeOuts);
+  }
+
+  void ProgramProcessor::InitializeDeferredEffect()
+  {
+    {
+      std::unique_lock lock(m_effectInitializationMutex);
+      auto expectedState = EffectInitializationState::Requested;
+      if (!m_effectInitializationState.compare_exchange_strong(expectedState, EffectInitializationState::Initializing, std::memory_order_relaxed))
+      {
+        // The processor is being destroyed so initialization is skipped. The destructor is notified while holding the lock so that the processor stays alive
+        // until the notification has been sent.
+        ASSERT(expectedState == EffectInitializationState::Cancelling);
+        m_effectInitializationState.store(EffectInitializationState::NotRequested, std::memory_order_relaxed);
+        m_effectInitializationConditionVariable.notify_one();
+        return;
+      }
+    }
+
+    m_effect->InitializeVoiceContexts();
+
+    // The scratch memory shared by the voices was sized without knowing the effect stage's requirement so the effect stage may need its own
+    MemoryRequirement scratchMemoryRequirement = m_effect->GetScratchMemoryRequirement();
+    bool allocateScratchMemory = false;
+    if (scratchMemoryRequirement.m_size > 0)
+    {
+      for (Span<u8> threadScratchMemory : m_threadScratchMemory)
+      {
+        allocateScratchMemory |= threadScratchMemory.Count() < scratchMemoryRequirement.m_size
+          || !IsAlignedPointer(threadScratchMemory.Elements(), scratchMemoryRequirement.m_alignment);
+      }
+    }
+
+    if (allocateScratchMemory)
+    {
+      m_effectThreadScratchMemoryAllocations = InitializeCapacity(m_threadScratchMemory.Count());
+      m_effectThreadScratchMemory = InitializeCapacity(m_threadScratchMemory.Count());
+      for (usz i = 0; i < m_effectThreadScratchMemoryAllocations.Count(); i++)
+      {
+        m_effectThreadScratchMemoryAllocations[i] = { scratchMemoryRequirement.m_size, scratchMemoryRequirement.m_alignment };
+        m_effectThreadScratchMemory[i] = m_effectThreadScratchMemoryAllocations[i].m_memory;
+      }
+    }
+
+    // This publishes the effect stage's voice contexts and scratch memory to the processing threads
+    std::unique_lock lock(m_effectInitializationMutex);
+    m_effectInitializationState.store(EffectInitializationState::Initialized, std::memory_order_release);
+    m_effectInitializationConditionVariable.notify_one();
   }
 
   void ProgramProcessor::StartEffectProcessing(StaticTaskGraph::TaskCompleter& taskCompleter)
@@ -440,7 +1098,18 @@ namespace Chord
     }
 
     if (shouldActivate && !m_effect->IsActive())
-      { m_effect->SetActive(true); }
+    {
+      // If initialization was deferred, the first activation enqueues it on the background thread and the effect stage stays inactive until it finishes
+      auto initializationState = m_effectInitializationState.load(std::memory_order_acquire);
+      if (initializationState == EffectInitializationState::Initialized)
+        { m_effect->SetActive(true); }
+      else if (initializationState == EffectInitializationState::NotRequested)
+      {
+        m_effectInitializationState.store(EffectInitializationState::Requested, std::memory_order_relaxed);
+        m_effectInitializationTask.Initialize([this]() { InitializeDeferredEffect(); });
+        m_taskExecutor->EnqueueBackgroundTask(&m_effectInitializationTask);
+      }
+    }
 
     if (m_effect->IsActive())
     {
@@ -448,7 +1117,7 @@ namespace Chord
         m_taskExecutor,
         &m_bufferManager,
         m_blockSampleCount,
-        m_threadScratchMemory,
+        m_effectThreadScratchMemory.IsEmpty() ? m_threadScratchMemory : m_effectThreadScratchMemory,
         [&taskCompleter]() { taskCompleter.CompleteTask(); });
     }
     else
@@ -474,7 +1143,7 @@ namespace Chord
     else
       { source = m_voiceOutputAccumulationBuffers[outputChannelIndex]; }
 
-    // If the source is a constant buffer, just grab the constant out up-front for simplicity
+    // If the source is a constant buffer, just grab the tracked constant value up-front so that it can be broadcast without reading buffer memory
     if (auto bufferHandle = std::get_if<BufferManager::BufferHandle>(&source); bufferHandle != nullptr)
     {
       m_bufferManager.StartBufferRead(*bufferHandle, nullptr);
@@ -485,11 +1154,11 @@ namespace Chord
         switch (buffer.m_primitiveType)
         {
         case PrimitiveTypeFloat:
-          source = buffer.Get<f32>(1)[0];
+          source = buffer.GetConstant<f32>();
           break;
 
         case PrimitiveTypeDouble:
-          source = buffer.Get<f64>(1)[0];
+          source = buffer.GetConstant<f64>();
           break;
 
         case PrimitiveTypeInt:
@@ -504,16 +1173,49 @@ namespace Chord
       m_bufferManager.FinishBufferRead(*bufferHandle, nullptr);
     }
 
+    auto MeasureConstant = [&](f64 value)
+    {
+      if (!m_outputChannelLevels.IsEmpty())
+      {
+        m_outputChannelLevels[outputChannelIndex].Combine(
+          { .m_peak = Abs(value), .m_sumOfSquares = value * value * f64(m_blockSampleCount), .m_sampleCount = m_blockSampleCount });
+      }
+    };
+
     if (auto f32Value = std::get_if<f32>(&source); f32Value != nullptr)
-      { ::Chord::FillOutputChannelBuffer(outputChannelBuffer, *f32Value, m_blockSampleOffset, m_blockSampleCount); }
+    {
+      MeasureConstant(*f32Value);
+      ::Chord::FillOutputChannelBuffer(outputChannelBuffer, *f32Value, m_blockSampleOffset, m_blockSampleCount);
+    }
     else if (auto f64Value = std::get_if<f64>(&source); f64Value != nullptr)
-      { ::Chord::FillOutputChannelBuffer(outputChannelBuffer, *f64Value, m_blockSampleOffset, m_blockSampleCount); }
+    {
+      MeasureConstant(*f64Value);
+      ::Chord::FillOutputChannelBuffer(outputChannelBuffer, *f64Value, m_blockSampleOffset, m_blockSampleCount);
+    }
     else
     {
       auto bufferHandle = std::get<BufferManager::BufferHandle>(source);
       m_bufferManager.StartBufferRead(bufferHandle, nullptr);
       const BufferManager::Buffer& buffer = m_bufferManager.GetBuffer(bufferHandle);
-      ::Chord::FillOutputChannelBuffer(outputChannelBuffer, buffer, m_blockSampleOffset, m_blockSampleCount);
+
+      if (!m_outputChannelLevels.IsEmpty())
+      {
+        m_outputChannelLevels[outputChannelIndex].Combine(
+          buffer.m_primitiveType == PrimitiveTypeFloat
+            ? MeasureSamples(Span<const f32>(buffer.Get<f32>(m_blockSampleCount)))
+            : MeasureSamples(Span<const f64>(buffer.Get<f64>(m_blockSampleCount))));
+      }
+
+      // If the buffer aliases the output channel buffer, the samples are already in place
+      const u8* blockSamples = outputChannelBuffer.m_samples.Elements() + m_blockSampleOffset * SampleTypeSize(outputChannelBuffer.m_sampleType);
+      if (buffer.m_memory == blockSamples)
+      {
+        m_bufferManager.FinishBufferRead(bufferHandle, nullptr);
+        return;
+      }
+
+      u32* ditherState = m_ditherIntegerOutputs ? &m_outputChannelDitherStates[outputChannelIndex] : nullptr;
+      ::Chord::FillOutputChannelBuffer(outputChannelBuffer, buffer, m_blockSampleOffset, m_blockSampleCount, ditherState);
       m_bufferManager.FinishBufferRead(bufferHandle, nullptr);
     }
   }
@@ -523,20 +1225,72 @@ namespace Chord
     // Disable voices at the end, after we've processed their output buffers
     if (m_voiceAllocator.has_value())
     {
-      for (usz voiceIndex : m_voiceAllocator->GetActiveVoiceIndices())
+      // Combine each voice's per-output peak levels so that the quietest voice can be stolen in the next block and so that silent voices can be detected
+      if (!m_voiceOutputPeakLevels.IsEmpty())
+      {
+        for (usz voiceIndex : m_voiceAllocator->GetActiveVoiceIndices())
+        {
+          f32 peakLevel = 0.0f;
+          for (usz outputIndex = 0; outputIndex < m_voiceOutputAccumulationBuffers.Count(); outputIndex++)
+            { peakLevel = Max(peakLevel, m_voiceOutputPeakLevels[outputIndex * m_voices.Count() + voiceIndex]); }
+          m_voiceAllocator->SetVoicePeakLevel(voiceIndex, peakLevel);
+
+          if (m_silentVoiceDetectionSettings.has_value())
+          {
+            bool isSilent = peakLevel <= m_silentVoiceDetectionSettings->m_threshold
+              && (!m_silentVoiceDetectionSettings->m_releasedVoicesOnly || m_voiceAllocator->IsVoiceReleased(voiceIndex));
+            m_voiceSilentBlockCounts[voiceIndex] = isSilent ? m_voiceSilentBlockCounts[voiceIndex] + 1 : 0;
+          }
+        }
+      }
+
+      // Iterate in reverse because deactivating a voice moves the last active voice into its slot. Voices which were fading out have now faded to silence.
+      usz processedVoiceCount = m_voiceAllocator->GetActiveVoiceIndices().Count();
+      for (usz i = m_voiceAllocator->GetActiveVoiceIndices().Count(); i-- > 0;)
       {
+        usz voiceIndex = m_voiceAllocator->GetActiveVoiceIndices()[i];
+
+        // Voices which continue into the next block process all of it
+        m_voiceSampleOffsets[voiceIndex] = 0;
         ProgramStageTaskManager& voice = m_voices[voiceIndex];
-        if (!voice.ShouldRemainActive())
+        bool isSilent = !m_voiceSilentBlockCounts.IsEmpty() && m_voiceSilentBlockCounts[voiceIndex] >= m_silentVoiceDetectionSettings->m_blockCount;
+        if (!voice.ShouldRemainActive() || m_voiceAllocator->IsVoiceFadingOut(voiceIndex) || isSilent)
         {
           m_voiceAllocator->DeactivateVoice(voiceIndex);
           voice.SetActive(false);
         }
       }
+
+      if (m_overloadGovernor.has_value())
+      {
+        // Any voices shed here start fading out in the next block
+        f64 elapsedSeconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - m_blockStartTime).count();
+        f64 blockSeconds = f64(m_blockSampleCount) / f64(m_sampleRate);
+        usz voiceLimit = m_overloadGovernor->Update(elapsedSeconds / blockSeconds, processedVoiceCount);
+        if (voiceLimit != m_voiceAllocator->GetVoiceLimit())
+          { m_voiceAllocator->SetVoiceLimit(voiceLimit); }
+      }
     }
 
     if (m_effect.has_value() && !m_effect->ShouldRemainActive())
       { m_effect->SetActive(false); }
 
+    // Don't hold on to host memory past the end of the block
+    if (m_zeroCopyChannelBuffers)
+    {
+      auto ClearExternalMemory = [&](Span<const BufferManager::BufferHandle> bufferHandles)
+      {
+        for (BufferManager::BufferHandle bufferHandle : bufferHandles)
+          { m_bufferManager.ClearBufferExternalMemory(bufferHandle); }
+      };
+
+      if (m_inputChannelBuffersFloat.has_value())
+        { ClearExternalMemory(m_inputChannelBuffersFloat.value()); }
+      if (m_inputChannelBuffersDouble.has_value())
+        { ClearExternalMemory(m_inputChannelBuffersDouble.value()); }
+      ClearExternalMemory(m_voiceOutputAccumulationBuffers);
+    }
+
     m_bufferManager.FinishProcessing();
 
     m_blockSampleOffset += m_blockSampleCount;
@@ -11,7 +11,10 @@ import :Native;
 import :Program;
 import :ProgramProcessing.BufferManager;
 import :ProgramProcessing.ConstantManager;
+import :ProgramProcessing.OverloadGovernor;
+import :ProgramProcessing.ProgramProcessorPlan;
 import :ProgramProcessing.ProgramProcessorTypes;
+import :ProgramProcessing.SharedConstantPool;
 import :ProgramProcessing.ProgramStageTaskManager;
 import :ProgramProcessing.VoiceAllocator;
 import :TaskSystem;
@@ -20,15 +23,103 @@ namespace Chord
 {
   export
   {
+    struct SilentVoiceDetectionSettings
+    {
+      // A block counts as silent for a voice when the peak level of every one of the voice's outputs is at or below this value
+      f32 m_threshold = 1.0e-4f;
+
+      // The number of consecutive silent blocks after which the voice is deactivated
+      usz m_blockCount = 8;
+
+      // If true, only voices which have been released are deactivated. This protects held voices which are silent for a while (e.g. due to a delayed onset).
+      bool m_releasedVoicesOnly = true;
+    };
+
+    // Determines when the effect stage's native module voice contexts (which may allocate large amounts of memory, e.g. for reverb tails) are initialized
+    enum class EffectStageWarmUpPolicy
+    {
+      // The effect stage is initialized along with the voices when the processor is constructed
+      Eager,
+
+      // The effect stage is initialized on the task executor's background thread the first time that it would activate. Until initialization finishes, the
+      // effect stage stays inactive and its outputs are silent, so the start of the input which triggered activation is lost. This only applies to programs
+      // whose effect activation mode is EffectActivationMode::Threshold. Effect stages which activate with voices would drop the first note (often entirely,
+      // for short notes) and effect stages which are always active need to be ready for the first block, so both are initialized eagerly.
+      OnFirstActivation,
+    };
+
     struct ProgramProcessorSettings
     {
       usz m_bufferSampleCount = 1024;
+
+      // Stages made up entirely of tileable native modules process blocks in sub-blocks of (at least) this many samples so that intermediate buffers stay in
+      // cache. The value is rounded up so that every sub-block starts at a SIMD-aligned offset. Set to 0 to always process full blocks.
+      usz m_tileSampleCount = 64;
+
+      // If true, voices triggered partway through a block start processing at the preceding multiple of VoiceStartSampleAlignment so that their outputs can
+      // be accumulated with aligned SIMD operations. The remaining offset is reported to native modules through NativeModuleContext::m_voiceStartSampleOffset
+      // so that modules which support it can keep onsets sample-accurate. Other voices start up to VoiceStartSampleAlignment - 1 samples early.
+      bool m_alignVoiceStarts = false;
+
+      // If true, each voice's outputs are summed into per-thread partial sums by the worker thread that finishes processing the voice, overlapping voice
+      // output accumulation with voices that are still processing. Only the partial sums (one per worker thread) are summed once all voices have finished.
+      // Constant voice outputs are expanded in this mode so it is best suited to programs with many simultaneously active voices.
+      bool m_parallelVoiceOutputAccumulation = false;
+
+      // If true, triangular dither of up to 1 LSB is added to output samples written to integer output channel buffers. Constant outputs (such as silence)
+      // are never dithered.
+      bool m_ditherIntegerOutputs = true;
+
+      // If true, engine buffers for input channels (and for output channels of programs without an effect stage) point directly at host channel buffer memory
+      // for each block instead of copying samples in and out. Channel buffers are only aliased when they are planar, match the engine buffer's sample type,
+      // are aligned to MaxSimdAlignment, and extend far enough past the block to cover a whole number of SIMD vectors. Otherwise, samples are copied.
+      bool m_zeroCopyChannelBuffers = false;
+
+      // If true, the peak and RMS level of each input and output channel are measured across each Process() call. Input levels are measured from host
+      // samples in the same pass as the effect activation threshold check. Output levels are measured from engine output samples before they are converted to
+      // the host sample type.
+      bool m_measureChannelLevels = false;
+
+      // If provided, this should hold a plan previously returned by ProgramProcessor::SerializePlan(). If the plan was produced for the same program, buffer
+      // sample count, thread count, and native library versions, buffer concurrency analysis and buffer memory grouping are skipped. Otherwise, it is ignored.
+      std::optional<Span<const u8>> m_cachedPlan;
+
+      // If provided, strings, primitive constant arrays, and constant buffers are stored in this pool and shared with other processors using the same pool
+      // rather than being stored by this processor. Constants held by the pool are not included in this processor's memory footprint. The pool must outlive
+      // the processor.
+      SharedConstantPool* m_sharedConstantPool = nullptr;
+
+      // Native modules may report messages from several task threads at once (voice contexts are initialized concurrently during construction) and from the
+      // background thread (when effect stage initialization is deferred). The processor serializes calls so this does not need to be thread-safe.
       Callable<void(ReportingSeverity severity, const UnicodeString& message)> m_reportCallback;
+
+      // Voice contexts for each voice and for the effect stage are initialized in parallel on task threads during construction. If provided, this is called
+      // (from task threads, one call at a time) as each stage finishes initializing. The final call, where initializedStageCount equals stageCount, signals
+      // that initialization is complete. Hosts which construct processors on a loading thread can use this to report progress without blocking other threads.
+      Callable<void(usz initializedStageCount, usz stageCount)> m_initializationProgressCallback;
+
+      // If true, a summary of how buffer memory was shared (and why buffers weren't shared in-place) is sent to the report callback after allocation
+      bool m_reportBufferSharing = false;
+
+      // Determines which voice is stolen when all voices are in use. VoiceStealingPolicy::Quietest enables per-voice peak level measurement while voice outputs
+      // are accumulated.
+      VoiceStealingPolicy m_voiceStealingPolicy = VoiceStealingPolicy::Oldest;
+
+      // If provided, block processing time is measured against the real-time duration of each block and the number of playing voices is lowered (fading out
+      // the voices chosen by the voice stealing policy) when processing approaches the deadline. Voices are restored once load drops.
+      std::optional<OverloadGovernorSettings> m_overloadGovernorSettings;
+
+      EffectStageWarmUpPolicy m_effectStageWarmUpPolicy = EffectStageWarmUpPolicy::Eager;
+
+      // If provided, voices whose output stays silent are deactivated even if their remain-active output is still true. Voice output peak levels are measured
+      // by the same vectorized loop that accumulates voice outputs so this doesn't add another pass over voice output samples.
+      std::optional<SilentVoiceDetectionSettings> m_silentVoiceDetectionSettings;
     };
 
     class ProgramProcessor
     {
     public:
+      // Construction waits for work enqueued on taskExecutor so it must not happen on one of taskExecutor's threads
       ProgramProcessor(
         TaskExecutor* taskExecutor,
         NativeLibraryRegistry* nativeLibraryRegistry,
@@ -39,6 +130,42 @@ namespace Chord
       ProgramProcessor(const ProgramProcessor&) = delete;
       ProgramProcessor& operator=(const ProgramProcessor&) = delete;
 
+      // Estimates the memory that a ProgramProcessor would hold for the given program without instantiating it or allocating buffers. This can be used to
+      // reject a program (or to retry with a smaller buffer sample count) before constructing a ProgramProcessor. Buffer sharing is not analyzed so buffer
+      // memory is an upper bound, and native module scratch memory and voice contexts are not included.
+      static ProgramProcessorMemoryFootprint EstimateMemoryFootprint(
+        const NativeLibraryRegistry* nativeLibraryRegistry,
+        const Program* program,
+        const ProgramProcessorSettings& settings,
+        usz threadCount);
+
+      ProgramProcessorMemoryFootprint GetMemoryFootprint() const;
+
+      // Returns a plan which the host can store (e.g. in an on-disk cache keyed by program) and supply through ProgramProcessorSettings::m_cachedPlan to speed
+      // up construction of later processors for the same program and configuration. This must not be called while Process() is running.
+      UnboundedArray<u8> SerializePlan() const;
+
+      // Returns whether the constant nodes in Program::ConstantUpdate::ChangedNodes() can be updated in place. If not, a new processor must be constructed from
+      // the updated program. A changed constant must not reach a native module with an InitializeVoice callback (voice contexts are initialized from argument
+      // values) or a Prepare callback (argument latencies, which the compiler used for latency compensation, are computed from argument values).
+      bool CanUpdateConstants(Span<const IProcessorProgramGraphNode*> changedNodes) const;
+
+      // Embeds the new values of changed constant nodes into this processor after Program::CommitConstantUpdate() has been called. CanUpdateConstants() must
+      // have returned true for the same nodes and program must be the program this processor was constructed from. This must not be called while Process()
+      // is running and the new values take effect on the next block.
+      void UpdateConstants(const Program* program, Span<const IProcessorProgramGraphNode*> changedNodes);
+
+      // Returns whether ProgramProcessorSettings::m_cachedPlan was applied. If not, the host's stored plan should be replaced.
+      bool IsUsingCachedPlan() const
+        { return m_isUsingCachedPlan; }
+
+      // These hold channel levels measured across the most recent Process() call if ProgramProcessorSettings::m_measureChannelLevels is set and are empty
+      // otherwise
+      Span<const SampleStatistics> GetInputChannelLevels() const
+        { return m_inputChannelLevels; }
+      Span<const SampleStatistics> GetOutputChannelLevels() const
+        { return m_outputChannelLevels; }
+
       void Process(
         usz sampleCount,
         Span<const InputChannelBuffer> inputChannelBuffers,
@@ -51,6 +178,7 @@ namespace Chord
         ScratchMemoryAllocation() = default;
 
         ScratchMemoryAllocation(usz size, usz alignment)
+          : m_alignment(alignment)
         {
           void* memory = ::operator new(size, std::align_val_t(alignment));
           m_memory = Span<u8>(static_cast<u8*>(memory), size);
@@ -81,23 +209,41 @@ namespace Chord
         Span<u8> m_memory;
       };
 
-      void AllocateBuffers(const ProgramGraph& programGraph);
+      static HashSet<const IProcessorProgramGraphNode*> BuildConstantNodeSet(Span<const IProcessorProgramGraphNode*> changedNodes);
+
+      void AllocateBuffers(const ProgramGraph& programGraph, std::optional<Span<const u8>> cachedPlan);
+      void ReportBufferSharing(const Callable<void(ReportingSeverity severity, const UnicodeString& message)>& reportCallback) const;
 
       void StartProcessBlock();
       void InitializeInputChannelBuffer(usz inputChannelIndex);
       void AllocateVoices();
       void StartVoiceProcessing(usz activeVoiceIndex, StaticTaskGraph::TaskCompleter& taskCompleter);
+      void AccumulateVoiceOutputsToPartialSums(usz voiceIndex);
       void FinishVoiceProcessing();
       void AccumulateVoiceOutput(usz outputIndex);
+      void InitializeDeferredEffect();
       void StartEffectProcessing(StaticTaskGraph::TaskCompleter& taskCompleter);
       void FinishEffectProcessing();
       void FillOutputChannelBuffer(usz outputChannelIndex);
       void FinishProcessBlock();
 
       TaskExecutor* m_taskExecutor = nullptr;
+      NativeLibraryRegistry* m_nativeLibraryRegistry = nullptr;
       usz m_bufferSampleCount = 0;
+      s32 m_sampleRate = 0;
+      bool m_alignVoiceStarts = false;
+      bool m_ditherIntegerOutputs = true;
+      bool m_zeroCopyChannelBuffers = false;
+
+      // Stages report through m_serializedReportCallback, which forwards to the host's callback while holding m_reportCallbackMutex
+      Callable<void(ReportingSeverity severity, const UnicodeString& message)> m_reportCallback;
+      Callable<void(ReportingSeverity severity, const UnicodeString& message)> m_serializedReportCallback;
+      std::mutex m_reportCallbackMutex;
+
       ConstantManager m_constantManager;
       BufferManager m_bufferManager;
+      ProgramProcessorPlanKey m_planKey;
+      bool m_isUsingCachedPlan = false;
 
       FixedArray<ScratchMemoryAllocation> m_threadScratchMemoryAllocations;
       FixedArray<Span<u8>> m_threadScratchMemory;
@@ -111,13 +257,56 @@ namespace Chord
       FixedArray<usz> m_voiceSampleOffsets;
       FixedArray<BufferManager::BufferHandle> m_voiceOutputAccumulationBuffers;
 
+      // Peak levels of each voice's contribution to each accumulated output, laid out as [outputIndex * voiceCount + voiceIndex]. This is empty unless the
+      // voice stealing policy needs peak levels.
+      FixedArray<f32> m_voiceOutputPeakLevels;
+
+      // Per-thread partial sums for parallel voice output accumulation, laid out as [outputIndex * threadCount + threadIndex], along with whether each thread
+      // has accumulated any voices during the current block. These are empty unless parallel voice output accumulation is enabled.
+      FixedArray<ScratchMemoryAllocation> m_voiceOutputPartialSumAllocations;
+      FixedArray<BufferManager::Buffer> m_voiceOutputPartialSums;
+      FixedArray<bool> m_threadVoiceOutputPartialSumsAccumulated;
+
+      // Voices flagged here are faded out during the current block and deactivated at the end of it. This is empty unless the overload governor is enabled.
+      std::optional<OverloadGovernor> m_overloadGovernor;
+      FixedArray<bool> m_voiceFadeOuts;
+
+      std::optional<SilentVoiceDetectionSettings> m_silentVoiceDetectionSettings;
+      FixedArray<usz> m_voiceSilentBlockCounts;
+      std::chrono::steady_clock::time_point m_blockStartTime;
+
       EffectActivationMode m_effectActivationMode = EffectActivationMode::Always;
       std::optional<f64> m_effectActivationThreshold;
       std::optional<ProgramStageTaskManager> m_effect;
       std::atomic<bool> m_shouldActivateEffect = false;
 
+      // When the effect stage's initialization is deferred, the first activation attempt enqueues a background task to initialize it. Effect stage scratch
+      // memory is allocated separately if the effect stage needs more than the voices. The mutex and condition variable are only used by the background task
+      // and the destructor, which removes the task if it's still queued and otherwise waits for it to finish (or skip initialization if it hasn't started yet).
+      enum class EffectInitializationState : u8
+      {
+        NotRequested,
+        Requested,
+        Cancelling,
+        Initializing,
+        Initialized,
+      };
+
+      std::atomic<EffectInitializationState> m_effectInitializationState = EffectInitializationState::Initialized;
+      Task m_effectInitializationTask;
+      std::mutex m_effectInitializationMutex;
+      std::condition_variable m_effectInitializationConditionVariable;
+      FixedArray<ScratchMemoryAllocation> m_effectThreadScratchMemoryAllocations;
+      FixedArray<Span<u8>> m_effectThreadScratchMemory;
+
       Span<const InputChannelBuffer> m_inputChannelBuffers;
       Span<const OutputChannelBuffer> m_outputChannelBuffers;
+
+      // Dither generator state for each output channel, carried across blocks
+      FixedArray<u32> m_outputChannelDitherStates;
+
+      FixedArray<SampleStatistics> m_inputChannelLevels;
+      FixedArray<SampleStatistics> m_outputChannelLevels;
       Span<const VoiceTrigger> m_voiceTriggers;
       usz m_processSampleCount = 0;
       usz m_blockSampleOffset = 0;
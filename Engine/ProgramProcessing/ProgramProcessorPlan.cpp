@@ -0,0 +1,176 @@
+module;
+
+#include "../../NativeLibraryApi/ChordNativeLibraryApi.h"
+
+module Chord.Engine;
+
+import std;
+
+import Chord.Foundation;
+
+namespace Chord
+{
+  static constexpr char PlanHeader[] = { 'C', 'H', 'O', 'R', 'D', 'P', 'L', 'A', 'N' };
+
+  // This must be bumped whenever the analysis which produces plans changes (e.g. buffer concurrency or sharing analysis, or the task and buffer layout built
+  // for a program) as well as whenever the serialized format changes. It is part of every plan key so that plans cached by an older engine build, which
+  // would otherwise still match the current buffers structurally, are rejected rather than used to alias live buffers.
+  static constexpr u32 PlanVersion = 1;
+
+  ProgramProcessorPlanKey CalculateProgramProcessorPlanKey(
+    const NativeLibraryRegistry* nativeLibraryRegistry,
+    const Program* program,
+    usz bufferSampleCount,
+    usz threadCount)
+  {
+    Sha256 sha256;
+    auto Update =
+      [&](auto value)
+        { sha256.Update(Span(reinterpret_cast<const u8*>(&value), sizeof(value))); };
+
+    // Buffer byte counts depend on the SIMD alignment the engine was built with
+    Update(PlanVersion);
+    Update(u64(MaxSimdAlignment));
+
+    // Native library IDs are part of the program content so only the loaded versions need to be included
+    sha256.Update(program->ContentHash());
+
+    // Simplification changes which tasks and buffers exist
+    Update(u8(program->IsSimplified() ? 1 : 0));
+    Update(u64(bufferSampleCount));
+    Update(u64(threadCount));
+    for (const Program::NativeLibraryDependency& nativeLibraryDependency : program->NativeLibraryDependencies())
+    {
+      NativeLibraryVersion version = { .m_major = 0, .m_minor = 0, .m_patch = 0 };
+      auto result = nativeLibraryRegistry->TryGetNativeLibraryAndContext(nativeLibraryDependency.m_id);
+      if (result.has_value())
+        { version = std::get<0>(result.value())->m_version; }
+
+      Update(version.m_major);
+      Update(version.m_minor);
+      Update(version.m_patch);
+    }
+
+    return sha256.Finalize();
+  }
+
+  UnboundedArray<u8> SerializeProgramProcessorPlan(const ProgramProcessorPlan& plan)
+  {
+    UnboundedArray<u8> bytes;
+    auto Write =
+      [&](auto value)
+        { bytes.AppendMultiple(Span(reinterpret_cast<const u8*>(&value), sizeof(value))); };
+
+    bytes.AppendMultiple(Span(reinterpret_cast<const u8*>(PlanHeader), sizeof(PlanHeader)));
+    Write(PlanVersion);
+    bytes.AppendMultiple(Span<const u8>(plan.m_key));
+
+    const BufferManager::AllocationPlan& bufferAllocationPlan = plan.m_bufferAllocationPlan;
+    Write(u32(bufferAllocationPlan.m_buffers.Count()));
+    for (const BufferManager::AllocationPlan::PlannedBuffer& plannedBuffer : bufferAllocationPlan.m_buffers)
+    {
+      Write(u8(plannedBuffer.m_primitiveType));
+      Write(plannedBuffer.m_upsampleFactor);
+      Write(u64(plannedBuffer.m_byteCount));
+      Write(u64(plannedBuffer.m_sharedBufferMemoryIndex));
+      Write(u8(plannedBuffer.m_inPlaceOutputSharingResult));
+      Write(u8(plannedBuffer.m_inPlaceInputSharingResult));
+      Write(u8(plannedBuffer.m_inPlaceSharedBufferIndex.has_value()));
+      Write(u64(plannedBuffer.m_inPlaceSharedBufferIndex.value_or(0)));
+    }
+
+    Write(u32(bufferAllocationPlan.m_sharedBufferMemoryByteCounts.Count()));
+    for (usz byteCount : bufferAllocationPlan.m_sharedBufferMemoryByteCounts)
+      { Write(u64(byteCount)); }
+
+    // A checksum of everything above is appended so that a plan which was corrupted in storage is rejected
+    FixedArray<u8, Sha256ByteCount> checksum = CalculateSha256(Span<const u8>(bytes));
+    bytes.AppendMultiple(Span<const u8>(checksum));
+    return bytes;
+  }
+
+  std::optional<ProgramProcessorPlan> DeserializeProgramProcessorPlan(Span<const u8> serializedBytes)
+  {
+    if (serializedBytes.Count() < Sha256ByteCount)
+      { return std::nullopt; }
+
+    Span<const u8> bytes = Span(serializedBytes, 0, serializedBytes.Count() - Sha256ByteCount);
+    FixedArray<u8, Sha256ByteCount> checksum = CalculateSha256(bytes);
+    if (std::memcmp(checksum.Elements(), serializedBytes.Elements() + bytes.Count(), Sha256ByteCount) != 0)
+      { return std::nullopt; }
+
+    BinaryReader reader(bytes, std::endian::native);
+
+    FixedArray<char, sizeof(PlanHeader)> header;
+    u32 version;
+    ProgramProcessorPlan plan;
+    if (!reader.Read(Span<char>(header))
+      || !reader.Read(&version)
+      || !reader.Read(Span<u8>(plan.m_key)))
+      { return std::nullopt; }
+
+    if (std::memcmp(header.Elements(), PlanHeader, sizeof(PlanHeader)) != 0 || version != PlanVersion)
+      { return std::nullopt; }
+
+    // Each planned buffer occupies 32 bytes so the buffer count can be checked against the remaining bytes before reserving memory for it
+    static constexpr usz PlannedBufferByteCount = 32;
+    u32 bufferCount;
+    if (!reader.Read(&bufferCount) || usz(bufferCount) > (bytes.Count() - reader.GetOffset()) / PlannedBufferByteCount)
+      { return std::nullopt; }
+
+    BufferManager::AllocationPlan& bufferAllocationPlan = plan.m_bufferAllocationPlan;
+    bufferAllocationPlan.m_buffers = InitializeCapacity(bufferCount);
+    for (BufferManager::AllocationPlan::PlannedBuffer& plannedBuffer : bufferAllocationPlan.m_buffers)
+    {
+      u8 primitiveType;
+      u64 byteCount;
+      u64 sharedBufferMemoryIndex;
+      u8 inPlaceOutputSharingResult;
+      u8 inPlaceInputSharingResult;
+      u8 hasInPlaceSharedBufferIndex;
+      u64 inPlaceSharedBufferIndex;
+      if (!reader.Read(&primitiveType)
+        || !reader.Read(&plannedBuffer.m_upsampleFactor)
+        || !reader.Read(&byteCount)
+        || !reader.Read(&sharedBufferMemoryIndex)
+        || !reader.Read(&inPlaceOutputSharingResult)
+        || !reader.Read(&inPlaceInputSharingResult)
+        || !reader.Read(&hasInPlaceSharedBufferIndex)
+        || !reader.Read(&inPlaceSharedBufferIndex))
+        { return std::nullopt; }
+
+      if (primitiveType > u8(PrimitiveTypeBool)
+        || inPlaceOutputSharingResult >= EnumCount<BufferManager::InPlaceSharingResult>()
+        || inPlaceInputSharingResult >= EnumCount<BufferManager::InPlaceSharingResult>()
+        || hasInPlaceSharedBufferIndex > 1)
+        { return std::nullopt; }
+
+      // Indices are range-checked against the current buffers when the plan is applied
+      plannedBuffer.m_primitiveType = PrimitiveType(primitiveType);
+      plannedBuffer.m_byteCount = usz(byteCount);
+      plannedBuffer.m_sharedBufferMemoryIndex = usz(sharedBufferMemoryIndex);
+      plannedBuffer.m_inPlaceOutputSharingResult = BufferManager::InPlaceSharingResult(inPlaceOutputSharingResult);
+      plannedBuffer.m_inPlaceInputSharingResult = BufferManager::InPlaceSharingResult(inPlaceInputSharingResult);
+      if (hasInPlaceSharedBufferIndex != 0)
+        { plannedBuffer.m_inPlaceSharedBufferIndex = usz(inPlaceSharedBufferIndex); }
+    }
+
+    u32 sharedBufferMemoryCount;
+    if (!reader.Read(&sharedBufferMemoryCount) || usz(sharedBufferMemoryCount) != (bytes.Count() - reader.GetOffset()) / sizeof(u64))
+      { return std::nullopt; }
+
+    bufferAllocationPlan.m_sharedBufferMemoryByteCounts = InitializeCapacity(sharedBufferMemoryCount);
+    for (usz& byteCount : bufferAllocationPlan.m_sharedBufferMemoryByteCounts)
+    {
+      u64 serializedByteCount;
+      if (!reader.Read(&serializedByteCount))
+        { return std::nullopt; }
+      byteCount = usz(serializedByteCount);
+    }
+
+    if (reader.GetOffset() != bytes.Count())
+      { return std::nullopt; }
+
+    return plan;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+module;
+
+#include "../../NativeLibraryApi/ChordNativeLibraryApi.h"
+
+export module Chord.Engine:ProgramProcessing.ProgramProcessorPlan;
+
+import std;
+
+import Chord.Foundation;
+import :Native.NativeLibraryRegistry;
+import :Program;
+import :ProgramProcessing.BufferManager;
+
+namespace Chord
+{
+  export
+  {
+    using ProgramProcessorPlanKey = FixedArray<u8, Sha256ByteCount>;
+
+    // Holds the results of the analysis performed when a ProgramProcessor is constructed which depend only on the program and on the processor's
+    // configuration. Hosts can store serialized plans (e.g. in an on-disk cache alongside their programs) and supply them to later processors to skip that
+    // analysis.
+    struct ProgramProcessorPlan
+    {
+      ProgramProcessorPlanKey m_key;
+      BufferManager::AllocationPlan m_bufferAllocationPlan;
+    };
+
+    // A plan may only be applied to a processor with an identical key. The key covers the engine's plan version (which changes whenever the analysis that
+    // produces plans changes), the program content, the buffer sample count, the thread count, and the versions of the loaded native libraries which the
+    // program depends on.
+    ProgramProcessorPlanKey CalculateProgramProcessorPlanKey(
+      const NativeLibraryRegistry* nativeLibraryRegistry,
+      const Program* program,
+      usz bufferSampleCount,
+      usz threadCount);
+
+    // Plans are only meaningful on the machine which produced them so they are serialized in native byte order. Serialized plans end with a checksum of their
+    // contents and plans which fail the checksum are rejected.
+    UnboundedArray<u8> SerializeProgramProcessorPlan(const ProgramProcessorPlan& plan);
+    std::optional<ProgramProcessorPlan> DeserializeProgramProcessorPlan(Span<const u8> bytes);
+  }
+}
\ No newline at end of file
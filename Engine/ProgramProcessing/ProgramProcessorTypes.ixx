@@ -12,24 +12,150 @@ namespace Chord
     {
       Float32,
       Float64,
+
+      // Integer PCM samples are normalized so that their full-scale range maps to [-1, 1). Int24 samples are packed 3-byte little-endian values.
+      Int16,
+      Int24,
+      Int32,
     };
 
+    constexpr usz SampleTypeSize(SampleType sampleType)
+    {
+      switch (sampleType)
+      {
+      case SampleType::Float32:
+        return sizeof(f32);
+
+      case SampleType::Float64:
+        return sizeof(f64);
+
+      case SampleType::Int16:
+        return 2;
+
+      case SampleType::Int24:
+        return 3;
+
+      case SampleType::Int32:
+        return 4;
+
+      default:
+        ASSERT(false, "Unsupported sample type");
+        return 0;
+      }
+    }
+
+    // Channel buffers can either be planar (each channel has its own span of consecutive samples) or interleaved (all channels share one buffer of frames).
+    // For an interleaved channel, m_samples starts at the channel's sample in the first frame and m_sampleStride is the number of channels per frame.
     struct InputChannelBuffer
     {
       SampleType m_sampleType = SampleType::Float64;
       Span<const u8> m_samples;
+      usz m_sampleStride = 1;
     };
 
     struct OutputChannelBuffer
     {
       SampleType m_sampleType = SampleType::Float32;
       Span<u8> m_samples;
+      usz m_sampleStride = 1;
+    };
+
+    // Returns the number of bytes a channel buffer must span to hold sampleCount samples. Interleaved channels don't need to span the other channels' samples
+    // in the final frame.
+    constexpr usz ChannelBufferByteCount(SampleType sampleType, usz sampleStride, usz sampleCount)
+    {
+      ASSERT(sampleStride > 0);
+      return sampleCount == 0 ? 0 : ((sampleCount - 1) * sampleStride + 1) * SampleTypeSize(sampleType);
+    }
+
+    // Fills channelBuffers with one interleaved channel buffer per channel, all referencing the same buffer of frames
+    template<typename TChannelBuffer, typename TByte>
+    void GetInterleavedChannelBuffers(SampleType sampleType, Span<TByte> frames, Span<TChannelBuffer> channelBuffers)
+    {
+      usz channelCount = channelBuffers.Count();
+      usz sampleSize = SampleTypeSize(sampleType);
+      ASSERT(frames.Count() % (channelCount * sampleSize) == 0);
+      for (usz channelIndex = 0; channelIndex < channelCount; channelIndex++)
+      {
+        channelBuffers[channelIndex] =
+        {
+          .m_sampleType = sampleType,
+          .m_samples = frames.IsEmpty() ? Span<TByte>() : Span<TByte>(frames, channelIndex * sampleSize, ToEnd),
+          .m_sampleStride = channelCount,
+        };
+      }
+    }
+
+    // The peak absolute value and sum of squares of a run of samples, used for level metering. Statistics of consecutive runs (e.g. blocks) combine exactly.
+    struct SampleStatistics
+    {
+      f64 m_peak = 0.0;
+      f64 m_sumOfSquares = 0.0;
+      usz m_sampleCount = 0;
+
+      void Combine(const SampleStatistics& other)
+      {
+        m_peak = Max(m_peak, other.m_peak);
+        m_sumOfSquares += other.m_sumOfSquares;
+        m_sampleCount += other.m_sampleCount;
+      }
+
+      f64 GetRms() const
+        { return m_sampleCount == 0 ? 0.0 : Sqrt(m_sumOfSquares / f64(m_sampleCount)); }
+    };
+
+    // A breakdown of the memory held by a ProgramProcessor, in bytes
+    struct ProgramProcessorMemoryFootprint
+    {
+      // Buffer memory after sharing and the amount that would be needed if no buffers shared memory. Estimates don't run buffer sharing analysis so these are
+      // equal in estimates.
+      usz m_sharedBufferByteCount = 0;
+      usz m_unsharedBufferByteCount = 0;
+
+      // Strings, constant arrays, constant buffers (excluding those held by a shared constant pool), and the per-buffer constant value slots
+      usz m_constantByteCount = 0;
+
+      // Scratch memory is allocated once for each worker thread. Scratch requirements are reported by native modules on voice initialization so estimates
+      // don't include them.
+      usz m_threadCount = 0;
+      usz m_scratchByteCountPerThread = 0;
+
+      // Memory reported by native module voice contexts, summed across all voices and the effect stage. Native modules with voice contexts which don't report
+      // their memory usage (which is all of them in estimates) are counted so that callers know how incomplete this value is.
+      usz m_voiceCount = 0;
+      usz m_nativeModuleVoiceContextByteCount = 0;
+      usz m_unreportedNativeModuleVoiceContextCount = 0;
+
+      // Bookkeeping for tasks, native module arguments, and buffers
+      usz m_taskMetadataByteCount = 0;
+
+      usz GetTotalByteCount() const
+      {
+        return m_sharedBufferByteCount
+          + m_constantByteCount
+          + m_threadCount * m_scratchByteCountPerThread
+          + m_nativeModuleVoiceContextByteCount
+          + m_taskMetadataByteCount;
+      }
+    };
+
+    enum class VoiceTriggerType
+    {
+      Trigger,
+      Release,
     };
 
     struct VoiceTrigger
     {
-      // $TODO we'll need an ID of some sort to link this voice to MIDI events
       usz m_sampleIndex = 0;
+      VoiceTriggerType m_type = VoiceTriggerType::Trigger;
+
+      // Links the trigger to its source (e.g. a MIDI note). Triggering an ID which is bound to an active voice retriggers that voice and releasing an ID
+      // releases the voice bound to it. Releases require an ID.
+      std::optional<u64> m_voiceId;
+
+      // Used by VoiceStealingPolicy::LowestPriority, ignored for releases
+      s32 m_priority = 0;
     };
   }
 }
\ No newline at end of file
@@ -55,6 +55,25 @@ namespace Chord
     }
   }
 
+  // Returns whether an input is connected to one of the given constant nodes, either directly or through an array element
+  static bool IsConnectedToConstantNode(const IInputProgramGraphNode* inputNode, const HashSet<const IProcessorProgramGraphNode*>& constantNodes)
+  {
+    const IProcessorProgramGraphNode* inputProcessorNode = inputNode->Connection()->Processor();
+    if (constantNodes.Contains(inputProcessorNode))
+      { return true; }
+
+    if (inputProcessorNode->Type() == ProgramGraphNodeType::Array)
+    {
+      for (const IInputProgramGraphNode* elementNode : static_cast<const ArrayProgramGraphNode*>(inputProcessorNode)->Elements())
+      {
+        if (constantNodes.Contains(elementNode->Connection()->Processor()))
+          { return true; }
+      }
+    }
+
+    return false;
+  }
+
   ProgramStageTaskManager::ProgramStageTaskManager(
     NativeLibraryRegistry* nativeLibraryRegistry,
     const Callable<void(ReportingSeverity severity, const UnicodeString& message)>& reportCallback,
@@ -63,11 +82,13 @@ namespace Chord
     ConstantManager* constantManager,
     BufferManager* bufferManager,
     usz bufferSampleCount,
+    usz tileSampleCount,
     std::optional<Span<const BufferManager::BufferHandle>> inputChannelBuffersFloat,
     std::optional<Span<const BufferManager::BufferHandle>> inputChannelBuffersDouble,
     usz nativeModuleCallNodeCount,
     Span<const IProcessorProgramGraphNode*> rootNodes)
     : m_reportCallback(reportCallback)
+    , m_program(program)
   {
     const ProgramGraph& programGraph = program->ProgramGraph();
 
@@ -127,28 +148,28 @@ namespace Chord
         case ProgramGraphNodeType::FloatConstant:
           {
             auto constantNode = static_cast<const FloatConstantProgramGraphNode*>(node);
-            m_buffersAndConstantsFromOutputNodes.Insert(constantNode->Output(), constantNode->Value());
+            m_buffersAndConstantsFromOutputNodes.Insert(constantNode->Output(), m_program->ConstantValue(constantNode));
             break;
           }
 
         case ProgramGraphNodeType::DoubleConstant:
           {
             auto constantNode = static_cast<const DoubleConstantProgramGraphNode*>(node);
-            m_buffersAndConstantsFromOutputNodes.Insert(constantNode->Output(), constantNode->Value());
+            m_buffersAndConstantsFromOutputNodes.Insert(constantNode->Output(), m_program->ConstantValue(constantNode));
             break;
           }
 
         case ProgramGraphNodeType::IntConstant:
           {
             auto constantNode = static_cast<const IntConstantProgramGraphNode*>(node);
-            m_buffersAndConstantsFromOutputNodes.Insert(constantNode->Output(), constantNode->Value());
+            m_buffersAndConstantsFromOutputNodes.Insert(constantNode->Output(), m_program->ConstantValue(constantNode));
             break;
           }
 
         case ProgramGraphNodeType::BoolConstant:
           {
             auto constantNode = static_cast<const BoolConstantProgramGraphNode*>(node);
-            m_buffersAndConstantsFromOutputNodes.Insert(constantNode->Output(), constantNode->Value());
+            m_buffersAndConstantsFromOutputNodes.Insert(constantNode->Output(), m_program->ConstantValue(constantNode));
             break;
           }
 
@@ -177,7 +198,7 @@ namespace Chord
           break;
 
         case ProgramGraphNodeType::GraphOutput:
-          InitializeGraphOutput(programGraph, static_cast<const GraphOutputProgramGraphNode*>(node));
+          InitializeGraphOutput(bufferManager, programGraph, static_cast<const GraphOutputProgramGraphNode*>(node));
           break;
 
         default:
@@ -226,7 +247,16 @@ namespace Chord
         { m_rootTaskIndices.Append(taskIndex); }
     }
 
-    // Now, initialize the voice context for each native library
+    // If every native module in this stage is tileable, larger blocks can be processed as a sequence of sub-blocks so that intermediate buffers stay in cache
+    m_tileSampleCount = CalculateTileSampleCount(bufferManager, tileSampleCount);
+  }
+
+  void ProgramStageTaskManager::InitializeVoiceContexts()
+  {
+    ASSERT(!m_voiceContextsInitialized);
+    m_voiceContextsInitialized = true;
+
+    // Initialize the voice context for each native library
     for (NativeLibraryEntry& nativeLibraryEntry : m_nativeLibraries)
     {
       if (nativeLibraryEntry.m_nativeLibrary->m_initializeVoice != nullptr)
@@ -243,7 +273,7 @@ namespace Chord
           nativeLibraryEntry,
           nullptr,
           task.m_upsampleFactor,
-          bufferSampleCount * Coerce<usz>(task.m_upsampleFactor),
+          m_bufferSampleCount * Coerce<usz>(task.m_upsampleFactor),
           0);
 
         // Non-constant argument buffers are by default set to null
@@ -262,6 +292,17 @@ namespace Chord
         m_scratchMemoryRequirement.m_size = Max(m_scratchMemoryRequirement.m_size, task.m_scratchMemoryRequirement.m_size);
         m_scratchMemoryRequirement.m_alignment = Max(m_scratchMemoryRequirement.m_alignment, task.m_scratchMemoryRequirement.m_alignment);
 
+        if (task.m_nativeModule->m_getVoiceMemoryUsage != nullptr)
+        {
+          NativeModuleContext voiceNativeModuleContext = BuildNativeModuleContext(
+            nativeLibraryEntry,
+            task.m_voiceContext,
+            task.m_upsampleFactor,
+            m_bufferSampleCount * Coerce<usz>(task.m_upsampleFactor),
+            0);
+          task.m_voiceContextByteCount = task.m_nativeModule->m_getVoiceMemoryUsage(&voiceNativeModuleContext);
+        }
+
         if (task.m_nativeModule->m_setVoiceActive != nullptr)
           { m_tasksWithSetVoiceActive.Append(&task); }
       }
@@ -270,6 +311,9 @@ namespace Chord
 
   ProgramStageTaskManager::~ProgramStageTaskManager() noexcept
   {
+    if (!m_voiceContextsInitialized)
+      { return; }
+
     for (usz i = 0; i < m_nativeModuleCallTasks.Count(); i++)
     {
       NativeModuleCallTask& task = m_nativeModuleCallTasks[m_nativeModuleCallTasks.Count() - i - 1];
@@ -294,9 +338,82 @@ namespace Chord
     }
   }
 
+  ProgramStageTaskManager::MemoryFootprint ProgramStageTaskManager::EstimateMemoryFootprint(
+    const NativeLibraryRegistry* nativeLibraryRegistry,
+    usz bufferSampleCount,
+    Span<const IProcessorProgramGraphNode*> rootNodes)
+  {
+    MemoryFootprint footprint;
+    IterateGraphTopological(
+      rootNodes,
+      [&](const IProcessorProgramGraphNode* node)
+      {
+        if (node->Type() != ProgramGraphNodeType::NativeModuleCall)
+          { return; }
+
+        auto nativeModuleCallNode = static_cast<const NativeModuleCallProgramGraphNode*>(node);
+        auto nativeLibraryAndContext = nativeLibraryRegistry->TryGetNativeLibraryAndContext(nativeModuleCallNode->NativeLibraryId());
+        ASSERT(nativeLibraryAndContext.has_value(), "Native library not found");
+        const NativeModule* nativeModule = FindNativeModule(std::get<0>(nativeLibraryAndContext.value()), nativeModuleCallNode);
+        ASSERT(nativeModule != nullptr);
+
+        footprint.m_taskMetadataByteCount += sizeof(NativeModuleCallTask) + nativeModule->m_signature.m_parameterCount * sizeof(NativeModuleArgument);
+        for (usz parameterIndex = 0; parameterIndex < nativeModule->m_signature.m_parameterCount; parameterIndex++)
+        {
+          // This mirrors the buffers and initializers set up by BuildNativeModuleInputArgument() and BuildNativeModuleOutputArgument(). Buffer array inputs
+          // are counted as a single buffer.
+          const NativeModuleParameter& parameter = nativeModule->m_signature.m_parameters[parameterIndex];
+          if (parameter.m_direction == ModuleParameterDirectionOut)
+          {
+            s32 upsampleFactor = nativeModuleCallNode->UpsampleFactor() * parameter.m_dataType.m_upsampleFactor;
+            footprint.m_bufferCount++;
+            footprint.m_unsharedBufferByteCount += BufferManager::CalculateBufferByteCount(
+              parameter.m_dataType.m_primitiveType,
+              bufferSampleCount,
+              upsampleFactor);
+            footprint.m_taskMetadataByteCount += sizeof(SampleCountInitializer) + sizeof(SamplesInitializer) + sizeof(IsConstantResolver);
+          }
+          else if (parameter.m_dataType.m_runtimeMutability != RuntimeMutability::RuntimeMutabilityConstant)
+            { footprint.m_taskMetadataByteCount += sizeof(SampleCountInitializer) + sizeof(SamplesInitializer) + sizeof(BufferManager::BufferHandle); }
+        }
+
+        if (nativeModule->m_initializeVoice != nullptr)
+          { footprint.m_unreportedNativeModuleVoiceContextCount++; }
+      });
+
+    return footprint;
+  }
+
   MemoryRequirement ProgramStageTaskManager::GetScratchMemoryRequirement() const
     { return m_scratchMemoryRequirement; }
 
+  ProgramStageTaskManager::MemoryFootprint ProgramStageTaskManager::GetMemoryFootprint(const BufferManager* bufferManager) const
+  {
+    MemoryFootprint footprint;
+    footprint.m_taskMetadataByteCount = m_nativeModuleCallTasks.Count() * sizeof(NativeModuleCallTask);
+    for (const NativeModuleCallTask& task : m_nativeModuleCallTasks)
+    {
+      footprint.m_taskMetadataByteCount += task.m_arguments.Count() * sizeof(NativeModuleArgument)
+        + task.m_sampleCountInitializers.Count() * sizeof(SampleCountInitializer)
+        + task.m_samplesInitializers.Count() * sizeof(SamplesInitializer)
+        + task.m_isConstantResolvers.Count() * sizeof(IsConstantResolver)
+        + task.m_inputBufferHandles.Count() * sizeof(BufferManager::BufferHandle)
+        + task.m_successorTaskIndices.Count() * sizeof(usz);
+
+      // Every output gets its own buffer so the output buffers of all tasks are the buffers owned by this stage
+      footprint.m_bufferCount += task.m_isConstantResolvers.Count();
+      for (const IsConstantResolver& isConstantResolver : task.m_isConstantResolvers)
+        { footprint.m_unsharedBufferByteCount += bufferManager->GetBuffer(isConstantResolver.m_bufferHandle).m_byteCount; }
+
+      if (task.m_voiceContextByteCount.has_value())
+        { footprint.m_nativeModuleVoiceContextByteCount += task.m_voiceContextByteCount.value(); }
+      else if (task.m_nativeModule->m_initializeVoice != nullptr)
+        { footprint.m_unreportedNativeModuleVoiceContextCount++; }
+    }
+
+    return footprint;
+  }
+
   void ProgramStageTaskManager::DeclareBufferConcurrency(BufferManager* bufferManager, Span<const IProcessorProgramGraphNode*> outputNodes) const
   {
     // Output buffers are generally produced last in the graph and so output buffer memory should not be reused for other buffers once outputs are produced.
@@ -321,7 +438,7 @@ namespace Chord
     }
 
     auto rootNodes = FindGraphRootNodes(outputNodes);
-    auto graphReachability = CalculateGraphNodeReachability(rootNodes);
+    GraphNodeReachability graphReachability(rootNodes);
 
     for (usz taskIndexA = 0; taskIndexA < m_nativeModuleCallTasks.Count(); taskIndexA++)
     {
@@ -347,9 +464,7 @@ namespace Chord
         // tasks are mutually reachable (i.e. you can get from A to B and from B to A), it means there is a cycle and we don't want to share buffers which
         // are part of cycles because the buffer may need multiple passes to be filled and should not be reused in the meantime.
         // $TODO $FEEDBACK the comment about cycles is overkill currently because we don't support cycles, but we will when feedback is a thing
-        auto aToB = std::make_tuple(taskA.m_node, taskB.m_node);
-        auto bToA = std::make_tuple(taskB.m_node, taskA.m_node);
-        bool areTasksConcurrent = graphReachability.Contains(aToB) == graphReachability.Contains(bToA);
+        bool areTasksConcurrent = graphReachability.IsReachable(taskA.m_node, taskB.m_node) == graphReachability.IsReachable(taskB.m_node, taskA.m_node);
         if (areTasksConcurrent)
         {
           for (const SamplesInitializer& samplesInitializerA : taskA.m_samplesInitializers)
@@ -360,6 +475,65 @@ namespace Chord
         }
       }
     }
+
+    // A buffer which is read by multiple tasks can still be shared with an output of the last task which reads it as long as all of the other tasks which read
+    // it are guaranteed to finish first
+    HashMap<usz, UnboundedArray<usz>> inputTaskIndicesFromBuffers;
+    for (usz taskIndex = 0; taskIndex < m_nativeModuleCallTasks.Count(); taskIndex++)
+    {
+      for (BufferManager::BufferHandle bufferHandle : m_nativeModuleCallTasks[taskIndex].m_inputBufferHandles)
+      {
+        auto inputTaskIndices = inputTaskIndicesFromBuffers.TryGet(usz(bufferHandle));
+        if (inputTaskIndices == nullptr)
+          { inputTaskIndices = inputTaskIndicesFromBuffers.Insert(usz(bufferHandle), {}); }
+        if (inputTaskIndices->Count() == 0 || (*inputTaskIndices)[inputTaskIndices->Count() - 1] != taskIndex)
+          { inputTaskIndices->Append(taskIndex); }
+      }
+    }
+
+    // Graph outputs are also read after every task has finished so no task is the final reader of a graph output buffer
+    HashSet<usz> graphOutputBufferIndices;
+    for (const BufferOrConstant& output : m_outputs)
+    {
+      if (auto bufferHandle = std::get_if<BufferManager::BufferHandle>(&output); bufferHandle != nullptr)
+        { graphOutputBufferIndices.Ensure(usz(*bufferHandle)); }
+    }
+
+    if (m_remainActiveOutput.has_value())
+    {
+      if (auto bufferHandle = std::get_if<BufferManager::BufferHandle>(&m_remainActiveOutput.value()); bufferHandle != nullptr)
+        { graphOutputBufferIndices.Ensure(usz(*bufferHandle)); }
+    }
+
+    for (auto [bufferIndex, inputTaskIndices] : inputTaskIndicesFromBuffers)
+    {
+      if (inputTaskIndices.Count() < 2 || graphOutputBufferIndices.Contains(bufferIndex))
+        { continue; }
+
+      for (usz finalTaskIndex : inputTaskIndices)
+      {
+        const NativeModuleCallTask& finalTask = m_nativeModuleCallTasks[finalTaskIndex];
+        bool isFinalTask = true;
+        for (usz otherTaskIndex : inputTaskIndices)
+        {
+          if (otherTaskIndex == finalTaskIndex)
+            { continue; }
+
+          const NativeModuleCallTask& otherTask = m_nativeModuleCallTasks[otherTaskIndex];
+          if (!graphReachability.IsReachable(otherTask.m_node, finalTask.m_node) || graphReachability.IsReachable(finalTask.m_node, otherTask.m_node))
+          {
+            isFinalTask = false;
+            break;
+          }
+        }
+
+        if (isFinalTask)
+        {
+          bufferManager->SetBufferFinalInputTask(BufferManager::BufferHandle(bufferIndex), &finalTask);
+          break;
+        }
+      }
+    }
   }
 
   void ProgramStageTaskManager::DeclareBufferConcurrencyWithOther(BufferManager* bufferManager, const ProgramStageTaskManager& other) const
@@ -383,6 +557,17 @@ namespace Chord
     static_cast<ProgramStageTaskManager*>(context)->m_reportCallback(reportingSeverity, messageString);
   }
 
+  const NativeModule* ProgramStageTaskManager::FindNativeModule(const NativeLibrary* nativeLibrary, const NativeModuleCallProgramGraphNode* node)
+  {
+    for (usz nativeModuleIndex = 0; nativeModuleIndex < nativeLibrary->m_nativeModuleCount; nativeModuleIndex++)
+    {
+      if (Guid::FromBytes(nativeLibrary->m_nativeModules[nativeModuleIndex]->m_id) == node->NativeModuleId())
+        { return nativeLibrary->m_nativeModules[nativeModuleIndex]; }
+    }
+
+    return nullptr;
+  }
+
   NativeModuleContext ProgramStageTaskManager::BuildNativeModuleContext(
     const NativeLibraryEntry& nativeLibraryEntry,
     void* voiceContext,
@@ -402,6 +587,7 @@ namespace Chord
       .m_upsampleFactor = upsampleFactor,
       .m_maxSampleCount = maxSampleCount,
       .m_sampleCount = sampleCount,
+      .m_voiceStartSampleOffset = 0,
       .m_isCompileTime = false,
 
       .m_reportingContext = this,
@@ -420,12 +606,7 @@ namespace Chord
     auto nativeLibraryAndContext = nativeLibraryRegistry->TryGetNativeLibraryAndContext(node->NativeLibraryId());
     ASSERT(nativeLibraryAndContext.has_value(), "Native library not found");
     auto [nativeLibrary, nativeLibraryContext] = nativeLibraryAndContext.value();
-    const NativeModule* nativeModule = nullptr;
-    for (usz nativeModuleIndex = 0; nativeModule == nullptr && nativeModuleIndex < nativeLibrary->m_nativeModuleCount; nativeModuleIndex++)
-    {
-      if (Guid::FromBytes(nativeLibrary->m_nativeModules[nativeModuleIndex]->m_id) == node->NativeModuleId())
-        { nativeModule = nativeLibrary->m_nativeModules[nativeModuleIndex]; }
-    }
+    const NativeModule* nativeModule = FindNativeModule(nativeLibrary, node);
 
     // Add an entry for this native library if it doesn't already exist
     usz nativeLibraryEntryIndex;
@@ -444,7 +625,9 @@ namespace Chord
     task->m_nativeModule = nativeModule;
     task->m_upsampleFactor = node->UpsampleFactor();
 
-    // Set up the arguments. We'll iterate over the native module definition parameters and map them to input/output connections.
+    // Set up the arguments. We'll iterate over the native module definition parameters and map them to input/output connections. Arguments are laid out in
+    // parameter order and are built in place because buffer initializers hold pointers into them.
+    task->m_arguments = InitializeCapacity(nativeModule->m_signature.m_parameterCount);
     usz inputIndex = 0;
     usz outputIndex = 0;
     for (usz parameterIndex = 0; parameterIndex < nativeModule->m_signature.m_parameterCount; parameterIndex++)
@@ -453,12 +636,12 @@ namespace Chord
       switch (parameter.m_direction)
       {
       case ModuleParameterDirectionIn:
-        task->m_arguments[inputIndex] = BuildNativeModuleInputArgument(constantManager, bufferManager, task, parameter, node->Inputs()[inputIndex]);
+        BuildNativeModuleInputArgument(constantManager, bufferManager, task, parameter, node->Inputs()[inputIndex], &task->m_arguments[parameterIndex]);
         inputIndex++;
         break;
 
       case ModuleParameterDirectionOut:
-        task->m_arguments[inputIndex] = BuildNativeModuleOutputArgument(bufferManager, task, parameter, node->Outputs()[outputIndex]);
+        BuildNativeModuleOutputArgument(bufferManager, task, parameter, node->Outputs()[outputIndex], &task->m_arguments[parameterIndex]);
         outputIndex++;
         break;
 
@@ -490,10 +673,15 @@ namespace Chord
         task->m_upsampleFactor,
         m_bufferSampleCount * Coerce<usz>(task->m_upsampleFactor),
         0);
+      if (active)
+        { nativeModuleContext.m_voiceStartSampleOffset = m_voiceStartSampleOffset * Coerce<usz>(task->m_upsampleFactor); }
       task->m_nativeModule->m_setVoiceActive(&nativeModuleContext, active);
     }
   }
 
+  void ProgramStageTaskManager::SetVoiceStartSampleOffset(usz voiceStartSampleOffset)
+    { m_voiceStartSampleOffset = voiceStartSampleOffset; }
+
   void ProgramStageTaskManager::Process(
     TaskExecutor* taskExecutor,
     BufferManager* bufferManager,
@@ -510,6 +698,20 @@ namespace Chord
       .m_onComplete = onComplete,
     };
 
+    // Small blocks don't benefit from sub-block processing so we only give up parallelism between tasks within this stage when there's more than one tile
+    if (m_tileSampleCount > 0 && sampleCount > m_tileSampleCount)
+    {
+      m_remainingOutputTaskCount.store(m_outputTaskCount, std::memory_order_relaxed);
+
+      #if CHORD_ASSERTS_ENABLED
+        m_outputsPublished = false;
+      #endif
+
+      m_tiledTask.Initialize([this]() { RunTiledTasks(); });
+      taskExecutor->EnqueueTask(&m_tiledTask);
+      return;
+    }
+
     for (usz taskIndex = 0; taskIndex < m_nativeModuleCallTasks.Count(); taskIndex++)
     {
       NativeModuleCallTask& task = m_nativeModuleCallTasks[taskIndex];
@@ -557,14 +759,109 @@ namespace Chord
     return m_remainActiveResult;
   }
 
-  NativeModuleArgument ProgramStageTaskManager::BuildNativeModuleInputArgument(
+  bool ProgramStageTaskManager::CanUpdateConstants(const HashSet<const IProcessorProgramGraphNode*>& constantNodes) const
+  {
+    for (const NativeModuleCallTask& task : m_nativeModuleCallTasks)
+    {
+      if (task.m_nativeModule->m_initializeVoice == nullptr && task.m_nativeModule->m_prepare == nullptr)
+        { continue; }
+
+      for (const IInputProgramGraphNode* inputNode : task.m_node->Inputs())
+      {
+        if (IsConnectedToConstantNode(inputNode, constantNodes))
+          { return false; }
+      }
+    }
+
+    return true;
+  }
+
+  void ProgramStageTaskManager::UpdateConstants(ConstantManager* constantManager, const HashSet<const IProcessorProgramGraphNode*>& constantNodes)
+  {
+    ASSERT(!m_processContext.has_value());
+    const ProgramGraph& programGraph = m_program->ProgramGraph();
+
+    // Constant buffer inputs and graph outputs were resolved by looking up constant values by output node so these lookups are updated first
+    for (const IProcessorProgramGraphNode* constantNode : constantNodes)
+    {
+      BufferOrConstant value;
+      switch (constantNode->Type())
+      {
+      case ProgramGraphNodeType::FloatConstant:
+        value = m_program->ConstantValue(static_cast<const FloatConstantProgramGraphNode*>(constantNode));
+        break;
+
+      case ProgramGraphNodeType::DoubleConstant:
+        value = m_program->ConstantValue(static_cast<const DoubleConstantProgramGraphNode*>(constantNode));
+        break;
+
+      case ProgramGraphNodeType::IntConstant:
+        value = m_program->ConstantValue(static_cast<const IntConstantProgramGraphNode*>(constantNode));
+        break;
+
+      case ProgramGraphNodeType::BoolConstant:
+        value = m_program->ConstantValue(static_cast<const BoolConstantProgramGraphNode*>(constantNode));
+        break;
+
+      default:
+        ASSERT(false);
+        continue;
+      }
+
+      IterateNodeOutputs(
+        constantNode,
+        [&](const IOutputProgramGraphNode* outputNode)
+        {
+          // Constants which were never visited while building this stage belong to a different stage
+          BufferOrConstant* bufferOrConstant = m_buffersAndConstantsFromOutputNodes.TryGet(outputNode);
+          if (bufferOrConstant == nullptr)
+            { return; }
+
+          *bufferOrConstant = value;
+          for (const IInputProgramGraphNode* inputNode : outputNode->Connections())
+          {
+            if (inputNode->Processor()->Type() != ProgramGraphNodeType::GraphOutput)
+              { continue; }
+
+            auto graphOutputNode = static_cast<const GraphOutputProgramGraphNode*>(inputNode->Processor());
+            if (graphOutputNode == programGraph.m_voiceRemainActive || graphOutputNode == programGraph.m_effectRemainActive)
+              { m_remainActiveOutput = value; }
+            else
+              { m_outputs[GetGraphOutputIndex(programGraph, graphOutputNode)] = value; }
+          }
+        });
+    }
+
+    for (NativeModuleCallTask& task : m_nativeModuleCallTasks)
+    {
+      // Input arguments are laid out the same way as in InitializeNativeModuleCallTask()
+      usz inputIndex = 0;
+      for (usz parameterIndex = 0; parameterIndex < task.m_nativeModule->m_signature.m_parameterCount; parameterIndex++)
+      {
+        const NativeModuleParameter& parameter = task.m_nativeModule->m_signature.m_parameters[parameterIndex];
+        if (parameter.m_direction != ModuleParameterDirectionIn)
+          { continue; }
+
+        const IInputProgramGraphNode* inputNode = task.m_node->Inputs()[inputIndex];
+        if (IsConnectedToConstantNode(inputNode, constantNodes))
+        {
+          ASSERT(task.m_nativeModule->m_initializeVoice == nullptr && task.m_nativeModule->m_prepare == nullptr);
+          UpdateNativeModuleInputArgument(constantManager, parameter, inputNode, constantNodes, &task.m_arguments[parameterIndex]);
+        }
+
+        inputIndex++;
+      }
+    }
+  }
+
+  void ProgramStageTaskManager::BuildNativeModuleInputArgument(
     ConstantManager* constantManager,
     BufferManager* bufferManager,
     NativeModuleCallTask* task,
     const NativeModuleParameter& parameter,
-    const IInputProgramGraphNode* inputNode)
+    const IInputProgramGraphNode* inputNode,
+    NativeModuleArgument* argument)
   {
-    NativeModuleArgument argument;
     const IOutputProgramGraphNode* outputNode = inputNode->Connection();
     const IProcessorProgramGraphNode* inputProcessorNode = outputNode->Processor();
 
@@ -579,23 +876,27 @@ namespace Chord
         switch (parameter.m_dataType.m_primitiveType)
         {
         case PrimitiveTypeFloat:
-          argument.m_floatConstantArrayIn = constantManager->EnsureFloatConstantArray(arrayNode);
+          argument->m_floatConstantArrayIn =
+            constantManager->EnsureFloatConstantArray(GatherConstantArrayValues<f32, FloatConstantProgramGraphNode>(arrayNode));
           break;
 
         case PrimitiveTypeDouble:
-          argument.m_doubleConstantArrayIn = constantManager->EnsureDoubleConstantArray(arrayNode);
+          argument->m_doubleConstantArrayIn =
+            constantManager->EnsureDoubleConstantArray(GatherConstantArrayValues<f64, DoubleConstantProgramGraphNode>(arrayNode));
           break;
 
         case PrimitiveTypeInt:
-          argument.m_intConstantArrayIn = constantManager->EnsureIntConstantArray(arrayNode);
+          argument->m_intConstantArrayIn =
+            constantManager->EnsureIntConstantArray(GatherConstantArrayValues<s32, IntConstantProgramGraphNode>(arrayNode));
           break;
 
         case PrimitiveTypeBool:
-          argument.m_boolConstantArrayIn = constantManager->EnsureBoolConstantArray(arrayNode);
+          argument->m_boolConstantArrayIn =
+            constantManager->EnsureBoolConstantArray(GatherConstantArrayValues<bool, BoolConstantProgramGraphNode>(arrayNode));
           break;
 
         case PrimitiveTypeString:
-          argument.m_stringConstantArrayIn = constantManager->EnsureStringConstantArray(arrayNode);
+          argument->m_stringConstantArrayIn = constantManager->EnsureStringConstantArray(arrayNode);
           break;
 
         default:
@@ -608,27 +909,27 @@ namespace Chord
         {
         case PrimitiveTypeFloat:
           ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::FloatConstant);
-          argument.m_floatConstantIn = static_cast<const FloatConstantProgramGraphNode*>(inputProcessorNode)->Value();
+          argument->m_floatConstantIn = m_program->ConstantValue(static_cast<const FloatConstantProgramGraphNode*>(inputProcessorNode));
           break;
 
         case PrimitiveTypeDouble:
           ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::DoubleConstant);
-          argument.m_doubleConstantIn = static_cast<const DoubleConstantProgramGraphNode*>(inputProcessorNode)->Value();
+          argument->m_doubleConstantIn = m_program->ConstantValue(static_cast<const DoubleConstantProgramGraphNode*>(inputProcessorNode));
           break;
 
         case PrimitiveTypeInt:
           ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::IntConstant);
-          argument.m_intConstantIn = static_cast<const IntConstantProgramGraphNode*>(inputProcessorNode)->Value();
+          argument->m_intConstantIn = m_program->ConstantValue(static_cast<const IntConstantProgramGraphNode*>(inputProcessorNode));
           break;
 
         case PrimitiveTypeBool:
           ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::BoolConstant);
-          argument.m_boolConstantIn = static_cast<const BoolConstantProgramGraphNode*>(inputProcessorNode)->Value();
+          argument->m_boolConstantIn = m_program->ConstantValue(static_cast<const BoolConstantProgramGraphNode*>(inputProcessorNode));
           break;
 
         case PrimitiveTypeString:
           ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::StringConstant);
-          argument.m_stringConstantIn = constantManager->EnsureString(static_cast<const StringConstantProgramGraphNode*>(inputProcessorNode)->Value());
+          argument->m_stringConstantIn = constantManager->EnsureString(static_cast<const StringConstantProgramGraphNode*>(inputProcessorNode)->Value());
           break;
 
         default:
@@ -664,7 +965,7 @@ namespace Chord
                 { bufferManager->AddBufferInputTask(*bufferHandle, task, !parameter.m_disallowBufferSharing); }
             }
 
-            argument.m_floatBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = arrayNode->Elements().Count() };
+            argument->m_floatBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = arrayNode->Elements().Count() };
             break;
           }
 
@@ -684,7 +985,7 @@ namespace Chord
                 { bufferManager->AddBufferInputTask(*bufferHandle, task, !parameter.m_disallowBufferSharing); }
             }
 
-            argument.m_doubleBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = arrayNode->Elements().Count() };
+            argument->m_doubleBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = arrayNode->Elements().Count() };
             break;
           }
 
@@ -704,7 +1005,7 @@ namespace Chord
                 { bufferManager->AddBufferInputTask(*bufferHandle, task, !parameter.m_disallowBufferSharing); }
             }
 
-            argument.m_intBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = arrayNode->Elements().Count() };
+            argument->m_intBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = arrayNode->Elements().Count() };
             break;
           }
 
@@ -724,7 +1025,7 @@ namespace Chord
                 { bufferManager->AddBufferInputTask(*bufferHandle, task, !parameter.m_disallowBufferSharing); }
             }
 
-            argument.m_boolBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = arrayNode->Elements().Count() };
+            argument->m_boolBufferArrayIn = { .m_elements = buffers.Elements(), .m_count = arrayNode->Elements().Count() };
             break;
           }
 
@@ -743,19 +1044,19 @@ namespace Chord
         switch (parameter.m_dataType.m_primitiveType)
         {
         case PrimitiveTypeFloat:
-          bufferHandle = InitializeBufferOrConstant<f32>(constantManager, bufferManager, task, outputNode, &argument.m_floatBufferIn, upsampleFactor);
+          bufferHandle = InitializeBufferOrConstant<f32>(constantManager, bufferManager, task, outputNode, &argument->m_floatBufferIn, upsampleFactor);
           break;
 
         case PrimitiveTypeDouble:
-          bufferHandle = InitializeBufferOrConstant<f64>(constantManager, bufferManager, task, outputNode, &argument.m_doubleBufferIn, upsampleFactor);
+          bufferHandle = InitializeBufferOrConstant<f64>(constantManager, bufferManager, task, outputNode, &argument->m_doubleBufferIn, upsampleFactor);
           break;
 
         case PrimitiveTypeInt:
-          bufferHandle = InitializeBufferOrConstant<s32>(constantManager, bufferManager, task, outputNode, &argument.m_intBufferIn, upsampleFactor);
+          bufferHandle = InitializeBufferOrConstant<s32>(constantManager, bufferManager, task, outputNode, &argument->m_intBufferIn, upsampleFactor);
           break;
 
         case PrimitiveTypeBool:
-          bufferHandle = InitializeBufferOrConstant<bool>(constantManager, bufferManager, task, outputNode, &argument.m_boolBufferIn, upsampleFactor);
+          bufferHandle = InitializeBufferOrConstant<bool>(constantManager, bufferManager, task, outputNode, &argument->m_boolBufferIn, upsampleFactor);
           break;
 
         case PrimitiveTypeString:
@@ -772,18 +1073,174 @@ namespace Chord
       }
     }
 
-    return argument;
   }
 
-  NativeModuleArgument ProgramStageTaskManager::BuildNativeModuleOutputArgument(
+  void ProgramStageTaskManager::UpdateNativeModuleInputArgument(
+    ConstantManager* constantManager,
+    const NativeModuleParameter& parameter,
+    const IInputProgramGraphNode* inputNode,
+    const HashSet<const IProcessorProgramGraphNode*>& constantNodes,
+    NativeModuleArgument* argument)
+  {
+    const IProcessorProgramGraphNode* inputProcessorNode = inputNode->Connection()->Processor();
+
+    // This mirrors BuildNativeModuleInputArgument() but only constant values are replaced. String constants never change in place.
+    if (parameter.m_dataType.m_runtimeMutability == RuntimeMutability::RuntimeMutabilityConstant)
+    {
+      if (parameter.m_dataType.m_isArray)
+      {
+        // The new array is ensured before the previous one is released so that unchanged contents are not freed and reallocated
+        ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::Array);
+        const ArrayProgramGraphNode* arrayNode = static_cast<const ArrayProgramGraphNode*>(inputProcessorNode);
+
+        switch (parameter.m_dataType.m_primitiveType)
+        {
+        case PrimitiveTypeFloat:
+          {
+            InputFloatConstantArray array =
+              constantManager->EnsureFloatConstantArray(GatherConstantArrayValues<f32, FloatConstantProgramGraphNode>(arrayNode));
+            constantManager->ReleaseConstantArray(argument->m_floatConstantArrayIn);
+            argument->m_floatConstantArrayIn = array;
+            break;
+          }
+
+        case PrimitiveTypeDouble:
+          {
+            InputDoubleConstantArray array =
+              constantManager->EnsureDoubleConstantArray(GatherConstantArrayValues<f64, DoubleConstantProgramGraphNode>(arrayNode));
+            constantManager->ReleaseConstantArray(argument->m_doubleConstantArrayIn);
+            argument->m_doubleConstantArrayIn = array;
+            break;
+          }
+
+        case PrimitiveTypeInt:
+          {
+            InputIntConstantArray array =
+              constantManager->EnsureIntConstantArray(GatherConstantArrayValues<s32, IntConstantProgramGraphNode>(arrayNode));
+            constantManager->ReleaseConstantArray(argument->m_intConstantArrayIn);
+            argument->m_intConstantArrayIn = array;
+            break;
+          }
+
+        case PrimitiveTypeBool:
+          {
+            InputBoolConstantArray array =
+              constantManager->EnsureBoolConstantArray(GatherConstantArrayValues<bool, BoolConstantProgramGraphNode>(arrayNode));
+            constantManager->ReleaseConstantArray(argument->m_boolConstantArrayIn);
+            argument->m_boolConstantArrayIn = array;
+            break;
+          }
+
+        default:
+          ASSERT(false);
+        }
+      }
+      else
+      {
+        switch (parameter.m_dataType.m_primitiveType)
+        {
+        case PrimitiveTypeFloat:
+          argument->m_floatConstantIn = m_program->ConstantValue(static_cast<const FloatConstantProgramGraphNode*>(inputProcessorNode));
+          break;
+
+        case PrimitiveTypeDouble:
+          argument->m_doubleConstantIn = m_program->ConstantValue(static_cast<const DoubleConstantProgramGraphNode*>(inputProcessorNode));
+          break;
+
+        case PrimitiveTypeInt:
+          argument->m_intConstantIn = m_program->ConstantValue(static_cast<const IntConstantProgramGraphNode*>(inputProcessorNode));
+          break;
+
+        case PrimitiveTypeBool:
+          argument->m_boolConstantIn = m_program->ConstantValue(static_cast<const BoolConstantProgramGraphNode*>(inputProcessorNode));
+          break;
+
+        default:
+          ASSERT(false);
+        }
+      }
+    }
+    else
+    {
+      // Constant buffers point to fixed memory holding the constant value so only the sample pointer needs to change. The sample count and constant flag are
+      // the same for every constant buffer.
+      if (parameter.m_dataType.m_isArray)
+      {
+        ASSERT(inputProcessorNode->Type() == ProgramGraphNodeType::Array);
+        const ArrayProgramGraphNode* arrayNode = static_cast<const ArrayProgramGraphNode*>(inputProcessorNode);
+        for (usz i = 0; i < arrayNode->Elements().Count(); i++)
+        {
+          const IProcessorProgramGraphNode* elementProcessorNode = arrayNode->Elements()[i]->Connection()->Processor();
+          if (!constantNodes.Contains(elementProcessorNode))
+            { continue; }
+
+          switch (parameter.m_dataType.m_primitiveType)
+          {
+          case PrimitiveTypeFloat:
+            argument->m_floatBufferArrayIn.m_elements[i].m_samples = constantManager->EnsureConstantBuffer(
+              m_program->ConstantValue(static_cast<const FloatConstantProgramGraphNode*>(elementProcessorNode))).m_samples;
+            break;
+
+          case PrimitiveTypeDouble:
+            argument->m_doubleBufferArrayIn.m_elements[i].m_samples = constantManager->EnsureConstantBuffer(
+              m_program->ConstantValue(static_cast<const DoubleConstantProgramGraphNode*>(elementProcessorNode))).m_samples;
+            break;
+
+          case PrimitiveTypeInt:
+            argument->m_intBufferArrayIn.m_elements[i].m_samples = constantManager->EnsureConstantBuffer(
+              m_program->ConstantValue(static_cast<const IntConstantProgramGraphNode*>(elementProcessorNode))).m_samples;
+            break;
+
+          case PrimitiveTypeBool:
+            argument->m_boolBufferArrayIn.m_elements[i].m_samples = constantManager->EnsureConstantBuffer(
+              m_program->ConstantValue(static_cast<const BoolConstantProgramGraphNode*>(elementProcessorNode))).m_samples;
+            break;
+
+          default:
+            ASSERT(false);
+          }
+        }
+      }
+      else
+      {
+        switch (parameter.m_dataType.m_primitiveType)
+        {
+        case PrimitiveTypeFloat:
+          argument->m_floatBufferIn.m_samples =
+            constantManager->EnsureConstantBuffer(m_program->ConstantValue(static_cast<const FloatConstantProgramGraphNode*>(inputProcessorNode))).m_samples;
+          break;
+
+        case PrimitiveTypeDouble:
+          argument->m_doubleBufferIn.m_samples =
+            constantManager->EnsureConstantBuffer(m_program->ConstantValue(static_cast<const DoubleConstantProgramGraphNode*>(inputProcessorNode))).m_samples;
+          break;
+
+        case PrimitiveTypeInt:
+          argument->m_intBufferIn.m_samples =
+            constantManager->EnsureConstantBuffer(m_program->ConstantValue(static_cast<const IntConstantProgramGraphNode*>(inputProcessorNode))).m_samples;
+          break;
+
+        case PrimitiveTypeBool:
+          argument->m_boolBufferIn.m_samples =
+            constantManager->EnsureConstantBuffer(m_program->ConstantValue(static_cast<const BoolConstantProgramGraphNode*>(inputProcessorNode))).m_samples;
+          break;
+
+        default:
+          ASSERT(false);
+        }
+      }
+    }
+  }
+
+  void ProgramStageTaskManager::BuildNativeModuleOutputArgument(
     BufferManager* bufferManager,
     NativeModuleCallTask* task,
     const NativeModuleParameter& parameter,
-    const IOutputProgramGraphNode* outputNode)
+    const IOutputProgramGraphNode* outputNode,
+    NativeModuleArgument* argument)
   {
     ASSERT(!parameter.m_dataType.m_isArray);
 
-    NativeModuleArgument argument;
 
     s32 upsampleFactor = task->m_upsampleFactor * parameter.m_dataType.m_upsampleFactor;
     auto bufferHandle = bufferManager->AddBuffer(parameter.m_dataType.m_primitiveType, m_bufferSampleCount, upsampleFactor);
@@ -797,19 +1254,19 @@ namespace Chord
     switch (parameter.m_dataType.m_primitiveType)
     {
     case PrimitiveTypeFloat:
-      InitializeBuffer(bufferManager, task, false, outputNode, &argument.m_floatBufferOut, upsampleFactor);
+      InitializeBuffer(bufferManager, task, false, outputNode, &argument->m_floatBufferOut, upsampleFactor);
       break;
 
     case PrimitiveTypeDouble:
-      InitializeBuffer(bufferManager, task, false, outputNode, &argument.m_doubleBufferOut, upsampleFactor);
+      InitializeBuffer(bufferManager, task, false, outputNode, &argument->m_doubleBufferOut, upsampleFactor);
       break;
 
     case PrimitiveTypeInt:
-      InitializeBuffer(bufferManager, task, false, outputNode, &argument.m_intBufferOut, upsampleFactor);
+      InitializeBuffer(bufferManager, task, false, outputNode, &argument->m_intBufferOut, upsampleFactor);
       break;
 
     case PrimitiveTypeBool:
-      InitializeBuffer(bufferManager, task, false, outputNode, &argument.m_boolBufferOut, upsampleFactor);
+      InitializeBuffer(bufferManager, task, false, outputNode, &argument->m_boolBufferOut, upsampleFactor);
       break;
 
     case PrimitiveTypeString:
@@ -820,13 +1277,19 @@ namespace Chord
       ASSERT(false);
     }
 
-    return argument;
   }
 
-  void ProgramStageTaskManager::InitializeGraphOutput(const ProgramGraph& programGraph, const GraphOutputProgramGraphNode* outputNode)
+  void ProgramStageTaskManager::InitializeGraphOutput(
+    BufferManager* bufferManager,
+    const ProgramGraph& programGraph,
+    const GraphOutputProgramGraphNode* outputNode)
   {
     BufferOrConstant graphOutput = m_buffersAndConstantsFromOutputNodes[outputNode->Input()->Connection()];
 
+    // Graph outputs are read after all tasks finish so a graph output buffer must never be overwritten in-place by a task which also reads it
+    if (auto bufferHandle = std::get_if<BufferManager::BufferHandle>(&graphOutput); bufferHandle != nullptr)
+      { bufferManager->AddBufferInputTask(*bufferHandle, this, false); }
+
     if (outputNode == programGraph.m_voiceRemainActive || outputNode == programGraph.m_effectRemainActive)
     {
       ASSERT(!m_remainActiveOutput.has_value());
@@ -839,25 +1302,116 @@ namespace Chord
     }
   }
 
+  usz ProgramStageTaskManager::CalculateTileSampleCount(const BufferManager* bufferManager, usz requestedTileSampleCount) const
+  {
+    if (requestedTileSampleCount == 0 || m_nativeModuleCallTasks.Count() == 0)
+      { return 0; }
+
+    // Sub-blocks must start at an offset that is SIMD-aligned within every buffer used by this stage, so round the requested tile size up accordingly. Note
+    // that all sample offset alignments are powers of two so the largest one is a multiple of all the others.
+    usz sampleOffsetAlignment = 1;
+    for (const NativeModuleCallTask& task : m_nativeModuleCallTasks)
+    {
+      if (!task.m_nativeModule->m_isTileable)
+        { return 0; }
+
+      for (const SamplesInitializer& samplesInitializer : task.m_samplesInitializers)
+        { sampleOffsetAlignment = Max(sampleOffsetAlignment, bufferManager->GetBufferSampleOffsetAlignment(samplesInitializer.m_bufferHandle)); }
+    }
+
+    usz tileSampleCount = AlignInt(requestedTileSampleCount, sampleOffsetAlignment);
+    return tileSampleCount < m_bufferSampleCount ? tileSampleCount : 0;
+  }
+
   void ProgramStageTaskManager::RunTask(TaskExecutor* taskExecutor, usz taskIndex)
   {
     DisallowAllocationsScope disallowAllocationsScope;
 
     NativeModuleCallTask& task = m_nativeModuleCallTasks[taskIndex];
+    InvokeTask(task, 0, m_processContext->m_sampleCount, GetThreadScratchMemory());
+
+    // Kick off successor tasks
+    for (usz successorTaskIndex : task.m_successorTaskIndices)
+    {
+      NativeModuleCallTask& successorTask = m_nativeModuleCallTasks[successorTaskIndex];
+      usz preDecrementCount = successorTask.m_remainingPredecessorCount.fetch_sub(1, std::memory_order_release);
+      ASSERT(preDecrementCount >= 1);
+      if (preDecrementCount == 1)
+        { taskExecutor->EnqueueTask(&successorTask.m_task); }
+    }
+
+    // Kick off the completion task if all outputs have been written
+    if (task.m_writesToGraphOutput)
+    {
+      usz preDecrementCount = m_remainingOutputTaskCount.fetch_sub(1, std::memory_order_release);
+      ASSERT(preDecrementCount >= 1);
+      if (preDecrementCount == 1)
+        { CompleteProcessing(); }
+    }
+  }
+
+  void ProgramStageTaskManager::RunTiledTasks()
+  {
+    DisallowAllocationsScope disallowAllocationsScope;
+
+    BufferManager* bufferManager = m_processContext->m_bufferManager;
+    usz sampleCount = m_processContext->m_sampleCount;
+    Span<u8> threadScratchMemory = GetThreadScratchMemory();
+
+    for (usz tileSampleOffset = 0; tileSampleOffset < sampleCount; tileSampleOffset += m_tileSampleCount)
+    {
+      usz tileSampleCount = Min(m_tileSampleCount, sampleCount - tileSampleOffset);
+
+      // Tasks were created in topological order so running them in order within each tile satisfies all dependencies
+      for (NativeModuleCallTask& task : m_nativeModuleCallTasks)
+      {
+        InvokeTask(task, tileSampleOffset, tileSampleCount, threadScratchMemory);
+        if (!task.m_writesToGraphOutput)
+          { continue; }
+
+        // Graph outputs are read as whole blocks once processing finishes so a constant tile must be written out in full. Otherwise, the constant value
+        // would be interpreted as applying to the entire block.
+        for (const IsConstantResolver& isConstantResolver : task.m_isConstantResolvers)
+        {
+          const BufferManager::Buffer& buffer = bufferManager->GetBuffer(isConstantResolver.m_bufferHandle);
+          if (!buffer.m_isConstant)
+            { continue; }
+
+          bufferManager->StartBufferWrite(isConstantResolver.m_bufferHandle, &task);
+          ExpandConstantBuffer(buffer.GetSubBuffer(tileSampleOffset), tileSampleCount);
+          bufferManager->SetBufferConstant(isConstantResolver.m_bufferHandle, false);
+          bufferManager->FinishBufferWrite(isConstantResolver.m_bufferHandle, &task);
+        }
+      }
+    }
+
+    m_remainingOutputTaskCount.store(0, std::memory_order_release);
+    CompleteProcessing();
+  }
+
+  void ProgramStageTaskManager::InvokeTask(NativeModuleCallTask& task, usz sampleOffset, usz sampleCount, Span<u8> threadScratchMemory)
+  {
+    BufferManager* bufferManager = m_processContext->m_bufferManager;
 
     #if BUFFER_GUARDS_ENABLED
       for (BufferManager::BufferHandle bufferHandle : task.m_inputBufferHandles)
-        { m_processContext->m_bufferManager->StartBufferRead(bufferHandle, &task); }
+        { bufferManager->StartBufferRead(bufferHandle, &task); }
       for (BufferManager::BufferHandle bufferHandle : task.m_outputBufferHandles)
-        { m_processContext->m_bufferManager->StartBufferWrite(bufferHandle, &task); }
+        { bufferManager->StartBufferWrite(bufferHandle, &task); }
     #endif
 
     for (const SampleCountInitializer& sampleCountInitializer : task.m_sampleCountInitializers)
-      { *sampleCountInitializer.m_sampleCount = m_processContext->m_sampleCount * sampleCountInitializer.m_upsampleFactor; }
+      { *sampleCountInitializer.m_sampleCount = sampleCount * sampleCountInitializer.m_upsampleFactor; }
     for (const SamplesInitializer& samplesInitializer : task.m_samplesInitializers)
     {
-      const BufferManager::Buffer& buffer = m_processContext->m_bufferManager->GetBuffer(samplesInitializer.m_bufferHandle);
-      *samplesInitializer.m_samples = buffer.m_memory;
+      const BufferManager::Buffer& buffer = bufferManager->GetBuffer(samplesInitializer.m_bufferHandle);
+
+      // Constant inputs read directly from the buffer's tracked constant value so that buffer memory isn't touched
+      if (samplesInitializer.m_isTaskInput && buffer.m_isConstant)
+        { *samplesInitializer.m_samples = buffer.m_constantValueMemory; }
+      else
+        { *samplesInitializer.m_samples = sampleOffset == 0 ? buffer.m_memory : buffer.GetSubBuffer(sampleOffset).m_memory; }
+
       *samplesInitializer.m_isConstant = buffer.m_isConstant;
     }
 
@@ -871,7 +1425,11 @@ namespace Chord
       task.m_voiceContext,
       task.m_upsampleFactor,
       m_bufferSampleCount * Coerce<usz>(task.m_upsampleFactor),
-      m_processContext->m_sampleCount * Coerce<usz>(task.m_upsampleFactor));
+      sampleCount * Coerce<usz>(task.m_upsampleFactor));
+
+    // The start offset is always smaller than a tile so only the first tile needs it
+    if (sampleOffset == 0)
+      { nativeModuleContext.m_voiceStartSampleOffset = m_voiceStartSampleOffset * Coerce<usz>(task.m_upsampleFactor); }
 
     NativeModuleArguments arguments =
     {
@@ -879,11 +1437,6 @@ namespace Chord
       .m_argumentCount = task.m_arguments.Count(),
     };
 
-    // Grab scratch memory using the thread index
-    auto taskThreadIndex = GetTaskThreadIndex();
-    ASSERT(taskThreadIndex.has_value());
-    Span<u8> threadScratchMemory = m_processContext->m_threadScratchMemory[taskThreadIndex.value()];
-
     ASSERT(threadScratchMemory.Count() >= task.m_scratchMemoryRequirement.m_size);
     ASSERT(IsAlignedPointer(threadScratchMemory.Elements(), task.m_scratchMemoryRequirement.m_alignment));
 
@@ -897,39 +1450,32 @@ namespace Chord
 
     // Update the constant state of output buffers
     for (const IsConstantResolver& isConstantResolver : task.m_isConstantResolvers)
-      { m_processContext->m_bufferManager->SetBufferConstant(isConstantResolver.m_bufferHandle, *isConstantResolver.m_isConstant); }
+      { bufferManager->SetBufferConstant(isConstantResolver.m_bufferHandle, *isConstantResolver.m_isConstant, sampleOffset); }
 
     #if BUFFER_GUARDS_ENABLED
       for (BufferManager::BufferHandle bufferHandle : task.m_inputBufferHandles)
-        { m_processContext->m_bufferManager->FinishBufferWrite(bufferHandle, &task); }
+        { bufferManager->FinishBufferRead(bufferHandle, &task); }
       for (BufferManager::BufferHandle bufferHandle : task.m_outputBufferHandles)
-        { m_processContext->m_bufferManager->FinishBufferWrite(bufferHandle, &task); }
+        { bufferManager->FinishBufferWrite(bufferHandle, &task); }
     #endif
+  }
 
-    // Kick off successor tasks
-    for (usz successorTaskIndex : task.m_successorTaskIndices)
-    {
-      NativeModuleCallTask& successorTask = m_nativeModuleCallTasks[successorTaskIndex];
-      usz preDecrementCount = successorTask.m_remainingPredecessorCount.fetch_sub(1, std::memory_order_release);
-      ASSERT(preDecrementCount >= 1);
-      if (preDecrementCount == 1)
-        { taskExecutor->EnqueueTask(&successorTask.m_task); }
-    }
+  Span<u8> ProgramStageTaskManager::GetThreadScratchMemory() const
+  {
+    // Grab scratch memory using the thread index
+    auto taskThreadIndex = GetTaskThreadIndex();
+    ASSERT(taskThreadIndex.has_value());
+    return m_processContext->m_threadScratchMemory[taskThreadIndex.value()];
+  }
 
-    // Kick off the completion task if all outputs have been written
-    if (task.m_writesToGraphOutput)
-    {
-      usz preDecrementCount = m_remainingOutputTaskCount.fetch_sub(1, std::memory_order_release);
-      ASSERT(preDecrementCount >= 1);
-      if (preDecrementCount == 1)
-      {
-        ProcessRemainActiveOutput();
+  void ProgramStageTaskManager::CompleteProcessing()
+  {
+    ProcessRemainActiveOutput();
+    m_voiceStartSampleOffset = 0;
 
-        ProcessContext processContext = m_processContext.value();
-        m_processContext.reset();
-        processContext.m_onComplete();
-      }
-    }
+    ProcessContext processContext = m_processContext.value();
+    m_processContext.reset();
+    processContext.m_onComplete();
   }
 
   void ProgramStageTaskManager::ProcessRemainActiveOutput()
@@ -24,6 +24,26 @@ namespace Chord
     public:
       using BufferOrConstant = std::variant<BufferManager::BufferHandle, f32, f64, s32, bool>;
 
+      struct MemoryFootprint
+      {
+        // The buffers written by this stage's native modules and the number of bytes they would occupy if no buffer memory were shared
+        usz m_bufferCount = 0;
+        usz m_unsharedBufferByteCount = 0;
+
+        // Memory reported by native module voice contexts. Native modules with voice contexts which don't report their memory usage are counted separately.
+        usz m_nativeModuleVoiceContextByteCount = 0;
+        usz m_unreportedNativeModuleVoiceContextCount = 0;
+
+        // Task, argument, and initializer bookkeeping
+        usz m_taskMetadataByteCount = 0;
+      };
+
+      // Estimates the footprint of a stage without instantiating it. Native module voice contexts are not initialized so they are all counted as unreported.
+      static MemoryFootprint EstimateMemoryFootprint(
+        const NativeLibraryRegistry* nativeLibraryRegistry,
+        usz bufferSampleCount,
+        Span<const IProcessorProgramGraphNode*> rootNodes);
+
       ProgramStageTaskManager(
         NativeLibraryRegistry* nativeLibraryRegistry,
         const Callable<void(ReportingSeverity severity, const UnicodeString& message)>& reportCallback,
@@ -32,6 +52,7 @@ namespace Chord
         ConstantManager* constantManager,
         BufferManager* bufferManager,
         usz bufferSampleCount,
+        usz tileSampleCount,
         std::optional<Span<const BufferManager::BufferHandle>> inputChannelBuffersFloat,
         std::optional<Span<const BufferManager::BufferHandle>> inputChannelBuffersDouble,
         usz nativeModuleCallNodeCount,
@@ -40,13 +61,22 @@ namespace Chord
       ProgramStageTaskManager(const ProgramStageTaskManager&) = delete;
       ProgramStageTaskManager& operator=(const ProgramStageTaskManager&) = delete;
 
+      // Initializes native library and native module voice contexts. This is separate from construction, which registers buffers and constants with shared
+      // managers, so that the voice contexts of different stages can be initialized in parallel. The scratch memory requirement and memory footprint are only
+      // complete after this has been called.
+      void InitializeVoiceContexts();
+
       MemoryRequirement GetScratchMemoryRequirement() const;
+      MemoryFootprint GetMemoryFootprint(const BufferManager* bufferManager) const;
 
       void DeclareBufferConcurrency(BufferManager* bufferManager, Span<const IProcessorProgramGraphNode*> outputNodes) const;
       void DeclareBufferConcurrencyWithOther(BufferManager* bufferManager, const ProgramStageTaskManager& other) const;
 
       bool IsActive() const;
       void SetActive(bool active);
+
+      // Reported to native modules on the next activation and the next processed block, after which it is reset to 0
+      void SetVoiceStartSampleOffset(usz voiceStartSampleOffset);
       void Process(
         TaskExecutor* taskExecutor,
         BufferManager* bufferManager,
@@ -60,6 +90,15 @@ namespace Chord
       BufferOrConstant GetOutput(usz outputIndex) const;
       bool ShouldRemainActive() const;
 
+      // Returns whether the values of the given constant nodes can be changed without rebuilding this stage. Voice contexts are initialized from argument
+      // values and Prepare computes argument latencies (which the compiler used for latency compensation) from argument values so a changed constant must not
+      // reach a native module with an InitializeVoice or Prepare callback.
+      bool CanUpdateConstants(const HashSet<const IProcessorProgramGraphNode*>& constantNodes) const;
+
+      // Embeds the program's current values of the given constant nodes into task arguments and graph outputs. Constant nodes which don't belong to this
+      // stage are ignored. This must not be called while the stage is processing and the new values take effect starting with the next processed block.
+      void UpdateConstants(ConstantManager* constantManager, const HashSet<const IProcessorProgramGraphNode*>& constantNodes);
+
     private:
       // This is used to quickly initialize all the sample count values within task arguments
       struct SampleCountInitializer
@@ -74,6 +113,7 @@ namespace Chord
         void** m_samples = nullptr;
         bool* m_isConstant = nullptr;
         BufferManager::BufferHandle m_bufferHandle;
+        bool m_isTaskInput = false;
       };
 
       // This is used to quickly set whether buffers are constant after the task runs
@@ -97,12 +137,13 @@ namespace Chord
         UnboundedArray<SampleCountInitializer> m_sampleCountInitializers;
         UnboundedArray<SamplesInitializer> m_samplesInitializers;
         UnboundedArray<IsConstantResolver> m_isConstantResolvers;
+        UnboundedArray<BufferManager::BufferHandle> m_inputBufferHandles;
         #if BUFFER_GUARDS_ENABLED
-          UnboundedArray<BufferManager::BufferHandle> m_inputBufferHandles;
           UnboundedArray<BufferManager::BufferHandle> m_outputBufferHandles;
         #endif
 
         void* m_voiceContext = nullptr;
+        std::optional<usz> m_voiceContextByteCount;
         MemoryRequirement m_scratchMemoryRequirement;
 
         Task m_task;
@@ -129,6 +170,7 @@ namespace Chord
       };
 
       static void ReportCallbackStatic(void* context, ReportingSeverity reportingSeverity, const char32_t* message, size_t length);
+      static const NativeModule* FindNativeModule(const NativeLibrary* nativeLibrary, const NativeModuleCallProgramGraphNode* node);
 
       NativeModuleContext BuildNativeModuleContext(
         const NativeLibraryEntry& nativeLibraryEntry,
@@ -144,25 +186,50 @@ namespace Chord
         const NativeModuleCallProgramGraphNode* node,
         NativeModuleCallTask* task);
 
-      NativeModuleArgument BuildNativeModuleInputArgument(
+      void BuildNativeModuleInputArgument(
         ConstantManager* constantManager,
         BufferManager* bufferManager,
         NativeModuleCallTask* task,
         const NativeModuleParameter& parameter,
-        const IInputProgramGraphNode* inputNode);
+        const IInputProgramGraphNode* inputNode,
+        NativeModuleArgument* argument);
 
-      NativeModuleArgument BuildNativeModuleOutputArgument(
+      void UpdateNativeModuleInputArgument(
+        ConstantManager* constantManager,
+        const NativeModuleParameter& parameter,
+        const IInputProgramGraphNode* inputNode,
+        const HashSet<const IProcessorProgramGraphNode*>& constantNodes,
+        NativeModuleArgument* argument);
+
+      void BuildNativeModuleOutputArgument(
         BufferManager* bufferManager,
         NativeModuleCallTask* task,
         const NativeModuleParameter& parameter,
-        const IOutputProgramGraphNode* outputNode);
+        const IOutputProgramGraphNode* outputNode,
+        NativeModuleArgument* argument);
 
-      void InitializeGraphOutput(const ProgramGraph& programGraph, const GraphOutputProgramGraphNode* outputNode);
+      void InitializeGraphOutput(BufferManager* bufferManager, const ProgramGraph& programGraph, const GraphOutputProgramGraphNode* outputNode);
+
+      usz CalculateTileSampleCount(const BufferManager* bufferManager, usz requestedTileSampleCount) const;
 
       void RunTask(TaskExecutor* taskExecutor, usz taskIndex);
+      void RunTiledTasks();
+      void InvokeTask(NativeModuleCallTask& task, usz sampleOffset, usz sampleCount, Span<u8> threadScratchMemory);
+      Span<u8> GetThreadScratchMemory() const;
+      void CompleteProcessing();
 
       void ProcessRemainActiveOutput();
 
+      // Constant values are read through the program because programs which share a graph share its constant nodes but not their values
+      template<typename TElement, typename TConstantNode>
+      FixedArray<TElement> GatherConstantArrayValues(const ArrayProgramGraphNode* arrayNode) const
+      {
+        FixedArray<TElement> elements = InitializeCapacity(arrayNode->Elements().Count());
+        for (usz i = 0; i < elements.Count(); i++)
+          { elements[i] = m_program->ConstantValue(static_cast<const TConstantNode*>(arrayNode->Elements()[i]->Connection()->Processor())); }
+        return elements;
+      }
+
       template<typename TElement, typename TBuffer>
       std::optional<BufferManager::BufferHandle> InitializeBufferOrConstant(
         ConstantManager* constantManager,
@@ -210,14 +277,11 @@ namespace Chord
             .m_samples = const_cast<void**>(reinterpret_cast<VoidPointer*>(&buffer->m_samples)),
             .m_isConstant = &buffer->m_isConstant,
             .m_bufferHandle = bufferHandle,
+            .m_isTaskInput = isTaskInput,
           });
 
         if (isTaskInput)
-        {
-          #if BUFFER_GUARDS_ENABLED
-            task->m_inputBufferHandles.Append(bufferHandle);
-          #endif
-        }
+          { task->m_inputBufferHandles.Append(bufferHandle); }
         else
         {
           task->m_isConstantResolvers.Append({ .m_isConstant = &buffer->m_isConstant, .m_bufferHandle = bufferHandle });
@@ -230,12 +294,16 @@ namespace Chord
       }
 
       Callable<void(ReportingSeverity severity, const UnicodeString& message)> m_reportCallback;
+      const Program* m_program = nullptr;
 
       s32 m_sampleRate = 0;
       s32 m_inputChannelCount = 0;
       s32 m_outputChannelCount = 0;
       usz m_bufferSampleCount = 0;
 
+      // If non-zero, every native module in this stage is tileable and blocks larger than this are processed in sub-blocks of this size on a single task
+      usz m_tileSampleCount = 0;
+
       HashMap<const IOutputProgramGraphNode*, BufferOrConstant> m_buffersAndConstantsFromOutputNodes;
 
       MemoryRequirement m_scratchMemoryRequirement = { .m_size = 0, .m_alignment = 0 };
@@ -243,13 +311,16 @@ namespace Chord
       UnboundedArray<NativeLibraryEntry> m_nativeLibraries;
       UnboundedArray<NativeModuleCallTask*> m_tasksWithSetVoiceActive;
 
+      bool m_voiceContextsInitialized = false;
       bool m_active = false;
+      usz m_voiceStartSampleOffset = 0;
 
       FixedArray<NativeModuleCallTask> m_nativeModuleCallTasks;
       FixedArray<BufferOrConstant> m_outputs;
       std::optional<BufferOrConstant> m_remainActiveOutput;
 
       UnboundedArray<usz> m_rootTaskIndices;
+      Task m_tiledTask;
 
       usz m_outputTaskCount = 0;
       std::atomic<usz> m_remainingOutputTaskCount = 0;
@@ -0,0 +1,120 @@
+module Chord.Engine;
+
+import std;
+
+import Chord.Foundation;
+
+namespace Chord
+{
+  template<typename TElement>
+  static Span<const u8> AsBytes(Span<const TElement> elements)
+    { return Span(reinterpret_cast<const u8*>(elements.Elements()), elements.Count() * sizeof(TElement)); }
+
+  template<typename TElement>
+  static Span<const TElement> FromBytes(const u8* bytes, usz count)
+    { return Span(reinterpret_cast<const TElement*>(bytes), count); }
+
+  template<typename TElement>
+  static FixedArray<u8, MaxSimdAlignment> BuildConstantBufferBytes(TElement value)
+  {
+    FixedArray<u8, MaxSimdAlignment> bytes;
+    for (usz i = 0; i < MaxSimdAlignment; i += sizeof(TElement))
+      { std::memcpy(bytes.Elements() + i, &value, sizeof(TElement)); }
+    return bytes;
+  }
+
+  SharedConstantPool::~SharedConstantPool() noexcept
+    { ASSERT(m_statistics.m_referenceCount == 0, "Not all constants were released"); }
+
+  Span<const char32_t> SharedConstantPool::EnsureString(Span<const char32_t> string)
+    { return FromBytes<char32_t>(Ensure(SharedConstantType::String, AsBytes(string)), string.Count()); }
+
+  Span<const f32> SharedConstantPool::EnsureConstantArray(Span<const f32> elements)
+    { return FromBytes<f32>(Ensure(SharedConstantType::FloatArray, AsBytes(elements)), elements.Count()); }
+
+  Span<const f64> SharedConstantPool::EnsureConstantArray(Span<const f64> elements)
+    { return FromBytes<f64>(Ensure(SharedConstantType::DoubleArray, AsBytes(elements)), elements.Count()); }
+
+  Span<const s32> SharedConstantPool::EnsureConstantArray(Span<const s32> elements)
+    { return FromBytes<s32>(Ensure(SharedConstantType::IntArray, AsBytes(elements)), elements.Count()); }
+
+  Span<const bool> SharedConstantPool::EnsureConstantArray(Span<const bool> elements)
+    { return FromBytes<bool>(Ensure(SharedConstantType::BoolArray, AsBytes(elements)), elements.Count()); }
+
+  const f32* SharedConstantPool::EnsureConstantBuffer(f32 value)
+    { return reinterpret_cast<const f32*>(Ensure(SharedConstantType::FloatBuffer, BuildConstantBufferBytes(value))); }
+
+  const f64* SharedConstantPool::EnsureConstantBuffer(f64 value)
+    { return reinterpret_cast<const f64*>(Ensure(SharedConstantType::DoubleBuffer, BuildConstantBufferBytes(value))); }
+
+  const s32* SharedConstantPool::EnsureConstantBuffer(s32 value)
+    { return reinterpret_cast<const s32*>(Ensure(SharedConstantType::IntBuffer, BuildConstantBufferBytes(value))); }
+
+  const u8* SharedConstantPool::EnsureConstantBuffer(bool value)
+    { return Ensure(SharedConstantType::BoolBuffer, BuildConstantBufferBytes(u8(value ? 0xff : 0))); }
+
+  void SharedConstantPool::Release(const void* constant)
+  {
+    std::unique_lock lock(m_mutex);
+    const SharedConstantKey* storedKey = m_keysFromConstants.TryGet(constant);
+    ASSERT(storedKey != nullptr, "Constant was not inserted into this pool");
+    SharedConstantKey key = *storedKey;
+
+    Entry* entry = m_entries.TryGet(key);
+    ASSERT(entry != nullptr && entry->m_referenceCount > 0);
+    usz byteCount = entry->m_memory.AsType<u8>().Count();
+
+    entry->m_referenceCount--;
+    m_statistics.m_referenceCount--;
+    if (entry->m_referenceCount > 0)
+    {
+      m_statistics.m_sharedByteCount -= byteCount;
+      return;
+    }
+
+    m_statistics.m_constantCount--;
+    m_statistics.m_byteCount -= byteCount;
+
+    // The key references the entry's memory so the entry must be removed last
+    m_keysFromConstants.Remove(constant);
+    m_entries.Remove(key);
+  }
+
+  SharedConstantPool::Statistics SharedConstantPool::GetStatistics() const
+  {
+    std::unique_lock lock(m_mutex);
+    return m_statistics;
+  }
+
+  const u8* SharedConstantPool::Ensure(SharedConstantType type, Span<const u8> bytes)
+  {
+    SharedConstantKey key = { .m_type = type, .m_bytes = bytes };
+
+    std::unique_lock lock(m_mutex);
+    m_statistics.m_referenceCount++;
+
+    Entry* entry = m_entries.TryGet(key);
+    if (entry != nullptr)
+    {
+      entry->m_referenceCount++;
+      m_statistics.m_sharedByteCount += entry->m_memory.AsType<u8>().Count();
+      return entry->m_memory.AsType<u8>().Elements();
+    }
+
+    // Every constant is padded to a whole number of SIMD vectors so that constant buffers (and empty constants) can be allocated in the same way as other
+    // constants
+    BufferMemory memory(AlignInt(Max(bytes.Count(), 1_usz), MaxSimdAlignment));
+    Span<u8> memoryBytes = memory.AsType<u8>();
+    memoryBytes.ZeroElements();
+    if (!bytes.IsEmpty())
+      { Copy(memoryBytes.Elements(), bytes.Elements(), bytes.Count()); }
+
+    SharedConstantKey storedKey = { .m_type = type, .m_bytes = Span<const u8>(memoryBytes.Elements(), bytes.Count()) };
+    m_keysFromConstants.Insert(memoryBytes.Elements(), storedKey);
+    m_entries.Insert(storedKey, { .m_memory = std::move(memory), .m_referenceCount = 1 });
+
+    m_statistics.m_constantCount++;
+    m_statistics.m_byteCount += memoryBytes.Count();
+    return memoryBytes.Elements();
+  }
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+export module Chord.Engine:ProgramProcessing.SharedConstantPool;
+
+import std;
+
+import Chord.Foundation;
+import :ProgramProcessing.BufferMemory;
+
+namespace Chord
+{
+  enum class SharedConstantType : u8
+  {
+    String,
+    FloatArray,
+    DoubleArray,
+    IntArray,
+    BoolArray,
+    FloatBuffer,
+    DoubleBuffer,
+    IntBuffer,
+    BoolBuffer,
+  };
+
+  // Keys stored in the pool reference the pool's own copy of each constant while keys used for lookups reference the caller's bytes, so constants are compared
+  // by content rather than by hash alone
+  struct SharedConstantKey
+  {
+    SharedConstantType m_type = SharedConstantType::String;
+    Span<const u8> m_bytes;
+
+    bool operator==(const SharedConstantKey& other) const
+    {
+      return m_type == other.m_type
+        && m_bytes.Count() == other.m_bytes.Count()
+        && (m_bytes.IsEmpty() || std::memcmp(m_bytes.Elements(), other.m_bytes.Elements(), m_bytes.Count()) == 0);
+    }
+  };
+
+  HashKey CalculateHashKey(const SharedConstantKey& value)
+  {
+    // The bytes hash already covers the byte count
+    HashGenerator hashGenerator;
+    hashGenerator.Append(u8(value.m_type));
+    hashGenerator.Append(u64(CalculateBytesHashKey(value.m_bytes)));
+    return hashGenerator.GetHashKey();
+  }
+
+  export
+  {
+    // Holds immutable strings, constant arrays, and constant buffers which are shared between the ConstantManagers of any number of ProgramProcessors so that
+    // identical constants (such as 0 and 1 buffers or a wavetable used by many instruments) are only stored once. Constants are inserted and released under a
+    // lock while processors are constructed and destroyed. Once inserted, a constant never moves or changes until its last reference is released, so
+    // processors read it during processing without any synchronization.
+    class SharedConstantPool
+    {
+    public:
+      struct Statistics
+      {
+        // The number of distinct constants currently held and the total number of outstanding references to those constants
+        usz m_constantCount = 0;
+        usz m_referenceCount = 0;
+
+        // The number of bytes held by distinct constants
+        usz m_byteCount = 0;
+
+        // The number of bytes which would have been held again had each reference stored its own copy of the constant
+        usz m_sharedByteCount = 0;
+      };
+
+      SharedConstantPool() = default;
+      SharedConstantPool(const SharedConstantPool&) = delete;
+      SharedConstantPool& operator=(const SharedConstantPool&) = delete;
+
+      // All constants must be released (i.e. all ConstantManagers using this pool must be destroyed) before the pool is destroyed
+      ~SharedConstantPool() noexcept;
+
+      // Each of these adds a reference to the returned constant which must later be released with Release()
+      Span<const char32_t> EnsureString(Span<const char32_t> string);
+
+      Span<const f32> EnsureConstantArray(Span<const f32> elements);
+      Span<const f64> EnsureConstantArray(Span<const f64> elements);
+      Span<const s32> EnsureConstantArray(Span<const s32> elements);
+      Span<const bool> EnsureConstantArray(Span<const bool> elements);
+
+      // Constant buffers hold MaxSimdAlignment bytes filled with the value (bool values are stored as 0x00 or 0xff bytes)
+      const f32* EnsureConstantBuffer(f32 value);
+      const f64* EnsureConstantBuffer(f64 value);
+      const s32* EnsureConstantBuffer(s32 value);
+      const u8* EnsureConstantBuffer(bool value);
+
+      void Release(const void* constant);
+
+      Statistics GetStatistics() const;
+
+    private:
+      struct Entry
+      {
+        BufferMemory m_memory;
+        usz m_referenceCount = 0;
+      };
+
+      const u8* Ensure(SharedConstantType type, Span<const u8> bytes);
+
+      mutable std::mutex m_mutex;
+      HashMap<SharedConstantKey, Entry> m_entries;
+      HashMap<const void*, SharedConstantKey> m_keysFromConstants;
+      Statistics m_statistics;
+    };
+  }
+}
\ No newline at end of file
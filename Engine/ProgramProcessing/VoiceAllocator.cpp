@@ -7,7 +7,15 @@ import Chord.Foundation;
 namespace Chord
 {
   VoiceAllocator::VoiceAllocator(usz maxVoiceCount)
-    : m_inactiveVoiceIndices(InitializeCapacity(maxVoiceCount))
+    : VoiceAllocator(maxVoiceCount, VoiceStealingPolicy::Oldest)
+    { }
+
+  VoiceAllocator::VoiceAllocator(usz maxVoiceCount, VoiceStealingPolicy voiceStealingPolicy)
+    : m_voiceStealingPolicy(voiceStealingPolicy)
+    , m_voiceStates(InitializeCapacity(maxVoiceCount))
+    , m_voiceIndicesFromIds(InitializeCapacity(maxVoiceCount))
+    , m_voiceLimit(maxVoiceCount)
+    , m_inactiveVoiceIndices(InitializeCapacity(maxVoiceCount))
     , m_activeVoiceIndices(InitializeCapacity(maxVoiceCount))
     , m_deactivatedVoiceIndices(InitializeCapacity(maxVoiceCount))
     , m_activatedVoices(InitializeCapacity(maxVoiceCount))
@@ -19,54 +27,100 @@ namespace Chord
 
   void VoiceAllocator::BeginBlockVoiceAllocation()
   {
+    for (usz voiceIndex : m_deactivatedVoiceIndices)
+      { m_voiceStates[voiceIndex].m_deactivatedThisBlock = false; }
+
+    for (const ActivatedVoice& activatedVoice : m_activatedVoices)
+      { m_voiceStates[activatedVoice.m_voiceIndex].m_activatedVoicesIndex.reset(); }
+
     m_deactivatedVoiceIndices.Clear();
     m_activatedVoices.Clear();
   }
 
-  void VoiceAllocator::TriggerVoice(usz sampleIndex)
+  usz VoiceAllocator::TriggerVoice(usz sampleIndex)
   {
-    if (m_inactiveVoiceIndices.IsEmpty())
-    {
-      // If there are no inactive voices, we'll deactivate the oldest active voice
-      ASSERT(!m_activeVoiceIndices.IsEmpty());
-      usz deactivatedVoiceIndex = m_activeVoiceIndices[0];
-      m_activeVoiceIndices.RemoveByIndex(0);
+    usz voiceIndex = AllocateVoice();
+    ActivateVoice(voiceIndex, sampleIndex);
+    return voiceIndex;
+  }
 
-      // If this voice is on the activation list, remove it; we don't want it on there twice
-      for (usz i = 0; i < m_activatedVoices.Count(); i++)
-      {
-        if (m_activatedVoices[i].m_voiceIndex == deactivatedVoiceIndex)
-        {
-          m_activatedVoices.RemoveByIndex(i);
-          break;
-        }
-      }
+  usz VoiceAllocator::TriggerVoice(usz sampleIndex, u64 voiceId)
+  {
+    usz voiceIndex;
+    const usz* boundVoiceIndex = m_voiceIndicesFromIds.TryGet(voiceId);
+    if (boundVoiceIndex != nullptr)
+    {
+      // Retrigger the voice which is already playing this ID by restarting it
+      voiceIndex = *boundVoiceIndex;
+      StopVoice(voiceIndex);
+    }
+    else
+      { voiceIndex = AllocateVoice(); }
 
-      m_inactiveVoiceIndices.Append(deactivatedVoiceIndex);
+    ActivateVoice(voiceIndex, sampleIndex);
 
-      // It's possible, though unlikely, that we already deactivated this voice and then reactivated it, and now we're deactivating it a second time. In this
-      // case, it will already be on the deactivation list, so don't add it again.
-      if (!m_deactivatedVoiceIndices.FirstIndexOf(deactivatedVoiceIndex).has_value())
-        { m_deactivatedVoiceIndices.Append(deactivatedVoiceIndex); }
-    }
+    m_voiceStates[voiceIndex].m_voiceId = voiceId;
+    m_voiceIndicesFromIds.Insert(voiceId, voiceIndex);
+    return voiceIndex;
+  }
 
-    ASSERT(!m_inactiveVoiceIndices.IsEmpty());
-    usz voiceIndex = m_inactiveVoiceIndices[m_inactiveVoiceIndices.Count() - 1];
-    m_inactiveVoiceIndices.RemoveByIndex(m_inactiveVoiceIndices.Count() - 1);
+  void VoiceAllocator::ReleaseVoice(u64 voiceId)
+  {
+    const usz* voiceIndex = m_voiceIndicesFromIds.TryGet(voiceId);
+    if (voiceIndex == nullptr)
+      { return; }
 
-    // Append to the active voice list which will cause the list to be sorted by voice age starting with the oldest voices
-    m_activeVoiceIndices.Append(voiceIndex);
-    m_activatedVoices.Append({ .m_voiceIndex = voiceIndex, .m_sampleIndex = sampleIndex });
+    VoiceState& voiceState = m_voiceStates[*voiceIndex];
+    ASSERT(voiceState.m_activeVoiceIndicesIndex.has_value());
+    voiceState.m_released = true;
+    UnbindVoiceId(*voiceIndex);
   }
 
   void VoiceAllocator::DeactivateVoice(usz voiceIndex)
   {
-    auto activeVoiceIndicesIndex = m_activeVoiceIndices.FirstIndexOf(voiceIndex);
-    ASSERT(activeVoiceIndicesIndex.has_value());
-    m_activeVoiceIndices.RemoveByIndex(activeVoiceIndicesIndex.value());
+    UnlinkActiveVoice(voiceIndex);
+    UnbindVoiceId(voiceIndex);
     m_inactiveVoiceIndices.Append(voiceIndex);
   }
 
+  bool VoiceAllocator::IsVoiceReleased(usz voiceIndex) const
+    { return m_voiceStates[voiceIndex].m_released; }
+
+  void VoiceAllocator::SetVoicePriority(usz voiceIndex, s32 priority)
+  {
+    ASSERT(m_voiceStates[voiceIndex].m_activeVoiceIndicesIndex.has_value());
+    m_voiceStates[voiceIndex].m_priority = priority;
+  }
+
+  void VoiceAllocator::SetVoicePeakLevel(usz voiceIndex, f32 peakLevel)
+  {
+    ASSERT(m_voiceStates[voiceIndex].m_activeVoiceIndicesIndex.has_value());
+    m_voiceStates[voiceIndex].m_peakLevel = peakLevel;
+  }
+
+  void VoiceAllocator::SetVoiceLimit(usz voiceLimit)
+  {
+    ASSERT(voiceLimit > 0 && voiceLimit <= m_voiceStates.Count());
+    m_voiceLimit = voiceLimit;
+
+    while (m_activeVoiceIndices.Count() - m_fadingOutVoiceCount > m_voiceLimit)
+    {
+      usz voiceIndex = SelectVoiceToSteal();
+      UnbindVoiceId(voiceIndex);
+      m_voiceStates[voiceIndex].m_fadingOut = true;
+      m_fadingOutVoiceCount++;
+    }
+  }
+
+  bool VoiceAllocator::IsVoiceFadingOut(usz voiceIndex) const
+    { return m_voiceStates[voiceIndex].m_fadingOut; }
+
+  std::optional<usz> VoiceAllocator::TryGetVoiceIndex(u64 voiceId) const
+  {
+    const usz* voiceIndex = m_voiceIndicesFromIds.TryGet(voiceId);
+    return voiceIndex != nullptr ? std::optional(*voiceIndex) : std::nullopt;
+  }
+
   Span<const usz> VoiceAllocator::GetDeactivatedVoiceIndices() const
     { return m_deactivatedVoiceIndices; }
 
@@ -75,4 +129,189 @@ namespace Chord
 
   Span<const usz> VoiceAllocator::GetActiveVoiceIndices() const
     { return m_activeVoiceIndices; }
+
+  usz VoiceAllocator::AllocateVoice()
+  {
+    if (m_activeVoiceIndices.Count() - m_fadingOutVoiceCount >= m_voiceLimit)
+    {
+      // If the voice limit has been reached, we'll deactivate an active voice chosen by the stealing policy
+      usz voiceIndex = SelectVoiceToSteal();
+      StopVoice(voiceIndex);
+      return voiceIndex;
+    }
+
+    if (m_inactiveVoiceIndices.IsEmpty())
+    {
+      // The remaining voices are all fading out so cut the oldest one short
+      usz voiceIndex = SelectFadingOutVoiceToSteal();
+      StopVoice(voiceIndex);
+      return voiceIndex;
+    }
+
+    usz voiceIndex = m_inactiveVoiceIndices[m_inactiveVoiceIndices.Count() - 1];
+    m_inactiveVoiceIndices.RemoveByIndex(m_inactiveVoiceIndices.Count() - 1);
+    return voiceIndex;
+  }
+
+  usz VoiceAllocator::SelectVoiceToSteal() const
+  {
+    // Voices which are fading out are skipped because they're already on their way out
+    std::optional<usz> oldestVoiceIndex = m_oldestActiveVoiceIndex;
+    while (oldestVoiceIndex.has_value() && m_voiceStates[oldestVoiceIndex.value()].m_fadingOut)
+      { oldestVoiceIndex = m_voiceStates[oldestVoiceIndex.value()].m_newerVoiceIndex; }
+    ASSERT(oldestVoiceIndex.has_value());
+
+    // Walk from the oldest to the newest voice, only replacing the selection when a voice is strictly better so that ties favor older voices
+    auto SelectVoice =
+      [&](auto&& isBetterVoice)
+      {
+        usz selectedVoiceIndex = oldestVoiceIndex.value();
+        for (std::optional<usz> voiceIndex = m_voiceStates[selectedVoiceIndex].m_newerVoiceIndex;
+          voiceIndex.has_value();
+          voiceIndex = m_voiceStates[voiceIndex.value()].m_newerVoiceIndex)
+        {
+          const VoiceState& voiceState = m_voiceStates[voiceIndex.value()];
+          if (!voiceState.m_fadingOut && isBetterVoice(voiceState, m_voiceStates[selectedVoiceIndex]))
+            { selectedVoiceIndex = voiceIndex.value(); }
+        }
+
+        return selectedVoiceIndex;
+      };
+
+    switch (m_voiceStealingPolicy)
+    {
+    case VoiceStealingPolicy::Oldest:
+      return oldestVoiceIndex.value();
+
+    case VoiceStealingPolicy::Quietest:
+      return SelectVoice(
+        [](const VoiceState& voiceState, const VoiceState& selectedVoiceState)
+        {
+          return voiceState.m_peakLevel.has_value()
+            && (!selectedVoiceState.m_peakLevel.has_value() || voiceState.m_peakLevel.value() < selectedVoiceState.m_peakLevel.value());
+        });
+
+    case VoiceStealingPolicy::ReleasedFirst:
+      return SelectVoice(
+        [](const VoiceState& voiceState, const VoiceState& selectedVoiceState)
+          { return voiceState.m_released && !selectedVoiceState.m_released; });
+
+    case VoiceStealingPolicy::LowestPriority:
+      return SelectVoice(
+        [](const VoiceState& voiceState, const VoiceState& selectedVoiceState)
+          { return voiceState.m_priority < selectedVoiceState.m_priority; });
+
+    default:
+      ASSERT(false);
+      return oldestVoiceIndex.value();
+    }
+  }
+
+  usz VoiceAllocator::SelectFadingOutVoiceToSteal() const
+  {
+    std::optional<usz> voiceIndex = m_oldestActiveVoiceIndex;
+    while (voiceIndex.has_value() && !m_voiceStates[voiceIndex.value()].m_fadingOut)
+      { voiceIndex = m_voiceStates[voiceIndex.value()].m_newerVoiceIndex; }
+    ASSERT(voiceIndex.has_value());
+    return voiceIndex.value();
+  }
+
+  void VoiceAllocator::ActivateVoice(usz voiceIndex, usz sampleIndex)
+  {
+    VoiceState& voiceState = m_voiceStates[voiceIndex];
+    ASSERT(!voiceState.m_activeVoiceIndicesIndex.has_value());
+
+    // Append to the end of the age list so that the oldest active voice is always at the front
+    voiceState.m_olderVoiceIndex = m_newestActiveVoiceIndex;
+    voiceState.m_newerVoiceIndex.reset();
+    if (m_newestActiveVoiceIndex.has_value())
+      { m_voiceStates[m_newestActiveVoiceIndex.value()].m_newerVoiceIndex = voiceIndex; }
+    else
+      { m_oldestActiveVoiceIndex = voiceIndex; }
+    m_newestActiveVoiceIndex = voiceIndex;
+
+    voiceState.m_activeVoiceIndicesIndex = m_activeVoiceIndices.Count();
+    m_activeVoiceIndices.Append(voiceIndex);
+
+    voiceState.m_released = false;
+    voiceState.m_priority = 0;
+    voiceState.m_peakLevel.reset();
+
+    if (voiceState.m_activatedVoicesIndex.has_value())
+    {
+      // This voice already activated and then deactivated itself this block (which can only happen if triggers are issued after the block was processed) so
+      // just update its existing activation
+      m_activatedVoices[voiceState.m_activatedVoicesIndex.value()].m_sampleIndex = sampleIndex;
+    }
+    else
+    {
+      voiceState.m_activatedVoicesIndex = m_activatedVoices.Count();
+      m_activatedVoices.Append({ .m_voiceIndex = voiceIndex, .m_sampleIndex = sampleIndex });
+    }
+  }
+
+  void VoiceAllocator::StopVoice(usz voiceIndex)
+  {
+    UnlinkActiveVoice(voiceIndex);
+    UnbindVoiceId(voiceIndex);
+
+    VoiceState& voiceState = m_voiceStates[voiceIndex];
+    if (voiceState.m_activatedVoicesIndex.has_value())
+    {
+      // This voice was activated earlier in this block so it never actually started playing. Remove it from the activation list rather than adding it to the
+      // deactivation list. If it was also active before this block started, it will have already been added to the deactivation list.
+      usz activatedVoicesIndex = voiceState.m_activatedVoicesIndex.value();
+      m_activatedVoices.RemoveByIndexUnordered(activatedVoicesIndex);
+      if (activatedVoicesIndex < m_activatedVoices.Count())
+        { m_voiceStates[m_activatedVoices[activatedVoicesIndex].m_voiceIndex].m_activatedVoicesIndex = activatedVoicesIndex; }
+      voiceState.m_activatedVoicesIndex.reset();
+    }
+    else if (!voiceState.m_deactivatedThisBlock)
+    {
+      voiceState.m_deactivatedThisBlock = true;
+      m_deactivatedVoiceIndices.Append(voiceIndex);
+    }
+  }
+
+  void VoiceAllocator::UnlinkActiveVoice(usz voiceIndex)
+  {
+    VoiceState& voiceState = m_voiceStates[voiceIndex];
+    ASSERT(voiceState.m_activeVoiceIndicesIndex.has_value());
+
+    if (voiceState.m_olderVoiceIndex.has_value())
+      { m_voiceStates[voiceState.m_olderVoiceIndex.value()].m_newerVoiceIndex = voiceState.m_newerVoiceIndex; }
+    else
+      { m_oldestActiveVoiceIndex = voiceState.m_newerVoiceIndex; }
+
+    if (voiceState.m_newerVoiceIndex.has_value())
+      { m_voiceStates[voiceState.m_newerVoiceIndex.value()].m_olderVoiceIndex = voiceState.m_olderVoiceIndex; }
+    else
+      { m_newestActiveVoiceIndex = voiceState.m_olderVoiceIndex; }
+
+    voiceState.m_olderVoiceIndex.reset();
+    voiceState.m_newerVoiceIndex.reset();
+
+    if (voiceState.m_fadingOut)
+    {
+      voiceState.m_fadingOut = false;
+      m_fadingOutVoiceCount--;
+    }
+
+    // Swap the last active voice into this voice's slot so that removal is constant-time
+    usz activeVoiceIndicesIndex = voiceState.m_activeVoiceIndicesIndex.value();
+    m_activeVoiceIndices.RemoveByIndexUnordered(activeVoiceIndicesIndex);
+    if (activeVoiceIndicesIndex < m_activeVoiceIndices.Count())
+      { m_voiceStates[m_activeVoiceIndices[activeVoiceIndicesIndex]].m_activeVoiceIndicesIndex = activeVoiceIndicesIndex; }
+    voiceState.m_activeVoiceIndicesIndex.reset();
+  }
+
+  void VoiceAllocator::UnbindVoiceId(usz voiceIndex)
+  {
+    VoiceState& voiceState = m_voiceStates[voiceIndex];
+    if (voiceState.m_voiceId.has_value())
+    {
+      m_voiceIndicesFromIds.Remove(voiceState.m_voiceId.value());
+      voiceState.m_voiceId.reset();
+    }
+  }
 }
\ No newline at end of file
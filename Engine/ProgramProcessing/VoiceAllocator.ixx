@@ -1,11 +1,30 @@
 export module Chord.Engine:ProgramProcessing.VoiceAllocator;
 
+import std;
+
 import Chord.Foundation;
 
 namespace Chord
 {
   export
   {
+    // Determines which active voice is stolen when a voice is triggered but all voices are in use. Ties are broken by stealing the oldest voice. Policies
+    // other than Oldest scan the active voices when stealing.
+    enum class VoiceStealingPolicy
+    {
+      Oldest,
+
+      // Steals the voice with the lowest output peak level over the last processed block. Voices which haven't reported a level yet are never considered
+      // quieter than voices which have.
+      Quietest,
+
+      // Steals the oldest released voice, falling back to the oldest voice if no voices are released
+      ReleasedFirst,
+
+      // Steals the voice with the lowest trigger priority
+      LowestPriority,
+    };
+
     class VoiceAllocator
     {
     public:
@@ -16,22 +35,88 @@ namespace Chord
       };
 
       VoiceAllocator(usz maxVoiceCount);
+      VoiceAllocator(usz maxVoiceCount, VoiceStealingPolicy voiceStealingPolicy);
       VoiceAllocator(const VoiceAllocator&) = delete;
       VoiceAllocator& operator=(const VoiceAllocator&) = delete;
 
+      VoiceStealingPolicy GetVoiceStealingPolicy() const
+        { return m_voiceStealingPolicy; }
+
       void BeginBlockVoiceAllocation();
-      void TriggerVoice(usz sampleIndex);
+
+      // These return the index of the triggered voice
+      usz TriggerVoice(usz sampleIndex);
+
+      // If the voice ID is already bound to an active voice, that voice is retriggered rather than allocating a new one
+      usz TriggerVoice(usz sampleIndex, u64 voiceId);
+
+      // Marks the voice bound to this ID as released and unbinds the ID. Releasing an unknown ID (e.g. one whose voice was stolen) does nothing.
+      void ReleaseVoice(u64 voiceId);
 
       // Note: this is called when an active voice deactivates itself and, because the deactivation is already known, it does not get added to the internal
-      // deactivated voices list
+      // deactivated voices list. The active voice indices list is reordered by this call so callers iterating over it should iterate in reverse.
       void DeactivateVoice(usz voiceIndex);
 
+      bool IsVoiceReleased(usz voiceIndex) const;
+
+      // Priority is reset to 0 whenever a voice is triggered
+      void SetVoicePriority(usz voiceIndex, s32 priority);
+
+      // Used by VoiceStealingPolicy::Quietest. The peak level is reset whenever a voice is triggered.
+      void SetVoicePeakLevel(usz voiceIndex, f32 peakLevel);
+
+      // Limits the number of active voices which aren't fading out. If more voices are active, the excess voices (chosen by the stealing policy) start fading
+      // out. Fading voices are expected to be deactivated by the caller once their fade completes. They don't count against the limit, their IDs are unbound,
+      // and they are only stolen if there are no inactive voices left.
+      void SetVoiceLimit(usz voiceLimit);
+      usz GetVoiceLimit() const
+        { return m_voiceLimit; }
+
+      bool IsVoiceFadingOut(usz voiceIndex) const;
+
+      std::optional<usz> TryGetVoiceIndex(u64 voiceId) const;
+
       Span<const usz> GetDeactivatedVoiceIndices() const;
       Span<const ActivatedVoice> GetActivatedVoices() const;
+
+      // Note: these are not ordered by age
       Span<const usz> GetActiveVoiceIndices() const;
 
     private:
-      // Note: we could use more complex data structures to reduce lookup time to O(1) but we'll start with these for now
+      struct VoiceState
+      {
+        // Intrusive links into the active voice age list, which runs from the oldest to the newest active voice
+        std::optional<usz> m_olderVoiceIndex;
+        std::optional<usz> m_newerVoiceIndex;
+
+        // Positions within m_activeVoiceIndices and m_activatedVoices so that removal from these lists doesn't require a search
+        std::optional<usz> m_activeVoiceIndicesIndex;
+        std::optional<usz> m_activatedVoicesIndex;
+
+        bool m_deactivatedThisBlock = false;
+        bool m_released = false;
+        bool m_fadingOut = false;
+        std::optional<u64> m_voiceId;
+        s32 m_priority = 0;
+        std::optional<f32> m_peakLevel;
+      };
+
+      usz AllocateVoice();
+      usz SelectVoiceToSteal() const;
+      usz SelectFadingOutVoiceToSteal() const;
+      void ActivateVoice(usz voiceIndex, usz sampleIndex);
+      void StopVoice(usz voiceIndex);
+      void UnlinkActiveVoice(usz voiceIndex);
+      void UnbindVoiceId(usz voiceIndex);
+
+      VoiceStealingPolicy m_voiceStealingPolicy = VoiceStealingPolicy::Oldest;
+      FixedArray<VoiceState> m_voiceStates;
+      std::optional<usz> m_oldestActiveVoiceIndex;
+      std::optional<usz> m_newestActiveVoiceIndex;
+      HashMap<u64, usz> m_voiceIndicesFromIds;
+      usz m_voiceLimit = 0;
+      usz m_fadingOutVoiceCount = 0;
+
       BoundedArray<usz> m_inactiveVoiceIndices;
       BoundedArray<usz> m_activeVoiceIndices;
       BoundedArray<usz> m_deactivatedVoiceIndices;
@@ -28,6 +28,10 @@ namespace Chord
       { context.m_queue.Stop(); }
     for (TaskThreadContext& context : m_taskThreadContexts)
       { context.m_thread.join(); }
+
+    m_backgroundThreadContext.m_queue.Stop();
+    if (m_backgroundThreadContext.m_thread.joinable())
+      { m_backgroundThreadContext.m_thread.join(); }
   }
 
   usz TaskExecutor::GetThreadCount() const
@@ -49,6 +53,23 @@ namespace Chord
     m_taskThreadContexts[enqueueBaseThreadIndex % m_taskThreadContexts.Count()].m_queue.Push(task);
   }
 
+  void TaskExecutor::EnqueueBackgroundTask(Task* task)
+  {
+    ASSERT(task->m_execute.IsValid(), "The task was not initialized");
+    std::call_once(m_backgroundThreadCreated, [&]() { m_backgroundThreadContext.m_thread = std::thread([this]() { BackgroundThreadEntryPoint(); }); });
+    m_backgroundThreadContext.m_queue.Push(task);
+  }
+
+  bool TaskExecutor::TryRemoveBackgroundTask(Task* task)
+  {
+    if (!m_backgroundThreadContext.m_queue.TryRemove(task))
+      { return false; }
+
+    Callable<void()> execute = std::move(task->m_execute);
+    ASSERT(!task->m_execute.IsValid());
+    return true;
+  }
+
   void TaskExecutor::TaskThreadEntryPoint(usz threadIndex)
   {
     tl_taskThreadIndex = threadIndex;
@@ -92,4 +113,20 @@ namespace Chord
     if (m_settings.m_deinitializeTaskThread.IsValid())
       { m_settings.m_deinitializeTaskThread(); }
   }
+
+  void TaskExecutor::BackgroundThreadEntryPoint()
+  {
+    while (true)
+    {
+      // A null result signals that the queue is shutting down
+      Task* task = m_backgroundThreadContext.m_queue.Pop();
+      if (task == nullptr)
+        { break; }
+
+      Callable<void()> execute = std::move(task->m_execute);
+      ASSERT(!task->m_execute.IsValid());
+
+      execute();
+    }
+  }
 }
\ No newline at end of file
@@ -35,6 +35,16 @@ namespace Chord
 
       void EnqueueTask(Task* task);
 
+      // Background tasks run one at a time on a single thread which is separate from the task threads. This is meant for long-running work (such as
+      // initialization which allocates and clears large amounts of memory) which shouldn't hold up tasks on the task threads. The background thread does not
+      // invoke the task thread initialize/deinitialize functions and is not assigned a task thread index. It is created when the first background task is
+      // enqueued so executors which are never given background work don't start it.
+      void EnqueueBackgroundTask(Task* task);
+
+      // Removes a background task which hasn't started yet so that the caller doesn't have to wait behind other background tasks. The removed task is released
+      // (as if it had run) and can be initialized again. Returns false if the task has already been dequeued, in which case it is running or about to run.
+      bool TryRemoveBackgroundTask(Task* task);
+
     private:
       struct TaskThreadContext
       {
@@ -47,9 +57,12 @@ namespace Chord
       };
 
       void TaskThreadEntryPoint(usz threadIndex);
+      void BackgroundThreadEntryPoint();
 
       TaskExecutorSettings m_settings;
       FixedArray<TaskThreadContext> m_taskThreadContexts;
+      TaskThreadContext m_backgroundThreadContext;
+      std::once_flag m_backgroundThreadCreated;
       std::atomic<usz> m_nextEnqueueBaseThreadIndex = 0;
     };
   }
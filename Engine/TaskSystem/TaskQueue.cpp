@@ -47,6 +47,34 @@ namespace Chord
     return result;
   }
 
+  bool TaskQueue::TryRemove(Task* task)
+  {
+    std::unique_lock lock(m_mutex);
+
+    // Tasks are linked from the front (m_next is the task ahead of this one) to the back (m_previous is the task behind this one)
+    for (Task* queuedTask = m_front; queuedTask != nullptr; queuedTask = queuedTask->m_previous)
+    {
+      if (queuedTask != task)
+        { continue; }
+
+      if (task->m_next == nullptr)
+        { m_front = task->m_previous; }
+      else
+        { task->m_next->m_previous = task->m_previous; }
+
+      if (task->m_previous == nullptr)
+        { m_back = task->m_next; }
+      else
+        { task->m_previous->m_next = task->m_next; }
+
+      task->m_next = nullptr;
+      task->m_previous = nullptr;
+      return true;
+    }
+
+    return false;
+  }
+
   void TaskQueue::Stop()
   {
     {
@@ -20,6 +20,9 @@ namespace Chord
       Task* Pop();
       Task* TryPop();
 
+      // Removes a task which is still in the queue, returning false if it has already been popped
+      bool TryRemove(Task* task);
+
       void Stop();
 
     private:
@@ -207,4 +207,19 @@ namespace Chord
       }
     }
   }
+
+  void OrBits(Span<u64> destination, Span<const u64> source)
+  {
+    ASSERT(destination.Count() == source.Count());
+
+    usz wordIndex = 0;
+    for (; wordIndex + u64xM::ElementCount <= destination.Count(); wordIndex += u64xM::ElementCount)
+    {
+      u64xM result = u64xM::LoadUnaligned(destination, wordIndex) | u64xM::LoadUnaligned(source, wordIndex);
+      result.StoreUnaligned(destination, wordIndex);
+    }
+
+    for (; wordIndex < destination.Count(); wordIndex++)
+      { destination[wordIndex] |= source[wordIndex]; }
+  }
 }
\ No newline at end of file
@@ -9,5 +9,8 @@ namespace Chord
   {
     constexpr void CopyBits(Span<u8> destination, usz destinationOffset, Span<const u8> source, usz sourceOffset, usz count);
     constexpr void SetBits(Span<u8> destination, usz destinationOffset, bool value, usz count);
+
+    // Performs destination |= source over whole 64-bit words of two equally-sized bit arrays
+    void OrBits(Span<u64> destination, Span<const u64> source);
   }
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+module Chord.Foundation;
+
+import std;
+
+namespace Chord
+{
+  using HashVector = Vector<u32, 8>;
+
+  static constexpr usz HashVectorByteCount = sizeof(u32) * HashVector::ElementCount;
+
+  // Multiple accumulators are used so that consecutive multiplies don't depend on each other
+  static constexpr usz AccumulatorCount = 4;
+
+  // These are the xxHash32 primes
+  static constexpr u32 Prime1 = 0x9e3779b1_u32;
+  static constexpr u32 Prime2 = 0x85ebca77_u32;
+  static constexpr u32 Prime3 = 0xc2b2ae3d_u32;
+
+  static HashVector RotateLeft(const HashVector& v, s32 count)
+    { return (v << count) | (v >> (32 - count)); }
+
+  // Each lane of each accumulator is an independent xxHash32 lane
+  static HashVector Round(const HashVector& accumulator, const HashVector& input)
+    { return RotateLeft(accumulator + input * HashVector(Prime2), 13) * HashVector(Prime1); }
+
+  HashKey CalculateBytesHashKey(Span<const u8> bytes)
+  {
+    const u8* data = bytes.Elements();
+    usz byteCount = bytes.Count();
+
+    auto Load =
+      [&](usz offset)
+        { return HashVector::LoadUnaligned(reinterpret_cast<const u32*>(data + offset)); };
+
+    HashVector accumulator0 = HashVector(Prime1, Prime2, Prime3, Prime1 + Prime2, Prime2 + Prime3, Prime1 + Prime3, Prime1 ^ Prime2, Prime2 ^ Prime3);
+    HashVector accumulator1 = accumulator0 + HashVector(Prime3);
+    HashVector accumulator2 = accumulator1 + HashVector(Prime3);
+    HashVector accumulator3 = accumulator2 + HashVector(Prime3);
+
+    usz offset = 0;
+    for (; offset + AccumulatorCount * HashVectorByteCount <= byteCount; offset += AccumulatorCount * HashVectorByteCount)
+    {
+      accumulator0 = Round(accumulator0, Load(offset));
+      accumulator1 = Round(accumulator1, Load(offset + HashVectorByteCount));
+      accumulator2 = Round(accumulator2, Load(offset + 2 * HashVectorByteCount));
+      accumulator3 = Round(accumulator3, Load(offset + 3 * HashVectorByteCount));
+    }
+
+    for (; offset + HashVectorByteCount <= byteCount; offset += HashVectorByteCount)
+      { accumulator0 = Round(accumulator0, Load(offset)); }
+
+    if (offset < byteCount)
+    {
+      // The remaining bytes are zero-padded. The byte count is mixed into the final hash so that inputs which only differ by trailing zeros don't collide.
+      FixedArray<u32, HashVector::ElementCount> remainingElements;
+      remainingElements.ZeroElements();
+      std::memcpy(remainingElements.Elements(), data + offset, byteCount - offset);
+      accumulator0 = Round(accumulator0, HashVector::LoadUnaligned(remainingElements.Elements()));
+    }
+
+    HashVector combinedAccumulator = RotateLeft(accumulator0, 1) + RotateLeft(accumulator1, 7) + RotateLeft(accumulator2, 12) + RotateLeft(accumulator3, 18);
+    FixedArray<u32, HashVector::ElementCount> lanes;
+    combinedAccumulator.StoreUnaligned(lanes.Elements());
+
+    // Only a few bytes remain so they are mixed down to 64 bits using the standard hash generator
+    HashGenerator hashGenerator;
+    hashGenerator.Append(u64(byteCount));
+    hashGenerator.Append(Span<const u32>(lanes));
+    return hashGenerator.GetHashKey();
+  }
+}
\ No newline at end of file
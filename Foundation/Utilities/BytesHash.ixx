@@ -0,0 +1,15 @@
+export module Chord.Foundation:Utilities.BytesHash;
+
+import :Containers;
+import :Core;
+import :Utilities.HashKey;
+
+namespace Chord
+{
+  export
+  {
+    // Computes a non-cryptographic hash of a block of memory using SIMD lanes. This is much faster than appending the bytes to a HashGenerator for large
+    // blocks (such as constant arrays holding wavetables) but its values are not guaranteed to match across versions so it should never be persisted.
+    HashKey CalculateBytesHashKey(Span<const u8> bytes);
+  }
+}
\ No newline at end of file
@@ -1,7 +1,27 @@
+module;
+
+#if PROCESSOR_X64
+  #if COMPILER_MSVC
+    #include <intrin.h>
+  #else
+    #include <cpuid.h>
+  #endif
+
+  #include <immintrin.h>
+#endif
+
 module Chord.Foundation;
 
 import std;
 
+#if PROCESSOR_X64
+  #if COMPILER_MSVC
+    #define SHA_EXTENSIONS_TARGET
+  #else
+    #define SHA_EXTENSIONS_TARGET __attribute__((target("sha,sse4.1")))
+  #endif
+#endif
+
 namespace Chord
 {
   static constexpr FixedArray<u32, 64> HashConstants =
@@ -72,55 +92,26 @@ namespace Chord
     0xc67178f2_u32,
   };
 
-  FixedArray<u8, Sha256ByteCount> CalculateSha256(Span<const u8> bytes)
+  static constexpr FixedArray<u32, 8> InitialHashValues =
   {
-    FixedArray<u32, 8> hashValues =
-    {
-      0x6a09e667_u32,
-      0xbb67ae85_u32,
-      0x3c6ef372_u32,
-      0xa54ff53a_u32,
-      0x510e527f_u32,
-      0x9b05688c_u32,
-      0x1f83d9ab_u32,
-      0x5be0cd19_u32,
-    };
-
-    static constexpr usz ChunkByteCount = 512 / 8;
-    usz paddedLength = AlignInt(bytes.Count() + 1 + sizeof(u64), ChunkByteCount);
-    for (usz index = 0; index < paddedLength; index += ChunkByteCount)
-    {
-      FixedArray<u8, ChunkByteCount> buffer;
-      Span<const u8> chunk;
-      if (index + ChunkByteCount <= bytes.Count())
-        { chunk = Span(bytes, index, ChunkByteCount); }
-      else
-      {
-        chunk = buffer;
-        buffer.ZeroElements();
-
-        if (index < bytes.Count())
-        {
-          usz copyCount = bytes.Count() - index;
-          ASSERT(copyCount < ChunkByteCount);
-          Span<u8>(buffer, 0, copyCount).CopyElementsFrom(Span(bytes, index, copyCount));
-        }
-
-        // Add the 1 bit
-        if (bytes.Count() >= index && bytes.Count() < index + ChunkByteCount)
-          { buffer[bytes.Count() - index] = 0x80; }
-
-        if (index + ChunkByteCount == paddedLength)
-        {
-          u64 bitLengthBigEndian = SwapByteOrderTo<std::endian::big>(bytes.Count() * 8);
-          Span<u8>(buffer, ChunkByteCount - sizeof(u64), sizeof(u64)).CopyElementsFrom(Span<u8>(reinterpret_cast<u8*>(&bitLengthBigEndian), sizeof(u64)));
-        }
-      }
+    0x6a09e667_u32,
+    0xbb67ae85_u32,
+    0x3c6ef372_u32,
+    0xa54ff53a_u32,
+    0x510e527f_u32,
+    0x9b05688c_u32,
+    0x1f83d9ab_u32,
+    0x5be0cd19_u32,
+  };
 
+  static void ProcessChunksScalar(Span<u32> hashValues, const u8* chunks, usz chunkCount)
+  {
+    for (usz chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+    {
       FixedArray<u32, 64> w;
-      CopyBytes(w.GetBuffer(0, ChunkByteCount / sizeof(u32)), chunk.Elements(), ChunkByteCount);
-      for (u32& v : w)
-        { v = SwapByteOrderFrom<std::endian::big>(v); }
+      CopyBytes(w.GetBuffer(0, Sha256ChunkByteCount / sizeof(u32)), chunks + chunkIndex * Sha256ChunkByteCount, Sha256ChunkByteCount);
+      for (usz i = 0; i < 16; i++)
+        { w[i] = SwapByteOrderFrom<std::endian::big>(w[i]); }
 
       for (usz i = 16; i < 64; i++)
       {
@@ -166,8 +157,174 @@ namespace Chord
       hashValues[6] += g;
       hashValues[7] += h;
     }
+  }
+
+  #if PROCESSOR_X64
+    SHA_EXTENSIONS_TARGET static void ProcessChunksShaExtensions(Span<u32> hashValues, const u8* chunks, usz chunkCount)
+    {
+      const __m128i byteSwapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+
+      // The SHA instructions operate on the state rearranged into ABEF and CDGH halves
+      __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hashValues.Elements()));
+      __m128i hgfe = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hashValues.Elements() + 4));
+      __m128i cdab = _mm_shuffle_epi32(dcba, 0xb1);
+      __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+      __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+      __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+      for (usz chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+      {
+        const u8* chunk = chunks + chunkIndex * Sha256ChunkByteCount;
+        __m128i previousAbef = abef;
+        __m128i previousCdgh = cdgh;
+
+        // Each of the 16 iterations performs 4 rounds. messages holds the 4 most recent groups of 4 schedule words and the oldest group is replaced with the
+        // next group once its rounds are done.
+        FixedArray<__m128i, 4> messages;
+        for (usz i = 0; i < 4; i++)
+          { messages[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + i * sizeof(__m128i))), byteSwapMask); }
+
+        for (usz i = 0; i < 16; i++)
+        {
+          __m128i message = _mm_add_epi32(messages[i % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(HashConstants.Elements() + i * 4)));
+          cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+          abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message, 0x0e));
+
+          if (i < 12)
+          {
+            __m128i nextMessage = _mm_sha256msg1_epu32(messages[i % 4], messages[(i + 1) % 4]);
+            nextMessage = _mm_add_epi32(nextMessage, _mm_alignr_epi8(messages[(i + 3) % 4], messages[(i + 2) % 4], 4));
+            messages[i % 4] = _mm_sha256msg2_epu32(nextMessage, messages[(i + 3) % 4]);
+          }
+        }
+
+        abef = _mm_add_epi32(abef, previousAbef);
+        cdgh = _mm_add_epi32(cdgh, previousCdgh);
+      }
+
+      __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+      __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(hashValues.Elements()), _mm_blend_epi16(feba, dchg, 0xf0));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(hashValues.Elements() + 4), _mm_alignr_epi8(dchg, feba, 8));
+    }
+  #endif
+
+  static bool DetectShaExtensions()
+  {
+    #if PROCESSOR_X64
+      // SHA support is reported by CPUID leaf 7 (EBX bit 29). The implementation also uses SSSE3 and SSE4.1 instructions (leaf 1, ECX bits 9 and 19).
+      u32 leaf1Ecx;
+      u32 leaf7Ebx;
+      #if COMPILER_MSVC
+        int registers[4];
+        __cpuid(registers, 0);
+        if (registers[0] < 7)
+          { return false; }
+        __cpuid(registers, 1);
+        leaf1Ecx = u32(registers[2]);
+        __cpuidex(registers, 7, 0);
+        leaf7Ebx = u32(registers[1]);
+      #else
+        unsigned int eax;
+        unsigned int ebx;
+        unsigned int ecx;
+        unsigned int edx;
+        if (__get_cpuid_max(0, nullptr) < 7)
+          { return false; }
+        __cpuid_count(1, 0, eax, ebx, ecx, edx);
+        leaf1Ecx = ecx;
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        leaf7Ebx = ebx;
+      #endif
+
+      return (leaf1Ecx & (1_u32 << 9)) != 0 && (leaf1Ecx & (1_u32 << 19)) != 0 && (leaf7Ebx & (1_u32 << 29)) != 0;
+    #else
+      return false;
+    #endif
+  }
+
+  bool IsSha256ImplementationSupported(Sha256Implementation implementation)
+  {
+    switch (implementation)
+    {
+    case Sha256Implementation::Scalar:
+      return true;
+
+    case Sha256Implementation::ShaExtensions:
+      {
+        static const bool IsSupported = DetectShaExtensions();
+        return IsSupported;
+      }
+
+    default:
+      ASSERT(false);
+      return false;
+    }
+  }
+
+  Sha256Implementation GetDefaultSha256Implementation()
+  {
+    return IsSha256ImplementationSupported(Sha256Implementation::ShaExtensions)
+      ? Sha256Implementation::ShaExtensions
+      : Sha256Implementation::Scalar;
+  }
+
+  Sha256::Sha256()
+    : Sha256(GetDefaultSha256Implementation())
+    { }
+
+  Sha256::Sha256(Sha256Implementation implementation)
+    : m_implementation(implementation)
+    , m_hashValues(InitialHashValues)
+    { ASSERT(IsSha256ImplementationSupported(implementation)); }
+
+  void Sha256::Update(Span<const u8> bytes)
+  {
+    ASSERT(!m_finalized);
+    m_totalByteCount += bytes.Count();
+
+    // Top off any partial chunk left over from the previous update first
+    usz offset = 0;
+    if (m_pendingByteCount > 0)
+    {
+      offset = Min(bytes.Count(), Sha256ChunkByteCount - m_pendingByteCount);
+      Span<u8>(m_pendingBytes, m_pendingByteCount, offset).CopyElementsFrom(Span(bytes, 0, offset));
+      m_pendingByteCount += offset;
+      if (m_pendingByteCount < Sha256ChunkByteCount)
+        { return; }
+
+      ProcessChunks(m_pendingBytes.Elements(), 1);
+      m_pendingByteCount = 0;
+    }
+
+    // Whole chunks are hashed directly from the source bytes
+    usz chunkCount = (bytes.Count() - offset) / Sha256ChunkByteCount;
+    ProcessChunks(bytes.Elements() + offset, chunkCount);
+    offset += chunkCount * Sha256ChunkByteCount;
+
+    m_pendingByteCount = bytes.Count() - offset;
+    Span<u8>(m_pendingBytes, 0, m_pendingByteCount).CopyElementsFrom(Span(bytes, offset, m_pendingByteCount));
+  }
+
+  FixedArray<u8, Sha256ByteCount> Sha256::Finalize()
+  {
+    ASSERT(!m_finalized);
+    m_finalized = true;
+
+    // Append the 1 bit, zero padding, and the big-endian message length in bits. If the length doesn't fit in the current chunk, an extra chunk is added.
+    FixedArray<u8, Sha256ChunkByteCount * 2> finalChunks;
+    finalChunks.ZeroElements();
+    Span<u8>(finalChunks, 0, m_pendingByteCount).CopyElementsFrom(Span<const u8>(m_pendingBytes, 0, m_pendingByteCount));
+    finalChunks[m_pendingByteCount] = 0x80;
+
+    usz finalChunkCount = (m_pendingByteCount + 1 + sizeof(u64) <= Sha256ChunkByteCount) ? 1 : 2;
+    u64 bitLengthBigEndian = SwapByteOrderTo<std::endian::big>(m_totalByteCount * 8);
+    Span<u8>(finalChunks, finalChunkCount * Sha256ChunkByteCount - sizeof(u64), sizeof(u64))
+      .CopyElementsFrom(Span<u8>(reinterpret_cast<u8*>(&bitLengthBigEndian), sizeof(u64)));
+    ProcessChunks(finalChunks.Elements(), finalChunkCount);
 
     // Convert to big endian and concatenate
+    FixedArray<u32, 8> hashValues = m_hashValues;
     for (u32& v : hashValues)
       { v = SwapByteOrderTo<std::endian::big>(v); }
 
@@ -175,4 +332,36 @@ namespace Chord
     CopyBytes(result.Elements(), hashValues.Elements(), result.Count());
     return result;
   }
+
+  void Sha256::ProcessChunks(const u8* chunks, usz chunkCount)
+  {
+    if (chunkCount == 0)
+      { return; }
+
+    switch (m_implementation)
+    {
+    case Sha256Implementation::Scalar:
+      ProcessChunksScalar(m_hashValues, chunks, chunkCount);
+      break;
+
+    case Sha256Implementation::ShaExtensions:
+      #if PROCESSOR_X64
+        ProcessChunksShaExtensions(m_hashValues, chunks, chunkCount);
+      #else
+        ASSERT(false);
+      #endif
+      break;
+
+    default:
+      ASSERT(false);
+      break;
+    }
+  }
+
+  FixedArray<u8, Sha256ByteCount> CalculateSha256(Span<const u8> bytes)
+  {
+    Sha256 sha256;
+    sha256.Update(bytes);
+    return sha256.Finalize();
+  }
 }
\ No newline at end of file
@@ -5,11 +5,51 @@ import :Core;
 
 namespace Chord
 {
+  constexpr usz Sha256ChunkByteCount = 512 / 8;
+
   export
   {
     constexpr usz Sha256BitCount = 256;
     constexpr usz Sha256ByteCount = Sha256BitCount / 8;
 
+    enum class Sha256Implementation
+    {
+      Scalar,
+
+      // Uses the x64 SHA extensions, which are detected at runtime
+      ShaExtensions,
+    };
+
+    bool IsSha256ImplementationSupported(Sha256Implementation implementation);
+
+    // Returns the fastest implementation supported by the current processor
+    Sha256Implementation GetDefaultSha256Implementation();
+
+    // Computes a SHA-256 hash incrementally so that non-contiguous data can be hashed without first being concatenated
+    class Sha256
+    {
+    public:
+      Sha256();
+      Sha256(Sha256Implementation implementation);
+      Sha256(const Sha256&) = default;
+      Sha256& operator=(const Sha256&) = default;
+
+      void Update(Span<const u8> bytes);
+
+      // Note: no further updates are allowed after finalizing
+      FixedArray<u8, Sha256ByteCount> Finalize();
+
+    private:
+      void ProcessChunks(const u8* chunks, usz chunkCount);
+
+      Sha256Implementation m_implementation = Sha256Implementation::Scalar;
+      FixedArray<u32, 8> m_hashValues;
+      FixedArray<u8, Sha256ChunkByteCount> m_pendingBytes;
+      usz m_pendingByteCount = 0;
+      u64 m_totalByteCount = 0;
+      bool m_finalized = false;
+    };
+
     FixedArray<u8, Sha256ByteCount> CalculateSha256(Span<const u8> bytes);
   }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@ export import :Utilities.BinaryReader;
 export import :Utilities.BitArrayOperations;
 export import :Utilities.BitOperations;
 export import :Utilities.Bounds;
+export import :Utilities.BytesHash;
 export import :Utilities.Copy;
 export import :Utilities.Guid;
 export import :Utilities.HashKey;
@@ -175,6 +175,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("38977bcb-5781-4aa1-b7f3-3ecf2d07bb8b");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(float[], x), CHORD_IN(float, y), CHORD_RETURN(float, result))
         { IndexArray(x, y, result); }
@@ -185,6 +186,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("810c4f1d-646d-463a-8017-6bc7b2a8110f");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const float[], x), CHORD_IN(float, y), CHORD_RETURN(float, result))
         { IndexConstArray(x, y, result); }
@@ -195,6 +197,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("78e1b51e-fc6a-4c21-b8ed-e8e3743ed12f");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(float[], x), CHORD_IN(double, y), CHORD_RETURN(float, result))
         { IndexArray(x, y, result); }
@@ -205,6 +208,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("58e68f69-a975-44e3-8177-0e3449f6d8f6");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const float[], x), CHORD_IN(double, y), CHORD_RETURN(float, result))
         { IndexConstArray(x, y, result); }
@@ -215,6 +219,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("1b6b608f-53b7-418a-9971-2a5aa1f72cd3");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(float[], x), CHORD_IN(int, y), CHORD_RETURN(float, result))
         { IndexArray(x, y, result); }
@@ -225,6 +230,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("e22e994f-d978-4987-b187-140ef6bf9da2");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const float[], x), CHORD_IN(int, y), CHORD_RETURN(float, result))
         { IndexConstArray(x, y, result); }
@@ -235,6 +241,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("565ad30e-2853-40fb-a73b-dd6825c68abc");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(double[], x), CHORD_IN(float, y), CHORD_RETURN(double, result))
         { IndexArray(x, y, result); }
@@ -245,6 +252,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("2753d55d-1f69-4dfb-a5da-8d337a760554");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const double[], x), CHORD_IN(float, y), CHORD_RETURN(double, result))
         { IndexConstArray(x, y, result); }
@@ -255,6 +263,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("c57ccff9-f666-4b34-b486-cdacf81293b1");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(double[], x), CHORD_IN(double, y), CHORD_RETURN(double, result))
         { IndexArray(x, y, result); }
@@ -265,6 +274,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("267c0b08-f48d-484a-8b53-1d978e283d3a");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const double[], x), CHORD_IN(double, y), CHORD_RETURN(double, result))
         { IndexConstArray(x, y, result); }
@@ -275,6 +285,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("e3d60201-68e3-4e06-9eae-b82904a20c47");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(double[], x), CHORD_IN(int, y), CHORD_RETURN(double, result))
         { IndexArray(x, y, result); }
@@ -285,6 +296,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("d05807aa-2a0a-480f-a290-3a567d8f4152");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const double[], x), CHORD_IN(int, y), CHORD_RETURN(double, result))
         { IndexConstArray(x, y, result); }
@@ -295,6 +307,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("fb8ff164-6300-4caa-8f5e-d8fd4e4fce08");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(int[], x), CHORD_IN(float, y), CHORD_RETURN(int, result))
         { IndexArray(x, y, result); }
@@ -305,6 +318,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("67f499ba-ee3d-4292-bbea-75885c0b33e7");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const int[], x), CHORD_IN(float, y), CHORD_RETURN(int, result))
         { IndexConstArray(x, y, result); }
@@ -315,6 +329,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("b48c30f3-95b7-40ba-937b-db90428a65e9");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(int[], x), CHORD_IN(double, y), CHORD_RETURN(int, result))
         { IndexArray(x, y, result); }
@@ -325,6 +340,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("3bfe8bdc-3fde-413e-b4cf-31ef254fe88f");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const int[], x), CHORD_IN(double, y), CHORD_RETURN(int, result))
         { IndexConstArray(x, y, result); }
@@ -335,6 +351,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("9f738dbd-4aa4-46b4-a337-4a84c0a43fa2");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(int[], x), CHORD_IN(int, y), CHORD_RETURN(int, result))
         { IndexArray(x, y, result); }
@@ -345,6 +362,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("457ce997-353d-4240-9aa1-5887e3ef27d8");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const int[], x), CHORD_IN(int, y), CHORD_RETURN(int, result))
         { IndexConstArray(x, y, result); }
@@ -355,6 +373,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("aae6b6de-2175-4e9b-bdba-de442c7cd7c8");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(bool[], x), CHORD_IN(float, y), CHORD_RETURN(bool, result))
         { IndexArray(x, y, result); }
@@ -365,6 +384,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("5bdc2977-179a-411d-849e-78d8fe2e8926");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const bool[], x), CHORD_IN(float, y), CHORD_RETURN(bool, result))
         { IndexConstArray(x, y, result); }
@@ -375,6 +395,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("df3a8fd2-be44-4632-8fad-d46ace44db55");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(bool[], x), CHORD_IN(double, y), CHORD_RETURN(bool, result))
         { IndexArray(x, y, result); }
@@ -385,6 +406,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("21b9a46f-8418-408d-a24b-e3012af0436b");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const bool[], x), CHORD_IN(double, y), CHORD_RETURN(bool, result))
         { IndexConstArray(x, y, result); }
@@ -395,6 +417,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("35c14642-eb4a-4edf-a152-e2f711b9d7ac");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(bool[], x), CHORD_IN(int, y), CHORD_RETURN(bool, result))
         { IndexArray(x, y, result); }
@@ -405,6 +428,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("103a8a05-13c2-415e-bd73-e14f962c8ac3");
       static constexpr const char32_t* Name = U"[";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const bool[], x), CHORD_IN(int, y), CHORD_RETURN(bool, result))
         { IndexConstArray(x, y, result); }
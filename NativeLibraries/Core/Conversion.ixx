@@ -18,6 +18,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("bc5ef31a-1c56-4ca3-9945-debf764632d9");
       static constexpr const char32_t* Name = U"as double";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const? float, x), CHORD_RETURN(const? double, result))
       {
@@ -37,6 +38,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("16fc6a50-f937-41c5-b129-81a600dabe24");
       static constexpr const char32_t* Name = U"as int";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const? float, x), CHORD_RETURN(const? int, result))
       {
@@ -56,6 +58,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("f8ca2f56-2fa1-417e-9f55-eb8193981306");
       static constexpr const char32_t* Name = U"as float";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const? double, x), CHORD_RETURN(const? float, result))
       {
@@ -75,6 +78,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("b730cd61-1b45-4b56-b4bc-d1a84b22bad3");
       static constexpr const char32_t* Name = U"as int";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const? double, x), CHORD_RETURN(const? int, result))
       {
@@ -94,6 +98,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("707c8e3c-8c0e-4e78-9ab4-e68c600bfb0f");
       static constexpr const char32_t* Name = U"as float";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const? int, x), CHORD_RETURN(const? float, result))
       {
@@ -113,6 +118,7 @@ namespace Chord
     public:
       static constexpr Guid Id = Guid::Parse("98537a6b-c68d-4124-929a-e716b2f5934c");
       static constexpr const char32_t* Name = U"as double";
+      static constexpr bool IsTileable = true;
 
       static void Invoke(CHORD_IN(const? int, x), CHORD_RETURN(const? double, result))
       {
@@ -288,6 +288,9 @@ namespace Chord
       { m_delayBuffer.Reset(); }
   }
 
+  usz DelayFloat::GetVoiceMemoryUsage()
+    { return m_delayBuffer.GetMemoryUsage(); }
+
   void DelayDouble::InitializeVoice(
     NativeModuleCallContext context,
     CHORD_IN(const int, samples),
@@ -319,6 +322,9 @@ namespace Chord
       { m_delayBuffer.Reset(); }
   }
 
+  usz DelayDouble::GetVoiceMemoryUsage()
+    { return m_delayBuffer.GetMemoryUsage(); }
+
   void DelayInt::InitializeVoice(
     NativeModuleCallContext context,
     CHORD_IN(const int, samples),
@@ -350,6 +356,9 @@ namespace Chord
       { m_delayBuffer.Reset(); }
   }
 
+  usz DelayInt::GetVoiceMemoryUsage()
+    { return m_delayBuffer.GetMemoryUsage(); }
+
   void DelayBool::InitializeVoice(
     NativeModuleCallContext context,
     CHORD_IN(const int, samples),
@@ -380,4 +389,7 @@ namespace Chord
     if (voiceActive)
       { m_delayBuffer.Reset(); }
   }
+
+  usz DelayBool::GetVoiceMemoryUsage()
+    { return m_delayBuffer.GetMemoryUsage(); }
 }
\ No newline at end of file
@@ -32,6 +32,10 @@ namespace Chord
 
         void Reset();
 
+        // Returns the number of bytes allocated for delayed samples
+        usz GetMemoryUsage() const
+          { return m_delayBuffer.Count() * sizeof(BufferElement); }
+
       private:
         void ConsumeDelayBuffer(Span<BufferElement> destination, usz count);
         void ProduceDelayBuffer(usz bufferIndex, Span<const BufferElement> source, usz count);
@@ -60,6 +64,7 @@ namespace Chord
       static constexpr Guid Id = Guid::Parse("2b25884a-c094-497d-b13d-a95a8c7efcb8");
       static constexpr const char32_t* Name = U"Delay";
       static constexpr bool AlwaysRuntime = true;
+      static constexpr bool IsTileable = true;
 
       void InitializeVoice(
         NativeModuleCallContext context,
@@ -73,6 +78,7 @@ namespace Chord
         CHORD_RETURN(float, result, ChordArgumentFlags::DisallowBufferSharing));
 
       void SetVoiceActive(bool voiceActive);
+      usz GetVoiceMemoryUsage();
 
     private:
       DelayInternal::DelayBuffer<f32> m_delayBuffer;
@@ -84,6 +90,7 @@ namespace Chord
       static constexpr Guid Id = Guid::Parse("ca98e59b-8de3-4208-ba70-e984733878a3");
       static constexpr const char32_t* Name = U"Delay";
       static constexpr bool AlwaysRuntime = true;
+      static constexpr bool IsTileable = true;
 
       void InitializeVoice(
         NativeModuleCallContext context,
@@ -97,6 +104,7 @@ namespace Chord
         CHORD_RETURN(double, result, ChordArgumentFlags::DisallowBufferSharing));
 
       void SetVoiceActive(bool voiceActive);
+      usz GetVoiceMemoryUsage();
 
     private:
       DelayInternal::DelayBuffer<f64> m_delayBuffer;
@@ -108,6 +116,7 @@ namespace Chord
       static constexpr Guid Id = Guid::Parse("a79fc345-b7d7-4d43-8092-783fa68d1ce0");
       static constexpr const char32_t* Name = U"Delay";
       static constexpr bool AlwaysRuntime = true;
+      static constexpr bool IsTileable = true;
 
       void InitializeVoice(
         NativeModuleCallContext context,
@@ -121,6 +130,7 @@ namespace Chord
         CHORD_RETURN(int, result, ChordArgumentFlags::DisallowBufferSharing));
 
       void SetVoiceActive(bool voiceActive);
+      usz GetVoiceMemoryUsage();
 
     private:
       DelayInternal::DelayBuffer<s32> m_delayBuffer;
@@ -132,6 +142,7 @@ namespace Chord
       static constexpr Guid Id = Guid::Parse("b2b31091-d8eb-42eb-b161-515167bf89b3");
       static constexpr const char32_t* Name = U"Delay";
       static constexpr bool AlwaysRuntime = true;
+      static constexpr bool IsTileable = true;
 
       void InitializeVoice(
         NativeModuleCallContext context,
@@ -145,6 +156,7 @@ namespace Chord
         CHORD_RETURN(bool, result, ChordArgumentFlags::DisallowBufferSharing));
 
       void SetVoiceActive(bool voiceActive);
+      usz GetVoiceMemoryUsage();
 
     private:
       DelayInternal::DelayBuffer<bool> m_delayBuffer;
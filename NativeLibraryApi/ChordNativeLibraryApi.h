@@ -313,6 +313,11 @@ typedef struct
   // The number of samples that this call is processing. This takes upsample factor into account.
   size_t m_sampleCount;
 
+  // When voice starts are aligned to SIMD boundaries, a voice triggered partway through a block starts processing up to a few samples before its trigger. On the
+  // voice's activation and its first processing call, this is the number of samples preceding the actual trigger so that modules which produce onsets (e.g.
+  // envelopes) can delay them and remain sample-accurate. This takes upsample factor into account and is 0 otherwise.
+  size_t m_voiceStartSampleOffset;
+
   // If true, the current call is running in a compile-time context.
   bool m_isCompileTime;
 
@@ -326,7 +331,8 @@ typedef struct
 // argument's upsample factor.
 typedef bool (*NativeModulePrepareFunc)(const NativeModuleContext* context, const NativeModuleArguments* arguments, int32_t* outArgumentLatenciesOut);
 
-// Called on program initialization. This should allocate/initialize any necessary memory and report scratch memory requirements.
+// Called on program initialization. This should allocate/initialize any necessary memory and report scratch memory requirements. Different voices may be
+// initialized concurrently on different threads but the native modules within a single voice are initialized one at a time.
 typedef void* (*NativeModuleInitializeVoiceFunc)(
   const NativeModuleContext* context,
   const NativeModuleArguments* arguments,
@@ -338,6 +344,10 @@ typedef void (*NativeModuleDeinitializeVoiceFunc)(const NativeModuleContext* con
 // Called when a native module within a voice becomes active. When a voice is activated, things like filter states and delay lines should be reset.
 typedef void (*NativeModuleSetVoiceActiveFunc)(const NativeModuleContext* context, bool voiceActive);
 
+// Optionally called after InitializeVoice to report how many bytes of memory are owned by the native module's voice context. This is only used to report
+// memory usage and is not called on the audio thread.
+typedef size_t (*NativeModuleGetVoiceMemoryUsageFunc)(const NativeModuleContext* context);
+
 // Called to invoke a native module at compile time.
 typedef void (*NativeModuleInvokeCompileTimeFunc)(const NativeModuleContext* context, const NativeModuleArguments* arguments);
 
@@ -359,10 +369,16 @@ typedef struct
   // If true, this native module will never be invoked at compile time (and thus cannot contribute to constant-folding)
   bool m_alwaysRuntime;
 
+  // If true, this native module produces the same results when a block is processed as a sequence of consecutive sub-blocks as it does when the block is
+  // processed all at once. This is true for stateless per-sample modules and for modules whose state is purely streaming (e.g. delays). Tileable modules may
+  // be invoked multiple times per block with sample counts smaller than the block size, allowing intermediate buffers to remain in cache.
+  bool m_isTileable;
+
   NativeModulePrepareFunc m_prepare;
   NativeModuleInitializeVoiceFunc m_initializeVoice;
   NativeModuleDeinitializeVoiceFunc m_deinitializeVoice;
   NativeModuleSetVoiceActiveFunc m_setVoiceActive;
+  NativeModuleGetVoiceMemoryUsageFunc m_getVoiceMemoryUsage;
   NativeModuleInvokeCompileTimeFunc m_invokeCompileTime;
   NativeModuleInvokeFunc m_invoke;
 } NativeModule;
@@ -452,7 +468,7 @@ typedef void* (*NativeLibraryInitializeFunc)();
 // Called when a native library is unloaded.
 typedef void (*NativeLibraryDeinitializeFunc)(void* context);
 
-// Called when a voice is created. Optionally returns a context pointer.
+// Called when a voice is created. Optionally returns a context pointer. Different voices may be created concurrently on different threads.
 typedef void* (*NativeLibraryInitializeVoiceFunc)(void* context);
 
 // Called when a voice is destroyed.
@@ -213,6 +213,39 @@ namespace Chord
       { static_assert(AlwaysFalse<TBufferData>, "Unsupported buffer type"); }
   }
 
+  template<typename TBufferData>
+  constexpr bool IsInputBufferData = std::same_as<TBufferData, InputBufferData<typename TBufferData::Element>>;
+
+  // For constant input buffers, this loads the constant value so that it can be reused across iterations. For other buffers, the result is unused.
+  template<usz ElementCount, typename TBufferData>
+  auto LoadConstantBufferValue(const TBufferData& bufferData)
+  {
+    using Value = std::remove_cvref_t<decltype(LoadBufferValue<ElementCount>(bufferData, 0))>;
+    if constexpr (IsInputBufferData<TBufferData>)
+    {
+      // Constant buffers have an index mask of 0 so they always load from the beginning of the buffer
+      if (bufferData.m_indexMask == 0)
+        { return Value(LoadBufferValue<ElementCount>(bufferData, 0)); }
+    }
+
+    if constexpr (vector<Value>)
+      { return Value(Uninitialized); }
+    else
+      { return Value(0); }
+  }
+
+  template<usz ElementCount, typename TBufferData, typename TConstantValue>
+  TConstantValue LoadBufferValueOrConstant(const TBufferData& bufferData, const TConstantValue& constantValue, usz index)
+  {
+    if constexpr (IsInputBufferData<TBufferData>)
+    {
+      if (bufferData.m_indexMask == 0)
+        { return constantValue; }
+    }
+
+    return TConstantValue(LoadBufferValue<ElementCount>(bufferData, index));
+  }
+
   template<usz ElementCount, typename TBufferData, typename TBufferValue>
   void StoreBufferValue(const TBufferData& bufferData, const TBufferValue& bufferValue, usz index)
   {
@@ -303,13 +336,23 @@ namespace Chord
         {
           usz endSampleIndex = sampleCount & ~(IterationElementCount - 1);
 
+          // Constant input buffers always produce the same value so load them once up-front and broadcast them from registers within the loop
+          auto constantValuesTuple = std::apply(
+            [&]<typename... TBufferData>(TBufferData&&... bufferData)
+              { return std::make_tuple(LoadConstantBufferValue<IterationElementCount>(bufferData)...); },
+            bufferDataTuple);
+
           while (sampleIndex < endSampleIndex)
           {
-            // Load values for each buffer. For constant buffers, indices are masked with 0 so that they always load from the beginning of the buffer.
-            auto bufferValuesTuple = std::apply(
-              [&]<typename... TBufferData>(TBufferData&&... bufferData)
-                { return std::make_tuple(LoadBufferValue<IterationElementCount>(bufferData, sampleIndex)...); },
-              bufferDataTuple);
+            // Load values for each buffer
+            auto bufferValuesTuple = [&]<usz... Indices>(std::index_sequence<Indices...>)
+            {
+              return std::make_tuple(
+                LoadBufferValueOrConstant<IterationElementCount>(
+                  std::get<Indices>(bufferDataTuple),
+                  std::get<Indices>(constantValuesTuple),
+                  sampleIndex)...);
+            }(std::index_sequence_for<TBuffers...>());
 
             auto CallCallback =
               [&](auto&&... args)
@@ -152,6 +152,23 @@ namespace Chord
       { return false; }
   }
 
+  template<typename TNativeModule>
+  consteval bool GetNativeModuleIsTileable()
+  {
+    if constexpr (requires { TNativeModule::IsTileable; })
+    {
+      if constexpr (requires { { TNativeModule::IsTileable } -> std::convertible_to<bool>; })
+        { return TNativeModule::IsTileable; }
+      else
+      {
+        static_assert(AlwaysFalse<TNativeModule>, "Native module 'IsTileable' field is not a bool");
+        return false;
+      }
+    }
+    else
+      { return false; }
+  }
+
   template<typename TFunc>
   consteval usz CountNativeModuleParameters()
   {
@@ -302,6 +319,13 @@ namespace Chord
         { return true; }
     }
 
+    if constexpr (requires { &TNativeModule::GetVoiceMemoryUsage; })
+    {
+      using Traits = FunctionTraits<decltype(&TNativeModule::GetVoiceMemoryUsage)>;
+      if constexpr (Traits::IsFunction && Traits::IsMemberFunction)
+        { return true; }
+    }
+
     if constexpr (requires { &TNativeModule::Invoke; })
     {
       using Traits = FunctionTraits<decltype(&TNativeModule::Invoke)>;
@@ -623,6 +647,65 @@ namespace Chord
       { return nullptr; }
   }
 
+  template<typename TNativeModule>
+  NativeModuleGetVoiceMemoryUsageFunc BuildNativeModuleGetVoiceMemoryUsage()
+  {
+    static constexpr bool ShouldInstantiateClass = ShouldInstantiateNativeModuleClass<TNativeModule>();
+
+    if constexpr (requires { &TNativeModule::GetVoiceMemoryUsage; })
+    {
+      using Traits = FunctionTraits<decltype(&TNativeModule::GetVoiceMemoryUsage)>;
+      if constexpr (!Traits::IsFunction)
+      {
+        static_assert(AlwaysFalse<TNativeModule>, "Native module 'GetVoiceMemoryUsage' is not a function");
+        return nullptr;
+      }
+      else if constexpr (!Traits::template Returns<usz>())
+      {
+        static_assert(AlwaysFalse<TNativeModule>, "Native module 'GetVoiceMemoryUsage' must return usz");
+        return nullptr;
+      }
+      else if constexpr (!Traits::template HasZeroOrOneArgumentsOfType<NativeModuleCallContext>())
+      {
+        static_assert(AlwaysFalse<TNativeModule>, "Native module 'GetVoiceMemoryUsage' should have at most one 'context' argument");
+        return nullptr;
+      }
+      else
+      {
+        auto GetVoiceMemoryUsageWrapper =
+          [](const NativeModuleContext* context) -> size_t
+          {
+            auto ResolveArgument =
+              [&]<typename TArgument>()
+              {
+                if constexpr (std::same_as<TArgument, NativeModuleCallContext>)
+                  { return NativeModuleCallContext(context); }
+                else
+                  { static_assert(AlwaysFalse<TNativeModule>, "Unsupported argument type"); }
+              };
+
+            // When the voice context is automatically instantiated, the instance itself is included in the reported memory usage
+            usz instanceByteCount = ShouldInstantiateClass ? sizeof(TNativeModule) : 0;
+            if constexpr (Traits::IsMemberFunction)
+            {
+              return instanceByteCount
+                + CallWithArgumentResolution(static_cast<TNativeModule*>(context->m_voiceContext), &TNativeModule::GetVoiceMemoryUsage, ResolveArgument);
+            }
+            else
+              { return instanceByteCount + CallWithArgumentResolution(&TNativeModule::GetVoiceMemoryUsage, ResolveArgument); }
+          };
+
+        return GetVoiceMemoryUsageWrapper;
+      }
+    }
+    else
+    {
+      // The class instance alone isn't reported because it may own memory (e.g. a FixedArray) which sizeof() doesn't see. Native modules without
+      // GetVoiceMemoryUsage are counted as unreported instead.
+      return nullptr;
+    }
+  }
+
   template<typename TNativeModule>
   NativeModuleInvokeFunc BuildNativeModuleInvoke()
   {
@@ -743,6 +826,12 @@ namespace Chord
     //   static constexpr Guid Id - the ID of the native module
     //   static constexpr const char32_t Name - the name of the native module (i.e. the name used to invoke it from a Chord script)
     //
+    // TNativeModule may have any of the following properties:
+    //
+    //   static constexpr bool HasSideEffects - maps to m_hasSideEffects within the returned NativeModule struct
+    //   static constexpr bool AlwaysRuntime - maps to m_alwaysRuntime within the returned NativeModule struct
+    //   static constexpr bool IsTileable - maps to m_isTileable within the returned NativeModule struct
+    //
     // TNativeModule may have any of the following methods:
     //
     //   static bool Prepare()
@@ -769,6 +858,12 @@ namespace Chord
     //     This function may take the following argument types:
     //       NativeModuleCallContext context - the native module call context
     //
+    //   [static] usz GetVoiceMemoryUsage()
+    //     This maps to m_getVoiceMemoryUsage with the returned NativeModule struct. It should return the number of bytes allocated by the voice context (not
+    //     including the automatically instantiated voice context itself, which is accounted for separately). Native modules with voice contexts which
+    //     don't provide this are reported as unreported in processor memory footprints. This function may take the following argument types:
+    //       NativeModuleCallContext context - the native module call context
+    //
     //   [static] void Invoke()
     //     This maps to m_invoke with the returned NativeModule struct. This function may take the following argument types:
     //       NativeModuleCallContext context - the native module call context
@@ -809,11 +904,13 @@ namespace Chord
       nativeModule.m_signature = BuildNativeModuleSignature<TNativeModule>();
       nativeModule.m_hasSideEffects = GetNativeModuleHasSideEffects<TNativeModule>();
       nativeModule.m_alwaysRuntime = GetNativeModuleAlwaysRuntime<TNativeModule>();
+      nativeModule.m_isTileable = GetNativeModuleIsTileable<TNativeModule>();
 
       nativeModule.m_prepare = BuildNativeModulePrepare<TNativeModule>();
       nativeModule.m_initializeVoice = BuildNativeModuleInitializeVoice<TNativeModule>();
       nativeModule.m_deinitializeVoice = BuildNativeModuleDeinitializeVoice<TNativeModule>();
       nativeModule.m_setVoiceActive = BuildNativeModuleSetVoiceActive<TNativeModule>();
+      nativeModule.m_getVoiceMemoryUsage = BuildNativeModuleGetVoiceMemoryUsage<TNativeModule>();
       nativeModule.m_invokeCompileTime = BuildNativeModuleInvokeCompileTime<TNativeModule>();
       nativeModule.m_invoke = BuildNativeModuleInvoke<TNativeModule>();
 
@@ -0,0 +1,439 @@
+module;
+
+#include "../../../NativeLibraryApi/ChordNativeLibraryApi.h"
+
+module Chord.Tests;
+
+import std;
+
+import Chord.Engine;
+import Chord.Foundation;
+import :Test;
+
+namespace Chord
+{
+  static constexpr u8 TestHashSalt[] = { 0x8b, 0xe1, 0x53, 0x2f, 0x41, 0x16, 0xc9, 0x8d, 0x1a, 0x2a, 0xb4, 0x3c, 0x0b, 0x34, 0xae, 0xdf };
+
+  static UnboundedArray<u8> BuildProgram(const UnboundedArray<u8>& content, u32 version = 1)
+  {
+    UnboundedArray<u8> hashInput = content;
+    hashInput.AppendMultiple(Span<const u8>(TestHashSalt));
+    auto contentHash = CalculateSha256(hashInput);
+
+    UnboundedArray<u8> bytes;
+    for (char c : { 'C', 'H', 'O', 'R', 'D', 'P', 'R', 'O', 'G', 'R', 'A', 'M' })
+      { bytes.Append(u8(c)); }
+    bytes.AppendMultiple(Span(reinterpret_cast<const u8*>(&version), sizeof(version)));
+    bytes.AppendMultiple(Span<const u8>(contentHash));
+    bytes.AppendMultiple(Span<const u8>(content));
+    return bytes;
+  }
+
+  // Builds a version 1 program with the graph [float constant] -> output -> input -> [graph output] plus an unconnected string constant
+  static UnboundedArray<u8> BuildNodeTableProgram(u32 firstConnectionReferenceIndex, f32 constantValue = 0.5f, u32 inputNodeCount = 1)
+  {
+    UnboundedArray<u8> content;
+    auto Write = [&](auto value) { content.AppendMultiple(Span(reinterpret_cast<const u8*>(&value), sizeof(value))); };
+
+    Write(0_u32); // Native library dependency count
+    Write(48000_s32);
+    Write(0_s32);
+    Write(1_s32);
+    Write(1_u32); // Max voices
+    Write(0_u32); // Effect activation mode
+    Write(0.0);
+
+    // Node counts: 1 input, 2 outputs, 1 float constant, 1 string constant, 1 graph output
+    for (u32 nodeCount : { inputNodeCount, 2_u32, 1_u32, 0_u32, 0_u32, 0_u32, 1_u32, 0_u32, 0_u32, 0_u32, 1_u32 })
+      { Write(nodeCount); }
+    Write(1_u32); // Reference count
+    Write(3_u32); // String pool length
+
+    // Output records (node indices 1 and 2)
+    Write(1_u32);
+    Write(firstConnectionReferenceIndex);
+    Write(0_u32);
+    Write(1_u32);
+
+    // Float constant record (node index 3)
+    Write(1_u32);
+    Write(constantValue);
+
+    // String constant record (node index 4)
+    Write(2_u32);
+    Write(0_u32);
+    Write(3_u32);
+
+    // Graph output record (node index 5)
+    Write(0_u32);
+
+    // Reference table and string pool
+    Write(0_u32);
+    for (char32_t c : U"abc")
+    {
+      if (c != 0)
+        { Write(c); }
+    }
+
+    Write(u8(0)); // No float input channels
+    Write(u8(0)); // No double input channels
+    Write(u8(PrimitiveTypeFloat));
+    Write(5_u32); // Output channel
+    Write(u8(0)); // No voice remain-active output
+    Write(u8(0)); // No effect remain-active output
+    Write(0_u32); // Voice-to-effect count
+    Write(u8(1)); // Voice graph
+    Write(3_u32);
+    Write(3_u32);
+    Write(4_u32);
+    Write(5_u32);
+    Write(u8(0)); // No effect graph
+
+    return BuildProgram(content);
+  }
+
+  // Builds a version 0 program with the same graph as BuildNodeTableProgram(0) but with node types interleaved in the node stream
+  static UnboundedArray<u8> BuildNodeStreamProgram()
+  {
+    UnboundedArray<u8> content;
+    auto Write = [&](auto value) { content.AppendMultiple(Span(reinterpret_cast<const u8*>(&value), sizeof(value))); };
+
+    Write(0_u32); // Native library dependency count
+    Write(48000_s32);
+    Write(0_s32);
+    Write(1_s32);
+    Write(1_u32); // Max voices
+    Write(0_u32); // Effect activation mode
+    Write(0.0);
+
+    // Node types: float constant, output, input, graph output, string constant, output
+    Write(6_u32);
+    for (u8 nodeType : { u8(2), u8(1), u8(0), u8(10), u8(6), u8(1) })
+      { Write(nodeType); }
+
+    // Float constant (node index 0)
+    Write(1_u32);
+    Write(0.5f);
+
+    // Output connected to the input (node index 1)
+    Write(1_u32);
+    Write(2_u32);
+
+    // Graph output (node index 3)
+    Write(2_u32);
+
+    // String constant (node index 4)
+    Write(5_u32);
+    Write(3_u32);
+    for (char32_t c : U"abc")
+    {
+      if (c != 0)
+        { Write(c); }
+    }
+
+    // Unconnected output (node index 5)
+    Write(0_u32);
+
+    Write(u8(0)); // No float input channels
+    Write(u8(0)); // No double input channels
+    Write(u8(PrimitiveTypeFloat));
+    Write(3_u32); // Output channel
+    Write(u8(0)); // No voice remain-active output
+    Write(u8(0)); // No effect remain-active output
+    Write(0_u32); // Voice-to-effect count
+    Write(u8(1)); // Voice graph
+    Write(3_u32);
+    Write(0_u32);
+    Write(4_u32);
+    Write(3_u32);
+    Write(u8(0)); // No effect graph
+
+    return BuildProgram(content, 0);
+  }
+
+  // Builds a version 1 program with the graph [float constant] -> output -> input -> [graph output] plus a float input channel which is never read
+  static UnboundedArray<u8> BuildUnusedInputChannelProgram()
+  {
+    UnboundedArray<u8> content;
+    auto Write = [&](auto value) { content.AppendMultiple(Span(reinterpret_cast<const u8*>(&value), sizeof(value))); };
+
+    Write(0_u32); // Native library dependency count
+    Write(48000_s32);
+    Write(1_s32);
+    Write(1_s32);
+    Write(1_u32); // Max voices
+    Write(0_u32); // Effect activation mode
+    Write(0.0);
+
+    // Node counts: 1 input, 2 outputs, 1 float constant, 1 graph input, 1 graph output
+    for (u32 nodeCount : { 1_u32, 2_u32, 1_u32, 0_u32, 0_u32, 0_u32, 0_u32, 0_u32, 0_u32, 1_u32, 1_u32 })
+      { Write(nodeCount); }
+    Write(1_u32); // Reference count
+    Write(0_u32); // String pool length
+
+    // Output records (node indices 1 and 2)
+    Write(1_u32);
+    Write(0_u32);
+    Write(0_u32);
+    Write(1_u32);
+
+    // Float constant record (node index 3)
+    Write(1_u32);
+    Write(0.5f);
+
+    // Graph input record (node index 4)
+    Write(2_u32);
+
+    // Graph output record (node index 5)
+    Write(0_u32);
+
+    // Reference table
+    Write(0_u32);
+
+    Write(u8(1)); // Float input channels
+    Write(4_u32);
+    Write(u8(0)); // No double input channels
+    Write(u8(PrimitiveTypeFloat));
+    Write(5_u32); // Output channel
+    Write(u8(0)); // No voice remain-active output
+    Write(u8(0)); // No effect remain-active output
+    Write(0_u32); // Voice-to-effect count
+    Write(u8(1)); // Voice graph
+    Write(1_u32);
+    Write(5_u32);
+    Write(u8(0)); // No effect graph
+
+    return BuildProgram(content);
+  }
+
+  TEST_CLASS(Program)
+  {
+    TEST_METHOD(DeserializeNodeStream)
+    {
+      UnboundedArray<u8> bytes = BuildNodeStreamProgram();
+      std::optional<Chord::Program> program = Program::Deserialize(bytes);
+      EXPECT(program.has_value());
+      EXPECT(!Program::TryReadStructureHash(bytes).has_value());
+
+      const ProgramGraph& programGraph = program->ProgramGraph();
+      EXPECT(programGraph.m_outputChannels.Count() == 1);
+      EXPECT(programGraph.m_voiceGraph.has_value() && programGraph.m_voiceGraph->Count() == 3);
+      EXPECT(!programGraph.m_effectGraph.has_value());
+
+      const IOutputProgramGraphNode* connection = programGraph.m_outputChannels[0]->Input()->Connection();
+      EXPECT(connection->Processor() == (*programGraph.m_voiceGraph)[0]);
+      EXPECT(connection->Processor()->Type() == ProgramGraphNodeType::FloatConstant);
+      EXPECT(static_cast<const FloatConstantProgramGraphNode*>(connection->Processor())->Value() == 0.5f);
+
+      const IProcessorProgramGraphNode* stringNode = (*programGraph.m_voiceGraph)[1];
+      EXPECT(stringNode->Type() == ProgramGraphNodeType::StringConstant);
+      EXPECT(static_cast<const StringConstantProgramGraphNode*>(stringNode)->Value() == U"abc");
+    }
+
+    TEST_METHOD(DeserializeNodeTable)
+    {
+      UnboundedArray<u8> bytes = BuildNodeTableProgram(0);
+      std::optional<Chord::Program> program = Program::Deserialize(bytes);
+      EXPECT(program.has_value());
+
+      const ProgramGraph& programGraph = program->ProgramGraph();
+      EXPECT(programGraph.m_outputChannels.Count() == 1);
+      EXPECT(programGraph.m_voiceGraph.has_value() && programGraph.m_voiceGraph->Count() == 3);
+      EXPECT(!programGraph.m_effectGraph.has_value());
+
+      const IOutputProgramGraphNode* connection = programGraph.m_outputChannels[0]->Input()->Connection();
+      EXPECT(connection->Processor() == (*programGraph.m_voiceGraph)[0]);
+      EXPECT(connection->Processor()->Type() == ProgramGraphNodeType::FloatConstant);
+      EXPECT(static_cast<const FloatConstantProgramGraphNode*>(connection->Processor())->Value() == 0.5f);
+
+      const IProcessorProgramGraphNode* stringNode = (*programGraph.m_voiceGraph)[1];
+      EXPECT(stringNode->Type() == ProgramGraphNodeType::StringConstant);
+      EXPECT(static_cast<const StringConstantProgramGraphNode*>(stringNode)->Value() == U"abc");
+    }
+
+    TEST_METHOD(DeserializeNodeTableInPlace)
+    {
+      UnboundedArray<u8> bytes = BuildNodeTableProgram(0);
+      std::optional<Chord::Program> program = Program::DeserializeInPlace(bytes);
+      EXPECT(program.has_value());
+
+      // The string constant should point directly into the serialized string pool
+      const auto* stringNode = static_cast<const StringConstantProgramGraphNode*>((*program->ProgramGraph().m_voiceGraph)[1]);
+      const u8* stringPointer = reinterpret_cast<const u8*>(stringNode->Value().CharPtr());
+      EXPECT(stringNode->Value() == U"abc");
+      EXPECT(stringPointer >= bytes.Elements() && stringPointer < bytes.Elements() + bytes.Count());
+    }
+
+    TEST_METHOD(RejectInvalidNodeTable)
+    {
+      // The output node's connection range lies outside of the reference table
+      UnboundedArray<u8> bytes = BuildNodeTableProgram(1);
+      EXPECT(!Program::Deserialize(bytes).has_value());
+
+      // Input records are empty so a huge input count still fits in the layout but there can't be more inputs than references
+      UnboundedArray<u8> excessiveInputBytes = BuildNodeTableProgram(0, 0.5f, 0x40000000);
+      EXPECT(!Program::Deserialize(excessiveInputBytes).has_value());
+
+      // The content hash (which follows the 12-byte header and the version) no longer matches the content
+      UnboundedArray<u8> corruptedBytes = BuildNodeTableProgram(0);
+      corruptedBytes[16] ^= 1;
+      EXPECT(!Program::Deserialize(corruptedBytes).has_value());
+    }
+
+    TEST_METHOD(SimplifyRemovesUnusedInputChannels)
+    {
+      UnboundedArray<u8> bytes = BuildUnusedInputChannelProgram();
+      std::optional<Chord::Program> program = Program::Deserialize(bytes);
+      EXPECT(program.has_value());
+      EXPECT(program->ProgramGraph().m_inputChannelsFloat.has_value());
+
+      // The program has no native module calls so no native libraries are needed
+      Program::SimplificationResult result = program->Simplify(nullptr);
+      EXPECT(program->IsSimplified());
+      EXPECT(result.m_foldedNativeModuleCallCount == 0);
+      EXPECT(result.m_removedTaskCount == 0);
+      EXPECT(result.m_removedInputChannelCount == 1);
+      EXPECT(!program->ProgramGraph().m_inputChannelsFloat.has_value());
+
+      // The rest of the graph is untouched
+      const IOutputProgramGraphNode* connection = program->ProgramGraph().m_outputChannels[0]->Input()->Connection();
+      EXPECT(connection->Processor()->Type() == ProgramGraphNodeType::FloatConstant);
+    }
+
+    TEST_METHOD(ProgramBankSharesDuplicatePrograms)
+    {
+      // The programs have no native library dependencies so no native libraries are needed
+      ProgramBank programBank(nullptr, false);
+      UnboundedArray<u8> bytesA = BuildNodeTableProgram(0);
+      UnboundedArray<u8> bytesB = BuildNodeTableProgram(0);
+      UnboundedArray<u8> otherBytes = BuildUnusedInputChannelProgram();
+
+      const Chord::Program* programA = programBank.AcquireProgram(bytesA);
+      const Chord::Program* programB = programBank.AcquireProgram(bytesB);
+      const Chord::Program* otherProgram = programBank.AcquireProgram(otherBytes);
+      EXPECT(programA != nullptr && otherProgram != nullptr);
+      EXPECT(programA == programB);
+      EXPECT(programA != otherProgram);
+
+      ProgramBank::Statistics statistics = programBank.GetStatistics();
+      EXPECT(statistics.m_programCount == 2);
+      EXPECT(statistics.m_referenceCount == 3);
+      EXPECT(statistics.m_nodeCount == programA->NodeCount() + otherProgram->NodeCount());
+      EXPECT(statistics.m_sharedNodeCount == programA->NodeCount());
+      EXPECT(statistics.m_sharedByteCount == bytesA.Count());
+
+      // Corrupted bytes must not resolve to the program which shares their content hash
+      UnboundedArray<u8> corruptedBytes = BuildNodeTableProgram(0);
+      corruptedBytes[corruptedBytes.Count() - 1] ^= 1;
+      EXPECT(programBank.AcquireProgram(corruptedBytes) == nullptr);
+
+      programBank.ReleaseProgram(programA);
+      statistics = programBank.GetStatistics();
+      EXPECT(statistics.m_programCount == 2);
+      EXPECT(statistics.m_sharedNodeCount == 0);
+
+      programBank.ReleaseProgram(programB);
+      programBank.ReleaseProgram(otherProgram);
+      statistics = programBank.GetStatistics();
+      EXPECT(statistics.m_programCount == 0);
+      EXPECT(statistics.m_referenceCount == 0);
+      EXPECT(statistics.m_byteCount == 0);
+    }
+
+    TEST_METHOD(ProgramBankSharesGraphsAcrossConstantVariants)
+    {
+      UnboundedArray<u8> bytesA = BuildNodeTableProgram(0, 0.5f);
+      UnboundedArray<u8> bytesB = BuildNodeTableProgram(0, 0.25f);
+      auto structureHashA = Program::TryReadStructureHash(bytesA);
+      auto structureHashB = Program::TryReadStructureHash(bytesB);
+      EXPECT(structureHashA.has_value() && structureHashB.has_value());
+      EXPECT(std::memcmp(structureHashA->Elements(), structureHashB->Elements(), Sha256ByteCount) == 0);
+
+      ProgramBank programBank(nullptr, false);
+      const Chord::Program* programA = programBank.AcquireProgram(bytesA);
+      const Chord::Program* programB = programBank.AcquireProgram(bytesB);
+      EXPECT(programA != nullptr && programB != nullptr && programA != programB);
+      EXPECT(programA->SharesGraph() && programB->SharesGraph());
+
+      // Both programs reference the same constant node but each reads its own value
+      const GraphOutputProgramGraphNode* outputChannel = programA->ProgramGraph().m_outputChannels[0];
+      EXPECT(programB->ProgramGraph().m_outputChannels[0] == outputChannel);
+      auto constantNode = static_cast<const FloatConstantProgramGraphNode*>(outputChannel->Input()->Connection()->Processor());
+      EXPECT(programA->ConstantValue(constantNode) == 0.5f);
+      EXPECT(programB->ConstantValue(constantNode) == 0.25f);
+
+      ProgramBank::Statistics statistics = programBank.GetStatistics();
+      EXPECT(statistics.m_programCount == 2);
+      EXPECT(statistics.m_graphCount == 1);
+      EXPECT(statistics.m_nodeCount == programA->NodeCount());
+      EXPECT(statistics.m_sharedNodeCount == programA->NodeCount());
+      EXPECT(statistics.m_sharedByteCount == 0);
+      EXPECT(statistics.m_constantValueByteCount == 2 * sizeof(f32));
+
+      // The graph outlives the program which provided it
+      programBank.ReleaseProgram(programA);
+      EXPECT(programB->ConstantValue(constantNode) == 0.25f);
+      statistics = programBank.GetStatistics();
+      EXPECT(statistics.m_graphCount == 1);
+      EXPECT(statistics.m_sharedNodeCount == 0);
+
+      programBank.ReleaseProgram(programB);
+      statistics = programBank.GetStatistics();
+      EXPECT(statistics.m_graphCount == 0);
+      EXPECT(statistics.m_nodeCount == 0);
+      EXPECT(statistics.m_constantValueByteCount == 0);
+
+      // Simplification may fold constants into the graph so simplified programs never share one
+      ProgramBank simplifyingProgramBank(nullptr, true);
+      const Chord::Program* simplifiedProgramA = simplifyingProgramBank.AcquireProgram(bytesA);
+      const Chord::Program* simplifiedProgramB = simplifyingProgramBank.AcquireProgram(bytesB);
+      EXPECT(simplifiedProgramA != nullptr && simplifiedProgramB != nullptr);
+      EXPECT(!simplifiedProgramA->SharesGraph() && !simplifiedProgramB->SharesGraph());
+      EXPECT(simplifyingProgramBank.GetStatistics().m_graphCount == 2);
+      simplifyingProgramBank.ReleaseProgram(simplifiedProgramA);
+      simplifyingProgramBank.ReleaseProgram(simplifiedProgramB);
+    }
+
+    TEST_METHOD(PatchUpdatesConstantsInPlace)
+    {
+      UnboundedArray<u8> baseBytes = BuildNodeTableProgram(0, 0.5f);
+      UnboundedArray<u8> targetBytes = BuildNodeTableProgram(0, 0.25f);
+
+      std::optional<UnboundedArray<u8>> patch = Program::CreatePatch(baseBytes, targetBytes);
+      EXPECT(patch.has_value());
+      std::optional<UnboundedArray<u8>> patchedBytes = Program::ApplyPatch(baseBytes, *patch);
+      EXPECT(patchedBytes.has_value());
+      EXPECT(patchedBytes->Count() == targetBytes.Count());
+      EXPECT(std::memcmp(patchedBytes->Elements(), targetBytes.Elements(), targetBytes.Count()) == 0);
+
+      // A patch can only be applied to the program it was created from
+      EXPECT(!Program::ApplyPatch(targetBytes, *patch).has_value());
+
+      std::optional<Chord::Program> program = Program::Deserialize(baseBytes);
+      EXPECT(program.has_value());
+      auto update = program->TryPrepareConstantUpdate(baseBytes, *patchedBytes);
+      EXPECT(update.has_value() && update->ChangedNodes().Count() == 1);
+      auto changedNode = update->ChangedNodes()[0];
+      EXPECT(changedNode->Type() == ProgramGraphNodeType::FloatConstant);
+
+      // Preparing an update leaves the program untouched so that it can still be rejected
+      auto baseContentHash = Program::TryReadContentHash(baseBytes);
+      EXPECT(program->ConstantValue(static_cast<const FloatConstantProgramGraphNode*>(changedNode)) == 0.5f);
+      EXPECT(std::memcmp(program->ContentHash().Elements(), baseContentHash->Elements(), Sha256ByteCount) == 0);
+
+      program->CommitConstantUpdate(*update);
+      EXPECT(program->ConstantValue(static_cast<const FloatConstantProgramGraphNode*>(changedNode)) == 0.25f);
+      auto targetContentHash = Program::TryReadContentHash(targetBytes);
+      EXPECT(std::memcmp(program->ContentHash().Elements(), targetContentHash->Elements(), Sha256ByteCount) == 0);
+
+      // Structural changes can be patched but must be loaded as a new program
+      UnboundedArray<u8> otherBytes = BuildUnusedInputChannelProgram();
+      std::optional<UnboundedArray<u8>> structuralPatch = Program::CreatePatch(targetBytes, otherBytes);
+      EXPECT(structuralPatch.has_value());
+      std::optional<UnboundedArray<u8>> patchedOtherBytes = Program::ApplyPatch(targetBytes, *structuralPatch);
+      EXPECT(patchedOtherBytes.has_value() && patchedOtherBytes->Count() == otherBytes.Count());
+      EXPECT(!program->TryPrepareConstantUpdate(targetBytes, otherBytes).has_value());
+      EXPECT(program->ConstantValue(static_cast<const FloatConstantProgramGraphNode*>(changedNode)) == 0.25f);
+    }
+  };
+}
\ No newline at end of file
@@ -4,6 +4,8 @@ module;
 
 module Chord.Tests;
 
+import std;
+
 import Chord.Engine;
 import Chord.Foundation;
 import :Test;
@@ -54,6 +56,104 @@ namespace Chord
       EXPECT(boolBufferA.m_byteCount == SampleCount / 8);
     }
 
+    TEST_METHOD(SubBuffer)
+    {
+      static constexpr usz SampleCount = 1024;
+      BufferManager bm;
+
+      auto floatBufferIndex = bm.AddBuffer(PrimitiveTypeFloat, SampleCount, 1);
+      auto doubleBufferIndex = bm.AddBuffer(PrimitiveTypeDouble, SampleCount, 2);
+      auto boolBufferIndex = bm.AddBuffer(PrimitiveTypeBool, SampleCount, 1);
+
+      EXPECT(bm.GetBufferSampleOffsetAlignment(floatBufferIndex) == MaxSimdAlignment / sizeof(f32));
+      EXPECT(bm.GetBufferSampleOffsetAlignment(doubleBufferIndex) == MaxSimdAlignment / (sizeof(f64) * 2));
+      EXPECT(bm.GetBufferSampleOffsetAlignment(boolBufferIndex) == MaxSimdAlignment * 8);
+
+      bm.InitializeBufferConcurrency();
+      bm.SetBuffersConcurrent(floatBufferIndex, doubleBufferIndex);
+      bm.SetBuffersConcurrent(floatBufferIndex, boolBufferIndex);
+      bm.SetBuffersConcurrent(doubleBufferIndex, boolBufferIndex);
+      bm.AllocateBuffers();
+
+      const BufferManager::Buffer& floatBuffer = bm.GetBuffer(floatBufferIndex);
+      auto floatSubBuffer = floatBuffer.GetSubBuffer(256);
+      EXPECT(floatSubBuffer.m_memory == static_cast<u8*>(floatBuffer.m_memory) + 256 * sizeof(f32));
+      EXPECT(floatSubBuffer.m_byteCount == floatBuffer.m_byteCount - 256 * sizeof(f32));
+
+      const BufferManager::Buffer& doubleBuffer = bm.GetBuffer(doubleBufferIndex);
+      auto doubleSubBuffer = doubleBuffer.GetSubBuffer(256);
+      EXPECT(doubleSubBuffer.m_memory == static_cast<u8*>(doubleBuffer.m_memory) + 256 * 2 * sizeof(f64));
+      EXPECT(doubleSubBuffer.m_byteCount == doubleBuffer.m_byteCount - 256 * 2 * sizeof(f64));
+
+      const BufferManager::Buffer& boolBuffer = bm.GetBuffer(boolBufferIndex);
+      auto boolSubBuffer = boolBuffer.GetSubBuffer(256);
+      EXPECT(boolSubBuffer.m_memory == static_cast<u8*>(boolBuffer.m_memory) + 256 / 8);
+      EXPECT(boolSubBuffer.m_byteCount == boolBuffer.m_byteCount - 256 / 8);
+    }
+
+    TEST_METHOD(ConstantValue)
+    {
+      static constexpr usz SampleCount = 256;
+      BufferManager bm;
+
+      auto floatBufferIndex = bm.AddBuffer(PrimitiveTypeFloat, SampleCount, 1);
+      auto boolBufferIndex = bm.AddBuffer(PrimitiveTypeBool, SampleCount, 1);
+
+      bm.InitializeBufferConcurrency();
+      bm.SetBuffersConcurrent(floatBufferIndex, boolBufferIndex);
+      bm.AllocateBuffers();
+
+      const BufferManager::Buffer& floatBuffer = bm.GetBuffer(floatBufferIndex);
+      floatBuffer.Get<f32>(SampleCount).Fill(2.0f);
+      bm.SetBufferConstant(floatBufferIndex, true);
+      EXPECT(floatBuffer.m_isConstant);
+      EXPECT(floatBuffer.m_constantValueMemory != floatBuffer.m_memory);
+      EXPECT(floatBuffer.GetConstant<f32>() == 2.0f);
+
+      // Setting a constant value directly should not touch buffer memory
+      bm.SetBufferConstantValue(floatBufferIndex, 5.0f);
+      EXPECT(floatBuffer.GetConstant<f32>() == 5.0f);
+      EXPECT(floatBuffer.Get<f32>(1)[0] == 2.0f);
+
+      bm.SetBufferConstant(floatBufferIndex, false);
+      EXPECT(!floatBuffer.m_isConstant);
+
+      const BufferManager::Buffer& boolBuffer = bm.GetBuffer(boolBufferIndex);
+      bm.SetBufferConstantValue(boolBufferIndex, true);
+      EXPECT(boolBuffer.GetConstant<bool>());
+      bm.SetBufferConstantValue(boolBufferIndex, false);
+      EXPECT(!boolBuffer.GetConstant<bool>());
+    }
+
+    TEST_METHOD(ExternalMemory)
+    {
+      static constexpr usz SampleCount = 256;
+      BufferManager bm;
+
+      auto floatBufferIndex = bm.AddBuffer(PrimitiveTypeFloat, SampleCount, 1);
+      bm.InitializeBufferConcurrency();
+      bm.AllocateBuffers();
+
+      const BufferManager::Buffer& floatBuffer = bm.GetBuffer(floatBufferIndex);
+      void* allocatedMemory = floatBuffer.m_memory;
+      usz allocatedByteCount = floatBuffer.m_byteCount;
+
+      alignas(MaxSimdAlignment) f32 externalSamples[64] = {};
+      externalSamples[0] = 3.0f;
+      bm.SetBufferExternalMemory(floatBufferIndex, externalSamples, sizeof(externalSamples));
+      EXPECT(floatBuffer.m_memory == externalSamples);
+      EXPECT(floatBuffer.m_byteCount == sizeof(externalSamples));
+      EXPECT(floatBuffer.Get<f32>(64)[0] == 3.0f);
+
+      bm.ClearBufferExternalMemory(floatBufferIndex);
+      EXPECT(floatBuffer.m_memory == allocatedMemory);
+      EXPECT(floatBuffer.m_byteCount == allocatedByteCount);
+
+      // Clearing a buffer which isn't using external memory does nothing
+      bm.ClearBufferExternalMemory(floatBufferIndex);
+      EXPECT(floatBuffer.m_memory == allocatedMemory);
+    }
+
     TEST_METHOD(AddFloatBufferArray)
     {
       BufferManager bm;
@@ -402,5 +502,244 @@ namespace Chord
       EXPECT(bufferB.m_memory != bufferC.m_memory);
       EXPECT(bufferA.m_memory == bufferB.m_memory || bufferA.m_memory == bufferC.m_memory);
     }
+
+    // The input buffer branches to a different task but that task is guaranteed to finish first so the input buffer dies in the final task
+    TEST_METHOD(SharedInputOutputBufferInFinalInputTask)
+    {
+      BufferManager bm;
+
+      s32 taskA = 0;
+      s32 taskB = 0;
+      s32 taskC = 0;
+
+      auto bufferIndexA = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      auto bufferIndexB = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      bm.SetBufferOutputTaskForSharing(bufferIndexA, &taskA);
+      bm.AddBufferInputTask(bufferIndexA, &taskB, true);
+      bm.AddBufferInputTask(bufferIndexA, &taskC, true);
+      bm.SetBufferFinalInputTask(bufferIndexA, &taskC);
+      bm.SetBufferOutputTaskForSharing(bufferIndexB, &taskC);
+
+      bm.InitializeBufferConcurrency();
+      bm.SetBuffersConcurrent(bufferIndexA, bufferIndexB);
+      bm.AllocateBuffers();
+
+      auto bufferA = bm.GetBuffer(bufferIndexA);
+      auto bufferB = bm.GetBuffer(bufferIndexB);
+
+      EXPECT(bufferA.m_memory == bufferB.m_memory);
+
+      auto diagnosticA = bm.GetBufferSharingDiagnostic(bufferIndexA);
+      EXPECT(diagnosticA.m_inPlaceInputSharingResult == BufferManager::InPlaceSharingResult::Shared);
+      EXPECT(diagnosticA.m_inPlaceSharedBufferHandle == bufferIndexB);
+    }
+
+    // Graph outputs are read after all tasks have finished so a buffer which feeds one must not be overwritten in-place, even by its final input task
+    TEST_METHOD(NonSharedInputOutputBufferDueToGraphOutputReader)
+    {
+      BufferManager bm;
+
+      s32 taskA = 0;
+      s32 taskB = 0;
+      s32 taskC = 0;
+      s32 stage = 0;
+
+      auto bufferIndexA = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      auto bufferIndexB = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      bm.SetBufferOutputTaskForSharing(bufferIndexA, &taskA);
+      bm.AddBufferInputTask(bufferIndexA, &taskB, true);
+      bm.AddBufferInputTask(bufferIndexA, &taskC, true);
+      bm.AddBufferInputTask(bufferIndexA, &stage, false);
+      bm.SetBufferFinalInputTask(bufferIndexA, &taskC);
+      bm.SetBufferOutputTaskForSharing(bufferIndexB, &taskC);
+
+      bm.InitializeBufferConcurrency();
+      bm.SetBuffersConcurrent(bufferIndexA, bufferIndexB);
+      bm.AllocateBuffers();
+
+      auto bufferA = bm.GetBuffer(bufferIndexA);
+      auto bufferB = bm.GetBuffer(bufferIndexB);
+
+      EXPECT(bufferA.m_memory != bufferB.m_memory);
+      EXPECT(bm.GetBufferSharingDiagnostic(bufferIndexA).m_inPlaceInputSharingResult == BufferManager::InPlaceSharingResult::Disallowed);
+    }
+
+    // Each array element is registered as a separate usage so an element buffer which appears twice in the array can't be shared but a distinct element can
+    TEST_METHOD(SharedInputOutputBufferFromArrayElement)
+    {
+      BufferManager bm;
+
+      s32 taskA = 0;
+      s32 taskB = 0;
+
+      auto bufferIndexA = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      auto bufferIndexB = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      auto bufferIndexC = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      bm.SetBufferOutputTaskForSharing(bufferIndexA, &taskA);
+      bm.SetBufferOutputTaskForSharing(bufferIndexB, &taskA);
+      bm.AddFloatBufferArray(3);
+      bm.AddBufferInputTask(bufferIndexA, &taskB, true);
+      bm.AddBufferInputTask(bufferIndexA, &taskB, true);
+      bm.AddBufferInputTask(bufferIndexB, &taskB, true);
+      bm.SetBufferOutputTaskForSharing(bufferIndexC, &taskB);
+
+      bm.InitializeBufferConcurrency();
+      bm.SetBufferConcurrentWithAll(bufferIndexA);
+      bm.SetBufferConcurrentWithAll(bufferIndexB);
+      bm.SetBufferConcurrentWithAll(bufferIndexC);
+      bm.AllocateBuffers();
+
+      auto bufferA = bm.GetBuffer(bufferIndexA);
+      auto bufferB = bm.GetBuffer(bufferIndexB);
+      auto bufferC = bm.GetBuffer(bufferIndexC);
+
+      EXPECT(bufferA.m_memory != bufferC.m_memory);
+      EXPECT(bufferB.m_memory == bufferC.m_memory);
+      EXPECT(bm.GetBufferSharingDiagnostic(bufferIndexA).m_inPlaceInputSharingResult == BufferManager::InPlaceSharingResult::MultipleUsagesInTask);
+      EXPECT(bm.GetBufferSharingDiagnostic(bufferIndexB).m_inPlaceInputSharingResult == BufferManager::InPlaceSharingResult::Shared);
+    }
+
+    // A bool output is written more slowly than a float input is read so the two can share memory
+    TEST_METHOD(SharedBoolOutputWithFloatInputBuffer)
+    {
+      BufferManager bm;
+
+      s32 taskA = 0;
+      s32 taskB = 0;
+
+      auto bufferIndexA = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      auto bufferIndexB = bm.AddBuffer(PrimitiveTypeBool, 128, 1);
+      bm.SetBufferOutputTaskForSharing(bufferIndexA, &taskA);
+      bm.AddBufferInputTask(bufferIndexA, &taskB, true);
+      bm.SetBufferOutputTaskForSharing(bufferIndexB, &taskB);
+
+      bm.InitializeBufferConcurrency();
+      bm.SetBuffersConcurrent(bufferIndexA, bufferIndexB);
+      bm.AllocateBuffers();
+
+      auto bufferA = bm.GetBuffer(bufferIndexA);
+      auto bufferB = bm.GetBuffer(bufferIndexB);
+
+      EXPECT(bufferA.m_memory == bufferB.m_memory);
+      EXPECT(bm.GetAllocatedByteCount() == bufferA.m_byteCount);
+    }
+
+    // The float output should claim the float input before the bool output can
+    TEST_METHOD(SharedInputOutputBufferPrefersMatchingWidth)
+    {
+      BufferManager bm;
+
+      s32 taskA = 0;
+      s32 taskB = 0;
+
+      auto bufferIndexA = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      auto bufferIndexB = bm.AddBuffer(PrimitiveTypeBool, 128, 1);
+      auto bufferIndexC = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      bm.SetBufferOutputTaskForSharing(bufferIndexA, &taskA);
+      bm.AddBufferInputTask(bufferIndexA, &taskB, true);
+      bm.SetBufferOutputTaskForSharing(bufferIndexB, &taskB);
+      bm.SetBufferOutputTaskForSharing(bufferIndexC, &taskB);
+
+      bm.InitializeBufferConcurrency();
+      bm.SetBuffersConcurrent(bufferIndexA, bufferIndexB);
+      bm.SetBuffersConcurrent(bufferIndexA, bufferIndexC);
+      bm.SetBuffersConcurrent(bufferIndexB, bufferIndexC);
+      bm.AllocateBuffers();
+
+      auto bufferA = bm.GetBuffer(bufferIndexA);
+      auto bufferB = bm.GetBuffer(bufferIndexB);
+      auto bufferC = bm.GetBuffer(bufferIndexC);
+
+      EXPECT(bufferA.m_memory != bufferB.m_memory);
+      EXPECT(bufferA.m_memory == bufferC.m_memory);
+      EXPECT(bm.GetBufferSharingDiagnostic(bufferIndexB).m_inPlaceOutputSharingResult == BufferManager::InPlaceSharingResult::CandidatesClaimed);
+    }
+
+    TEST_METHOD(BufferSharingDiagnostics)
+    {
+      BufferManager bm;
+
+      s32 taskA = 0;
+      s32 taskB = 0;
+      s32 taskC = 0;
+
+      auto bufferIndexA = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      auto bufferIndexB = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      auto bufferIndexC = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+      bm.SetBufferOutputTaskForSharing(bufferIndexA, &taskA);
+      bm.AddBufferInputTask(bufferIndexA, &taskB, true);
+      bm.AddBufferInputTask(bufferIndexA, &taskC, true);
+      bm.SetBufferOutputTaskForSharing(bufferIndexB, &taskB);
+      bm.AddBufferInputTask(bufferIndexC, &taskC, true);
+
+      bm.InitializeBufferConcurrency();
+      bm.SetBufferConcurrentWithAll(bufferIndexA);
+      bm.SetBufferConcurrentWithAll(bufferIndexB);
+      bm.SetBufferConcurrentWithAll(bufferIndexC);
+      bm.AllocateBuffers();
+
+      auto diagnosticA = bm.GetBufferSharingDiagnostic(bufferIndexA);
+      auto diagnosticB = bm.GetBufferSharingDiagnostic(bufferIndexB);
+      auto diagnosticC = bm.GetBufferSharingDiagnostic(bufferIndexC);
+
+      EXPECT(diagnosticA.m_inPlaceInputSharingResult == BufferManager::InPlaceSharingResult::NoFinalInputTask);
+      EXPECT(!diagnosticA.m_inPlaceSharedBufferHandle.has_value());
+      EXPECT(diagnosticB.m_inPlaceOutputSharingResult == BufferManager::InPlaceSharingResult::NoCandidates);
+      EXPECT(diagnosticB.m_inPlaceInputSharingResult == BufferManager::InPlaceSharingResult::NotApplicable);
+      EXPECT(diagnosticC.m_inPlaceOutputSharingResult == BufferManager::InPlaceSharingResult::Disallowed);
+      EXPECT(diagnosticC.m_inPlaceInputSharingResult == BufferManager::InPlaceSharingResult::UntrackedProducer);
+      EXPECT(bm.GetAllocatedByteCount() == 3 * 128 * sizeof(f32));
+    }
+
+    TEST_METHOD(AllocationPlan)
+    {
+      s32 taskA = 0;
+      s32 taskB = 0;
+
+      auto AddBuffers =
+        [&](BufferManager& bm, PrimitiveType primitiveTypeC)
+        {
+          auto bufferIndexA = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+          auto bufferIndexB = bm.AddBuffer(PrimitiveTypeFloat, 128, 1);
+          auto bufferIndexC = bm.AddBuffer(primitiveTypeC, 128, 1);
+          bm.SetBufferOutputTaskForSharing(bufferIndexA, &taskA);
+          bm.AddBufferInputTask(bufferIndexA, &taskB, true);
+          bm.SetBufferOutputTaskForSharing(bufferIndexB, &taskB);
+          return std::make_tuple(bufferIndexA, bufferIndexB, bufferIndexC);
+        };
+
+      BufferManager bm;
+      auto [bufferIndexA, bufferIndexB, bufferIndexC] = AddBuffers(bm, PrimitiveTypeFloat);
+      bm.InitializeBufferConcurrency();
+      bm.SetBufferConcurrentWithAll(bufferIndexC);
+      bm.AllocateBuffers();
+
+      ProgramProcessorPlan plan = { .m_bufferAllocationPlan = bm.GetAllocationPlan() };
+      plan.m_key.ZeroElements();
+      UnboundedArray<u8> planBytes = SerializeProgramProcessorPlan(plan);
+      std::optional<ProgramProcessorPlan> deserializedPlan = DeserializeProgramProcessorPlan(planBytes);
+      EXPECT(deserializedPlan.has_value());
+      EXPECT(!DeserializeProgramProcessorPlan(Span(planBytes, 0, planBytes.Count() - 1)).has_value());
+
+      // A plan whose contents don't match its checksum is rejected
+      UnboundedArray<u8> corruptedPlanBytes = planBytes;
+      corruptedPlanBytes[corruptedPlanBytes.Count() / 2] ^= 1;
+      EXPECT(!DeserializeProgramProcessorPlan(corruptedPlanBytes).has_value());
+
+      // Buffer concurrency doesn't need to be declared when a plan is used
+      BufferManager plannedBm;
+      AddBuffers(plannedBm, PrimitiveTypeFloat);
+      EXPECT(plannedBm.TryAllocateBuffers(deserializedPlan->m_bufferAllocationPlan));
+      EXPECT(plannedBm.GetAllocatedByteCount() == bm.GetAllocatedByteCount());
+      EXPECT(plannedBm.GetBuffer(bufferIndexA).m_memory == plannedBm.GetBuffer(bufferIndexB).m_memory);
+      EXPECT(plannedBm.GetBuffer(bufferIndexA).m_memory != plannedBm.GetBuffer(bufferIndexC).m_memory);
+      EXPECT(plannedBm.GetBufferSharingDiagnostic(bufferIndexB).m_inPlaceSharedBufferHandle == bufferIndexA);
+
+      // A plan which doesn't describe the current buffers is rejected without allocating
+      BufferManager mismatchedBm;
+      AddBuffers(mismatchedBm, PrimitiveTypeDouble);
+      EXPECT(!mismatchedBm.TryAllocateBuffers(deserializedPlan->m_bufferAllocationPlan));
+      EXPECT(mismatchedBm.GetBuffer(bufferIndexA).m_memory == nullptr);
+    }
   };
 }
\ No newline at end of file
@@ -97,6 +97,31 @@ namespace Chord
       EXPECT(doubleFromDoubleMemory[3] == 6.0);
     }
 
+    TEST_METHOD(ConvertSamples)
+    {
+      auto Run =
+        []<typename TDestination, typename TSource>()
+        {
+          // Offsetting both spans by a sample covers the unaligned head, the vectorized body, and the scalar tail
+          alignas(MaxSimdAlignment) FixedArray<TSource, 24> source;
+          for (usz i = 0; i < source.Count(); i++)
+            { source[i] = TSource(i) - TSource(10.5); }
+
+          alignas(MaxSimdAlignment) FixedArray<TDestination, 24> destination;
+          destination.ZeroElements();
+          ConvertSamples(Span<TDestination>(destination, 1, 22), Span<const TSource>(source, 1, 22));
+
+          EXPECT(destination[0] == TDestination(0));
+          for (usz i = 1; i < 23; i++)
+            { EXPECT(destination[i] == TDestination(source[i])); }
+          EXPECT(destination[23] == TDestination(0));
+        };
+
+      Run.operator()<f32, f64>();
+      Run.operator()<f64, f32>();
+      Run.operator()<f32, f32>();
+    }
+
     TEST_METHOD(ShouldActivateEffect)
     {
       static constexpr f32 FloatSamples[] = { 0.0f, 0.25f, 0.0f, 0.0f, 0.0f, 0.0f, -0.75f, 0.0f, 1000.0f, -1000.0f };
@@ -126,6 +151,22 @@ namespace Chord
       EXPECT(ShouldActivateEffect(inputChannelBufferDouble, 0.0, 4, 4));
       EXPECT(ShouldActivateEffect(inputChannelBufferDouble, 0.5, 4, 4));
       EXPECT(!ShouldActivateEffect(inputChannelBufferDouble, 1.0, 4, 4));
+
+      // Thresholds which aren't representable as f32 must be compared as if they were, and long blocks use the vectorized path
+      FixedArray<f32, 19> longFloatSamples;
+      longFloatSamples.ZeroElements();
+      longFloatSamples[17] = 0.1f;
+      InputChannelBuffer longInputChannelBufferFloat =
+      {
+        .m_sampleType = SampleType::Float32,
+        .m_samples = Span(reinterpret_cast<const u8*>(longFloatSamples.Elements()), longFloatSamples.Count() * sizeof(f32)),
+      };
+
+      EXPECT(ShouldActivateEffect(longInputChannelBufferFloat, 0.09, 1, 18));
+      EXPECT(!ShouldActivateEffect(longInputChannelBufferFloat, 0.09, 1, 16));
+      EXPECT(ShouldActivateEffect(longInputChannelBufferFloat, std::nextafter(f64(0.1f), 0.0), 0, 19));
+      EXPECT(!ShouldActivateEffect(longInputChannelBufferFloat, f64(0.1f), 0, 19));
+      EXPECT(!ShouldActivateEffect(longInputChannelBufferFloat, std::nextafter(f64(0.1f), 1.0), 0, 19));
     }
 
     TEST_METHOD(ProcessRemainActiveBuffer)
@@ -138,6 +179,7 @@ namespace Chord
         .m_byteCount = bufferMemory.Count(),
         .m_memory = bufferMemory.Elements(),
         .m_isConstant = false,
+        .m_constantValueMemory = bufferMemory.Elements(),
       };
 
       bufferMemory[0] = 0xff;
@@ -179,6 +221,124 @@ namespace Chord
       EXPECT(!ProcessRemainActiveOutput(buffer, 32));
     }
 
+    TEST_METHOD(ProcessRemainActiveBufferVectorized)
+    {
+      // Long enough to cover whole vectors of bytes followed by leftover bytes and a partial byte
+      FixedArray<u8, 100> bufferMemory;
+      BufferManager::Buffer buffer =
+      {
+        .m_primitiveType = PrimitiveTypeBool,
+        .m_upsampleFactor = 1,
+        .m_byteCount = bufferMemory.Count(),
+        .m_memory = bufferMemory.Elements(),
+        .m_isConstant = false,
+      };
+
+      static constexpr usz SampleCount = 99 * 8 + 3;
+      Span<u8>(bufferMemory).Fill(0xff_u8);
+      EXPECT(ProcessRemainActiveOutput(buffer, SampleCount));
+
+      for (usz byteIndex = 0; byteIndex < 99; byteIndex++)
+      {
+        bufferMemory[byteIndex] = 0x7f;
+        EXPECT(!ProcessRemainActiveOutput(buffer, SampleCount));
+        bufferMemory[byteIndex] = 0xff;
+      }
+
+      bufferMemory[99] = 0x07;
+      EXPECT(ProcessRemainActiveOutput(buffer, SampleCount));
+      EXPECT(!ProcessRemainActiveOutput(buffer, SampleCount + 1));
+    }
+
+    TEST_METHOD(MeasureSamples)
+    {
+      FixedArray<f32, 19> samples;
+      for (usz i = 0; i < samples.Count(); i++)
+        { samples[i] = (i % 2 == 0) ? 0.5f : -0.5f; }
+      samples[17] = -0.75f;
+
+      SampleStatistics statistics = MeasureSamples(Span<const f32>(samples));
+      EXPECT(statistics.m_peak == 0.75);
+      EXPECT(statistics.m_sampleCount == 19);
+      EXPECT(statistics.m_sumOfSquares == 18.0 * 0.25 + 0.5625);
+
+      samples[3] = -1.0f;
+      statistics = MeasureSamples(Span<const f32>(samples));
+      EXPECT(statistics.m_peak == 1.0);
+
+      // 2^24 + 1 isn't representable in f32 so the small squares would be dropped if they were accumulated at f32 precision
+      FixedArray<f32, 64> wideRangeSamples;
+      for (usz i = 0; i < wideRangeSamples.Count(); i++)
+        { wideRangeSamples[i] = (i < 32) ? 4096.0f : 1.0f; }
+
+      statistics = MeasureSamples(Span<const f32>(wideRangeSamples));
+      EXPECT(statistics.m_sumOfSquares == 32.0 * 4096.0 * 4096.0 + 32.0);
+
+      SampleStatistics combined;
+      combined.Combine({ .m_peak = 0.5, .m_sumOfSquares = 1.0, .m_sampleCount = 4 });
+      combined.Combine({ .m_peak = 0.25, .m_sumOfSquares = 3.0, .m_sampleCount = 12 });
+      EXPECT(combined.m_peak == 0.5);
+      EXPECT(combined.GetRms() == 0.5);
+
+      // Interleaved integer input is measured after normalization
+      static constexpr s16 Int16Frames[] = { 16384, 0, -32768, 0, 8192, 0 };
+      FixedArray<InputChannelBuffer, 2> channelBuffers;
+      GetInterleavedChannelBuffers(SampleType::Int16, Span(reinterpret_cast<const u8*>(Int16Frames), sizeof(Int16Frames)), Span<InputChannelBuffer>(channelBuffers));
+
+      SampleStatistics inputStatistics = MeasureInputChannelBuffer(channelBuffers[0], 0, 3);
+      EXPECT(inputStatistics.m_peak == 1.0);
+      EXPECT(inputStatistics.m_sumOfSquares == 0.25 + 1.0 + 0.0625);
+      EXPECT(MeasureInputChannelBuffer(channelBuffers[1], 0, 3).m_peak == 0.0);
+      EXPECT(MeasureInputChannelBuffer(channelBuffers[0], 2, 1).m_peak == 0.25);
+    }
+
+    TEST_METHOD(ExpandConstantBuffer)
+    {
+      {
+        FixedArray<f32, 8> bufferMemory;
+        bufferMemory.ZeroElements();
+        FixedArray<f32, BufferConstantValueByteCount / sizeof(f32)> constantValueMemory;
+        constantValueMemory.Fill(3.0f);
+        BufferManager::Buffer buffer =
+        {
+          .m_primitiveType = PrimitiveTypeFloat,
+          .m_upsampleFactor = 1,
+          .m_byteCount = bufferMemory.Count() * sizeof(f32),
+          .m_memory = bufferMemory.Elements(),
+          .m_isConstant = true,
+          .m_constantValueMemory = constantValueMemory.Elements(),
+        };
+
+        ExpandConstantBuffer(buffer, 6);
+        EXPECT(bufferMemory[0] == 3.0f);
+        EXPECT(bufferMemory[5] == 3.0f);
+        EXPECT(bufferMemory[6] == 0.0f);
+        EXPECT(bufferMemory[7] == 0.0f);
+      }
+
+      {
+        FixedArray<u8, 4> bufferMemory;
+        bufferMemory.ZeroElements();
+        FixedArray<u8, BufferConstantValueByteCount> constantValueMemory;
+        constantValueMemory.Fill(0xff);
+        BufferManager::Buffer buffer =
+        {
+          .m_primitiveType = PrimitiveTypeBool,
+          .m_upsampleFactor = 1,
+          .m_byteCount = bufferMemory.Count(),
+          .m_memory = bufferMemory.Elements(),
+          .m_isConstant = true,
+          .m_constantValueMemory = constantValueMemory.Elements(),
+        };
+
+        ExpandConstantBuffer(buffer, 16);
+        EXPECT(bufferMemory[0] == 0xff);
+        EXPECT(bufferMemory[1] == 0xff);
+        EXPECT(bufferMemory[2] == 0x00);
+        EXPECT(bufferMemory[3] == 0x00);
+      }
+    }
+
     TEST_METHOD(AccumulateToBuffer)
     {
       auto Run =
@@ -228,7 +388,7 @@ namespace Chord
           {
             FixedArray<TElement, 8> destination;
 
-            AccumulateToBuffer(Span<TElement>(destination), buffer, true, 3);
+            AccumulateToBuffer(Span<TElement>(destination), buffer, true, 3, static_cast<TElement*>(nullptr));
 
             EXPECT(destination[0] == TElement(0));
             EXPECT(destination[1] == TElement(0));
@@ -244,8 +404,10 @@ namespace Chord
             FixedArray<TElement, 8> destination;
             destination.ZeroElements();
 
-            AccumulateToBuffer(Span<TElement>(destination), buffer, false, 3);
+            TElement peakLevel = TElement(0);
+            AccumulateToBuffer(Span<TElement>(destination), buffer, false, 3, &peakLevel);
 
+            EXPECT(peakLevel == TElement(5));
             EXPECT(destination[0] == TElement(0));
             EXPECT(destination[1] == TElement(0));
             EXPECT(destination[2] == TElement(0));
@@ -255,6 +417,194 @@ namespace Chord
             EXPECT(destination[6] == TElement(4));
             EXPECT(destination[7] == TElement(5));
           }
+
+          {
+            // Constant buffers are broadcast from their tracked constant value rather than read from buffer memory
+            FixedArray<TElement, BufferConstantValueByteCount / sizeof(TElement)> constantValueMemory;
+            constantValueMemory.Fill(TElement(7));
+            BufferManager::Buffer constantBuffer = buffer;
+            constantBuffer.m_isConstant = true;
+            constantBuffer.m_constantValueMemory = constantValueMemory.Elements();
+
+            FixedArray<TElement, 8> destination;
+            destination.Fill(TElement(1));
+
+            TElement peakLevel = TElement(0);
+            AccumulateToBuffer(Span<TElement>(destination), constantBuffer, false, 3, &peakLevel);
+
+            EXPECT(peakLevel == TElement(7));
+            EXPECT(destination[0] == TElement(1));
+            EXPECT(destination[1] == TElement(1));
+            EXPECT(destination[2] == TElement(1));
+            EXPECT(destination[3] == TElement(8));
+            EXPECT(destination[4] == TElement(8));
+            EXPECT(destination[5] == TElement(8));
+            EXPECT(destination[6] == TElement(8));
+            EXPECT(destination[7] == TElement(8));
+          }
+        };
+
+      Run.operator()<f32>(PrimitiveTypeFloat);
+      Run.operator()<f64>(PrimitiveTypeDouble);
+      Run.operator()<s32>(PrimitiveTypeInt);
+    }
+
+    TEST_METHOD(AddSamples)
+    {
+      auto Run =
+        []<typename TElement>()
+        {
+          // Cover the aligned vector path with a scalar tail as well as the unaligned fallback
+          alignas(MaxSimdAlignment) FixedArray<TElement, 35> destination;
+          alignas(MaxSimdAlignment) FixedArray<TElement, 35> source;
+          for (usz i = 0; i < source.Count(); i++)
+          {
+            destination[i] = TElement(i);
+            source[i] = TElement(2);
+          }
+
+          AddSamples(Span<TElement>(destination), Span<const TElement>(source));
+          for (usz i = 0; i < destination.Count(); i++)
+            { EXPECT(destination[i] == TElement(i + 2)); }
+
+          AddSamples(Span<TElement>(destination, 1, 34), Span<const TElement>(source, 0, 34));
+          EXPECT(destination[0] == TElement(2));
+          for (usz i = 1; i < destination.Count(); i++)
+            { EXPECT(destination[i] == TElement(i + 4)); }
+        };
+
+      Run.operator()<f32>();
+      Run.operator()<f64>();
+      Run.operator()<s32>();
+    }
+
+    TEST_METHOD(AccumulateSamplesMeasuringPeak)
+    {
+      auto Run =
+        []<typename TElement>()
+        {
+          // Cover the aligned vector path with a scalar tail as well as the unaligned fallback. The peak is a negative sample in the middle of the vector path.
+          alignas(MaxSimdAlignment) FixedArray<TElement, 35> destination;
+          alignas(MaxSimdAlignment) FixedArray<TElement, 35> source;
+          for (usz i = 0; i < source.Count(); i++)
+          {
+            destination[i] = TElement(i);
+            source[i] = TElement(i % 3);
+          }
+
+          source[17] = TElement(-9);
+
+          TElement peak = AccumulateSamplesMeasuringPeak(Span<TElement>(destination), Span<const TElement>(source), true);
+          EXPECT(peak == TElement(9));
+          for (usz i = 0; i < destination.Count(); i++)
+            { EXPECT(destination[i] == source[i]); }
+
+          source[34] = TElement(11);
+          peak = AccumulateSamplesMeasuringPeak(Span<TElement>(destination, 1, 34), Span<const TElement>(source, 1, 34), false);
+          EXPECT(peak == TElement(11));
+          EXPECT(destination[0] == TElement(0));
+          for (usz i = 1; i < destination.Count(); i++)
+            { EXPECT(destination[i] == (i == 34 ? TElement(i % 3) + TElement(11) : source[i] + source[i])); }
+        };
+
+      Run.operator()<f32>();
+      Run.operator()<f64>();
+      Run.operator()<s32>();
+    }
+
+    TEST_METHOD(AccumulateToBufferFadingOut)
+    {
+      auto Run =
+        []<typename TElement>(PrimitiveType primitiveType)
+        {
+          FixedArray<TElement, 4> bufferMemory = { TElement(4), TElement(4), TElement(4), TElement(4) };
+          BufferManager::Buffer buffer =
+          {
+            .m_primitiveType = primitiveType,
+            .m_upsampleFactor = 1,
+            .m_byteCount = bufferMemory.Count() * sizeof(TElement),
+            .m_memory = bufferMemory.Elements(),
+            .m_isConstant = false,
+          };
+
+          {
+            FixedArray<TElement, 8> destination;
+            destination.Fill(TElement(1));
+
+            AccumulateToBufferFadingOut(Span<TElement>(destination), TElement(8), true, 4);
+
+            EXPECT(destination[0] == TElement(0));
+            EXPECT(destination[3] == TElement(0));
+            EXPECT(destination[4] == TElement(6));
+            EXPECT(destination[5] == TElement(4));
+            EXPECT(destination[6] == TElement(2));
+            EXPECT(destination[7] == TElement(0));
+          }
+
+          {
+            FixedArray<TElement, 8> destination;
+            destination.Fill(TElement(1));
+
+            // The peak level is measured before the fade is applied
+            TElement peakLevel = TElement(0);
+            AccumulateToBufferFadingOut(Span<TElement>(destination), buffer, false, 4, &peakLevel);
+
+            EXPECT(peakLevel == TElement(4));
+            EXPECT(destination[0] == TElement(1));
+            EXPECT(destination[3] == TElement(1));
+            EXPECT(destination[4] == TElement(4));
+            EXPECT(destination[5] == TElement(3));
+            EXPECT(destination[6] == TElement(2));
+            EXPECT(destination[7] == TElement(1));
+          }
+        };
+
+      Run.operator()<f32>(PrimitiveTypeFloat);
+      Run.operator()<f64>(PrimitiveTypeDouble);
+    }
+
+    TEST_METHOD(ReducePartialSums)
+    {
+      auto Run =
+        []<typename TElement>(PrimitiveType primitiveType)
+        {
+          FixedArray<TElement, 12> partialSumMemory =
+          {
+            TElement(1), TElement(2), TElement(3), TElement(4),
+            TElement(10), TElement(20), TElement(30), TElement(40),
+            TElement(100), TElement(200), TElement(300), TElement(400),
+          };
+          FixedArray<BufferManager::Buffer, 3> partialSums;
+          for (usz i = 0; i < partialSums.Count(); i++)
+          {
+            partialSums[i] =
+            {
+              .m_primitiveType = primitiveType,
+              .m_upsampleFactor = 1,
+              .m_byteCount = 4 * sizeof(TElement),
+              .m_memory = partialSumMemory.Elements() + i * 4,
+              .m_isConstant = false,
+            };
+          }
+
+          {
+            FixedArray<TElement, 4> destination;
+            FixedArray<bool, 3> partialSumsAccumulated = { true, false, true };
+            EXPECT(ReducePartialSums(Span<TElement>(destination), Span<const BufferManager::Buffer>(partialSums), Span<const bool>(partialSumsAccumulated)));
+            EXPECT(destination[0] == TElement(101));
+            EXPECT(destination[1] == TElement(202));
+            EXPECT(destination[2] == TElement(303));
+            EXPECT(destination[3] == TElement(404));
+          }
+
+          {
+            FixedArray<TElement, 4> destination;
+            destination.Fill(TElement(7));
+            FixedArray<bool, 3> partialSumsAccumulated = { false, false, false };
+            EXPECT(!ReducePartialSums(Span<TElement>(destination), Span<const BufferManager::Buffer>(partialSums), Span<const bool>(partialSumsAccumulated)));
+            EXPECT(destination[0] == TElement(7));
+            EXPECT(destination[3] == TElement(7));
+          }
         };
 
       Run.operator()<f32>(PrimitiveTypeFloat);
@@ -314,7 +664,7 @@ namespace Chord
 
           {
             outputChannelBufferMemory.ZeroElements();
-            FillOutputChannelBuffer(outputChannelBuffer, sourceBuffer, 2, 4);
+            FillOutputChannelBuffer(outputChannelBuffer, sourceBuffer, 2, 4, nullptr);
 
             EXPECT(outputChannelBufferMemory[0] == TDestination(0));
             EXPECT(outputChannelBufferMemory[1] == TDestination(0));
@@ -332,5 +682,170 @@ namespace Chord
       Run.operator()<f64, f32>(PrimitiveTypeDouble, SampleType::Float32);
       Run.operator()<f64, f64>(PrimitiveTypeDouble, SampleType::Float64);
     }
+
+    TEST_METHOD(InitializeFromInterleavedInputChannelBuffer)
+    {
+      // Two interleaved int16 channels
+      static constexpr s16 Int16Frames[] = { 0, 1, 16384, 2, -32768, 3, 32767, 4, -16384, 5, 8192, 6 };
+      FixedArray<InputChannelBuffer, 2> int16ChannelBuffers;
+      GetInterleavedChannelBuffers(
+        SampleType::Int16,
+        Span(reinterpret_cast<const u8*>(Int16Frames), sizeof(Int16Frames)),
+        Span<InputChannelBuffer>(int16ChannelBuffers));
+
+      EXPECT(int16ChannelBuffers[1].m_sampleStride == 2);
+      EXPECT(int16ChannelBuffers[1].m_samples.Count() == sizeof(Int16Frames) - sizeof(s16));
+
+      FixedArray<f32, 5> floatMemory;
+      BufferManager::Buffer floatBuffer =
+      {
+        .m_primitiveType = PrimitiveTypeFloat,
+        .m_upsampleFactor = 1,
+        .m_byteCount = floatMemory.Count() * sizeof(f32),
+        .m_memory = floatMemory.Elements(),
+        .m_isConstant = false,
+      };
+
+      InitializeFromInputChannelBuffer<f32>(int16ChannelBuffers[0], floatBuffer, 1, 5);
+      EXPECT(floatMemory[0] == 0.5f);
+      EXPECT(floatMemory[1] == -1.0f);
+      EXPECT(floatMemory[2] == 32767.0f / 32768.0f);
+      EXPECT(floatMemory[3] == -0.5f);
+      EXPECT(floatMemory[4] == 0.25f);
+
+      InitializeFromInputChannelBuffer<f32>(int16ChannelBuffers[1], floatBuffer, 1, 5);
+      EXPECT(floatMemory[0] == 2.0f / 32768.0f);
+      EXPECT(floatMemory[4] == 6.0f / 32768.0f);
+
+      // Packed little-endian int24 samples: 0.5, -2 LSB, -1.0, and a single interleaved channel of 3
+      static constexpr u8 Int24Frames[] =
+      {
+        0x00, 0x00, 0x40, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xfe, 0xff, 0xff, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0x00, 0x00, 0x80, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+      };
+
+      InputChannelBuffer int24ChannelBuffer =
+      {
+        .m_sampleType = SampleType::Int24,
+        .m_samples = Span<const u8>(Int24Frames, ArrayLength(Int24Frames) - 6),
+        .m_sampleStride = 3,
+      };
+
+      FixedArray<f64, 3> doubleMemory;
+      BufferManager::Buffer doubleBuffer =
+      {
+        .m_primitiveType = PrimitiveTypeDouble,
+        .m_upsampleFactor = 1,
+        .m_byteCount = doubleMemory.Count() * sizeof(f64),
+        .m_memory = doubleMemory.Elements(),
+        .m_isConstant = false,
+      };
+
+      InitializeFromInputChannelBuffer<f64>(int24ChannelBuffer, doubleBuffer, 0, 3);
+      EXPECT(doubleMemory[0] == 0.5);
+      EXPECT(doubleMemory[1] == -2.0 / 8388608.0);
+      EXPECT(doubleMemory[2] == -1.0);
+
+      static constexpr s32 Int32Samples[] = { 1 << 30, -(1 << 30), 0x7fffffff };
+      InputChannelBuffer int32ChannelBuffer =
+      {
+        .m_sampleType = SampleType::Int32,
+        .m_samples = Span(reinterpret_cast<const u8*>(Int32Samples), sizeof(Int32Samples)),
+      };
+
+      InitializeFromInputChannelBuffer<f64>(int32ChannelBuffer, doubleBuffer, 0, 3);
+      EXPECT(doubleMemory[0] == 0.5);
+      EXPECT(doubleMemory[1] == -0.5);
+      EXPECT(doubleMemory[2] == 2147483647.0 / 2147483648.0);
+
+      static constexpr f32 FloatFrames[] = { 1.0f, -1.0f, 2.0f, -2.0f, 3.0f, -3.0f };
+      FixedArray<InputChannelBuffer, 2> floatChannelBuffers;
+      GetInterleavedChannelBuffers(
+        SampleType::Float32,
+        Span(reinterpret_cast<const u8*>(FloatFrames), sizeof(FloatFrames)),
+        Span<InputChannelBuffer>(floatChannelBuffers));
+
+      InitializeFromInputChannelBuffer<f64>(floatChannelBuffers[1], doubleBuffer, 0, 3);
+      EXPECT(doubleMemory[0] == -1.0);
+      EXPECT(doubleMemory[1] == -2.0);
+      EXPECT(doubleMemory[2] == -3.0);
+
+      EXPECT(ShouldActivateEffect(int16ChannelBuffers[0], 0.99, 0, 6));
+      EXPECT(!ShouldActivateEffect(int16ChannelBuffers[0], 1.0, 0, 6));
+      EXPECT(!ShouldActivateEffect(int16ChannelBuffers[1], 6.0 / 32768.0, 0, 6));
+      EXPECT(ShouldActivateEffect(floatChannelBuffers[1], 2.5, 0, 3));
+      EXPECT(!ShouldActivateEffect(floatChannelBuffers[1], 2.5, 0, 2));
+    }
+
+    TEST_METHOD(WriteInterleavedOutputChannelBuffer)
+    {
+      static constexpr f32 Samples[] = { 0.5f, -1.0f, 2.0f, -2.0f, 0.25f, 1.0f / 8388608.0f, 0.0f };
+
+      // Two interleaved int24 channels, filling only the first
+      FixedArray<u8, ArrayLength(Samples) * 2 * 3> int24Frames;
+      int24Frames.ZeroElements();
+      FixedArray<OutputChannelBuffer, 2> int24ChannelBuffers;
+      GetInterleavedChannelBuffers(SampleType::Int24, Span<u8>(int24Frames), Span<OutputChannelBuffer>(int24ChannelBuffers));
+      WriteOutputChannelBufferSamples(int24ChannelBuffers[0], Span<const f32>(Samples), 0, nullptr);
+
+      static constexpr s32 ExpectedInt24Samples[] = { 0x400000, -0x800000, 0x7fffff, -0x800000, 0x200000, 1, 0 };
+      for (usz i = 0; i < ArrayLength(Samples); i++)
+      {
+        EXPECT(ReadIntegerSample<SampleType::Int24>(&int24Frames[i * 6]) == ExpectedInt24Samples[i]);
+        EXPECT(ReadIntegerSample<SampleType::Int24>(&int24Frames[i * 6 + 3]) == 0);
+      }
+
+      // Int32 clamps exactly at full scale
+      FixedArray<s32, ArrayLength(Samples)> int32Samples;
+      OutputChannelBuffer int32ChannelBuffer =
+      {
+        .m_sampleType = SampleType::Int32,
+        .m_samples = Span(reinterpret_cast<u8*>(int32Samples.Elements()), int32Samples.Count() * sizeof(s32)),
+      };
+
+      WriteOutputChannelBufferSamples(int32ChannelBuffer, Span<const f32>(Samples), 0, nullptr);
+      EXPECT(int32Samples[0] == 1 << 30);
+      EXPECT(int32Samples[1] == std::numeric_limits<s32>::min());
+      EXPECT(int32Samples[2] == std::numeric_limits<s32>::max());
+      EXPECT(int32Samples[3] == std::numeric_limits<s32>::min());
+      EXPECT(int32Samples[5] == 256);
+
+      // Dithered samples land within 1 LSB of the undithered samples
+      FixedArray<s16, 64> ditheredSamples;
+      FixedArray<f64, 64> sourceSamples;
+      for (usz i = 0; i < sourceSamples.Count(); i++)
+        { sourceSamples[i] = f64(s32(i) - 32) / 64.0; }
+      OutputChannelBuffer int16ChannelBuffer =
+      {
+        .m_sampleType = SampleType::Int16,
+        .m_samples = Span(reinterpret_cast<u8*>(ditheredSamples.Elements()), ditheredSamples.Count() * sizeof(s16)),
+      };
+
+      u32 ditherState = 1;
+      WriteOutputChannelBufferSamples(int16ChannelBuffer, Span<const f64>(sourceSamples), 0, &ditherState);
+      EXPECT(ditherState != 1);
+      for (usz i = 0; i < sourceSamples.Count(); i++)
+        { EXPECT(Abs(f64(ditheredSamples[i]) - sourceSamples[i] * 32768.0) <= 1.0); }
+
+      // Constant values are converted once and written to every sample of the channel
+      FixedArray<s16, 8> int16Frames;
+      int16Frames.ZeroElements();
+      FixedArray<OutputChannelBuffer, 2> int16ChannelBuffers;
+      GetInterleavedChannelBuffers(
+        SampleType::Int16,
+        Span(reinterpret_cast<u8*>(int16Frames.Elements()), int16Frames.Count() * sizeof(s16)),
+        Span<OutputChannelBuffer>(int16ChannelBuffers));
+      FillOutputChannelBuffer(int16ChannelBuffers[1], -0.5f, 1, 2);
+
+      EXPECT(int16Frames[0] == 0);
+      EXPECT(int16Frames[1] == 0);
+      EXPECT(int16Frames[2] == 0);
+      EXPECT(int16Frames[3] == -16384);
+      EXPECT(int16Frames[4] == 0);
+      EXPECT(int16Frames[5] == -16384);
+      EXPECT(int16Frames[6] == 0);
+      EXPECT(int16Frames[7] == 0);
+    }
   };
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+module Chord.Tests;
+
+import std;
+
+import Chord.Engine;
+import Chord.Foundation;
+import :Test;
+import :TestUtilities.Benchmark;
+
+namespace Chord
+{
+  // Compares the vectorized channel I/O and accumulation kernels against the scalar loops they replaced. Host buffers are offset by one sample so that the
+  // unaligned head and tail paths are included.
+  BENCHMARK_CLASS(BufferOperationsBenchmark)
+  {
+    static constexpr usz SampleCount = 1024;
+    static constexpr usz IterationCount = 2000;
+
+    TEST_METHOD(ConvertSamples)
+    {
+      auto Run =
+        []<typename TDestination, typename TSource>(const char* name)
+        {
+          FixedArray<TSource> source = InitializeCapacity(SampleCount + 1);
+          for (usz i = 0; i < source.Count(); i++)
+            { source[i] = TSource(i % 64) / TSource(64); }
+
+          FixedArray<TDestination> scalarDestination = InitializeCapacity(SampleCount);
+          FixedArray<TDestination> vectorizedDestination = InitializeCapacity(SampleCount);
+          Span<const TSource> offsetSource = { source, 1, SampleCount };
+
+          f64 baselineNanoseconds = MeasureAverageNanoseconds(
+            IterationCount,
+            [&]()
+            {
+              for (usz i = 0; i < SampleCount; i++)
+                { scalarDestination[i] = TDestination(offsetSource[i]); }
+            });
+
+          f64 optimizedNanoseconds = MeasureAverageNanoseconds(
+            IterationCount,
+            [&]() { ::Chord::ConvertSamples(Span<TDestination>(vectorizedDestination), offsetSource); });
+
+          for (usz i = 0; i < SampleCount; i++)
+            { EXPECT(scalarDestination[i] == vectorizedDestination[i]); }
+
+          ReportBenchmark(name, baselineNanoseconds, optimizedNanoseconds);
+        };
+
+      Run.operator()<f32, f64>("f64 to f32");
+      Run.operator()<f64, f32>("f32 to f64");
+    }
+
+    TEST_METHOD(AddSamples)
+    {
+      auto Run =
+        []<typename TElement>(const char* name)
+        {
+          FixedArray<TElement> source = InitializeCapacity(SampleCount);
+          for (usz i = 0; i < source.Count(); i++)
+            { source[i] = TElement(i % 16); }
+
+          FixedArray<TElement> scalarDestination(SampleCount, TElement(0));
+          FixedArray<TElement> vectorizedDestination(SampleCount, TElement(0));
+
+          f64 baselineNanoseconds = MeasureAverageNanoseconds(
+            IterationCount,
+            [&]()
+            {
+              for (usz i = 0; i < SampleCount; i++)
+                { scalarDestination[i] += source[i]; }
+            });
+
+          f64 optimizedNanoseconds = MeasureAverageNanoseconds(
+            IterationCount,
+            [&]() { ::Chord::AddSamples(Span<TElement>(vectorizedDestination), Span<const TElement>(source)); });
+
+          for (usz i = 0; i < SampleCount; i++)
+            { EXPECT(scalarDestination[i] == vectorizedDestination[i]); }
+
+          ReportBenchmark(name, baselineNanoseconds, optimizedNanoseconds);
+        };
+
+      Run.operator()<f32>("f32");
+      Run.operator()<f64>("f64");
+      Run.operator()<s32>("s32");
+    }
+
+    TEST_METHOD(ShouldActivateEffect)
+    {
+      auto Run =
+        []<typename TElement>(SampleType sampleType, const char* name)
+        {
+          // Silence is the worst case because every sample must be scanned
+          FixedArray<TElement> samples(SampleCount + 1, TElement(0));
+          InputChannelBuffer inputChannelBuffer =
+          {
+            .m_sampleType = sampleType,
+            .m_samples = Span(reinterpret_cast<const u8*>(samples.Elements()), samples.Count() * sizeof(TElement)),
+          };
+
+          f64 threshold = 0.001;
+          bool scalarResult = false;
+          f64 baselineNanoseconds = MeasureAverageNanoseconds(
+            IterationCount,
+            [&]()
+            {
+              scalarResult = false;
+              for (usz i = 1; i <= SampleCount; i++)
+              {
+                if (Abs(samples[i]) > threshold)
+                {
+                  scalarResult = true;
+                  break;
+                }
+              }
+            });
+
+          bool vectorizedResult = true;
+          f64 optimizedNanoseconds = MeasureAverageNanoseconds(
+            IterationCount,
+            [&]() { vectorizedResult = ::Chord::ShouldActivateEffect(inputChannelBuffer, threshold, 1, SampleCount); });
+
+          EXPECT(scalarResult == vectorizedResult);
+          ReportBenchmark(name, baselineNanoseconds, optimizedNanoseconds);
+        };
+
+      Run.operator()<f32>(SampleType::Float32, "f32");
+      Run.operator()<f64>(SampleType::Float64, "f64");
+    }
+  };
+}
\ No newline at end of file
@@ -32,26 +32,14 @@ namespace Chord
 
     TEST_METHOD(EnsureFloatConstantArray)
     {
-      ConstantArray<FloatConstantProgramGraphNode, f32> arrayA = { 3 };
-      arrayA.AddValue(1.0f);
-      arrayA.AddValue(2.0f);
-      arrayA.AddValue(3.0f);
-
-      ConstantArray<FloatConstantProgramGraphNode, f32> arrayB = { 4 };
-      arrayB.AddValue(4.0f);
-      arrayB.AddValue(5.0f);
-      arrayB.AddValue(6.0f);
-      arrayB.AddValue(7.0f);
-
-      ConstantArray<FloatConstantProgramGraphNode, f32> arrayC = { 3 };
-      arrayC.AddValue(1.0f);
-      arrayC.AddValue(2.0f);
-      arrayC.AddValue(3.0f);
+      FixedArray<f32> arrayA({ 1.0f, 2.0f, 3.0f });
+      FixedArray<f32> arrayB({ 4.0f, 5.0f, 6.0f, 7.0f });
+      FixedArray<f32> arrayC({ 1.0f, 2.0f, 3.0f });
 
       ConstantManager cm;
-      auto constantArrayA = cm.EnsureFloatConstantArray(&arrayA.m_array);
-      auto constantArrayB = cm.EnsureFloatConstantArray(&arrayB.m_array);
-      auto constantArrayC = cm.EnsureFloatConstantArray(&arrayC.m_array);
+      auto constantArrayA = cm.EnsureFloatConstantArray(arrayA);
+      auto constantArrayB = cm.EnsureFloatConstantArray(arrayB);
+      auto constantArrayC = cm.EnsureFloatConstantArray(arrayC);
 
       EXPECT(constantArrayA.m_elements != constantArrayB.m_elements);
       EXPECT(constantArrayA.m_elements == constantArrayC.m_elements);
@@ -75,26 +63,14 @@ namespace Chord
 
     TEST_METHOD(EnsureDoubleConstantArray)
     {
-      ConstantArray<DoubleConstantProgramGraphNode, f64> arrayA = { 3 };
-      arrayA.AddValue(1.0);
-      arrayA.AddValue(2.0);
-      arrayA.AddValue(3.0);
-
-      ConstantArray<DoubleConstantProgramGraphNode, f64> arrayB = { 4 };
-      arrayB.AddValue(4.0);
-      arrayB.AddValue(5.0);
-      arrayB.AddValue(6.0);
-      arrayB.AddValue(7.0);
-
-      ConstantArray<DoubleConstantProgramGraphNode, f64> arrayC = { 3 };
-      arrayC.AddValue(1.0);
-      arrayC.AddValue(2.0);
-      arrayC.AddValue(3.0);
+      FixedArray<f64> arrayA({ 1.0, 2.0, 3.0 });
+      FixedArray<f64> arrayB({ 4.0, 5.0, 6.0, 7.0 });
+      FixedArray<f64> arrayC({ 1.0, 2.0, 3.0 });
 
       ConstantManager cm;
-      auto constantArrayA = cm.EnsureDoubleConstantArray(&arrayA.m_array);
-      auto constantArrayB = cm.EnsureDoubleConstantArray(&arrayB.m_array);
-      auto constantArrayC = cm.EnsureDoubleConstantArray(&arrayC.m_array);
+      auto constantArrayA = cm.EnsureDoubleConstantArray(arrayA);
+      auto constantArrayB = cm.EnsureDoubleConstantArray(arrayB);
+      auto constantArrayC = cm.EnsureDoubleConstantArray(arrayC);
 
       EXPECT(constantArrayA.m_elements != constantArrayB.m_elements);
       EXPECT(constantArrayA.m_elements == constantArrayC.m_elements);
@@ -118,26 +94,14 @@ namespace Chord
 
     TEST_METHOD(EnsureIntConstantArray)
     {
-      ConstantArray<IntConstantProgramGraphNode, s32> arrayA = { 3 };
-      arrayA.AddValue(1);
-      arrayA.AddValue(2);
-      arrayA.AddValue(3);
-
-      ConstantArray<IntConstantProgramGraphNode, s32> arrayB = { 4 };
-      arrayB.AddValue(4);
-      arrayB.AddValue(5);
-      arrayB.AddValue(6);
-      arrayB.AddValue(7);
-
-      ConstantArray<IntConstantProgramGraphNode, s32> arrayC = { 3 };
-      arrayC.AddValue(1);
-      arrayC.AddValue(2);
-      arrayC.AddValue(3);
+      FixedArray<s32> arrayA({ 1, 2, 3 });
+      FixedArray<s32> arrayB({ 4, 5, 6, 7 });
+      FixedArray<s32> arrayC({ 1, 2, 3 });
 
       ConstantManager cm;
-      auto constantArrayA = cm.EnsureIntConstantArray(&arrayA.m_array);
-      auto constantArrayB = cm.EnsureIntConstantArray(&arrayB.m_array);
-      auto constantArrayC = cm.EnsureIntConstantArray(&arrayC.m_array);
+      auto constantArrayA = cm.EnsureIntConstantArray(arrayA);
+      auto constantArrayB = cm.EnsureIntConstantArray(arrayB);
+      auto constantArrayC = cm.EnsureIntConstantArray(arrayC);
 
       EXPECT(constantArrayA.m_elements != constantArrayB.m_elements);
       EXPECT(constantArrayA.m_elements == constantArrayC.m_elements);
@@ -161,26 +125,14 @@ namespace Chord
 
     TEST_METHOD(EnsureBoolConstantArray)
     {
-      ConstantArray<BoolConstantProgramGraphNode, bool> arrayA = { 3 };
-      arrayA.AddValue(true);
-      arrayA.AddValue(false);
-      arrayA.AddValue(true);
-
-      ConstantArray<BoolConstantProgramGraphNode, bool> arrayB = { 4 };
-      arrayB.AddValue(false);
-      arrayB.AddValue(false);
-      arrayB.AddValue(true);
-      arrayB.AddValue(true);
-
-      ConstantArray<BoolConstantProgramGraphNode, bool> arrayC = { 3 };
-      arrayC.AddValue(true);
-      arrayC.AddValue(false);
-      arrayC.AddValue(true);
+      FixedArray<bool> arrayA({ true, false, true });
+      FixedArray<bool> arrayB({ false, false, true, true });
+      FixedArray<bool> arrayC({ true, false, true });
 
       ConstantManager cm;
-      auto constantArrayA = cm.EnsureBoolConstantArray(&arrayA.m_array);
-      auto constantArrayB = cm.EnsureBoolConstantArray(&arrayB.m_array);
-      auto constantArrayC = cm.EnsureBoolConstantArray(&arrayC.m_array);
+      auto constantArrayA = cm.EnsureBoolConstantArray(arrayA);
+      auto constantArrayB = cm.EnsureBoolConstantArray(arrayB);
+      auto constantArrayC = cm.EnsureBoolConstantArray(arrayC);
 
       EXPECT(constantArrayA.m_elements != constantArrayB.m_elements);
       EXPECT(constantArrayA.m_elements == constantArrayC.m_elements);
@@ -245,6 +197,72 @@ namespace Chord
       EXPECT(UnicodeString(Unmanaged, Span(constantArrayC.m_elements[2].m_value, constantArrayC.m_elements[2].m_length)) == "def");
     }
 
+    TEST_METHOD(EnsureConstantArrayDifferentContent)
+    {
+      // These arrays have matching counts and differ in a single element so they're only told apart by comparing content
+      FixedArray<f32> floatArrayA({ 1.0f, 2.0f, 3.0f, 4.0f });
+      FixedArray<f32> floatArrayB({ 1.0f, 2.0f, 3.0f, 5.0f });
+      FixedArray<f64> doubleArrayA({ 1.0, 2.0, 3.0, 4.0 });
+      FixedArray<f64> doubleArrayB({ 1.0, 2.0, 5.0, 4.0 });
+      FixedArray<s32> intArrayA({ 1, 2, 3, 4 });
+      FixedArray<s32> intArrayB({ 0, 2, 3, 4 });
+      FixedArray<bool> boolArrayA({ true, false, true, false });
+      FixedArray<bool> boolArrayB({ true, false, true, true });
+
+      ConstantManager cm;
+      EXPECT(cm.EnsureFloatConstantArray(floatArrayA).m_elements != cm.EnsureFloatConstantArray(floatArrayB).m_elements);
+      EXPECT(cm.EnsureDoubleConstantArray(doubleArrayA).m_elements != cm.EnsureDoubleConstantArray(doubleArrayB).m_elements);
+      EXPECT(cm.EnsureIntConstantArray(intArrayA).m_elements != cm.EnsureIntConstantArray(intArrayB).m_elements);
+      EXPECT(cm.EnsureBoolConstantArray(boolArrayA).m_elements != cm.EnsureBoolConstantArray(boolArrayB).m_elements);
+
+      auto floatConstantArrayB = cm.EnsureFloatConstantArray(floatArrayB);
+      EXPECT(floatConstantArrayB.m_elements[3] == 5.0f);
+    }
+
+    TEST_METHOD(EnsureStringConstantArrayDifferentElement)
+    {
+      ConstantArray<StringConstantProgramGraphNode, UnicodeString> arrayA = { 3 };
+      arrayA.AddValue(UnicodeString("a"));
+      arrayA.AddValue(UnicodeString("bc"));
+      arrayA.AddValue(UnicodeString("def"));
+
+      ConstantArray<StringConstantProgramGraphNode, UnicodeString> arrayB = { 3 };
+      arrayB.AddValue(UnicodeString("a"));
+      arrayB.AddValue(UnicodeString("bd"));
+      arrayB.AddValue(UnicodeString("def"));
+
+      ConstantManager cm;
+      auto constantArrayA = cm.EnsureStringConstantArray(&arrayA.m_array);
+      auto constantArrayB = cm.EnsureStringConstantArray(&arrayB.m_array);
+
+      EXPECT(constantArrayA.m_elements != constantArrayB.m_elements);
+      EXPECT(UnicodeString(Unmanaged, Span(constantArrayA.m_elements[1].m_value, constantArrayA.m_elements[1].m_length)) == "bc");
+      EXPECT(UnicodeString(Unmanaged, Span(constantArrayB.m_elements[1].m_value, constantArrayB.m_elements[1].m_length)) == "bd");
+    }
+
+    TEST_METHOD(EnsureConstantArraySignedZero)
+    {
+      // Constant arrays are deduplicated by their bits so -0 and +0 are kept distinct even though they compare equal
+      FixedArray<f32> floatArrayA({ 1.0f, -0.0f });
+      FixedArray<f32> floatArrayB({ 1.0f, 0.0f });
+      FixedArray<f64> doubleArrayA({ 1.0, -0.0 });
+      FixedArray<f64> doubleArrayB({ 1.0, 0.0 });
+
+      ConstantManager cm;
+      auto floatConstantArrayA = cm.EnsureFloatConstantArray(floatArrayA);
+      auto floatConstantArrayB = cm.EnsureFloatConstantArray(floatArrayB);
+      auto doubleConstantArrayA = cm.EnsureDoubleConstantArray(doubleArrayA);
+      auto doubleConstantArrayB = cm.EnsureDoubleConstantArray(doubleArrayB);
+
+      EXPECT(floatConstantArrayA.m_elements != floatConstantArrayB.m_elements);
+      EXPECT(std::signbit(floatConstantArrayA.m_elements[1]));
+      EXPECT(!std::signbit(floatConstantArrayB.m_elements[1]));
+
+      EXPECT(doubleConstantArrayA.m_elements != doubleConstantArrayB.m_elements);
+      EXPECT(std::signbit(doubleConstantArrayA.m_elements[1]));
+      EXPECT(!std::signbit(doubleConstantArrayB.m_elements[1]));
+    }
+
     TEST_METHOD(EnsureFloatConstantBuffer)
     {
       f32 vA = 1.0f;
@@ -349,6 +367,137 @@ namespace Chord
       EXPECT(constantBufferC.m_samples == constantBufferA.m_samples);
     }
 
+    TEST_METHOD(GetByteCount)
+    {
+      FixedArray<s32> arrayA({ 1, 2, 3 });
+
+      ConstantManager cm;
+      EXPECT(cm.GetByteCount() == 0);
+
+      cm.EnsureString(UnicodeString("asd"));
+      cm.EnsureString(UnicodeString("asd"));
+      EXPECT(cm.GetByteCount() == 3 * sizeof(char32_t));
+
+      cm.EnsureIntConstantArray(arrayA);
+      cm.EnsureIntConstantArray(arrayA);
+      EXPECT(cm.GetByteCount() == 3 * sizeof(char32_t) + 3 * sizeof(s32));
+
+      cm.EnsureConstantBuffer(1.0f);
+      cm.EnsureConstantBuffer(true);
+      cm.EnsureConstantBuffer(1.0f);
+      EXPECT(cm.GetByteCount() == 3 * sizeof(char32_t) + 3 * sizeof(s32) + 2 * MaxSimdAlignment);
+    }
+
+    TEST_METHOD(ReleaseConstantArray)
+    {
+      ConstantManager cm;
+      auto constantArrayA = cm.EnsureIntConstantArray(FixedArray<s32>({ 1, 2, 3 }));
+      auto constantArrayB = cm.EnsureIntConstantArray(FixedArray<s32>({ 1, 2, 3 }));
+      auto constantArrayC = cm.EnsureIntConstantArray(FixedArray<s32>({ 4, 5, 6 }));
+      EXPECT(constantArrayA.m_elements == constantArrayB.m_elements);
+      EXPECT(cm.GetByteCount() == 6 * sizeof(s32));
+
+      // The array is still referenced through constantArrayB
+      cm.ReleaseConstantArray(constantArrayA);
+      EXPECT(cm.GetByteCount() == 6 * sizeof(s32));
+      EXPECT(constantArrayB.m_elements[2] == 3);
+
+      cm.ReleaseConstantArray(constantArrayB);
+      EXPECT(cm.GetByteCount() == 3 * sizeof(s32));
+      EXPECT(constantArrayC.m_elements[2] == 6);
+
+      // A released array is allocated again the next time it is ensured
+      auto constantArrayD = cm.EnsureIntConstantArray(FixedArray<s32>({ 1, 2, 3 }));
+      EXPECT(cm.GetByteCount() == 6 * sizeof(s32));
+      EXPECT(constantArrayD.m_count == 3);
+      EXPECT(constantArrayD.m_elements[0] == 1);
+
+      cm.ReleaseConstantArray(constantArrayC);
+      cm.ReleaseConstantArray(constantArrayD);
+      EXPECT(cm.GetByteCount() == 0);
+    }
+
+    TEST_METHOD(ReleaseConstantArrayWithSharedConstantPool)
+    {
+      SharedConstantPool pool;
+      {
+        ConstantManager cmA(&pool);
+        ConstantManager cmB(&pool);
+
+        auto constantArrayA = cmA.EnsureFloatConstantArray(FixedArray<f32>({ 1.0f, 2.0f, 3.0f }));
+        auto constantArrayB = cmA.EnsureFloatConstantArray(FixedArray<f32>({ 1.0f, 2.0f, 3.0f }));
+        auto constantArrayC = cmB.EnsureFloatConstantArray(FixedArray<f32>({ 1.0f, 2.0f, 3.0f }));
+        EXPECT(constantArrayA.m_elements == constantArrayB.m_elements);
+        EXPECT(constantArrayA.m_elements == constantArrayC.m_elements);
+        EXPECT(pool.GetStatistics().m_referenceCount == 2);
+
+        // cmA only releases its pool reference once both of its arrays are released
+        cmA.ReleaseConstantArray(constantArrayA);
+        EXPECT(pool.GetStatistics().m_referenceCount == 2);
+
+        cmA.ReleaseConstantArray(constantArrayB);
+        EXPECT(pool.GetStatistics().m_referenceCount == 1);
+        EXPECT(pool.GetStatistics().m_constantCount == 1);
+        EXPECT(constantArrayC.m_elements[2] == 3.0f);
+
+        cmB.ReleaseConstantArray(constantArrayC);
+        EXPECT(pool.GetStatistics().m_constantCount == 0);
+      }
+
+      // Released arrays are not released again when the ConstantManagers are destroyed
+      SharedConstantPool::Statistics statistics = pool.GetStatistics();
+      EXPECT(statistics.m_constantCount == 0);
+      EXPECT(statistics.m_referenceCount == 0);
+    }
+
+    TEST_METHOD(EnsureWithSharedConstantPool)
+    {
+      FixedArray<f32> arrayA({ 1.0f, 2.0f, 3.0f });
+      FixedArray<f32> arrayB({ 1.0f, 2.0f, 4.0f });
+
+      SharedConstantPool pool;
+      {
+        ConstantManager cmA(&pool);
+        ConstantManager cmB(&pool);
+
+        auto constantArrayA = cmA.EnsureFloatConstantArray(arrayA);
+        auto constantArrayB = cmB.EnsureFloatConstantArray(arrayA);
+        auto constantArrayC = cmB.EnsureFloatConstantArray(arrayB);
+        EXPECT(constantArrayA.m_elements == constantArrayB.m_elements);
+        EXPECT(constantArrayA.m_elements != constantArrayC.m_elements);
+        EXPECT(constantArrayC.m_count == 3);
+        EXPECT(constantArrayC.m_elements[2] == 4.0f);
+
+        auto stringA = cmA.EnsureString(UnicodeString("asd"));
+        auto stringB = cmB.EnsureString(UnicodeString("asd"));
+        EXPECT(stringA.m_value == stringB.m_value);
+        EXPECT(UnicodeString(Unmanaged, Span(stringA.m_value, stringA.m_length)) == UnicodeString("asd"));
+
+        auto constantBufferA = cmA.EnsureConstantBuffer(1.0f);
+        auto constantBufferB = cmA.EnsureConstantBuffer(1.0f);
+        auto constantBufferC = cmB.EnsureConstantBuffer(1.0f);
+        EXPECT(constantBufferA.m_samples == constantBufferB.m_samples);
+        EXPECT(constantBufferA.m_samples == constantBufferC.m_samples);
+        for (usz i = 0; i < MaxSimdAlignment / sizeof(f32); i++)
+          { EXPECT(constantBufferA.m_samples[i] == 1.0f); }
+
+        // Pooled constants are not held by the ConstantManagers themselves
+        EXPECT(cmA.GetByteCount() == 0);
+        EXPECT(cmB.GetByteCount() == 0);
+
+        // Each ConstantManager holds a single reference to each constant it uses
+        SharedConstantPool::Statistics statistics = pool.GetStatistics();
+        EXPECT(statistics.m_constantCount == 4);
+        EXPECT(statistics.m_referenceCount == 7);
+        EXPECT(statistics.m_sharedByteCount == 3 * MaxSimdAlignment);
+      }
+
+      SharedConstantPool::Statistics statistics = pool.GetStatistics();
+      EXPECT(statistics.m_constantCount == 0);
+      EXPECT(statistics.m_referenceCount == 0);
+      EXPECT(statistics.m_byteCount == 0);
+    }
+
     template<typename TConstantNode, typename TConstant>
     struct ConstantArray
     {
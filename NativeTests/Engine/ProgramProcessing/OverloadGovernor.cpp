@@ -0,0 +1,65 @@
+module Chord.Tests;
+
+import Chord.Engine;
+import Chord.Foundation;
+import :Test;
+
+namespace Chord
+{
+  TEST_CLASS(OverloadGovernor)
+  {
+    TEST_METHOD(LowerAndRestoreVoiceLimit)
+    {
+      usz eventCount = 0;
+      OverloadEvent lastEvent;
+      OverloadGovernorSettings settings =
+      {
+        .m_overloadLoad = 0.8,
+        .m_recoveryLoad = 0.4,
+        .m_recoveryBlockCount = 2,
+        .m_recoveryVoiceCount = 2,
+        .m_loadSmoothing = 1.0,
+        .m_minVoiceLimit = 2,
+        .m_eventCallback = [&](const OverloadEvent& event)
+        {
+          eventCount++;
+          lastEvent = event;
+        },
+      };
+
+      OverloadGovernor overloadGovernor(settings, 16);
+
+      EXPECT(overloadGovernor.Update(0.5, 16) == 16);
+      EXPECT(overloadGovernor.GetState() == OverloadState::Normal);
+      EXPECT(eventCount == 0);
+
+      // 16 voices at a load of 1.2 should be cut to 8 voices to target a load of 0.6
+      EXPECT(overloadGovernor.Update(1.2, 16) == 8);
+      EXPECT(overloadGovernor.GetState() == OverloadState::Overloaded);
+      EXPECT(eventCount == 1);
+      EXPECT(lastEvent.m_state == OverloadState::Overloaded);
+      EXPECT(lastEvent.m_voiceLimit == 8);
+      EXPECT(lastEvent.m_maxVoiceCount == 16);
+
+      // Repeated overloads always shed at least one voice but never go below the minimum
+      EXPECT(overloadGovernor.Update(0.8, 8) == 6);
+      EXPECT(overloadGovernor.Update(10.0, 6) == 2);
+      EXPECT(overloadGovernor.Update(10.0, 2) == 2);
+      EXPECT(overloadGovernor.GetState() == OverloadState::Overloaded);
+
+      EXPECT(overloadGovernor.Update(0.6, 2) == 2);
+      EXPECT(overloadGovernor.GetState() == OverloadState::Recovering);
+
+      EXPECT(overloadGovernor.Update(0.2, 2) == 2);
+      EXPECT(overloadGovernor.Update(0.2, 2) == 4);
+      EXPECT(overloadGovernor.GetState() == OverloadState::Recovering);
+
+      for (usz i = 0; i < 12; i++)
+        { overloadGovernor.Update(0.2, 4); }
+
+      EXPECT(overloadGovernor.GetVoiceLimit() == 16);
+      EXPECT(overloadGovernor.GetState() == OverloadState::Normal);
+      EXPECT(lastEvent.m_state == OverloadState::Normal);
+    }
+  };
+}
\ No newline at end of file
@@ -0,0 +1,655 @@
+module;
+
+#include "../../../NativeLibraryApi/ChordNativeLibraryApi.h"
+#include "../../../NativeLibraryToolkit/ChordArgument.h"
+
+module Chord.Tests;
+
+import std;
+
+import Chord.Engine;
+import Chord.Foundation;
+import Chord.NativeLibraryToolkit;
+import :Test;
+import :TestUtilities.NativeModuleTesting;
+import :TestUtilities.TestProgramBuilder;
+
+namespace Chord
+{
+  static constexpr Guid AddFloatFloatId = Guid::Parse("7d346384-54b7-45fd-9911-7426df715dea");
+  static constexpr Guid DelayFloatId = Guid::Parse("2b25884a-c094-497d-b13d-a95a8c7efcb8");
+  static constexpr Guid IndexFloatIntId = Guid::Parse("1b6b608f-53b7-418a-9971-2a5aa1f72cd3");
+  static constexpr Guid IndexConstFloatIntId = Guid::Parse("e22e994f-d978-4987-b187-140ef6bf9da2");
+  static constexpr Guid AddLatencyFloatId = Guid::Parse("243551d7-fced-4324-9bfa-f453f149d79c");
+  static constexpr Guid ScratchMemoryNativeLibraryId = Guid::Parse("3e0d3c6a-8f51-4f0e-b2c7-5d94a1e6f208");
+
+  // None of the core native modules use scratch memory so this test-only module is registered directly with the native library registry
+  class ScratchMemoryCopyFloat
+  {
+  public:
+    static constexpr Guid Id = Guid::Parse("c4a1f7b2-09d6-4e83-a5f1-6b2e8d3c7a94");
+    static constexpr const char32_t* Name = U"ScratchMemoryCopy";
+    static constexpr usz ScratchSampleCount = 4096;
+
+    static void* InitializeVoice(StackAllocatorCalculator& scratchMemoryAllocatorCalculator)
+    {
+      scratchMemoryAllocatorCalculator.Add<f32>(ScratchSampleCount);
+      return nullptr;
+    }
+
+    static void Invoke(CHORD_IN(const? float, x), CHORD_RETURN(const? float, result), StackAllocator& scratchMemoryAllocator)
+    {
+      // Allocating the array clears it, which fails loudly if this invocation was given too little scratch memory
+      Span<f32> scratchSamples = scratchMemoryAllocator.AllocateArray<f32>(ScratchSampleCount);
+      ASSERT(scratchSamples.Count() == ScratchSampleCount);
+      IterateBuffers<IterateBuffersFlags::PropagateConstants>(x, result, [](auto&& xVal, auto&& resultVal) { resultVal = xVal; });
+    }
+  };
+
+  TEST_CLASS_SHARED(ProgramProcessor)
+  {
+    NON_TRIVIAL_TEST_CLASS(ProgramProcessor)
+
+    TEST_METHOD(TiledProcessingMatchesFullBlocks)
+    {
+      // The input reaches the output through two delays so the second delay's input is constant (the first delay's initial value) for the first few tiles
+      // and then becomes non-constant partway through a tile
+      static constexpr s32 FirstDelaySampleCount = 40;
+      static constexpr s32 SecondDelaySampleCount = 9;
+      TestProgramBuilder builder;
+      auto input = builder.AddFloatInputChannel();
+      auto delayedInput = builder.AddNativeModuleCall(DelayFloatId, { input, builder.AddIntConstant(FirstDelaySampleCount), builder.AddFloatConstant(0.25f) });
+      auto twiceDelayedInput = builder.AddNativeModuleCall(
+        DelayFloatId,
+        { delayedInput, builder.AddIntConstant(SecondDelaySampleCount), builder.AddFloatConstant(0.5f) });
+      builder.AddOutputChannel(TestProgramStage::Effect, builder.AddNativeModuleCall(AddFloatFloatId, { twiceDelayedInput, builder.AddFloatConstant(1.0f) }));
+      auto program = LoadProgram(builder.Build());
+
+      // The last block is not a whole number of tiles
+      static constexpr usz SampleCount = 700;
+      FixedArray<f32> inputSamples = InitializeCapacity(SampleCount);
+      for (usz i = 0; i < SampleCount; i++)
+        { inputSamples[i] = f32(std::sin(f64(i) * 0.1)); }
+
+      auto ProcessWithTileSampleCount =
+        [&](usz tileSampleCount)
+        {
+          ProgramProcessorSettings settings = { .m_bufferSampleCount = 256, .m_tileSampleCount = tileSampleCount };
+          ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+          return Process(processor, inputSamples, SampleCount);
+        };
+
+      FixedArray<f32> fullBlockOutput = ProcessWithTileSampleCount(0);
+      FixedArray<f32> tiledOutput = ProcessWithTileSampleCount(16);
+      for (usz i = 0; i < SampleCount; i++)
+      {
+        f32 expected = 1.0f + (i < SecondDelaySampleCount
+          ? 0.5f
+          : (i < FirstDelaySampleCount + SecondDelaySampleCount ? 0.25f : inputSamples[i - FirstDelaySampleCount - SecondDelaySampleCount]));
+        EXPECT(fullBlockOutput[i] == expected);
+        EXPECT(tiledOutput[i] == expected);
+      }
+    }
+
+    TEST_METHOD(MemoryFootprint)
+    {
+      static constexpr u32 VoiceCount = 4;
+      static constexpr s32 DelaySampleCount = 1000;
+      TestProgramBuilder builder({ .m_maxVoices = VoiceCount });
+      auto delayedValue = builder.AddNativeModuleCall(
+        DelayFloatId,
+        { builder.AddFloatConstant(1.0f), builder.AddIntConstant(DelaySampleCount), builder.AddFloatConstant(0.0f) });
+      builder.AddOutputChannel(TestProgramStage::Voice, delayedValue);
+      auto program = LoadProgram(builder.Build());
+
+      ProgramProcessorSettings settings = { .m_bufferSampleCount = 256 };
+      ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+
+      // Each voice's delay reports the delay line that it allocated on voice initialization
+      ProgramProcessorMemoryFootprint footprint = processor.GetMemoryFootprint();
+      EXPECT(footprint.m_voiceCount == VoiceCount);
+      EXPECT(footprint.m_threadCount == ThreadCount);
+      EXPECT(footprint.m_nativeModuleVoiceContextByteCount >= VoiceCount * DelaySampleCount * sizeof(f32));
+      EXPECT(footprint.m_unreportedNativeModuleVoiceContextCount == 0);
+      EXPECT(footprint.m_sharedBufferByteCount > 0);
+      EXPECT(footprint.m_sharedBufferByteCount <= footprint.m_unsharedBufferByteCount);
+      EXPECT(footprint.GetTotalByteCount() > footprint.m_nativeModuleVoiceContextByteCount);
+
+      // Estimates don't initialize voices so every delay is unreported, and buffer memory is an upper bound because sharing isn't analyzed
+      ProgramProcessorMemoryFootprint estimate = ProgramProcessor::EstimateMemoryFootprint(m_nativeLibraryRegistry.get(), &program.value(), settings, ThreadCount);
+      EXPECT(estimate.m_voiceCount == VoiceCount);
+      EXPECT(estimate.m_threadCount == ThreadCount);
+      EXPECT(estimate.m_nativeModuleVoiceContextByteCount == 0);
+      EXPECT(estimate.m_unreportedNativeModuleVoiceContextCount == VoiceCount);
+      EXPECT(estimate.m_sharedBufferByteCount == estimate.m_unsharedBufferByteCount);
+      EXPECT(estimate.m_unsharedBufferByteCount >= footprint.m_sharedBufferByteCount);
+    }
+
+    TEST_METHOD(SilentVoiceDetection)
+    {
+      // The voice wants to remain active forever but its output is silent until the delay has elapsed
+      static constexpr usz BlockSampleCount = 64;
+      static constexpr s32 DelaySampleCount = s32(BlockSampleCount * 5);
+      TestProgramBuilder builder;
+      auto delayedValue = builder.AddNativeModuleCall(
+        DelayFloatId,
+        { builder.AddFloatConstant(1.0f), builder.AddIntConstant(DelaySampleCount), builder.AddFloatConstant(0.0f) });
+      builder.AddOutputChannel(TestProgramStage::Voice, delayedValue);
+      builder.SetRemainActiveOutput(TestProgramStage::Voice, builder.AddBoolConstant(true));
+      auto program = LoadProgram(builder.Build());
+
+      static constexpr usz SampleCount = BlockSampleCount * 8;
+      auto ProcessWithSilentVoiceDetectionSettings =
+        [&](const std::optional<SilentVoiceDetectionSettings>& silentVoiceDetectionSettings)
+        {
+          ProgramProcessorSettings settings = { .m_bufferSampleCount = BlockSampleCount, .m_silentVoiceDetectionSettings = silentVoiceDetectionSettings };
+          ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+          VoiceTrigger voiceTrigger = { .m_sampleIndex = 0, .m_type = VoiceTriggerType::Trigger };
+          return Process(processor, {}, SampleCount, Span<const VoiceTrigger>(&voiceTrigger, 1));
+        };
+
+      // Without silent voice detection or when only released voices are deactivated, the voice outlasts its silence
+      for (const std::optional<SilentVoiceDetectionSettings>& settings :
+        { std::optional<SilentVoiceDetectionSettings>(), std::optional(SilentVoiceDetectionSettings { .m_blockCount = 3, .m_releasedVoicesOnly = true }) })
+      {
+        FixedArray<f32> output = ProcessWithSilentVoiceDetectionSettings(settings);
+        for (usz i = 0; i < SampleCount; i++)
+          { EXPECT(output[i] == (i < usz(DelaySampleCount) ? 0.0f : 1.0f)); }
+      }
+
+      // The voice is deactivated after 3 silent blocks even though its remain-active output is still true
+      FixedArray<f32> output = ProcessWithSilentVoiceDetectionSettings(SilentVoiceDetectionSettings { .m_blockCount = 3, .m_releasedVoicesOnly = false });
+      for (usz i = 0; i < SampleCount; i++)
+        { EXPECT(output[i] == 0.0f); }
+    }
+
+    TEST_METHOD(CachedPlan)
+    {
+      // Buffers along this chain can share memory so the plan has something to record
+      TestProgramBuilder builder;
+      auto value = builder.AddNativeModuleCall(AddFloatFloatId, { builder.AddFloatInputChannel(), builder.AddFloatConstant(1.0f) });
+      value = builder.AddNativeModuleCall(AddFloatFloatId, { value, builder.AddFloatConstant(2.0f) });
+      value = builder.AddNativeModuleCall(DelayFloatId, { value, builder.AddIntConstant(9), builder.AddFloatConstant(0.0f) });
+      value = builder.AddNativeModuleCall(AddFloatFloatId, { value, builder.AddFloatConstant(4.0f) });
+      builder.AddOutputChannel(TestProgramStage::Effect, value);
+      auto program = LoadProgram(builder.Build());
+
+      static constexpr usz SampleCount = 600;
+      FixedArray<f32> inputSamples = InitializeCapacity(SampleCount);
+      for (usz i = 0; i < SampleCount; i++)
+        { inputSamples[i] = f32(std::sin(f64(i) * 0.05)); }
+
+      ProgramProcessorSettings settings = { .m_bufferSampleCount = 256 };
+      ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+      EXPECT(!processor.IsUsingCachedPlan());
+      UnboundedArray<u8> plan = processor.SerializePlan();
+      FixedArray<f32> expectedOutput = Process(processor, inputSamples, SampleCount);
+
+      // A processor constructed with the plan applies it and produces the same output
+      ProgramProcessorSettings cachedPlanSettings = settings;
+      cachedPlanSettings.m_cachedPlan = Span<const u8>(plan);
+      ProgramProcessor cachedPlanProcessor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), cachedPlanSettings);
+      EXPECT(cachedPlanProcessor.IsUsingCachedPlan());
+      EXPECT(cachedPlanProcessor.GetMemoryFootprint().m_sharedBufferByteCount == processor.GetMemoryFootprint().m_sharedBufferByteCount);
+      FixedArray<f32> cachedPlanOutput = Process(cachedPlanProcessor, inputSamples, SampleCount);
+      for (usz i = 0; i < SampleCount; i++)
+        { EXPECT(cachedPlanOutput[i] == expectedOutput[i]); }
+
+      // A plan produced for a different buffer sample count has a different key so it is ignored
+      ProgramProcessorSettings otherSettings = { .m_bufferSampleCount = 128 };
+      ProgramProcessor otherProcessor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), otherSettings);
+      UnboundedArray<u8> otherPlan = otherProcessor.SerializePlan();
+
+      ProgramProcessorSettings mismatchedPlanSettings = settings;
+      mismatchedPlanSettings.m_cachedPlan = Span<const u8>(otherPlan);
+      ProgramProcessor mismatchedPlanProcessor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), mismatchedPlanSettings);
+      EXPECT(!mismatchedPlanProcessor.IsUsingCachedPlan());
+      FixedArray<f32> mismatchedPlanOutput = Process(mismatchedPlanProcessor, inputSamples, SampleCount);
+      for (usz i = 0; i < SampleCount; i++)
+        { EXPECT(mismatchedPlanOutput[i] == expectedOutput[i]); }
+    }
+
+    TEST_METHOD(InitializationProgress)
+    {
+      // Each voice and the effect stage is initialized as a separate stage
+      static constexpr u32 VoiceCount = 6;
+      TestProgramBuilder builder({ .m_maxVoices = VoiceCount });
+      auto delayedValue = builder.AddNativeModuleCall(
+        DelayFloatId,
+        { builder.AddFloatConstant(1.0f), builder.AddIntConstant(100), builder.AddFloatConstant(0.0f) });
+      auto effectInput = builder.AddVoiceToEffect(PrimitiveTypeFloat, delayedValue);
+      builder.AddOutputChannel(
+        TestProgramStage::Effect,
+        builder.AddNativeModuleCall(DelayFloatId, { effectInput, builder.AddIntConstant(200), builder.AddFloatConstant(0.0f) }));
+      auto program = LoadProgram(builder.Build());
+
+      auto Initialize =
+        [&](TaskExecutor* taskExecutor)
+        {
+          // The callback is invoked one call at a time and construction doesn't return until the final call has been made
+          UnboundedArray<std::tuple<usz, usz>> progress;
+          ProgramProcessorSettings settings =
+          {
+            .m_bufferSampleCount = 256,
+            .m_initializationProgressCallback = [&](usz initializedStageCount, usz stageCount) { progress.Append({ initializedStageCount, stageCount }); },
+          };
+
+          ProgramProcessor processor(taskExecutor, m_nativeLibraryRegistry.get(), &program.value(), settings);
+
+          static constexpr usz StageCount = VoiceCount + 1;
+          EXPECT(progress.Count() == StageCount);
+          for (usz i = 0; i < progress.Count(); i++)
+          {
+            auto [initializedStageCount, stageCount] = progress[i];
+            EXPECT(initializedStageCount == i + 1);
+            EXPECT(stageCount == StageCount);
+          }
+
+          return processor.GetMemoryFootprint();
+        };
+
+      // Stages initialized in parallel should end up with the same requirements as stages initialized one at a time on a single task thread
+      ProgramProcessorMemoryFootprint parallelFootprint = Initialize(m_taskExecutor.get());
+      auto serialTaskExecutor = std::make_unique<TaskExecutor>(TaskExecutorSettings { .m_threadCount = 1 });
+      ProgramProcessorMemoryFootprint serialFootprint = Initialize(serialTaskExecutor.get());
+      EXPECT(parallelFootprint.m_scratchByteCountPerThread == serialFootprint.m_scratchByteCountPerThread);
+      EXPECT(parallelFootprint.m_nativeModuleVoiceContextByteCount == serialFootprint.m_nativeModuleVoiceContextByteCount);
+      EXPECT(parallelFootprint.m_nativeModuleVoiceContextByteCount >= (VoiceCount * 100 + 200) * sizeof(f32));
+    }
+
+    TEST_METHOD(DeferredEffectInitializationCancelledOnDestroy)
+    {
+      static constexpr usz BlockSampleCount = 64;
+      auto program = LoadProgram(BuildThresholdEffectProgram(1 << 20));
+      ProgramProcessorSettings settings = { .m_bufferSampleCount = BlockSampleCount, .m_effectStageWarmUpPolicy = EffectStageWarmUpPolicy::OnFirstActivation };
+
+      // An effect stage which never activates is never initialized and destroying its processor doesn't wait on anything
+      {
+        ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+        FixedArray<f32> silence = InitializeCapacity(BlockSampleCount);
+        silence.ZeroElements();
+        for (usz blockIndex = 0; blockIndex < 4; blockIndex++)
+        {
+          FixedArray<f32> output = Process(processor, silence, BlockSampleCount);
+          for (f32 sample : output)
+            { EXPECT(sample == 0.0f); }
+        }
+
+        EXPECT(processor.GetMemoryFootprint().m_nativeModuleVoiceContextByteCount == 0);
+      }
+
+      // Destroying a processor right after its effect stage first tries to activate either cancels the enqueued initialization or waits for it to finish
+      FixedArray<f32> inputSamples = BuildLoudInput(BlockSampleCount);
+      for (usz i = 0; i < 8; i++)
+      {
+        ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+        FixedArray<f32> output = Process(processor, inputSamples, BlockSampleCount);
+        for (f32 sample : output)
+          { EXPECT(sample == 0.0f); }
+      }
+    }
+
+    TEST_METHOD(EffectActivationDuringDeferredInitialization)
+    {
+      // The effect stage's delay line is large so that blocks are likely to be processed while it is being initialized
+      static constexpr usz BlockSampleCount = 64;
+      static constexpr s32 DelaySampleCount = 1 << 22;
+      auto program = LoadProgram(BuildThresholdEffectProgram(DelaySampleCount));
+      ProgramProcessorSettings settings = { .m_bufferSampleCount = BlockSampleCount, .m_effectStageWarmUpPolicy = EffectStageWarmUpPolicy::OnFirstActivation };
+      ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+      EXPECT(processor.GetMemoryFootprint().m_nativeModuleVoiceContextByteCount == 0);
+
+      // Every block asks to activate the effect stage but initialization is only enqueued once and the effect stage is silent until it has finished
+      EXPECT(ProcessUntilEffectActivates(processor, BuildLoudInput(BlockSampleCount)));
+      EXPECT(processor.GetMemoryFootprint().m_nativeModuleVoiceContextByteCount >= DelaySampleCount * sizeof(f32));
+    }
+
+    TEST_METHOD(DeferredEffectScratchMemory)
+    {
+      static constexpr usz BlockSampleCount = 64;
+      TestProgramBuilder builder({ .m_effectActivationMode = EffectActivationMode::Threshold, .m_effectActivationThreshold = 0.5 });
+      auto effectOutput = builder.AddNativeModuleCall(ScratchMemoryNativeLibraryId, ScratchMemoryCopyFloat::Id, { builder.AddFloatInputChannel() }, 1, 1)[0];
+      builder.AddOutputChannel(TestProgramStage::Effect, effectOutput);
+      auto program = LoadProgram(builder.Build());
+
+      // The voices don't need scratch memory so the effect stage's scratch memory is allocated separately once it has been initialized
+      ProgramProcessorSettings settings = { .m_bufferSampleCount = BlockSampleCount, .m_effectStageWarmUpPolicy = EffectStageWarmUpPolicy::OnFirstActivation };
+      ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+      EXPECT(processor.GetMemoryFootprint().m_scratchByteCountPerThread == 0);
+      EXPECT(ProcessUntilEffectActivates(processor, BuildLoudInput(BlockSampleCount)));
+      EXPECT(processor.GetMemoryFootprint().m_scratchByteCountPerThread >= ScratchMemoryCopyFloat::ScratchSampleCount * sizeof(f32));
+
+      // This matches the scratch memory of a processor which initialized its effect stage eagerly
+      ProgramProcessorSettings eagerSettings = { .m_bufferSampleCount = BlockSampleCount };
+      ProgramProcessor eagerProcessor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), eagerSettings);
+      EXPECT(processor.GetMemoryFootprint().m_scratchByteCountPerThread == eagerProcessor.GetMemoryFootprint().m_scratchByteCountPerThread);
+    }
+
+    TEST_METHOD(VoiceActivatedEffectIgnoresDeferredInitialization)
+    {
+      // Deferring a voice-activated effect stage would drop the note which first activates it so it is initialized eagerly
+      static constexpr usz BlockSampleCount = 64;
+      TestProgramBuilder builder({ .m_effectActivationMode = EffectActivationMode::Voice });
+      auto effectInput = builder.AddVoiceToEffect(PrimitiveTypeFloat, builder.AddFloatConstant(1.0f));
+      builder.AddOutputChannel(
+        TestProgramStage::Effect,
+        builder.AddNativeModuleCall(AddFloatFloatId, { effectInput, builder.AddFloatConstant(0.5f) }));
+      auto program = LoadProgram(builder.Build());
+
+      ProgramProcessorSettings settings = { .m_bufferSampleCount = BlockSampleCount, .m_effectStageWarmUpPolicy = EffectStageWarmUpPolicy::OnFirstActivation };
+      ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), settings);
+      VoiceTrigger voiceTrigger = { .m_sampleIndex = 0, .m_type = VoiceTriggerType::Trigger };
+      FixedArray<f32> output = Process(processor, {}, BlockSampleCount, Span<const VoiceTrigger>(&voiceTrigger, 1));
+      for (f32 sample : output)
+        { EXPECT(sample == 1.5f); }
+    }
+
+    TEST_METHOD(SimplifyFoldsConstantChain)
+    {
+      // Both calls are upsampled so their constant input buffers need as many samples as their outputs. The second call only becomes foldable once the first
+      // has been folded.
+      TestProgramBuilder builder;
+      auto sum = builder.AddNativeModuleCall(AddFloatFloatId, { builder.AddFloatConstant(1.0f), builder.AddFloatConstant(2.0f) }, 1, 2)[0];
+      sum = builder.AddNativeModuleCall(AddFloatFloatId, { sum, builder.AddFloatConstant(4.0f) }, 1, 2)[0];
+      builder.AddOutputChannel(TestProgramStage::Effect, sum);
+      auto program = LoadProgram(builder.Build());
+
+      Program::SimplificationResult result = program->Simplify(m_nativeLibraryRegistry.get());
+      EXPECT(result.m_foldedNativeModuleCallCount == 2);
+      EXPECT(result.m_removedTaskCount == 2);
+      EXPECT(result.m_removedBufferCount == 2);
+
+      const IOutputProgramGraphNode* connection = program->ProgramGraph().m_outputChannels[0]->Input()->Connection();
+      EXPECT(connection->Processor()->Type() == ProgramGraphNodeType::FloatConstant);
+      EXPECT(static_cast<const FloatConstantProgramGraphNode*>(connection->Processor())->Value() == 7.0f);
+
+      static constexpr usz SampleCount = 300;
+      ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), { .m_bufferSampleCount = 256 });
+      FixedArray<f32> output = Process(processor, {}, SampleCount);
+      for (f32 sample : output)
+        { EXPECT(sample == 7.0f); }
+    }
+
+    TEST_METHOD(SimplifyRemovesDeadNativeModuleCall)
+    {
+      // The second call reads the input channel but its result is never used
+      TestProgramBuilder builder;
+      auto input = builder.AddFloatInputChannel();
+      builder.AddOutputChannel(TestProgramStage::Effect, builder.AddNativeModuleCall(AddFloatFloatId, { input, builder.AddFloatConstant(2.0f) }));
+      builder.AddNativeModuleCall(AddFloatFloatId, { input, builder.AddFloatConstant(1.0f) });
+      auto program = LoadProgram(builder.Build());
+
+      const GraphInputProgramGraphNode* inputChannel = (*program->ProgramGraph().m_inputChannelsFloat)[0];
+      EXPECT(inputChannel->Output()->Connections().Count() == 2);
+
+      Program::SimplificationResult result = program->Simplify(m_nativeLibraryRegistry.get());
+      EXPECT(result.m_foldedNativeModuleCallCount == 0);
+      EXPECT(result.m_removedTaskCount == 1);
+      EXPECT(result.m_removedBufferCount == 1);
+      EXPECT(result.m_removedInputChannelCount == 0);
+      EXPECT(inputChannel->Output()->Connections().Count() == 1);
+
+      static constexpr usz SampleCount = 300;
+      FixedArray<f32> inputSamples = BuildLoudInput(SampleCount);
+      ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), { .m_bufferSampleCount = 256 });
+      FixedArray<f32> output = Process(processor, inputSamples, SampleCount);
+      for (usz i = 0; i < SampleCount; i++)
+        { EXPECT(output[i] == inputSamples[i] + 2.0f); }
+    }
+
+    TEST_METHOD(ProgramBankConstantVariants)
+    {
+      // The programs differ only in the added constant so they share a graph but each processor must embed its own program's value
+      auto BuildAddConstantProgram =
+        [](f32 value)
+        {
+          TestProgramBuilder builder;
+          auto input = builder.AddFloatInputChannel();
+          builder.AddOutputChannel(TestProgramStage::Effect, builder.AddNativeModuleCall(AddFloatFloatId, { input, builder.AddFloatConstant(value) }));
+          return builder.Build();
+        };
+
+      UnboundedArray<u8> bytesA = BuildAddConstantProgram(1.0f);
+      UnboundedArray<u8> bytesB = BuildAddConstantProgram(2.0f);
+      ProgramBank programBank(m_nativeLibraryRegistry.get(), false);
+      const Program* programA = programBank.AcquireProgram(bytesA);
+      const Program* programB = programBank.AcquireProgram(bytesB);
+      EXPECT(programA != nullptr && programB != nullptr && programA != programB);
+      EXPECT(programBank.GetStatistics().m_graphCount == 1);
+
+      static constexpr usz SampleCount = 300;
+      FixedArray<f32> inputSamples = BuildLoudInput(SampleCount);
+      {
+        ProgramProcessor processorA(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), programA, { .m_bufferSampleCount = 256 });
+        ProgramProcessor processorB(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), programB, { .m_bufferSampleCount = 256 });
+        FixedArray<f32> outputA = Process(processorA, inputSamples, SampleCount);
+        FixedArray<f32> outputB = Process(processorB, inputSamples, SampleCount);
+        for (usz i = 0; i < SampleCount; i++)
+        {
+          EXPECT(outputA[i] == inputSamples[i] + 1.0f);
+          EXPECT(outputB[i] == inputSamples[i] + 2.0f);
+        }
+      }
+
+      programBank.ReleaseProgram(programA);
+      programBank.ReleaseProgram(programB);
+    }
+
+    TEST_METHOD(UpdateConstantsInPlace)
+    {
+      // The first array is a task argument embedded by the constant manager, the second array's elements are constant buffers
+      auto BuildIndexingProgram =
+        [](f32 constArrayElement, f32 bufferArrayElement)
+        {
+          TestProgramBuilder builder;
+          auto input = builder.AddFloatInputChannel();
+          auto constArray = builder.AddArray({ builder.AddFloatConstant(1.0f), builder.AddFloatConstant(constArrayElement) });
+          auto constArrayValue = builder.AddNativeModuleCall(IndexConstFloatIntId, { constArray, builder.AddIntConstant(1) });
+          auto bufferArray = builder.AddArray({ builder.AddFloatConstant(bufferArrayElement), builder.AddFloatConstant(20.0f) });
+          auto bufferArrayValue = builder.AddNativeModuleCall(IndexFloatIntId, { bufferArray, builder.AddIntConstant(0) });
+          auto sum = builder.AddNativeModuleCall(AddFloatFloatId, { input, constArrayValue });
+          builder.AddOutputChannel(TestProgramStage::Effect, builder.AddNativeModuleCall(AddFloatFloatId, { sum, bufferArrayValue }));
+          return builder.Build();
+        };
+
+      static constexpr usz SampleCount = 300;
+      FixedArray<f32> inputSamples = BuildLoudInput(SampleCount);
+      {
+        UnboundedArray<u8> baseBytes = BuildIndexingProgram(2.0f, 10.0f);
+        UnboundedArray<u8> targetBytes = BuildIndexingProgram(3.0f, 30.0f);
+        auto program = LoadProgram(baseBytes);
+        ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), { .m_bufferSampleCount = 256 });
+        FixedArray<f32> output = Process(processor, inputSamples, SampleCount);
+        for (usz i = 0; i < SampleCount; i++)
+          { EXPECT(output[i] == inputSamples[i] + 12.0f); }
+
+        auto update = program->TryPrepareConstantUpdate(baseBytes, targetBytes);
+        EXPECT(update.has_value() && update->ChangedNodes().Count() == 2);
+        EXPECT(processor.CanUpdateConstants(update->ChangedNodes()));
+        program->CommitConstantUpdate(*update);
+        processor.UpdateConstants(&program.value(), update->ChangedNodes());
+
+        output = Process(processor, inputSamples, SampleCount);
+        for (usz i = 0; i < SampleCount; i++)
+          { EXPECT(output[i] == inputSamples[i] + 33.0f); }
+      }
+
+      // A constant connected directly to an output channel is written to the graph output
+      auto BuildConstantOutputProgram =
+        [](f32 value)
+        {
+          TestProgramBuilder builder;
+          builder.AddOutputChannel(TestProgramStage::Effect, builder.AddFloatConstant(value));
+          return builder.Build();
+        };
+
+      {
+        UnboundedArray<u8> baseBytes = BuildConstantOutputProgram(0.5f);
+        UnboundedArray<u8> targetBytes = BuildConstantOutputProgram(0.75f);
+        auto program = LoadProgram(baseBytes);
+        ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), { .m_bufferSampleCount = 256 });
+        FixedArray<f32> output = Process(processor, {}, SampleCount);
+        for (f32 sample : output)
+          { EXPECT(sample == 0.5f); }
+
+        auto update = program->TryPrepareConstantUpdate(baseBytes, targetBytes);
+        EXPECT(update.has_value() && update->ChangedNodes().Count() == 1);
+        EXPECT(processor.CanUpdateConstants(update->ChangedNodes()));
+        program->CommitConstantUpdate(*update);
+        processor.UpdateConstants(&program.value(), update->ChangedNodes());
+
+        output = Process(processor, {}, SampleCount);
+        for (f32 sample : output)
+          { EXPECT(sample == 0.75f); }
+      }
+
+      // Prepare computes argument latencies from constant arguments so a constant reaching a native module with a Prepare callback can't be updated. The
+      // rejected update must leave the program untouched. AddLatency reports an error when invoked so this program is never processed.
+      auto BuildLatencyProgram =
+        [](s32 latency)
+        {
+          TestProgramBuilder builder;
+          auto input = builder.AddFloatInputChannel();
+          builder.AddOutputChannel(TestProgramStage::Effect, builder.AddNativeModuleCall(AddLatencyFloatId, { input, builder.AddIntConstant(latency) }));
+          return builder.Build();
+        };
+
+      {
+        UnboundedArray<u8> baseBytes = BuildLatencyProgram(4);
+        UnboundedArray<u8> targetBytes = BuildLatencyProgram(8);
+        auto program = LoadProgram(baseBytes);
+        ProgramProcessor processor(m_taskExecutor.get(), m_nativeLibraryRegistry.get(), &program.value(), { .m_bufferSampleCount = 256 });
+
+        auto update = program->TryPrepareConstantUpdate(baseBytes, targetBytes);
+        EXPECT(update.has_value() && update->ChangedNodes().Count() == 1);
+        EXPECT(!processor.CanUpdateConstants(update->ChangedNodes()));
+
+        auto baseContentHash = Program::TryReadContentHash(baseBytes);
+        EXPECT(std::memcmp(program->ContentHash().Elements(), baseContentHash->Elements(), Sha256ByteCount) == 0);
+        EXPECT(program->ConstantValue(static_cast<const IntConstantProgramGraphNode*>(update->ChangedNodes()[0])) == 4);
+      }
+    }
+
+    // The effect stage activates when the input exceeds 0.5 and passes the input through once active. A delay line of the given length is allocated when the
+    // effect stage is initialized.
+    static UnboundedArray<u8> BuildThresholdEffectProgram(s32 delaySampleCount)
+    {
+      TestProgramBuilder builder({ .m_effectActivationMode = EffectActivationMode::Threshold, .m_effectActivationThreshold = 0.5 });
+      auto input = builder.AddFloatInputChannel();
+      auto delayedInput = builder.AddNativeModuleCall(DelayFloatId, { input, builder.AddIntConstant(delaySampleCount), builder.AddFloatConstant(0.0f) });
+      builder.AddOutputChannel(TestProgramStage::Effect, builder.AddNativeModuleCall(AddFloatFloatId, { delayedInput, input }));
+      return builder.Build();
+    }
+
+    static FixedArray<f32> BuildLoudInput(usz sampleCount)
+    {
+      FixedArray<f32> samples = InitializeCapacity(sampleCount);
+      for (usz i = 0; i < sampleCount; i++)
+        { samples[i] = f32(std::sin(f64(i) * 0.1)); }
+      return samples;
+    }
+
+    // Processes blocks of the given input until the effect stage activates and passes the input through. The first block only requests initialization so it
+    // is always silent. Returns false if the effect stage doesn't activate within a few seconds.
+    static bool ProcessUntilEffectActivates(ProgramProcessor& processor, Span<const f32> inputSamples)
+    {
+      FixedArray<f32> output = Process(processor, inputSamples, inputSamples.Count());
+      for (f32 sample : output)
+        { EXPECT(sample == 0.0f); }
+
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (std::chrono::steady_clock::now() < deadline)
+      {
+        output = Process(processor, inputSamples, inputSamples.Count());
+        if (output[0] == inputSamples[0])
+        {
+          for (usz i = 0; i < inputSamples.Count(); i++)
+            { EXPECT(output[i] == inputSamples[i]); }
+          return true;
+        }
+
+        for (f32 sample : output)
+          { EXPECT(sample == 0.0f); }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+
+      return false;
+    }
+
+    std::optional<Program> LoadProgram(const UnboundedArray<u8>& bytes)
+    {
+      std::optional<Program> program = Program::Deserialize(bytes);
+      ASSERT(program.has_value());
+      EXPECT(program->Validate(m_nativeLibraryRegistry.get()));
+      return program;
+    }
+
+    // Processes sampleCount samples of a program with at most one float input channel and a single output channel
+    static FixedArray<f32> Process(
+      ProgramProcessor& processor,
+      Span<const f32> inputSamples,
+      usz sampleCount,
+      Span<const VoiceTrigger> voiceTriggers = {})
+    {
+      FixedArray<f32> outputSamples = InitializeCapacity(sampleCount);
+      InputChannelBuffer inputChannelBuffer =
+      {
+        .m_sampleType = SampleType::Float32,
+        .m_samples = Span(reinterpret_cast<const u8*>(inputSamples.Elements()), sampleCount * sizeof(f32)),
+      };
+
+      OutputChannelBuffer outputChannelBuffer =
+      {
+        .m_sampleType = SampleType::Float32,
+        .m_samples = Span(reinterpret_cast<u8*>(outputSamples.Elements()), sampleCount * sizeof(f32)),
+      };
+
+      processor.Process(
+        sampleCount,
+        inputSamples.IsEmpty() ? Span<const InputChannelBuffer>() : Span<const InputChannelBuffer>(&inputChannelBuffer, 1),
+        Span<const OutputChannelBuffer>(&outputChannelBuffer, 1),
+        voiceTriggers);
+      return outputSamples;
+    }
+
+    static constexpr usz ThreadCount = 4;
+
+    class TestNativeLibraryRegistry : public NativeLibraryRegistry
+    {
+    public:
+      using NativeLibraryRegistry::NativeLibraryRegistry;
+      using NativeLibraryRegistry::RegisterNativeLibrary;
+    };
+
+    TestReporting m_reporting;
+    std::unique_ptr<TaskExecutor> m_taskExecutor = std::make_unique<TaskExecutor>(TaskExecutorSettings { .m_threadCount = ThreadCount });
+    std::unique_ptr<TestNativeLibraryRegistry> m_nativeLibraryRegistry = CreateNativeLibraryRegistry(&m_reporting);
+
+    static std::unique_ptr<TestNativeLibraryRegistry> CreateNativeLibraryRegistry(IReporting* reporting)
+    {
+      auto nativeLibraryRegistry = std::make_unique<TestNativeLibraryRegistry>(reporting, std::filesystem::current_path() / ".." / "native-libraries");
+
+      NativeModule scratchMemoryCopyFloat = DeclareNativeModule<ScratchMemoryCopyFloat>();
+      NativeModule* nativeModules[] = { &scratchMemoryCopyFloat };
+      NativeLibrary nativeLibrary =
+      {
+        .m_version = { .m_major = 1, .m_minor = 0, .m_patch = 0 },
+        .m_name = U"ScratchMemoryTest",
+        .m_initialize = nullptr,
+        .m_deinitialize = nullptr,
+        .m_initializeVoice = nullptr,
+        .m_deinitializeVoice = nullptr,
+
+        .m_nativeModules = nativeModules,
+        .m_nativeModuleCount = ArrayLength(nativeModules),
+
+        .m_optimizationRules = nullptr,
+        .m_optimizationRuleCount = 0,
+      };
+
+      Span(nativeLibrary.m_id).CopyElementsFrom(ScratchMemoryNativeLibraryId.Bytes());
+      nativeLibraryRegistry->RegisterNativeLibrary(&nativeLibrary);
+      return nativeLibraryRegistry;
+    }
+  };
+}
\ No newline at end of file
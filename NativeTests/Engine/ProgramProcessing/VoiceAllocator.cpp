@@ -131,5 +131,168 @@ namespace Chord
       EXPECT(voiceAllocator.GetDeactivatedVoiceIndices()[0] == voiceA.m_voiceIndex);
       EXPECT(voiceAllocator.GetDeactivatedVoiceIndices()[1] == voiceB.m_voiceIndex);
     }
+
+    TEST_METHOD(RetriggerVoice)
+    {
+      VoiceAllocator voiceAllocator(4);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      voiceAllocator.TriggerVoice(10, 60);
+      voiceAllocator.TriggerVoice(20, 64);
+
+      auto voiceIndexA = voiceAllocator.TryGetVoiceIndex(60);
+      auto voiceIndexB = voiceAllocator.TryGetVoiceIndex(64);
+      EXPECT(voiceIndexA.has_value());
+      EXPECT(voiceIndexB.has_value());
+      EXPECT(voiceIndexA != voiceIndexB);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      voiceAllocator.TriggerVoice(5, 60);
+
+      EXPECT(voiceAllocator.GetActiveVoiceIndices().Count() == 2);
+      EXPECT(voiceAllocator.GetActivatedVoices().Count() == 1);
+      EXPECT(voiceAllocator.GetActivatedVoices()[0].m_voiceIndex == voiceIndexA.value());
+      EXPECT(voiceAllocator.GetActivatedVoices()[0].m_sampleIndex == 5);
+      EXPECT(voiceAllocator.GetDeactivatedVoiceIndices().Count() == 1);
+      EXPECT(voiceAllocator.GetDeactivatedVoiceIndices()[0] == voiceIndexA.value());
+      EXPECT(voiceAllocator.TryGetVoiceIndex(60) == voiceIndexA);
+
+      // Retriggering a voice which was activated earlier in the same block should just move its activation
+      voiceAllocator.TriggerVoice(8, 60);
+
+      EXPECT(voiceAllocator.GetActiveVoiceIndices().Count() == 2);
+      EXPECT(voiceAllocator.GetActivatedVoices().Count() == 1);
+      EXPECT(voiceAllocator.GetActivatedVoices()[0].m_voiceIndex == voiceIndexA.value());
+      EXPECT(voiceAllocator.GetActivatedVoices()[0].m_sampleIndex == 8);
+      EXPECT(voiceAllocator.GetDeactivatedVoiceIndices().Count() == 1);
+    }
+
+    TEST_METHOD(ReleaseVoice)
+    {
+      VoiceAllocator voiceAllocator(2);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      voiceAllocator.TriggerVoice(10, 60);
+
+      usz voiceIndexA = voiceAllocator.TryGetVoiceIndex(60).value();
+      EXPECT(!voiceAllocator.IsVoiceReleased(voiceIndexA));
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      voiceAllocator.ReleaseVoice(60);
+      voiceAllocator.ReleaseVoice(62);
+
+      EXPECT(voiceAllocator.IsVoiceReleased(voiceIndexA));
+      EXPECT(!voiceAllocator.TryGetVoiceIndex(60).has_value());
+      EXPECT(voiceAllocator.GetActiveVoiceIndices().Count() == 1);
+      EXPECT(voiceAllocator.GetDeactivatedVoiceIndices().IsEmpty());
+
+      // The released voice keeps playing so triggering its ID again allocates a new voice
+      voiceAllocator.TriggerVoice(20, 60);
+
+      usz voiceIndexB = voiceAllocator.TryGetVoiceIndex(60).value();
+      EXPECT(voiceIndexB != voiceIndexA);
+      EXPECT(voiceAllocator.GetActiveVoiceIndices().Count() == 2);
+
+      voiceAllocator.DeactivateVoice(voiceIndexB);
+
+      EXPECT(!voiceAllocator.TryGetVoiceIndex(60).has_value());
+      EXPECT(voiceAllocator.GetActiveVoiceIndices().Count() == 1);
+      EXPECT(voiceAllocator.GetActiveVoiceIndices()[0] == voiceIndexA);
+    }
+
+    TEST_METHOD(StealQuietestVoice)
+    {
+      VoiceAllocator voiceAllocator(3, VoiceStealingPolicy::Quietest);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      usz voiceIndexA = voiceAllocator.TriggerVoice(0);
+      usz voiceIndexB = voiceAllocator.TriggerVoice(0);
+      usz voiceIndexC = voiceAllocator.TriggerVoice(0);
+      voiceAllocator.SetVoicePeakLevel(voiceIndexA, 0.5f);
+      voiceAllocator.SetVoicePeakLevel(voiceIndexB, 0.25f);
+      voiceAllocator.SetVoicePeakLevel(voiceIndexC, 0.75f);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      EXPECT(voiceAllocator.TriggerVoice(0) == voiceIndexB);
+
+      // The new voice hasn't reported a level yet so it shouldn't be stolen
+      EXPECT(voiceAllocator.TriggerVoice(1) == voiceIndexA);
+      EXPECT(voiceAllocator.GetDeactivatedVoiceIndices().Count() == 2);
+      EXPECT(voiceAllocator.GetDeactivatedVoiceIndices()[0] == voiceIndexB);
+      EXPECT(voiceAllocator.GetDeactivatedVoiceIndices()[1] == voiceIndexA);
+    }
+
+    TEST_METHOD(StealReleasedVoice)
+    {
+      VoiceAllocator voiceAllocator(3, VoiceStealingPolicy::ReleasedFirst);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      usz voiceIndexA = voiceAllocator.TriggerVoice(0, 60);
+      usz voiceIndexB = voiceAllocator.TriggerVoice(0, 62);
+      usz voiceIndexC = voiceAllocator.TriggerVoice(0, 64);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      voiceAllocator.ReleaseVoice(64);
+      EXPECT(voiceAllocator.TriggerVoice(0, 65) == voiceIndexC);
+
+      // With no released voices, the oldest voice is stolen
+      EXPECT(voiceAllocator.TriggerVoice(0, 67) == voiceIndexA);
+      EXPECT(voiceAllocator.TryGetVoiceIndex(62) == voiceIndexB);
+    }
+
+    TEST_METHOD(StealLowestPriorityVoice)
+    {
+      VoiceAllocator voiceAllocator(3, VoiceStealingPolicy::LowestPriority);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      usz voiceIndexA = voiceAllocator.TriggerVoice(0);
+      usz voiceIndexB = voiceAllocator.TriggerVoice(0);
+      usz voiceIndexC = voiceAllocator.TriggerVoice(0);
+      voiceAllocator.SetVoicePriority(voiceIndexA, 2);
+      voiceAllocator.SetVoicePriority(voiceIndexB, 1);
+      voiceAllocator.SetVoicePriority(voiceIndexC, 1);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      usz voiceIndexD = voiceAllocator.TriggerVoice(0);
+      EXPECT(voiceIndexD == voiceIndexB);
+      voiceAllocator.SetVoicePriority(voiceIndexD, 3);
+
+      EXPECT(voiceAllocator.TriggerVoice(0) == voiceIndexC);
+    }
+
+    TEST_METHOD(VoiceLimit)
+    {
+      VoiceAllocator voiceAllocator(4);
+
+      voiceAllocator.BeginBlockVoiceAllocation();
+      usz voiceIndexA = voiceAllocator.TriggerVoice(0, 60);
+      usz voiceIndexB = voiceAllocator.TriggerVoice(0, 62);
+      usz voiceIndexC = voiceAllocator.TriggerVoice(0, 64);
+
+      // The oldest voices should start fading out
+      voiceAllocator.SetVoiceLimit(1);
+      EXPECT(voiceAllocator.IsVoiceFadingOut(voiceIndexA));
+      EXPECT(voiceAllocator.IsVoiceFadingOut(voiceIndexB));
+      EXPECT(!voiceAllocator.IsVoiceFadingOut(voiceIndexC));
+      EXPECT(!voiceAllocator.TryGetVoiceIndex(60).has_value());
+      EXPECT(voiceAllocator.GetActiveVoiceIndices().Count() == 3);
+
+      // Triggering a voice at the limit steals the remaining voice which isn't fading out
+      voiceAllocator.BeginBlockVoiceAllocation();
+      EXPECT(voiceAllocator.TriggerVoice(0) == voiceIndexC);
+
+      voiceAllocator.DeactivateVoice(voiceIndexA);
+      voiceAllocator.DeactivateVoice(voiceIndexB);
+      EXPECT(!voiceAllocator.IsVoiceFadingOut(voiceIndexA));
+      EXPECT(voiceAllocator.GetActiveVoiceIndices().Count() == 1);
+
+      voiceAllocator.SetVoiceLimit(4);
+      voiceAllocator.BeginBlockVoiceAllocation();
+      voiceAllocator.TriggerVoice(0);
+      voiceAllocator.TriggerVoice(0);
+      voiceAllocator.TriggerVoice(0);
+      EXPECT(voiceAllocator.GetActiveVoiceIndices().Count() == 4);
+      EXPECT(voiceAllocator.GetDeactivatedVoiceIndices().IsEmpty());
+    }
   };
 }
\ No newline at end of file
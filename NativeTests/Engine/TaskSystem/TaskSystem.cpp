@@ -76,5 +76,120 @@ namespace Chord
       for (usz i = 0; i < ValueCount; i++)
         { EXPECT(taskContext.m_values[i] == u32(i)); }
     }
+
+    TEST_METHOD(BackgroundTasks)
+    {
+      static constexpr usz TaskCount = 16;
+
+      auto taskExecutor = std::make_unique<TaskExecutor>(TaskExecutorSettings { .m_threadCount = 2 });
+
+      struct TaskContext
+      {
+        TaskContext() = default;
+        TaskContext(const TaskContext&) = delete;
+        TaskContext& operator=(const TaskContext&) = delete;
+
+        void RunTask(usz taskIndex)
+        {
+          m_ranOnTaskThread |= GetTaskThreadIndex().has_value();
+          m_executionOrder.Append(taskIndex);
+          m_completedTaskCount.fetch_add(1);
+        }
+
+        FixedArray<Task, TaskCount> m_tasks;
+
+        // These are only accessed by the background thread until the task executor has been destroyed
+        bool m_ranOnTaskThread = false;
+        UnboundedArray<usz> m_executionOrder;
+
+        std::atomic<usz> m_completedTaskCount = 0;
+      };
+
+      TaskContext taskContext;
+      for (usz i = 0; i < TaskCount; i++)
+      {
+        taskContext.m_tasks[i].Initialize([context = &taskContext, i]() { context->RunTask(i); });
+        taskExecutor->EnqueueBackgroundTask(&taskContext.m_tasks[i]);
+      }
+
+      while (taskContext.m_completedTaskCount.load() < TaskCount)
+        { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }
+
+      taskExecutor.reset();
+
+      // Background tasks run one at a time in the order they were enqueued, and never on a task thread
+      EXPECT(!taskContext.m_ranOnTaskThread);
+      EXPECT(taskContext.m_executionOrder.Count() == TaskCount);
+      for (usz i = 0; i < taskContext.m_executionOrder.Count(); i++)
+        { EXPECT(taskContext.m_executionOrder[i] == i); }
+    }
+
+    TEST_METHOD(RemoveBackgroundTasks)
+    {
+      static constexpr usz TaskCount = 4;
+
+      auto taskExecutor = std::make_unique<TaskExecutor>(TaskExecutorSettings { .m_threadCount = 2 });
+
+      struct TaskContext
+      {
+        TaskContext() = default;
+        TaskContext(const TaskContext&) = delete;
+        TaskContext& operator=(const TaskContext&) = delete;
+
+        void RunTask(usz taskIndex)
+        {
+          // The first task holds up the background thread so that the remaining tasks stay queued until it is released
+          if (taskIndex == 0)
+          {
+            m_blockingTaskStarted.store(true);
+            while (!m_releaseBlockingTask.load())
+              { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+          }
+
+          m_executionOrder.Append(taskIndex);
+          m_completedTaskCount.fetch_add(1);
+        }
+
+        FixedArray<Task, TaskCount> m_tasks;
+        std::atomic<bool> m_blockingTaskStarted = false;
+        std::atomic<bool> m_releaseBlockingTask = false;
+
+        // This is only accessed by the background thread until the task executor has been destroyed
+        UnboundedArray<usz> m_executionOrder;
+
+        std::atomic<usz> m_completedTaskCount = 0;
+      };
+
+      TaskContext taskContext;
+      for (usz i = 0; i < TaskCount; i++)
+      {
+        taskContext.m_tasks[i].Initialize([context = &taskContext, i]() { context->RunTask(i); });
+        taskExecutor->EnqueueBackgroundTask(&taskContext.m_tasks[i]);
+      }
+
+      while (!taskContext.m_blockingTaskStarted.load())
+        { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+      // The running task has already been dequeued so it can't be removed. Tasks in the middle and at the back of the queue can be removed, but only once.
+      EXPECT(!taskExecutor->TryRemoveBackgroundTask(&taskContext.m_tasks[0]));
+      EXPECT(taskExecutor->TryRemoveBackgroundTask(&taskContext.m_tasks[2]));
+      EXPECT(!taskExecutor->TryRemoveBackgroundTask(&taskContext.m_tasks[2]));
+      EXPECT(taskExecutor->TryRemoveBackgroundTask(&taskContext.m_tasks[3]));
+
+      // A removed task can be initialized and enqueued again
+      taskContext.m_tasks[2].Initialize([context = &taskContext]() { context->RunTask(2); });
+      taskExecutor->EnqueueBackgroundTask(&taskContext.m_tasks[2]);
+
+      taskContext.m_releaseBlockingTask.store(true);
+      while (taskContext.m_completedTaskCount.load() < 3)
+        { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }
+
+      taskExecutor.reset();
+
+      usz expectedExecutionOrder[] = { 0, 1, 2 };
+      EXPECT(taskContext.m_executionOrder.Count() == ArrayLength(expectedExecutionOrder));
+      for (usz i = 0; i < taskContext.m_executionOrder.Count(); i++)
+        { EXPECT(taskContext.m_executionOrder[i] == expectedExecutionOrder[i]); }
+    }
   };
 }
\ No newline at end of file
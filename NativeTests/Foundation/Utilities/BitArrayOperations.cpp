@@ -101,5 +101,24 @@ namespace Chord
         }
       }
     }
+
+    TEST_METHOD(OrBits)
+    {
+      for (usz wordCount = 0; wordCount <= 11; wordCount++)
+      {
+        FixedArray<u64> destination = InitializeCapacity(wordCount);
+        FixedArray<u64> source = InitializeCapacity(wordCount);
+        for (usz i = 0; i < wordCount; i++)
+        {
+          destination[i] = 0x00ff00ff00ff00ff_u64 + i;
+          source[i] = 0x0f0f0f0f0f0f0f0f_u64 << (i % 4);
+        }
+
+        OrBits(destination, source);
+
+        for (usz i = 0; i < wordCount; i++)
+          { EXPECT(destination[i] == ((0x00ff00ff00ff00ff_u64 + i) | (0x0f0f0f0f0f0f0f0f_u64 << (i % 4)))); }
+      }
+    }
   };
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+module Chord.Tests;
+
+import std;
+
+import Chord.Foundation;
+import :Test;
+
+namespace Chord
+{
+  TEST_CLASS(BytesHash)
+  {
+    TEST_METHOD(CalculateBytesHashKey)
+    {
+      // Cover the empty case, the partial-vector tail, whole vectors, and the multi-accumulator loop
+      FixedArray<u8> bytes = InitializeCapacity(1000);
+      for (usz i = 0; i < bytes.Count(); i++)
+        { bytes[i] = u8(i * 31 + 7); }
+
+      for (usz count : { 0_usz, 1_usz, 31_usz, 32_usz, 33_usz, 128_usz, 129_usz, 1000_usz })
+      {
+        Span<const u8> span = Span<const u8>(bytes, 0, count);
+        HashKey hashKey = CalculateBytesHashKey(span);
+
+        // The hash only depends on the contents of the bytes, not their location
+        FixedArray<u8> copy = InitializeCapacity(count);
+        if (count > 0)
+          { Copy(copy.Elements(), span.Elements(), count); }
+        EXPECT(CalculateBytesHashKey(copy) == hashKey);
+
+        // Changing any byte should change the hash
+        if (count > 0)
+        {
+          copy[count - 1] ^= 1;
+          EXPECT(CalculateBytesHashKey(copy) != hashKey);
+          copy[count - 1] ^= 1;
+          copy[0] ^= 0x80;
+          EXPECT(CalculateBytesHashKey(copy) != hashKey);
+        }
+      }
+
+      // Trailing zeros are zero-padded internally but the byte count keeps these distinct
+      FixedArray<u8> zeros = InitializeCapacity(8);
+      zeros.ZeroElements();
+      EXPECT(CalculateBytesHashKey(Span<const u8>(zeros, 0, 4)) != CalculateBytesHashKey(Span<const u8>(zeros, 0, 8)));
+    }
+  };
+}
\ No newline at end of file
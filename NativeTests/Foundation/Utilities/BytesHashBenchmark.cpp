@@ -0,0 +1,84 @@
+module Chord.Tests;
+
+import std;
+
+import Chord.Foundation;
+import :Test;
+import :TestUtilities.Benchmark;
+
+namespace Chord
+{
+  // Compares the SIMD bytes hash against per-element HashGenerator hashing (which ConstantManager previously used) on a constant array the size of a large
+  // wavetable, and compares bulk equality against per-element equality
+  BENCHMARK_CLASS(BytesHashBenchmark)
+  {
+    static constexpr usz ElementCount = 1024 * 1024;
+    static constexpr usz IterationCount = 10;
+
+    TEST_METHOD(HashConstantArray)
+    {
+      FixedArray<f32> elements = InitializeCapacity(ElementCount);
+      for (usz i = 0; i < elements.Count(); i++)
+        { elements[i] = std::sin(f32(i) * 0.001f); }
+
+      Span<const u8> elementBytes = Span(reinterpret_cast<const u8*>(elements.Elements()), elements.Count() * sizeof(f32));
+
+      HashKey baselineHashKey = HashKey(0);
+      HashKey optimizedHashKey = HashKey(0);
+
+      f64 baselineNanoseconds = MeasureAverageNanoseconds(
+        IterationCount,
+        [&]()
+        {
+          HashGenerator hashGenerator;
+          hashGenerator.Append(elements.Count());
+          for (f32 element : elements)
+            { hashGenerator.Append(element); }
+          baselineHashKey = hashGenerator.GetHashKey();
+        });
+
+      f64 optimizedNanoseconds = MeasureAverageNanoseconds(
+        IterationCount,
+        [&]()
+          { optimizedHashKey = CalculateBytesHashKey(elementBytes); });
+
+      // Use the results so the work can't be optimized away
+      EXPECT(baselineHashKey != HashKey(0) || optimizedHashKey != HashKey(0));
+
+      ReportBenchmark("Constant array hash (4 MB)", baselineNanoseconds, optimizedNanoseconds);
+    }
+
+    TEST_METHOD(CompareConstantArrays)
+    {
+      FixedArray<f32> elementsA = InitializeCapacity(ElementCount);
+      FixedArray<f32> elementsB = InitializeCapacity(ElementCount);
+      for (usz i = 0; i < elementsA.Count(); i++)
+      {
+        elementsA[i] = std::sin(f32(i) * 0.001f);
+        elementsB[i] = elementsA[i];
+      }
+
+      bool baselineMatches = false;
+      bool optimizedMatches = false;
+
+      f64 baselineNanoseconds = MeasureAverageNanoseconds(
+        IterationCount,
+        [&]()
+        {
+          baselineMatches = true;
+          for (usz i = 0; baselineMatches && i < elementsA.Count(); i++)
+            { baselineMatches = elementsA[i] == elementsB[i]; }
+        });
+
+      f64 optimizedNanoseconds = MeasureAverageNanoseconds(
+        IterationCount,
+        [&]()
+          { optimizedMatches = std::memcmp(elementsA.Elements(), elementsB.Elements(), elementsA.Count() * sizeof(f32)) == 0; });
+
+      EXPECT(baselineMatches);
+      EXPECT(optimizedMatches);
+
+      ReportBenchmark("Constant array comparison (4 MB)", baselineNanoseconds, optimizedNanoseconds);
+    }
+  };
+}
\ No newline at end of file
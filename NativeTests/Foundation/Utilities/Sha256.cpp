@@ -60,5 +60,92 @@ namespace Chord
       EXPECT(TestSha256Result("ce69541a1577c63f11dd9b0a26f23d7a6ba26eb7bd0aa0805b217fb1b41bd504", hashD));
       EXPECT(TestSha256Result("6832e13a459ea002bc6d3032d4845a626fe403980f4d64560cfd4a880b682d1b", hashE));
     }
+
+    TEST_METHOD(IncrementalSha256)
+    {
+      const char* message = "This is a message which takes up two chunks. It extends partially into the second chunk.";
+      Span<const u8> messageBytes(reinterpret_cast<const u8*>(message), NullTerminatedStringLength(message));
+
+      // Split the message at every possible point, including points which leave a partial chunk pending across updates
+      for (usz splitIndex = 0; splitIndex <= messageBytes.Count(); splitIndex++)
+      {
+        Sha256 sha256;
+        sha256.Update(Span(messageBytes, 0, splitIndex));
+        sha256.Update(Span(messageBytes, splitIndex, ToEnd));
+        EXPECT(TestSha256Result("3f1132493adc0ce71d2a528de0728275883692e5d9e813f8f9a43ac32f1345d4", sha256.Finalize()));
+      }
+
+      Sha256 emptySha256;
+      EXPECT(TestSha256Result("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", emptySha256.Finalize()));
+    }
+
+    TEST_METHOD(Sha256Implementations)
+    {
+      FixedArray<u8> bytes = InitializeCapacity(1000);
+      for (usz i = 0; i < bytes.Count(); i++)
+        { bytes[i] = u8(i * 7); }
+
+      for (usz byteCount : { 0_usz, 55_usz, 56_usz, 64_usz, 1000_usz })
+      {
+        Sha256 scalarSha256(Sha256Implementation::Scalar);
+        scalarSha256.Update(Span<const u8>(bytes, 0, byteCount));
+        auto scalarHash = scalarSha256.Finalize();
+
+        Sha256 defaultSha256;
+        defaultSha256.Update(Span<const u8>(bytes, 0, byteCount));
+        auto defaultHash = defaultSha256.Finalize();
+
+        EXPECT(std::memcmp(scalarHash.Elements(), defaultHash.Elements(), Sha256ByteCount) == 0);
+
+        if (IsSha256ImplementationSupported(Sha256Implementation::ShaExtensions))
+        {
+          Sha256 shaExtensionsSha256(Sha256Implementation::ShaExtensions);
+          shaExtensionsSha256.Update(Span<const u8>(bytes, 0, byteCount));
+          auto shaExtensionsHash = shaExtensionsSha256.Finalize();
+
+          EXPECT(std::memcmp(scalarHash.Elements(), shaExtensionsHash.Elements(), Sha256ByteCount) == 0);
+        }
+      }
+    }
+
+    TEST_METHOD(ShaExtensionsSha256)
+    {
+      if (!IsSha256ImplementationSupported(Sha256Implementation::ShaExtensions))
+      {
+        LogTestMessage("Skipped: SHA extensions are not supported on this machine");
+        return;
+      }
+
+      auto Calculate =
+        [](const char* message)
+        {
+          Sha256 sha256(Sha256Implementation::ShaExtensions);
+          sha256.Update(Span<const u8>(reinterpret_cast<const u8*>(message), NullTerminatedStringLength(message)));
+          return sha256.Finalize();
+        };
+
+      const char* messageA = "This is a message which takes up only one chunk.";
+      const char* messageB = "This is a message which takes up two chunks. It extends partially into the second chunk.";
+      const char* messageC = "This message ends 1 byte short of chunk 1. AAAAAAAAAAAAAAAAAAAA";
+      const char* messageD = "This message takes up exactly one chunk, no more. AAAAAAAAAAAAAA";
+      const char* messageE = "This message doesn't leave enough space length in chunk 1.";
+
+      EXPECT(TestSha256Result("9437a8d89f539035b7ca9a4f2c91e3d3a2f7dea76d38b9addd398d41d05896f4", Calculate(messageA)));
+      EXPECT(TestSha256Result("3f1132493adc0ce71d2a528de0728275883692e5d9e813f8f9a43ac32f1345d4", Calculate(messageB)));
+      EXPECT(TestSha256Result("5e154a9a730101001a15a3b8e76a9be2f7af46ea7c5b2eca53e2cd1e27c4dcc6", Calculate(messageC)));
+      EXPECT(TestSha256Result("ce69541a1577c63f11dd9b0a26f23d7a6ba26eb7bd0aa0805b217fb1b41bd504", Calculate(messageD)));
+      EXPECT(TestSha256Result("6832e13a459ea002bc6d3032d4845a626fe403980f4d64560cfd4a880b682d1b", Calculate(messageE)));
+      EXPECT(TestSha256Result("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", Calculate("")));
+
+      // Split the message at every possible point, including points which leave a partial chunk pending across updates
+      Span<const u8> messageBytes(reinterpret_cast<const u8*>(messageB), NullTerminatedStringLength(messageB));
+      for (usz splitIndex = 0; splitIndex <= messageBytes.Count(); splitIndex++)
+      {
+        Sha256 sha256(Sha256Implementation::ShaExtensions);
+        sha256.Update(Span(messageBytes, 0, splitIndex));
+        sha256.Update(Span(messageBytes, splitIndex, ToEnd));
+        EXPECT(TestSha256Result("3f1132493adc0ce71d2a528de0728275883692e5d9e813f8f9a43ac32f1345d4", sha256.Finalize()));
+      }
+    }
   };
 }
\ No newline at end of file
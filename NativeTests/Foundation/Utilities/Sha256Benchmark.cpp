@@ -0,0 +1,55 @@
+module Chord.Tests;
+
+import std;
+
+import Chord.Foundation;
+import :Test;
+import :TestUtilities.Benchmark;
+
+namespace Chord
+{
+  // Compares the SHA extensions implementation against the scalar implementation on a buffer roughly the size of a large program
+  BENCHMARK_CLASS(Sha256Benchmark)
+  {
+    static constexpr usz ByteCount = 256 * 1024;
+    static constexpr usz IterationCount = 20;
+
+    TEST_METHOD(HashBytes)
+    {
+      if (!IsSha256ImplementationSupported(Sha256Implementation::ShaExtensions))
+      {
+        LogTestMessage("Skipped: SHA extensions are not supported on this machine");
+        return;
+      }
+
+      FixedArray<u8> bytes = InitializeCapacity(ByteCount);
+      for (usz i = 0; i < bytes.Count(); i++)
+        { bytes[i] = u8(i * 31 + 7); }
+
+      FixedArray<u8, Sha256ByteCount> scalarHash;
+      FixedArray<u8, Sha256ByteCount> shaExtensionsHash;
+
+      f64 baselineNanoseconds = MeasureAverageNanoseconds(
+        IterationCount,
+        [&]()
+        {
+          Sha256 sha256(Sha256Implementation::Scalar);
+          sha256.Update(bytes);
+          scalarHash = sha256.Finalize();
+        });
+
+      f64 optimizedNanoseconds = MeasureAverageNanoseconds(
+        IterationCount,
+        [&]()
+        {
+          Sha256 sha256(Sha256Implementation::ShaExtensions);
+          sha256.Update(bytes);
+          shaExtensionsHash = sha256.Finalize();
+        });
+
+      EXPECT(std::memcmp(scalarHash.Elements(), shaExtensionsHash.Elements(), Sha256ByteCount) == 0);
+
+      ReportBenchmark("SHA-256 (256 KB)", baselineNanoseconds, optimizedNanoseconds);
+    }
+  };
+}
\ No newline at end of file
@@ -7,7 +7,7 @@
 
 #define TEST_CLASS_NAME(name) TestClass__ ## name
 
-#define REGISTER_TEST_CLASS(name, shared) \
+#define REGISTER_TEST_CLASS(name, shared, benchmark) \
   static TestClassInfo s_testClassInfo__ ## name = \
     []() \
     { \
@@ -15,6 +15,7 @@
       { \
         .m_name = #name, \
         .m_shared = shared, \
+        .m_benchmark = benchmark, \
       }; \
     }(); \
   \
@@ -30,8 +31,11 @@
   \
   private:
 
-#define TEST_CLASS(name) REGISTER_TEST_CLASS(name, false)
-#define TEST_CLASS_SHARED(name) REGISTER_TEST_CLASS(name, true)
+#define TEST_CLASS(name) REGISTER_TEST_CLASS(name, false, false)
+#define TEST_CLASS_SHARED(name) REGISTER_TEST_CLASS(name, true, false)
+
+// Benchmark classes are skipped by default and only run when benchmarks are enabled on the command line or the class is named explicitly in a filter
+#define BENCHMARK_CLASS(name) REGISTER_TEST_CLASS(name, false, true)
 
 #define REGISTER_TEST_METHOD_(name) \
   static inline TestMethodInfo s_testMethodInfo__ ## name = \
@@ -19,6 +19,7 @@ struct TestContext
 
   std::mutex m_mutex;
   std::vector<TestFailure> m_failures;
+  std::vector<std::string> m_messages;
 };
 
 class TestFailedException : public std::exception
@@ -39,6 +40,15 @@ static void TestExpectHandler(const char* message, std::source_location sourceLo
   s_currentTestContext->m_failures.push_back({ .m_message = message, .m_sourceLocation = sourceLocation });
 }
 
+static void TestLogHandler(const char* message)
+{
+  std::unique_lock lock(s_currentTestContext->m_mutex);
+  s_currentTestContext->m_messages.push_back(message);
+}
+
+// Pass this argument to run benchmark classes which aren't explicitly named by a filter
+static constexpr std::string_view RunBenchmarksArgument = "--benchmarks";
+
 struct Filter
 {
   std::string m_testClass;
@@ -53,10 +63,10 @@ static Filter BuildFilter(std::string filterString)
     : Filter { .m_testClass = filterString.substr(0, dotIndex), .m_testMethod = filterString.substr(dotIndex + 1) };
 }
 
-static bool ShouldRunTestClass(const TestClassInfo* testClass, const std::vector<Filter>& filters)
+static bool ShouldRunTestClass(const TestClassInfo* testClass, const std::vector<Filter>& filters, bool runBenchmarks)
 {
   if (filters.empty())
-    { return true; }
+    { return !testClass->m_benchmark || runBenchmarks; }
 
   for (const Filter& filter : filters)
   {
@@ -86,13 +96,20 @@ s32 main(s32 argc, char** argv)
   InitializeFloatingPointEnvironment();
 
   std::vector<Filter> filters;
+  bool runBenchmarks = false;
   for (s32 i = 1; i < argc; i++)
-    { filters.push_back(BuildFilter(argv[i])); }
+  {
+    if (argv[i] == RunBenchmarksArgument)
+      { runBenchmarks = true; }
+    else
+      { filters.push_back(BuildFilter(argv[i])); }
+  }
 
   TestClassInfo* testClasses = FinalizeAndGetTests();
 
   SetCustomAssertHandler(&TestAssertHandler);
   SetExpectHandler(&TestExpectHandler);
+  SetLogHandler(&TestLogHandler);
 
   usz totalSuccessCount = 0;
   usz totalFailureCount = 0;
@@ -100,7 +117,7 @@ s32 main(s32 argc, char** argv)
   TestClassInfo* testClass = testClasses;
   while (testClass != nullptr)
   {
-    if (!ShouldRunTestClass(testClass, filters))
+    if (!ShouldRunTestClass(testClass, filters, runBenchmarks))
     {
       testClass = testClass->m_next;
       continue;
@@ -151,6 +168,8 @@ s32 main(s32 argc, char** argv)
       {
         successCount++;
         std::cout << ConsoleCommand::ForegroundGreen << "succeeded" << ConsoleCommand::Reset << "\n";
+        for (const std::string& message : testContext.m_messages)
+          { std::cout << "    " << message << "\n"; }
       }
       else
       {
@@ -168,6 +187,9 @@ s32 main(s32 argc, char** argv)
             << failure.m_message
             << "\n";
         }
+
+        for (const std::string& message : testContext.m_messages)
+          { std::cout << "    " << message << "\n"; }
       }
 
       testMethod = testMethod->m_next;
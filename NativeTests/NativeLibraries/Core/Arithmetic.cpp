@@ -97,6 +97,7 @@ namespace Chord
         .m_upsampleFactor = 1,
         .m_maxSampleCount = 1,
         .m_sampleCount = 0,
+        .m_voiceStartSampleOffset = 0,
         .m_isCompileTime = true, // This only gets invoked at compile time
         .m_reportingContext = nullptr,
         .m_report = nullptr,
@@ -154,6 +155,7 @@ namespace Chord
         .m_upsampleFactor = 1,
         .m_maxSampleCount = 1,
         .m_sampleCount = 0,
+        .m_voiceStartSampleOffset = 0,
         .m_isCompileTime = true, // This only gets invoked at compile time
         .m_reportingContext = nullptr,
         .m_report = nullptr,
@@ -277,6 +279,7 @@ namespace Chord
         .m_upsampleFactor = 1,
         .m_maxSampleCount = 1,
         .m_sampleCount = 0,
+        .m_voiceStartSampleOffset = 0,
         .m_isCompileTime = true, // This only gets invoked at compile time
         .m_reportingContext = nullptr,
         .m_report = nullptr,
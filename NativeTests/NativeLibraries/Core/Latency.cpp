@@ -38,6 +38,7 @@ namespace Chord
         .m_upsampleFactor = 1,
         .m_maxSampleCount = 1,
         .m_sampleCount = 0,
+        .m_voiceStartSampleOffset = 0,
         .m_isCompileTime = true, // Prepare only gets invoked at compile time
         .m_reportingContext = nullptr,
         .m_report = nullptr,
@@ -71,4 +71,20 @@ namespace Chord
 
     ASSERT(false, "Expect handler not set");
   }
+
+  static std::atomic<LogHandler> s_logHandler = nullptr;
+
+  void SetLogHandler(LogHandler logHandler)
+    { s_logHandler.store(logHandler); }
+
+  void LogTestMessage(const char* message)
+  {
+    if (LogHandler logHandler = s_logHandler.load(); logHandler != nullptr)
+    {
+      logHandler(message);
+      return;
+    }
+
+    ASSERT(false, "Log handler not set");
+  }
 }
\ No newline at end of file
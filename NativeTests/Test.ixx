@@ -40,6 +40,7 @@ namespace Chord
     {
       const char* m_name = nullptr;
       bool m_shared = false;
+      bool m_benchmark = false;
       CreateTestClass m_create = nullptr;
       TestMethodInfo* m_methods = nullptr;
     };
@@ -65,5 +66,11 @@ namespace Chord
 
     void SetExpectHandler(ExpectHandler expectHandler);
     void HandleExpect(const char* message, std::source_location sourceLocation = std::source_location::current());
+
+    using LogHandler = void (*)(const char* message);
+
+    // Messages logged during a test method are reported alongside that test method's result
+    void SetLogHandler(LogHandler logHandler);
+    void LogTestMessage(const char* message);
   }
 }
\ No newline at end of file
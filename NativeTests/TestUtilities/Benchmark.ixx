@@ -0,0 +1,37 @@
+export module Chord.Tests:TestUtilities.Benchmark;
+
+import std;
+
+import Chord.Foundation;
+import :ConsoleCommand;
+import :Test;
+
+namespace Chord
+{
+  export
+  {
+    // Runs func once to warm up and then iterationCount more times, returning the average duration of a run in nanoseconds. Timings are only meaningful in
+    // optimized builds.
+    template<typename TFunc>
+    f64 MeasureAverageNanoseconds(usz iterationCount, TFunc&& func)
+    {
+      func();
+      auto startTime = std::chrono::steady_clock::now();
+      for (usz i = 0; i < iterationCount; i++)
+        { func(); }
+      return std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - startTime).count() / f64(iterationCount);
+    }
+
+    // Logs an optimized implementation's timing alongside the timing of the implementation it replaces
+    void ReportBenchmark(const char* name, f64 baselineNanoseconds, f64 optimizedNanoseconds)
+    {
+      std::ostringstream message;
+      message
+        << ConsoleCommand::Bold << name << ConsoleCommand::Reset
+        << ": baseline " << baselineNanoseconds
+        << " ns, optimized " << optimizedNanoseconds
+        << " ns (" << (baselineNanoseconds / optimizedNanoseconds) << "x)";
+      LogTestMessage(message.str().c_str());
+    }
+  }
+}
\ No newline at end of file
@@ -835,6 +835,7 @@ namespace Chord
         .m_upsampleFactor = 1,
         .m_maxSampleCount = maxSampleCount,
         .m_sampleCount = 0,
+        .m_voiceStartSampleOffset = 0,
         .m_isCompileTime = false,
         .m_reportingContext = &reportingContext,
         .m_report = Report,
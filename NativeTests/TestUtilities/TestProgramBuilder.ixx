@@ -0,0 +1,429 @@
+module;
+
+#include "../../NativeLibraryApi/ChordNativeLibraryApi.h"
+
+export module Chord.Tests:TestUtilities.TestProgramBuilder;
+
+import std;
+
+import Chord.Engine;
+import Chord.Foundation;
+
+namespace Chord
+{
+  // This matches the node type order of serialized version 1 programs
+  enum class TestProgramNodeType
+  {
+    Input,
+    Output,
+    FloatConstant,
+    DoubleConstant,
+    IntConstant,
+    BoolConstant,
+    StringConstant,
+    Array,
+    NativeModuleCall,
+    GraphInput,
+    GraphOutput,
+  };
+
+  export
+  {
+    enum class TestProgramStage
+    {
+      Voice,
+      Effect,
+    };
+
+    struct TestProgramSettings
+    {
+      u32 m_maxVoices = 1;
+      EffectActivationMode m_effectActivationMode = EffectActivationMode::Always;
+      f64 m_effectActivationThreshold = 0.0;
+      PrimitiveType m_outputChannelPrimitiveType = PrimitiveTypeFloat;
+    };
+
+    // Builds serialized version 1 programs (see Program.cpp for the layout) whose native module calls reference the core native library (or other native
+    // libraries registered with the processor's registry, all at version 1.0.0). This allows tests to run real native modules through a ProgramProcessor
+    // without the compiler.
+    class TestProgramBuilder
+    {
+    public:
+      // Identifies an output node of a constant, array, native module call, or graph input node
+      struct Output
+      {
+        usz m_index = 0;
+      };
+
+      static constexpr Guid CoreNativeLibraryId = Guid::Parse("fa002397-f724-4b7d-80b7-4d6408051bd2");
+
+      TestProgramBuilder(const TestProgramSettings& settings = {})
+        : m_settings(settings)
+        { m_nativeLibraryIds.Append(CoreNativeLibraryId); }
+
+      TestProgramBuilder(const TestProgramBuilder&) = delete;
+      TestProgramBuilder& operator=(const TestProgramBuilder&) = delete;
+
+      Output AddFloatConstant(f32 value)
+        { return AddConstant(m_floatConstants, value); }
+      Output AddDoubleConstant(f64 value)
+        { return AddConstant(m_doubleConstants, value); }
+      Output AddIntConstant(s32 value)
+        { return AddConstant(m_intConstants, value); }
+      Output AddBoolConstant(bool value)
+        { return AddConstant(m_boolConstants, u32(value ? 1 : 0)); }
+
+      Output AddArray(std::initializer_list<Output> elements)
+      {
+        ArrayRecord& record = m_arrays.AppendNew();
+        for (Output element : elements)
+          { record.m_elementInputIndices.Append(AddInput(element)); }
+        record.m_outputIndex = AddOutput();
+        return { record.m_outputIndex };
+      }
+
+      UnboundedArray<Output> AddNativeModuleCall(const Guid& nativeModuleId, std::initializer_list<Output> inputs, usz outputCount, s32 upsampleFactor = 1)
+        { return AddNativeModuleCall(CoreNativeLibraryId, nativeModuleId, inputs, outputCount, upsampleFactor); }
+
+      UnboundedArray<Output> AddNativeModuleCall(
+        const Guid& nativeLibraryId,
+        const Guid& nativeModuleId,
+        std::initializer_list<Output> inputs,
+        usz outputCount,
+        s32 upsampleFactor)
+      {
+        std::optional<usz> nativeLibraryIndex;
+        for (usz i = 0; i < m_nativeLibraryIds.Count() && !nativeLibraryIndex.has_value(); i++)
+        {
+          if (m_nativeLibraryIds[i] == nativeLibraryId)
+            { nativeLibraryIndex = i; }
+        }
+
+        if (!nativeLibraryIndex.has_value())
+        {
+          nativeLibraryIndex = m_nativeLibraryIds.Count();
+          m_nativeLibraryIds.Append(nativeLibraryId);
+        }
+
+        NativeModuleCallRecord& record = m_nativeModuleCalls.AppendNew();
+        record.m_nativeLibraryIndex = *nativeLibraryIndex;
+        record.m_nativeModuleId = nativeModuleId;
+        record.m_upsampleFactor = upsampleFactor;
+        for (Output input : inputs)
+          { record.m_inputIndices.Append(AddInput(input)); }
+
+        UnboundedArray<Output> outputs;
+        for (usz i = 0; i < outputCount; i++)
+        {
+          record.m_outputIndices.Append(AddOutput());
+          outputs.Append({ record.m_outputIndices[i] });
+        }
+
+        return outputs;
+      }
+
+      // Convenience for the common case of a native module with a single output
+      Output AddNativeModuleCall(const Guid& nativeModuleId, std::initializer_list<Output> inputs)
+        { return AddNativeModuleCall(nativeModuleId, inputs, 1)[0]; }
+
+      Output AddFloatInputChannel()
+      {
+        usz graphInputIndex = AddGraphInput();
+        m_floatInputChannelGraphInputIndices.Append(graphInputIndex);
+        return { m_graphInputOutputIndices[graphInputIndex] };
+      }
+
+      void AddOutputChannel(TestProgramStage stage, Output output)
+        { m_outputChannelGraphOutputIndices.Append(AddGraphOutput(stage, output)); }
+
+      void SetRemainActiveOutput(TestProgramStage stage, Output output)
+      {
+        usz graphOutputIndex = AddGraphOutput(stage, output);
+        if (stage == TestProgramStage::Voice)
+          { m_voiceRemainActiveGraphOutputIndex = graphOutputIndex; }
+        else
+          { m_effectRemainActiveGraphOutputIndex = graphOutputIndex; }
+      }
+
+      // Routes a voice output to the effect stage and returns the corresponding effect stage input
+      Output AddVoiceToEffect(PrimitiveType primitiveType, Output voiceOutput)
+      {
+        usz graphInputIndex = AddGraphInput();
+        m_voiceToEffects.Append(
+          {
+            .m_primitiveType = primitiveType,
+            .m_graphOutputIndex = AddGraphOutput(TestProgramStage::Voice, voiceOutput),
+            .m_graphInputIndex = graphInputIndex,
+          });
+        return { m_graphInputOutputIndices[graphInputIndex] };
+      }
+
+      UnboundedArray<u8> Build() const
+      {
+        // Nodes are grouped by type in the serialized program so node indices are only known once all nodes have been added
+        FixedArray<usz, EnumCount<NodeType>()> nodeCounts;
+        nodeCounts[EnumValue(NodeType::Input)] = m_inputCount;
+        nodeCounts[EnumValue(NodeType::Output)] = m_outputConnectionInputIndices.Count();
+        nodeCounts[EnumValue(NodeType::FloatConstant)] = m_floatConstants.Count();
+        nodeCounts[EnumValue(NodeType::DoubleConstant)] = m_doubleConstants.Count();
+        nodeCounts[EnumValue(NodeType::IntConstant)] = m_intConstants.Count();
+        nodeCounts[EnumValue(NodeType::BoolConstant)] = m_boolConstants.Count();
+        nodeCounts[EnumValue(NodeType::StringConstant)] = 0;
+        nodeCounts[EnumValue(NodeType::Array)] = m_arrays.Count();
+        nodeCounts[EnumValue(NodeType::NativeModuleCall)] = m_nativeModuleCalls.Count();
+        nodeCounts[EnumValue(NodeType::GraphInput)] = m_graphInputOutputIndices.Count();
+        nodeCounts[EnumValue(NodeType::GraphOutput)] = m_graphOutputInputIndices.Count();
+
+        FixedArray<u32, EnumCount<NodeType>()> nodeStartIndices;
+        u32 nextNodeIndex = 0;
+        for (usz i = 0; i < nodeCounts.Count(); i++)
+        {
+          nodeStartIndices[i] = nextNodeIndex;
+          nextNodeIndex += u32(nodeCounts[i]);
+        }
+
+        auto NodeIndex = [&](NodeType nodeType, usz index) { return nodeStartIndices[EnumValue(nodeType)] + u32(index); };
+
+        UnboundedArray<u8> content;
+        auto Write = [&](auto value) { content.AppendMultiple(Span(reinterpret_cast<const u8*>(&value), sizeof(value))); };
+
+        // Records reference ranges of the reference table, which is filled in as records are written
+        UnboundedArray<u32> references;
+        auto AddReferences =
+          [&](NodeType nodeType, const UnboundedArray<usz>& indices)
+          {
+            u32 firstReferenceIndex = u32(references.Count());
+            for (usz index : indices)
+              { references.Append(NodeIndex(nodeType, index)); }
+            return firstReferenceIndex;
+          };
+
+        // Every input node is referenced by the output it connects to. Array elements and native module call inputs and outputs are referenced as well.
+        usz referenceCount = m_inputCount;
+        for (const ArrayRecord& record : m_arrays)
+          { referenceCount += record.m_elementInputIndices.Count(); }
+        for (const NativeModuleCallRecord& record : m_nativeModuleCalls)
+          { referenceCount += record.m_inputIndices.Count() + record.m_outputIndices.Count(); }
+
+        Write(u32(m_nativeLibraryIds.Count()));
+        for (const Guid& nativeLibraryId : m_nativeLibraryIds)
+        {
+          content.AppendMultiple(nativeLibraryId.Bytes());
+          Write(1_u32);
+          Write(0_u32);
+          Write(0_u32);
+        }
+
+        Write(48000_s32);
+        Write(s32(m_floatInputChannelGraphInputIndices.Count()));
+        Write(s32(m_outputChannelGraphOutputIndices.Count()));
+        Write(m_settings.m_maxVoices);
+        Write(u32(m_settings.m_effectActivationMode));
+        Write(m_settings.m_effectActivationThreshold);
+
+        for (usz nodeCount : nodeCounts)
+          { Write(u32(nodeCount)); }
+
+        Write(u32(referenceCount));
+        Write(0_u32); // String pool length
+
+        for (const UnboundedArray<usz>& connectionInputIndices : m_outputConnectionInputIndices)
+        {
+          Write(u32(connectionInputIndices.Count()));
+          Write(AddReferences(NodeType::Input, connectionInputIndices));
+        }
+
+        for (auto [outputIndex, value] : m_floatConstants)
+        {
+          Write(NodeIndex(NodeType::Output, outputIndex));
+          Write(value);
+        }
+
+        for (auto [outputIndex, value] : m_doubleConstants)
+        {
+          Write(NodeIndex(NodeType::Output, outputIndex));
+          Write(value);
+        }
+
+        for (auto [outputIndex, value] : m_intConstants)
+        {
+          Write(NodeIndex(NodeType::Output, outputIndex));
+          Write(value);
+        }
+
+        for (auto [outputIndex, value] : m_boolConstants)
+        {
+          Write(NodeIndex(NodeType::Output, outputIndex));
+          Write(value);
+        }
+
+        for (const ArrayRecord& record : m_arrays)
+        {
+          Write(u32(record.m_elementInputIndices.Count()));
+          Write(AddReferences(NodeType::Input, record.m_elementInputIndices));
+          Write(NodeIndex(NodeType::Output, record.m_outputIndex));
+        }
+
+        for (const NativeModuleCallRecord& record : m_nativeModuleCalls)
+        {
+          Write(u32(record.m_nativeLibraryIndex));
+          content.AppendMultiple(record.m_nativeModuleId.Bytes());
+          Write(u32(record.m_inputIndices.Count()));
+          Write(u32(record.m_outputIndices.Count()));
+          Write(record.m_upsampleFactor);
+          Write(AddReferences(NodeType::Input, record.m_inputIndices));
+          AddReferences(NodeType::Output, record.m_outputIndices);
+        }
+
+        for (usz outputIndex : m_graphInputOutputIndices)
+          { Write(NodeIndex(NodeType::Output, outputIndex)); }
+
+        for (usz inputIndex : m_graphOutputInputIndices)
+          { Write(NodeIndex(NodeType::Input, inputIndex)); }
+
+        ASSERT(references.Count() == referenceCount);
+        for (u32 reference : references)
+          { Write(reference); }
+
+        Write(u8(m_floatInputChannelGraphInputIndices.IsEmpty() ? 0 : 1));
+        for (usz graphInputIndex : m_floatInputChannelGraphInputIndices)
+          { Write(NodeIndex(NodeType::GraphInput, graphInputIndex)); }
+        Write(u8(0)); // No double input channels
+
+        Write(u8(m_settings.m_outputChannelPrimitiveType));
+        for (usz graphOutputIndex : m_outputChannelGraphOutputIndices)
+          { Write(NodeIndex(NodeType::GraphOutput, graphOutputIndex)); }
+
+        for (const std::optional<usz>& graphOutputIndex : { m_voiceRemainActiveGraphOutputIndex, m_effectRemainActiveGraphOutputIndex })
+        {
+          Write(u8(graphOutputIndex.has_value() ? 1 : 0));
+          if (graphOutputIndex.has_value())
+            { Write(NodeIndex(NodeType::GraphOutput, *graphOutputIndex)); }
+        }
+
+        Write(u32(m_voiceToEffects.Count()));
+        for (const VoiceToEffectRecord& record : m_voiceToEffects)
+          { Write(u8(record.m_primitiveType)); }
+        for (const VoiceToEffectRecord& record : m_voiceToEffects)
+          { Write(NodeIndex(NodeType::GraphOutput, record.m_graphOutputIndex)); }
+        for (const VoiceToEffectRecord& record : m_voiceToEffects)
+          { Write(NodeIndex(NodeType::GraphInput, record.m_graphInputIndex)); }
+
+        // Each stage graph is stored as the list of graph output nodes belonging to that stage
+        for (TestProgramStage stage : { TestProgramStage::Voice, TestProgramStage::Effect })
+        {
+          usz graphOutputCount = 0;
+          for (TestProgramStage graphOutputStage : m_graphOutputStages)
+            { graphOutputCount += (graphOutputStage == stage ? 1 : 0); }
+
+          Write(u8(graphOutputCount == 0 ? 0 : 1));
+          if (graphOutputCount > 0)
+          {
+            Write(u32(graphOutputCount));
+            for (usz graphOutputIndex = 0; graphOutputIndex < m_graphOutputStages.Count(); graphOutputIndex++)
+            {
+              if (m_graphOutputStages[graphOutputIndex] == stage)
+                { Write(NodeIndex(NodeType::GraphOutput, graphOutputIndex)); }
+            }
+          }
+        }
+
+        UnboundedArray<u8> hashInput = content;
+        hashInput.AppendMultiple(Span<const u8>(HashSalt));
+        auto contentHash = CalculateSha256(hashInput);
+
+        UnboundedArray<u8> bytes;
+        for (char c : { 'C', 'H', 'O', 'R', 'D', 'P', 'R', 'O', 'G', 'R', 'A', 'M' })
+          { bytes.Append(u8(c)); }
+        u32 version = 1;
+        bytes.AppendMultiple(Span(reinterpret_cast<const u8*>(&version), sizeof(version)));
+        bytes.AppendMultiple(Span<const u8>(contentHash));
+        bytes.AppendMultiple(Span<const u8>(content));
+        return bytes;
+      }
+
+    private:
+      using NodeType = TestProgramNodeType;
+
+      static constexpr u8 HashSalt[] = { 0x8b, 0xe1, 0x53, 0x2f, 0x41, 0x16, 0xc9, 0x8d, 0x1a, 0x2a, 0xb4, 0x3c, 0x0b, 0x34, 0xae, 0xdf };
+
+      struct ArrayRecord
+      {
+        UnboundedArray<usz> m_elementInputIndices;
+        usz m_outputIndex = 0;
+      };
+
+      struct NativeModuleCallRecord
+      {
+        usz m_nativeLibraryIndex = 0;
+        Guid m_nativeModuleId = Guid::Empty();
+        s32 m_upsampleFactor = 1;
+        UnboundedArray<usz> m_inputIndices;
+        UnboundedArray<usz> m_outputIndices;
+      };
+
+      struct VoiceToEffectRecord
+      {
+        PrimitiveType m_primitiveType = PrimitiveTypeFloat;
+        usz m_graphOutputIndex = 0;
+        usz m_graphInputIndex = 0;
+      };
+
+      template<typename TValue>
+      Output AddConstant(UnboundedArray<std::tuple<usz, TValue>>& constants, TValue value)
+      {
+        usz outputIndex = AddOutput();
+        constants.Append({ outputIndex, value });
+        return { outputIndex };
+      }
+
+      usz AddOutput()
+      {
+        m_outputConnectionInputIndices.AppendNew();
+        return m_outputConnectionInputIndices.Count() - 1;
+      }
+
+      // Creates an input node connected to the given output
+      usz AddInput(Output connection)
+      {
+        usz inputIndex = m_inputCount++;
+        m_outputConnectionInputIndices[connection.m_index].Append(inputIndex);
+        return inputIndex;
+      }
+
+      usz AddGraphInput()
+      {
+        m_graphInputOutputIndices.Append(AddOutput());
+        return m_graphInputOutputIndices.Count() - 1;
+      }
+
+      usz AddGraphOutput(TestProgramStage stage, Output output)
+      {
+        m_graphOutputInputIndices.Append(AddInput(output));
+        m_graphOutputStages.Append(stage);
+        return m_graphOutputInputIndices.Count() - 1;
+      }
+
+      TestProgramSettings m_settings;
+
+      UnboundedArray<Guid> m_nativeLibraryIds;
+      usz m_inputCount = 0;
+      UnboundedArray<UnboundedArray<usz>> m_outputConnectionInputIndices;
+      UnboundedArray<std::tuple<usz, f32>> m_floatConstants;
+      UnboundedArray<std::tuple<usz, f64>> m_doubleConstants;
+      UnboundedArray<std::tuple<usz, s32>> m_intConstants;
+      UnboundedArray<std::tuple<usz, u32>> m_boolConstants;
+      UnboundedArray<ArrayRecord> m_arrays;
+      UnboundedArray<NativeModuleCallRecord> m_nativeModuleCalls;
+      UnboundedArray<usz> m_graphInputOutputIndices;
+      UnboundedArray<usz> m_graphOutputInputIndices;
+      UnboundedArray<TestProgramStage> m_graphOutputStages;
+
+      UnboundedArray<usz> m_floatInputChannelGraphInputIndices;
+      UnboundedArray<usz> m_outputChannelGraphOutputIndices;
+      std::optional<usz> m_voiceRemainActiveGraphOutputIndex;
+      std::optional<usz> m_effectRemainActiveGraphOutputIndex;
+      UnboundedArray<VoiceToEffectRecord> m_voiceToEffects;
+    };
+  }
+}
\ No newline at end of file